@@ -64,9 +64,18 @@
  * Used in cycle detection algorithm
  */
 #define COLOR_WHITE 0  // Unvisited
-#define COLOR_GRAY 1   // Currently being processed (in recursion stack)
+#define COLOR_GRAY 1   // Currently being processed (on the DFS stack)
 #define COLOR_BLACK 2  // Finished processing
 
+/* =============================================================================
+ * CYCLE DETECTION ENGINES
+ * =============================================================================
+ * Selected at runtime with set_cycle_engine() / --engine
+ */
+#define CYCLE_ENGINE_DFS 0      // Back-edge DFS, reports every distinct cycle found
+#define CYCLE_ENGINE_SCC 1      // Tarjan SCC, one witness cycle per deadlocked set
+#define DEFAULT_CYCLE_ENGINE CYCLE_ENGINE_DFS
+
 /* =============================================================================
  * VERTEX TYPES
  * =============================================================================
@@ -81,6 +90,13 @@
 #define RESOURCE_TYPE_SINGLE_INSTANCE 0
 #define RESOURCE_TYPE_MULTIPLE_INSTANCE 1
 
+/* Resource ID of a pipe's write end when its ends are known; the read end
+ * (and a pipe with an unknown end) uses the plain inode-derived ID */
+#define PIPE_WRITE_END_RESOURCE_BASE 1000000
+
+/* Resource ID of "child PID exits", held by the child, waited on by wait4() */
+#define CHILD_EXIT_RESOURCE_BASE 2000000
+
 /* =============================================================================
  * OUTPUT FORMATS
  * =============================================================================
@@ -103,10 +119,12 @@
  */
 #define PROC_BASE_PATH "/proc"
 #define PROC_STATUS_FILE "status"
+#define PROC_STAT_FILE "stat"
 #define PROC_FD_DIR "fd"
 #define PROC_LOCKS_FILE "locks"
 #define PROC_CMDLINE_FILE "cmdline"
 #define PROC_WCHAN_FILE "wchan"
+#define PROC_SYSCALL_FILE "syscall"
 #define PROC_SYSTEM_LOCKS_FILE "/proc/locks"
 #define MAX_WCHAN_LEN 64
 #define MAX_PIPE_INODES 1024
@@ -125,7 +143,29 @@
  */
 #define DEFAULT_MONITORING_INTERVAL 5
 #define MAX_MONITORING_INTERVAL 3600
-#define MIN_MONITORING_INTERVAL 1
+#define MIN_MONITORING_INTERVAL_MS 10 /* Shortest accepted -i and --min-interval */
+#define ADAPTIVE_FLOOR_MS 250         /* Adaptive scheduling: shortest delay between scans */
+#define ADAPTIVE_CEILING_MS 60000     /* Adaptive scheduling: longest delay between scans */
+#define ADAPTIVE_RAMP 2.0             /* Adaptive scheduling: back-off factor per quiet scan */
+#define DEFAULT_CONFIRM_ROUNDS 0      /* Re-reads of a suspected deadlock (0 = report at once) */
+#define DEFAULT_CONFIRM_INTERVAL_MS 50 /* Spacing between confirmation re-reads */
+#define MAX_CONFIRM_ROUNDS 100
+#define MAX_CONFIRM_INTERVAL_MS 10000
+#define DEFAULT_WORKER_THREADS 1      /* 1 = collect serially, 0 = one per CPU */
+#define MAX_WORKER_THREADS 256
+#define COLLECT_CHUNK_SIZE 16         /* PIDs claimed per worker cursor step */
+#define ARENA_CHUNK_SIZE 65536        /* Bytes per scan arena chunk */
+#define ARENA_ALIGNMENT 16            /* Alignment of every arena allocation */
+#define PROC_READ_BUFFER_SIZE 4096    /* Initial size of per-thread /proc read buffers */
+#define PROC_HANDLE_CACHE_FD_RESERVE 256 /* FDs left free when sizing the handle cache */
+#define SCAN_RECORD_WCHAN_LEN 64      /* Longest wait channel kept for incremental reuse */
+#define PROC_EVENTS_RECONCILE_SCANS 60 /* Scans between full /proc walks with the event feed */
+#define PROC_EVENTS_RECV_BUFFER 8192  /* Bytes per connector receive */
+#define PROC_EVENTS_SOCKET_BUFFER (1 << 20) /* Requested connector socket receive buffer */
+#define PROC_EVENTS_PROBE_TIMEOUT_MS 1000 /* Wait for the probe fork event when subscribing */
+#define PROC_URING_ENTRIES 64         /* Submission ring size of each io_uring */
+#define PROC_URING_MAX_BATCH 32       /* Files read per io_uring batch */
+#define PROC_URING_READ_SIZE 1024     /* Buffer per batched read (stat, wchan) */
 
 /* =============================================================================
  * VERSION INFORMATION
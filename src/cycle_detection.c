@@ -2,7 +2,8 @@
  * CYCLE_DETECTION.C - Cycle Detection Implementation
  * =============================================================================
  * Implementation of DFS-based cycle detection algorithm using 3-color marking
- * to detect all cycles in Resource Allocation Graphs.
+ * to detect all cycles in Resource Allocation Graphs, and of an iterative
+ * Tarjan SCC engine that reports each deadlocked vertex set once.
  * =============================================================================
  */
 
@@ -13,11 +14,74 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Engine used by has_cycle() */
+static int s_cycle_engine = DEFAULT_CYCLE_ENGINE;
+
+/*
+ * DfsStack - Explicit DFS frame stack shared by the traversals in this file
+ * Frame i holds a vertex and the position of the next CSR edge to examine.
+ * Grown on demand and kept across scans; released by free_cycle_workspace().
+ */
+typedef struct {
+    int* vertex;                    /* Vertex of each frame */
+    int* edge;                      /* Next csr_targets position per frame */
+    int capacity;                   /* Frames allocated */
+} DfsStack;
+
+static DfsStack s_dfs_stack;
+
+/*
+ * DfsMarks - Epoch-stamped vertex state for find_all_cycles()
+ * A vertex is WHITE unless stamp[v] equals the current epoch, so starting a
+ * new scan only bumps the epoch. Parent is written when a vertex is
+ * discovered, so it never needs clearing either. Kept across scans.
+ */
+typedef struct {
+    unsigned int* stamp;            /* Epoch in which the vertex was discovered */
+    unsigned char* on_stack;        /* 1 = GRAY, 0 = BLACK (valid when stamped) */
+    int* parent;                    /* DFS tree parent (valid when stamped) */
+    int capacity;                   /* Vertices allocated */
+    unsigned int epoch;             /* Current epoch, never 0 */
+} DfsMarks;
+
+static DfsMarks s_dfs_marks;
+
 /* =============================================================================
  * HELPER FUNCTIONS
  * =============================================================================
  */
 
+/*
+ * dfs_stack_reserve - Ensure the shared DFS stack holds at least depth frames
+ * @depth: Required number of frames
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+static int dfs_stack_reserve(int depth)
+{
+    if (depth <= s_dfs_stack.capacity) {
+        return SUCCESS;
+    }
+    
+    int new_capacity = s_dfs_stack.capacity == 0 ? 64 : s_dfs_stack.capacity;
+    while (new_capacity < depth) {
+        new_capacity *= 2;
+    }
+    
+    int* vertex = (int*)safe_realloc(s_dfs_stack.vertex, sizeof(int) * new_capacity);
+    if (vertex == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    s_dfs_stack.vertex = vertex;
+    
+    int* edge = (int*)safe_realloc(s_dfs_stack.edge, sizeof(int) * new_capacity);
+    if (edge == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    s_dfs_stack.edge = edge;
+    s_dfs_stack.capacity = new_capacity;
+    return SUCCESS;
+}
+
 /*
  * is_duplicate_cycle - Check if a cycle is duplicate of existing ones
  * @cycle: Cycle to check
@@ -140,6 +204,175 @@ static int add_cycle_to_list(CycleInfo** cycle_list, int* num_cycles,
     return SUCCESS;
 }
 
+/*
+ * dfs_marks_begin - Start a new epoch covering num_vertices vertices
+ * @num_vertices: Number of vertices in the graph about to be traversed
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ * Description: O(1) unless the arrays must grow or the epoch wraps, in which
+ *              case stamps are cleared once.
+ */
+static int dfs_marks_begin(int num_vertices)
+{
+    if (num_vertices > s_dfs_marks.capacity) {
+        int new_capacity = s_dfs_marks.capacity == 0 ? 64 : s_dfs_marks.capacity;
+        while (new_capacity < num_vertices) {
+            new_capacity *= 2;
+        }
+        
+        unsigned int* stamp = (unsigned int*)safe_realloc(
+            s_dfs_marks.stamp, sizeof(unsigned int) * new_capacity);
+        if (stamp == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        s_dfs_marks.stamp = stamp;
+        /* New entries must not match any epoch */
+        memset(stamp + s_dfs_marks.capacity, 0,
+               sizeof(unsigned int) * (new_capacity - s_dfs_marks.capacity));
+        
+        unsigned char* on_stack = (unsigned char*)safe_realloc(
+            s_dfs_marks.on_stack, sizeof(unsigned char) * new_capacity);
+        if (on_stack == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        s_dfs_marks.on_stack = on_stack;
+        
+        int* parent = (int*)safe_realloc(s_dfs_marks.parent, sizeof(int) * new_capacity);
+        if (parent == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        s_dfs_marks.parent = parent;
+        s_dfs_marks.capacity = new_capacity;
+    }
+    
+    s_dfs_marks.epoch++;
+    if (s_dfs_marks.epoch == 0) {
+        memset(s_dfs_marks.stamp, 0, sizeof(unsigned int) * s_dfs_marks.capacity);
+        s_dfs_marks.epoch = 1;
+    }
+    
+    return SUCCESS;
+}
+
+/*
+ * has_self_loop - Check whether a vertex has an edge to itself
+ * @graph: ResourceGraph
+ * @vertex: Vertex index
+ * @return: 1 if vertex -> vertex exists, 0 otherwise
+ */
+static int has_self_loop(const ResourceGraph* graph, int vertex)
+{
+    for (int e = graph->csr_offsets[vertex]; e < graph->csr_offsets[vertex + 1]; e++) {
+        if (graph->csr_targets[e] == vertex) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * set_component_members - Replace cycle IDs with all members of a component
+ * @graph: ResourceGraph for vertex information
+ * @members: Vertex indices of the component
+ * @count: Number of members
+ * @cycle: Cycle whose process_ids/resource_ids are rebuilt
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+static int set_component_members(const ResourceGraph* graph, const int* members,
+                                 int count, CycleInfo* cycle)
+{
+    int num_processes = 0;
+    int num_resources = 0;
+
+    for (int i = 0; i < count; i++) {
+        if (graph->vertex_type[members[i]] == VERTEX_TYPE_PROCESS) {
+            num_processes++;
+        } else if (graph->vertex_type[members[i]] == VERTEX_TYPE_RESOURCE) {
+            num_resources++;
+        }
+    }
+
+    safe_free((void**)&cycle->process_ids);
+    safe_free((void**)&cycle->resource_ids);
+    cycle->num_processes = 0;
+    cycle->num_resources = 0;
+
+    if (num_processes > 0) {
+        cycle->process_ids = (int*)safe_malloc(sizeof(int) * num_processes);
+        if (cycle->process_ids == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+    }
+    if (num_resources > 0) {
+        cycle->resource_ids = (int*)safe_malloc(sizeof(int) * num_resources);
+        if (cycle->resource_ids == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        int vertex = members[i];
+        if (graph->vertex_type[vertex] == VERTEX_TYPE_PROCESS) {
+            cycle->process_ids[cycle->num_processes++] = graph->vertex_id[vertex];
+        } else if (graph->vertex_type[vertex] == VERTEX_TYPE_RESOURCE) {
+            cycle->resource_ids[cycle->num_resources++] = graph->vertex_id[vertex];
+        }
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * extract_component_cycle - Build the witness cycle of one component
+ * @graph: ResourceGraph being analyzed
+ * @component: Component ID per vertex
+ * @comp_id: ID of the component to extract
+ * @root: Component root (first member discovered)
+ * @parent: Scratch parent array (num_vertices entries)
+ * @queue: Scratch BFS queue (num_vertices entries)
+ * @cycle: Output cycle (zero-initialized by caller)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: BFS from root restricted to the component; the first edge
+ *              back into root closes the shortest cycle through root.
+ */
+static int extract_component_cycle(const ResourceGraph* graph, const int* component,
+                                   int comp_id, int root, int* parent, int* queue,
+                                   CycleInfo* cycle)
+{
+    int head = 0;
+    int tail = 0;
+
+    parent[root] = root;
+    queue[tail++] = root;
+
+    while (head < tail) {
+        int u = queue[head++];
+        for (int e = graph->csr_offsets[u]; e < graph->csr_offsets[u + 1]; e++) {
+            int w = graph->csr_targets[e];
+            if (w < 0 || w >= graph->num_vertices || component[w] != comp_id) {
+                continue;
+            }
+            if (w == root) {
+                parent[root] = -1;
+                int result = extract_cycle_path(parent, root, u, graph, cycle);
+                /* Leave parent clean for the next component */
+                for (int i = 0; i < tail; i++) {
+                    parent[queue[i]] = -1;
+                }
+                return result;
+            }
+            if (parent[w] == -1) {
+                parent[w] = u;
+                queue[tail++] = w;
+            }
+        }
+    }
+
+    for (int i = 0; i < tail; i++) {
+        parent[queue[i]] = -1;
+    }
+    return ERROR_CYCLE_DETECTION_FAILED;
+}
+
 /* =============================================================================
  * MAIN FUNCTIONS
  * =============================================================================
@@ -153,7 +386,7 @@ static int add_cycle_to_list(CycleInfo** cycle_list, int* num_cycles,
  * @color: Current color array
  * @return: 1 if back edge, 0 otherwise
  * Description: Checks if edge from_vertex->to_vertex is a back edge.
- *              Back edge exists when to_vertex is GRAY (in recursion stack).
+ *              Back edge exists when to_vertex is GRAY (on the DFS stack).
  *              Time complexity: O(1)
  * Error handling: Returns 0 for invalid parameters
  */
@@ -169,7 +402,7 @@ int detect_back_edge(const ResourceGraph* graph, int from_vertex, int to_vertex,
         return 0;
     }
     
-    /* Back edge: edge to a GRAY vertex (in recursion stack) */
+    /* Back edge: edge to a GRAY vertex (on the DFS stack) */
     return (color[to_vertex] == COLOR_GRAY) ? 1 : 0;
 }
 
@@ -231,68 +464,53 @@ int extract_cycle_path(const int* parent, int ancestor, int current,
     }
     
     /* When back edge current->ancestor is detected:
-     * - ancestor is GRAY (in recursion stack)
+     * - ancestor is GRAY (on the DFS stack)
      * - ancestor is an ancestor of current in DFS tree
      * - Parent chain from current leads back to ancestor
      * - Cycle: ancestor -> ... -> current -> ancestor
      */
     
-    /* Build path from current back to ancestor by following parent chain */
-    int* temp_path = (int*)safe_malloc(sizeof(int) * graph->num_vertices);
-    if (temp_path == NULL) {
-        return ERROR_OUT_OF_MEMORY;
-    }
-    
-    int path_idx = 0;
+    /* Measure the parent chain from current back to ancestor first, so the
+     * path can be written in place without a V-sized scratch buffer */
+    int chain_length = 0;
     int v = current;
     
-    /* Follow parent chain from current back to ancestor */
-    while (v != ancestor && v >= 0 && path_idx < graph->num_vertices) {
-        temp_path[path_idx++] = v;
+    while (v != ancestor && v >= 0 && chain_length < graph->num_vertices) {
+        chain_length++;
         v = parent[v];
         if (v < 0) {
             /* Parent chain broken - this shouldn't happen with valid back edge */
-            free(temp_path);
             return ERROR_INVALID_ARGUMENT;
         }
     }
     
     if (v != ancestor) {
         /* Couldn't reach ancestor - invalid back edge */
-        free(temp_path);
         return ERROR_INVALID_ARGUMENT;
     }
     
-    /* Add ancestor at the end */
-    temp_path[path_idx++] = ancestor;
-    
     /* Path length: ancestor -> ... -> current -> ancestor */
-    int path_length = path_idx + 1; /* +1 to close cycle with ancestor again */
+    int path_length = chain_length + 2;
     
     /* Allocate cycle path array */
     cycle_info->cycle_path = (int*)safe_malloc(sizeof(int) * path_length);
     if (cycle_info->cycle_path == NULL) {
-        free(temp_path);
         return ERROR_OUT_OF_MEMORY;
     }
     
-    /* Build cycle: start from ancestor, follow path to current, then back to ancestor */
-    int pos = 0;
-    cycle_info->cycle_path[pos++] = ancestor; /* Start with ancestor */
-    
-    /* Reverse temp_path to get: ancestor -> ... -> current */
-    for (int i = path_idx - 2; i >= 0; i--) { /* Skip last (ancestor) in temp_path */
-        cycle_info->cycle_path[pos++] = temp_path[i];
+    /* Walk the chain again, filling positions chain_length..1 backwards */
+    cycle_info->cycle_path[0] = ancestor; /* Start with ancestor */
+    v = current;
+    for (int pos = chain_length; pos >= 1; pos--) {
+        cycle_info->cycle_path[pos] = v;
+        v = parent[v];
     }
-    
-    cycle_info->cycle_path[pos++] = ancestor; /* Close cycle */
+    cycle_info->cycle_path[path_length - 1] = ancestor; /* Close cycle */
     
     cycle_info->cycle_length = path_length;
     cycle_info->cycle_start_vertex = ancestor;
     cycle_info->cycle_end_vertex = ancestor; /* Cycle is closed */
     
-    free(temp_path);
-    
     /* Extract process and resource IDs (excluding duplicate closing vertex) */
     int num_processes = 0;
     int num_resources = 0;
@@ -353,92 +571,121 @@ int extract_cycle_path(const int* parent, int ancestor, int current,
 }
 
 /*
- * dfs_visit - Recursive DFS visit for cycle detection
+ * dfs_visit_all - Iterative DFS visit collecting every back-edge cycle
  * @graph: ResourceGraph being traversed
- * @vertex: Current vertex being visited
- * @color: Color array for DFS marking
- * @parent: Parent array for path reconstruction
+ * @root: Vertex to start from (must be unstamped in the current epoch)
  * @cycle_list: Output list for detected cycles
  * @num_cycles: Pointer to cycle count
  * @capacity: Pointer to cycle list capacity
  * @return: SUCCESS (0) on success, negative on error
- * Description: Recursive DFS function that marks vertices and detects back edges.
- *              When a back edge (edge to GRAY vertex) is found, a cycle is detected.
- *              Time complexity: O(1) per call, O(V+E) total
- * Error handling: Returns error codes for invalid parameters
+ * Description: Marks vertices and detects back edges using the shared frame
+ *              stack instead of recursion, and the epoch-stamped marks in
+ *              place of graph->color/graph->parent. Edges are visited in the
+ *              same order as a recursive DFS, so the same cycles are
+ *              reported in the same order.
+ *              Time complexity: O(V+E) total
+ * Error handling: Returns error codes for invalid parameters and allocation
+ *                 failure of the frame stack
  */
-static int dfs_visit_recursive(ResourceGraph* graph, int vertex, int* color, 
-                               int* parent, CycleInfo** cycle_list,
-                               int* num_cycles, int* capacity)
+static int dfs_visit_all(ResourceGraph* graph, int root, CycleInfo** cycle_list,
+                         int* num_cycles, int* capacity)
 {
-    if (graph == NULL || color == NULL || parent == NULL) {
+    if (graph == NULL) {
         return ERROR_INVALID_ARGUMENT;
     }
     
-    if (vertex < 0 || vertex >= graph->num_vertices) {
+    if (root < 0 || root >= graph->num_vertices) {
         return ERROR_INVALID_ARGUMENT;
     }
     
-    /* Mark vertex as GRAY (in recursion stack) */
-    color[vertex] = COLOR_GRAY;
+    if (dfs_stack_reserve(graph->num_vertices) != SUCCESS) {
+        return ERROR_OUT_OF_MEMORY;
+    }
     
-    /* Visit all neighbors */
-    GraphNode* current = graph->adjacency_list[vertex];
-    while (current != NULL) {
-        int neighbor = current->vertex_id;
+    int* frame_vertex = s_dfs_stack.vertex;
+    int* frame_edge = s_dfs_stack.edge;
+    const int* offsets = graph->csr_offsets;
+    const int* targets = graph->csr_targets;
+    unsigned int* stamp = s_dfs_marks.stamp;
+    unsigned char* on_stack = s_dfs_marks.on_stack;
+    int* parent = s_dfs_marks.parent;
+    unsigned int epoch = s_dfs_marks.epoch;
+    int depth = 0;
+    
+    /* Discover root: GRAY (on the DFS stack), no parent */
+    stamp[root] = epoch;
+    on_stack[root] = 1;
+    parent[root] = -1;
+    frame_vertex[depth] = root;
+    frame_edge[depth] = offsets[root];
+    depth++;
+    
+    while (depth > 0) {
+        int vertex = frame_vertex[depth - 1];
+        int current = frame_edge[depth - 1];
+        
+        if (current == offsets[vertex + 1]) {
+            /* All neighbors done: mark BLACK (finished) and return to caller frame */
+            on_stack[vertex] = 0;
+            depth--;
+            continue;
+        }
+        
+        frame_edge[depth - 1] = current + 1;
+        int neighbor = targets[current];
         
         if (neighbor < 0 || neighbor >= graph->num_vertices) {
-            current = current->next;
             continue;
         }
         
-        if (color[neighbor] == COLOR_WHITE) {
-            /* Unvisited vertex - recurse */
+        if (stamp[neighbor] != epoch) {
+            /* Unvisited vertex - descend */
+            stamp[neighbor] = epoch;
+            on_stack[neighbor] = 1;
             parent[neighbor] = vertex;
-            int result = dfs_visit_recursive(graph, neighbor, color, parent,
-                                            cycle_list, num_cycles, capacity);
-            if (result != SUCCESS) {
-                return result;
-            }
-        } else if (color[neighbor] == COLOR_GRAY) {
+            frame_vertex[depth] = neighbor;
+            frame_edge[depth] = offsets[neighbor];
+            depth++;
+        } else if (on_stack[neighbor]) {
             /* Back edge detected - cycle found! */
-            /* neighbor is GRAY (ancestor), vertex is current */
             /* Cycle: neighbor -> ... -> vertex -> neighbor */
             CycleInfo cycle;
             memset(&cycle, 0, sizeof(CycleInfo));
             
             int result = extract_cycle_path(parent, neighbor, vertex, graph, &cycle);
             if (result == SUCCESS) {
-                /* Add cycle to list */
                 add_cycle_to_list(cycle_list, num_cycles, capacity, &cycle);
-                
-                /* Free temporary cycle structure */
                 free_cycle_info(&cycle);
             }
         }
-        /* If BLACK, skip (already processed) */
-        
-        current = current->next;
+        /* If finished (BLACK), skip */
     }
     
-    /* Mark vertex as BLACK (finished) */
-    color[vertex] = COLOR_BLACK;
-    
     return SUCCESS;
 }
 
 /*
- * dfs_visit_single - Internal recursive DFS for single cycle detection
+ * dfs_visit_single - Iterative DFS that stops at the first cycle
+ * @graph: ResourceGraph being traversed
+ * @root: Vertex to start from
+ * @color: Color array for DFS marking
+ * @parent: Parent array for path reconstruction
+ * @cycle_info: Output structure for the first cycle found
+ * @found: Set to 1 when a cycle is found
+ * @return: SUCCESS (0) on success, negative on error
+ * Description: Same traversal as dfs_visit_all(). When a cycle is found, the
+ *              vertex that closed it stays GRAY and its ancestors are marked
+ *              BLACK, as the unwinding of the recursive version did.
  */
-static int dfs_visit_single(ResourceGraph* graph, int vertex, int* color, 
-                           int* parent, CycleInfo* cycle_info, int* found)
+static int dfs_visit_single(ResourceGraph* graph, int root, int* color, 
+                            int* parent, CycleInfo* cycle_info, int* found)
 {
     if (graph == NULL || color == NULL || parent == NULL || 
         cycle_info == NULL || found == NULL) {
         return ERROR_INVALID_ARGUMENT;
     }
     
-    if (vertex < 0 || vertex >= graph->num_vertices) {
+    if (root < 0 || root >= graph->num_vertices) {
         return ERROR_INVALID_ARGUMENT;
     }
     
@@ -446,44 +693,62 @@ static int dfs_visit_single(ResourceGraph* graph, int vertex, int* color,
         return SUCCESS; /* Already found a cycle */
     }
     
-    /* Mark vertex as GRAY (in recursion stack) */
-    color[vertex] = COLOR_GRAY;
+    if (dfs_stack_reserve(graph->num_vertices) != SUCCESS) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    
+    int* frame_vertex = s_dfs_stack.vertex;
+    int* frame_edge = s_dfs_stack.edge;
+    const int* offsets = graph->csr_offsets;
+    const int* targets = graph->csr_targets;
+    int depth = 0;
+    
+    color[root] = COLOR_GRAY;
+    frame_vertex[depth] = root;
+    frame_edge[depth] = offsets[root];
+    depth++;
     
-    /* Visit all neighbors */
-    GraphNode* current = graph->adjacency_list[vertex];
-    while (current != NULL && !(*found)) {
-        int neighbor = current->vertex_id;
+    while (depth > 0) {
+        int vertex = frame_vertex[depth - 1];
+        int current = frame_edge[depth - 1];
         
-        if (neighbor >= 0 && neighbor < graph->num_vertices) {
-            if (color[neighbor] == COLOR_WHITE) {
-                /* Unvisited vertex - recurse */
-                parent[neighbor] = vertex;
-                int result = dfs_visit_single(graph, neighbor, color, parent,
-                                              cycle_info, found);
-                if (result != SUCCESS) {
-                    return result;
-                }
-            } else if (color[neighbor] == COLOR_GRAY) {
-                /* Back edge detected - cycle found! */
-                /* neighbor is GRAY (ancestor), vertex is current */
-                int result = extract_cycle_path(parent, neighbor, vertex, graph, cycle_info);
-                if (result == SUCCESS) {
-                    *found = 1;
-                    return SUCCESS;
+        if (current == offsets[vertex + 1]) {
+            color[vertex] = COLOR_BLACK;
+            depth--;
+            continue;
+        }
+        
+        frame_edge[depth - 1] = current + 1;
+        int neighbor = targets[current];
+        
+        if (neighbor < 0 || neighbor >= graph->num_vertices) {
+            continue;
+        }
+        
+        if (color[neighbor] == COLOR_WHITE) {
+            parent[neighbor] = vertex;
+            color[neighbor] = COLOR_GRAY;
+            frame_vertex[depth] = neighbor;
+            frame_edge[depth] = offsets[neighbor];
+            depth++;
+        } else if (color[neighbor] == COLOR_GRAY) {
+            /* Back edge detected - cycle found! */
+            if (extract_cycle_path(parent, neighbor, vertex, graph, cycle_info) == SUCCESS) {
+                *found = 1;
+                /* Ancestors of the closing vertex finish as BLACK */
+                for (int i = 0; i < depth - 1; i++) {
+                    color[frame_vertex[i]] = COLOR_BLACK;
                 }
+                return SUCCESS;
             }
         }
-        current = current->next;
     }
     
-    /* Mark vertex as BLACK (finished) */
-    color[vertex] = COLOR_BLACK;
-    
     return SUCCESS;
 }
 
 /*
- * dfs_visit - Recursive DFS visit for cycle detection (wrapper)
+ * dfs_visit - DFS visit for cycle detection (wrapper)
  * @graph: ResourceGraph being traversed
  * @vertex: Current vertex being visited
  * @color: Color array for DFS marking
@@ -509,6 +774,11 @@ int dfs_visit(ResourceGraph* graph, int vertex, int* color, int* parent,
         return ERROR_INVALID_ARGUMENT;
     }
     
+    int result = freeze_graph(graph);
+    if (result != SUCCESS) {
+        return result;
+    }
+    
     return dfs_visit_single(graph, vertex, color, parent, cycle_info, found);
 }
 
@@ -519,7 +789,9 @@ int dfs_visit(ResourceGraph* graph, int vertex, int* color, int* parent,
  * @num_cycles: Output parameter for number of cycles found
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Finds ALL cycles in graph, not just the first one.
- *              Each cycle is stored as a CycleInfo structure.
+ *              Each cycle is stored as a CycleInfo structure. Vertex state
+ *              lives in epoch-stamped arrays kept across calls, so neither
+ *              graph->color nor graph->parent is read or reset.
  *              Time complexity: O(V + E)
  *              Space complexity: O(V + C) where C is number of cycles
  * Error handling: Returns error codes for allocation failures
@@ -533,8 +805,16 @@ int find_all_cycles(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycle
     *cycle_list = NULL;
     *num_cycles = 0;
     
-    /* Reset graph colors */
-    reset_graph_colors(graph);
+    /* Traversal runs on the CSR layout */
+    int frozen = freeze_graph(graph);
+    if (frozen != SUCCESS) {
+        return frozen;
+    }
+    
+    /* New epoch: every vertex becomes WHITE in O(1) */
+    if (dfs_marks_begin(graph->num_vertices) != SUCCESS) {
+        return ERROR_OUT_OF_MEMORY;
+    }
     
     /* Initialize cycle list */
     int capacity = 0;
@@ -542,14 +822,8 @@ int find_all_cycles(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycle
     
     /* Perform DFS from each unvisited vertex */
     for (int i = 0; i < graph->num_vertices; i++) {
-        if (graph->color[i] == COLOR_WHITE) {
-            /* Reset parent array for this DFS tree */
-            for (int j = 0; j < graph->num_vertices; j++) {
-                graph->parent[j] = -1;
-            }
-            
-            int result = dfs_visit_recursive(graph, i, graph->color, graph->parent,
-                                            &cycles, num_cycles, &capacity);
+        if (s_dfs_marks.stamp[i] != s_dfs_marks.epoch) {
+            int result = dfs_visit_all(graph, i, &cycles, num_cycles, &capacity);
             if (result != SUCCESS) {
                 free_cycle_list(cycles, *num_cycles);
                 *cycle_list = NULL;
@@ -563,14 +837,41 @@ int find_all_cycles(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycle
     return SUCCESS;
 }
 
+/*
+ * set_cycle_engine - Select the engine used by has_cycle()
+ * @engine: CYCLE_ENGINE_DFS or CYCLE_ENGINE_SCC
+ * @return: SUCCESS (0) on success, ERROR_INVALID_ARGUMENT for unknown engine
+ * Description: Process-wide setting; call before detection starts.
+ * Error handling: Leaves the current engine unchanged on error
+ */
+int set_cycle_engine(int engine)
+{
+    if (engine != CYCLE_ENGINE_DFS && engine != CYCLE_ENGINE_SCC) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    s_cycle_engine = engine;
+    return SUCCESS;
+}
+
+/*
+ * get_cycle_engine - Get the engine used by has_cycle()
+ * @return: CYCLE_ENGINE_DFS or CYCLE_ENGINE_SCC
+ */
+int get_cycle_engine(void)
+{
+    return s_cycle_engine;
+}
+
 /*
  * has_cycle - Detect if graph contains any cycles
  * @graph: ResourceGraph to analyze
  * @cycle_list: Output parameter for array of detected cycles
  * @num_cycles: Output parameter for number of cycles found
  * @return: 1 if cycles exist, 0 if no cycles, negative on error
- * Description: Main entry point for cycle detection. Uses DFS to find all
- *              cycles in the graph. Returns array of CycleInfo structures.
+ * Description: Main entry point for cycle detection. Dispatches to the
+ *              engine selected with set_cycle_engine(). Returns array of
+ *              CycleInfo structures.
  *              Time complexity: O(V + E) where V=vertices, E=edges
  *              Space complexity: O(V)
  * Error handling: Returns negative error code on failure, sets num_cycles to 0
@@ -581,7 +882,12 @@ int has_cycle(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles)
         return ERROR_INVALID_ARGUMENT;
     }
     
-    int result = find_all_cycles(graph, cycle_list, num_cycles);
+    int result;
+    if (s_cycle_engine == CYCLE_ENGINE_SCC) {
+        result = find_cycle_components(graph, cycle_list, num_cycles);
+    } else {
+        result = find_all_cycles(graph, cycle_list, num_cycles);
+    }
     if (result != SUCCESS) {
         *cycle_list = NULL;
         *num_cycles = 0;
@@ -591,6 +897,179 @@ int has_cycle(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles)
     return (*num_cycles > 0) ? 1 : 0;
 }
 
+/*
+ * find_cycle_components - Find deadlocked vertex sets via SCC decomposition
+ * @graph: ResourceGraph to analyze
+ * @cycle_list: Output parameter for one CycleInfo per deadlocked component
+ * @num_cycles: Output parameter for number of components found
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Iterative Tarjan: the shared frame stack of (vertex, next
+ *              edge) replaces recursion. When a root's lowlink equals its
+ *              index, the vertices above it on the Tarjan stack form one
+ *              component. Components with more than one vertex or with a
+ *              self-loop are deadlocked; each gets one witness cycle for
+ *              reporting plus the full member list.
+ *              Time complexity: O(V + E)
+ *              Space complexity: O(V)
+ * Error handling: Returns error codes for invalid parameters and allocation
+ *                 failures; no partial list is returned
+ */
+int find_cycle_components(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles)
+{
+    if (graph == NULL || cycle_list == NULL || num_cycles == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    *cycle_list = NULL;
+    *num_cycles = 0;
+    
+    int n = graph->num_vertices;
+    if (n <= 0) {
+        return SUCCESS;
+    }
+    
+    int frozen = freeze_graph(graph);
+    if (frozen != SUCCESS) {
+        return frozen;
+    }
+    
+    if (dfs_stack_reserve(n) != SUCCESS) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    
+    /* index, lowlink, component, tarjan stack, BFS parent, BFS queue */
+    int* work = (int*)safe_malloc(sizeof(int) * (size_t)n * 6);
+    if (work == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    
+    int* index = work;
+    int* lowlink = work + n;
+    int* component = work + 2 * n;      /* -2 = on Tarjan stack, -1 = unvisited */
+    int* stack = work + 3 * n;
+    int* parent = work + 4 * n;
+    int* queue = work + 5 * n;
+    int* frame_vertex = s_dfs_stack.vertex;
+    int* frame_edge = s_dfs_stack.edge;
+    const int* offsets = graph->csr_offsets;
+    const int* targets = graph->csr_targets;
+    
+    for (int i = 0; i < n; i++) {
+        index[i] = -1;
+        component[i] = -1;
+        parent[i] = -1;
+    }
+    
+    CycleInfo* cycles = NULL;
+    int count = 0;
+    int capacity = 0;
+    int next_index = 0;
+    int num_components = 0;
+    int sp = 0;
+    int result = SUCCESS;
+    
+    for (int start = 0; start < n && result == SUCCESS; start++) {
+        if (index[start] != -1) {
+            continue;
+        }
+        
+        int depth = 0;
+        index[start] = lowlink[start] = next_index++;
+        component[start] = -2;
+        stack[sp++] = start;
+        frame_vertex[depth] = start;
+        frame_edge[depth] = offsets[start];
+        depth++;
+        
+        while (depth > 0 && result == SUCCESS) {
+            int v = frame_vertex[depth - 1];
+            int edge = frame_edge[depth - 1];
+            
+            if (edge < offsets[v + 1]) {
+                frame_edge[depth - 1] = edge + 1;
+                int w = targets[edge];
+                if (w < 0 || w >= n) {
+                    continue;
+                }
+                if (index[w] == -1) {
+                    /* Tree edge: descend */
+                    index[w] = lowlink[w] = next_index++;
+                    component[w] = -2;
+                    stack[sp++] = w;
+                    frame_vertex[depth] = w;
+                    frame_edge[depth] = offsets[w];
+                    depth++;
+                } else if (component[w] == -2 && index[w] < lowlink[v]) {
+                    lowlink[v] = index[w];
+                }
+                continue;
+            }
+            
+            /* All edges of v done: return to caller frame */
+            depth--;
+            if (depth > 0) {
+                int u = frame_vertex[depth - 1];
+                if (lowlink[v] < lowlink[u]) {
+                    lowlink[u] = lowlink[v];
+                }
+            }
+            
+            if (lowlink[v] != index[v]) {
+                continue;
+            }
+            
+            /* v is a component root: members are stack[base..sp-1], v first */
+            int base = sp;
+            do {
+                base--;
+                component[stack[base]] = num_components;
+            } while (stack[base] != v);
+            
+            int size = sp - base;
+            if (size > 1 || has_self_loop(graph, v)) {
+                if (count >= capacity) {
+                    int new_capacity = capacity == 0 ? 10 : capacity * 2;
+                    CycleInfo* new_list = (CycleInfo*)safe_realloc(
+                        cycles, sizeof(CycleInfo) * new_capacity);
+                    if (new_list == NULL) {
+                        result = ERROR_OUT_OF_MEMORY;
+                        break;
+                    }
+                    cycles = new_list;
+                    capacity = new_capacity;
+                }
+                
+                CycleInfo* cycle = &cycles[count];
+                memset(cycle, 0, sizeof(CycleInfo));
+                result = extract_component_cycle(graph, component, num_components, v,
+                                                 parent, queue, cycle);
+                if (result == SUCCESS) {
+                    result = set_component_members(graph, &stack[base], size, cycle);
+                }
+                if (result != SUCCESS) {
+                    free_cycle_info(cycle);
+                    break;
+                }
+                count++;
+            }
+            
+            sp = base;
+            num_components++;
+        }
+    }
+    
+    free(work);
+    
+    if (result != SUCCESS) {
+        free_cycle_list(cycles, count);
+        return result;
+    }
+    
+    *cycle_list = cycles;
+    *num_cycles = count;
+    return SUCCESS;
+}
+
 /*
  * print_cycle - Print cycle information in readable format
  * @cycle: CycleInfo structure to print
@@ -774,18 +1253,7 @@ int validate_cycle(const CycleInfo* cycle, const ResourceGraph* graph)
         int from = cycle->cycle_path[i];
         int to = cycle->cycle_path[i + 1];
         
-        /* Check if edge exists in adjacency list */
-        int edge_found = 0;
-        GraphNode* current = graph->adjacency_list[from];
-        while (current != NULL) {
-            if (current->vertex_id == to) {
-                edge_found = 1;
-                break;
-            }
-            current = current->next;
-        }
-        
-        if (!edge_found) {
+        if (!graph_has_edge(graph, from, to)) {
             return 0; /* Edge doesn't exist */
         }
     }
@@ -793,3 +1261,21 @@ int validate_cycle(const CycleInfo* cycle, const ResourceGraph* graph)
     return 1; /* Valid cycle */
 }
 
+/*
+ * free_cycle_workspace - Release the DFS workspace kept across scans
+ * @return: None
+ * Description: The stack is reallocated on the next traversal if needed.
+ * Error handling: Safe to call multiple times
+ */
+void free_cycle_workspace(void)
+{
+    safe_free((void**)&s_dfs_stack.vertex);
+    safe_free((void**)&s_dfs_stack.edge);
+    s_dfs_stack.capacity = 0;
+    
+    safe_free((void**)&s_dfs_marks.stamp);
+    safe_free((void**)&s_dfs_marks.on_stack);
+    safe_free((void**)&s_dfs_marks.parent);
+    s_dfs_marks.capacity = 0;
+    s_dfs_marks.epoch = 0;
+}
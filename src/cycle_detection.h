@@ -5,7 +5,9 @@
  * CYCLE_DETECTION.H - Cycle Detection Algorithm Interface
  * =============================================================================
  * This header defines structures and functions for detecting cycles in
- * Resource Allocation Graphs using Depth-First Search (DFS) algorithm.
+ * Resource Allocation Graphs. Two engines are available: a back-edge DFS that
+ * reports every distinct cycle it meets, and a strongly connected component
+ * (SCC) engine that reports each deadlocked vertex set once.
  * =============================================================================
  */
 
@@ -26,8 +28,8 @@ typedef struct {
     int cycle_length;               /* Number of vertices in cycle */
     int cycle_start_vertex;         /* Starting vertex index of cycle */
     int cycle_end_vertex;           /* Ending vertex index of cycle (back edge target) */
-    int* process_ids;                /* Array of PIDs in cycle (if applicable) */
-    int* resource_ids;              /* Array of RIDs in cycle (if applicable) */
+    int* process_ids;                /* Array of PIDs in cycle (SCC engine: whole component) */
+    int* resource_ids;              /* Array of RIDs in cycle (SCC engine: whole component) */
     int num_processes;              /* Number of processes in cycle */
     int num_resources;              /* Number of resources in cycle */
 } CycleInfo;
@@ -37,20 +39,55 @@ typedef struct {
  * =============================================================================
  */
 
+/*
+ * set_cycle_engine - Select the engine used by has_cycle()
+ * @engine: CYCLE_ENGINE_DFS or CYCLE_ENGINE_SCC
+ * @return: SUCCESS (0) on success, ERROR_INVALID_ARGUMENT for unknown engine
+ * Description: Process-wide setting; call before detection starts.
+ * Error handling: Leaves the current engine unchanged on error
+ */
+int set_cycle_engine(int engine);
+
+/*
+ * get_cycle_engine - Get the engine used by has_cycle()
+ * @return: CYCLE_ENGINE_DFS or CYCLE_ENGINE_SCC
+ */
+int get_cycle_engine(void);
+
 /*
  * has_cycle - Detect if graph contains any cycles
  * @graph: ResourceGraph to analyze
  * @cycle_list: Output parameter for array of detected cycles
  * @num_cycles: Output parameter for number of cycles found
  * @return: 1 if cycles exist, 0 if no cycles, negative on error
- * Description: Main entry point for cycle detection. Uses DFS to find all
- *              cycles in the graph. Returns array of CycleInfo structures.
+ * Description: Main entry point for cycle detection. Dispatches to
+ *              find_all_cycles() or find_cycle_components() depending on the
+ *              engine selected with set_cycle_engine().
  *              Time complexity: O(V + E) where V=vertices, E=edges
  *              Space complexity: O(V)
  * Error handling: Returns negative error code on failure, sets num_cycles to 0
  */
 int has_cycle(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles);
 
+/*
+ * find_cycle_components - Find deadlocked vertex sets via SCC decomposition
+ * @graph: ResourceGraph to analyze
+ * @cycle_list: Output parameter for one CycleInfo per deadlocked component
+ * @num_cycles: Output parameter for number of components found
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Runs an iterative Tarjan SCC pass. Every component with more
+ *              than one vertex, or a single vertex with a self-loop, is
+ *              reported. cycle_path holds one witness cycle through the
+ *              component root (shortest, found by BFS inside the component)
+ *              for display; process_ids/resource_ids list every member of
+ *              the component, which is exactly the deadlocked set.
+ *              Time complexity: O(V + E)
+ *              Space complexity: O(V)
+ * Error handling: Returns error codes for invalid parameters and allocation
+ *                 failures; no partial list is returned
+ */
+int find_cycle_components(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles);
+
 /*
  * find_all_cycles - Find all cycles in the graph
  * @graph: ResourceGraph to analyze
@@ -58,7 +95,8 @@ int has_cycle(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles);
  * @num_cycles: Output parameter for number of cycles found
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Finds ALL cycles in graph, not just the first one.
- *              Each cycle is stored as a CycleInfo structure.
+ *              Each cycle is stored as a CycleInfo structure. Uses its own
+ *              epoch-stamped visit state (no reset_graph_colors() needed).
  *              Time complexity: O(V + E)
  *              Space complexity: O(V + C) where C is number of cycles
  * Error handling: Returns error codes for allocation failures
@@ -66,7 +104,7 @@ int has_cycle(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles);
 int find_all_cycles(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycles);
 
 /*
- * dfs_visit - Recursive DFS visit for cycle detection
+ * dfs_visit - DFS visit for cycle detection
  * @graph: ResourceGraph being traversed
  * @vertex: Current vertex being visited
  * @color: Color array for DFS marking
@@ -74,10 +112,13 @@ int find_all_cycles(ResourceGraph* graph, CycleInfo** cycle_list, int* num_cycle
  * @cycle_info: Output structure for detected cycle (if found)
  * @found: Flag indicating if cycle was found
  * @return: SUCCESS (0) on success, negative on error
- * Description: Recursive DFS function that marks vertices and detects back edges.
- *              When a back edge (edge to GRAY vertex) is found, a cycle is detected.
- *              Time complexity: O(1) per call, O(V+E) total
- * Error handling: Returns error codes for invalid parameters
+ * Description: Marks vertices and detects back edges, stopping at the first
+ *              cycle. Uses an explicit heap frame stack (reused across
+ *              calls) rather than recursion, so depth is bounded only by
+ *              the number of vertices.
+ *              Time complexity: O(V+E) total
+ * Error handling: Returns error codes for invalid parameters and allocation
+ *                 failure
  */
 int dfs_visit(ResourceGraph* graph, int vertex, int* color, int* parent,
               CycleInfo* cycle_info, int* found);
@@ -107,7 +148,7 @@ int extract_cycle_path(const int* parent, int ancestor, int current,
  * @color: Current color array
  * @return: 1 if back edge, 0 otherwise
  * Description: Checks if edge from_vertex->to_vertex is a back edge.
- *              Back edge exists when to_vertex is GRAY (in recursion stack).
+ *              Back edge exists when to_vertex is GRAY (on the DFS stack).
  *              Time complexity: O(1)
  * Error handling: Returns 0 for invalid parameters
  */
@@ -172,5 +213,15 @@ void free_cycle_list(CycleInfo* cycle_list, int num_cycles);
  */
 int validate_cycle(const CycleInfo* cycle, const ResourceGraph* graph);
 
+/*
+ * free_cycle_workspace - Release the DFS workspace kept across scans
+ * @return: None
+ * Description: Traversals keep their frame stack and epoch-stamped vertex
+ *              marks between calls so repeated scans neither reallocate nor
+ *              clear them. Call at shutdown.
+ * Error handling: Safe to call multiple times
+ */
+void free_cycle_workspace(void);
+
 #endif /* CYCLE_DETECTION_H */
 
@@ -0,0 +1,288 @@
+/* =============================================================================
+ * DEADLOCK_CONFIRM.C - Suspected Deadlock Confirmation Implementation
+ * =============================================================================
+ * Targeted re-reads of cycle members before a deadlock is reported.
+ * =============================================================================
+ */
+
+#include "deadlock_confirm.h"
+#include "deadlock_detection.h"
+#include "proc_handle.h"
+#include "fd_snapshot.h"
+#include "utility.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+static double confirm_clock_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+/*
+ * sleep_ms - Sleep for the full spacing, resuming after signal handlers
+ * @ms: Milliseconds to sleep
+ * @return: None
+ */
+static void sleep_ms(long ms)
+{
+    struct timespec remaining = { ms / 1000, (ms % 1000) * 1000000L };
+    while (nanosleep(&remaining, &remaining) != 0 && errno == EINTR) {
+        /* Continue with the time left */
+    }
+}
+
+/*
+ * same_wait_state - Compare a member's wait with the one the scan saw
+ * @scanned: Resource information from the scan
+ * @fresh: Resource information from the re-read
+ * @return: 1 if the process waits the same way, 0 otherwise
+ */
+static int same_wait_state(const ProcessResourceInfo* scanned, const ProcessResourceInfo* fresh)
+{
+    if (scanned->is_blocked_on_pipe != fresh->is_blocked_on_pipe ||
+        scanned->is_blocked_on_lock != fresh->is_blocked_on_lock ||
+        scanned->is_blocked_on_child != fresh->is_blocked_on_child) {
+        return 0;
+    }
+
+    /* A syscall the scan could not decode leaves nothing finer to compare */
+    if (scanned->wait.kind == WAIT_SYSCALL_UNKNOWN) {
+        return 1;
+    }
+    if (scanned->wait.kind != fresh->wait.kind) {
+        return 0;
+    }
+
+    switch (scanned->wait.kind) {
+        case WAIT_SYSCALL_READ:
+        case WAIT_SYSCALL_WRITE:
+        case WAIT_SYSCALL_FLOCK:
+        case WAIT_SYSCALL_FCNTL_LOCK:
+            return scanned->wait.fd == fresh->wait.fd;
+        case WAIT_SYSCALL_CHILD:
+            return scanned->wait.child == fresh->wait.child;
+        default:
+            return 1;
+    }
+}
+
+/*
+ * first_missing_member - Find a member the re-read cycles no longer contain
+ * @pids: Members
+ * @num_pids: Number of members
+ * @report: Report filled by find_deadlock_cycles()
+ * @return: First PID not reported as deadlocked, 0 if all are
+ */
+static int first_missing_member(const int* pids, int num_pids, const DeadlockReport* report)
+{
+    for (int k = 0; k < num_pids; k++) {
+        int found = 0;
+        for (int d = 0; d < report->num_deadlocked && !found; d++) {
+            found = report->deadlocked_pids[d] == pids[k];
+        }
+        if (!found) {
+            return pids[k];
+        }
+    }
+    return 0;
+}
+
+/*
+ * reread_members - Re-read every member and check it still waits the same way
+ * @handles: Open handle per member
+ * @scanned: Scan's resource information per member
+ * @num_pids: Number of members
+ * @snapshot: FD snapshot prepared with num_pids tables
+ * @fresh: Output array of num_pids entries
+ * @num_fresh: Output parameter for entries that must be freed
+ * @result: Receives the changed member and reason
+ * @return: 1 if every member is unchanged, 0 otherwise
+ */
+static int reread_members(ProcHandle* handles, const ProcessResourceInfo** scanned,
+                          int num_pids, FdSnapshot* snapshot,
+                          ProcessResourceInfo* fresh, int* num_fresh,
+                          ConfirmResult* result)
+{
+    for (int k = 0; k < num_pids; k++) {
+        char state = 0;
+        unsigned long long start_time = 0;
+
+        if (proc_handle_read_stat(&handles[k], &state, &start_time) != SUCCESS ||
+            start_time != handles[k].start_time) {
+            result->changed_pid = (int)handles[k].pid;
+            result->reason = "process exited";
+            return 0;
+        }
+        if (state != 'S' && state != 'D') {
+            result->changed_pid = (int)handles[k].pid;
+            result->reason = "process is running";
+            return 0;
+        }
+
+        int read_result = get_process_resources_at(&handles[k], &snapshot->tables[k],
+                                                   NULL, &fresh[k]);
+        *num_fresh = k + 1;
+        if (read_result != SUCCESS) {
+            result->changed_pid = (int)handles[k].pid;
+            result->reason = "process could not be read";
+            return 0;
+        }
+        if (!same_wait_state(scanned[k], &fresh[k])) {
+            result->changed_pid = (int)handles[k].pid;
+            result->reason = "wait state changed";
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * confirm_deadlock - Re-verify the members of a suspected deadlock
+ * @pids: Deadlocked PIDs reported by the scan
+ * @num_pids: Number of PIDs
+ * @procs: Resource information the scan collected (must contain every PID)
+ * @num_procs: Number of entries in procs
+ * @rounds: Number of re-reads
+ * @spacing_ms: Sleep before each re-read
+ * @result: Output parameter describing the run (may be NULL)
+ * @return: 1 if every re-read found the cycle, 0 if it dissolved, negative
+ *          error code on failure
+ */
+int confirm_deadlock(const int* pids, int num_pids,
+                     const ProcessResourceInfo* procs, int num_procs,
+                     int rounds, long spacing_ms, ConfirmResult* result)
+{
+    ConfirmResult local;
+    if (result == NULL) {
+        result = &local;
+    }
+    memset(result, 0, sizeof(*result));
+
+    if (pids == NULL || num_pids <= 0 || procs == NULL || num_procs <= 0 ||
+        rounds <= 0 || spacing_ms < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    double started_ms = confirm_clock_ms();
+    const ProcessResourceInfo** scanned =
+        (const ProcessResourceInfo**)safe_malloc(sizeof(*scanned) * num_pids);
+    ProcHandle* handles = (ProcHandle*)safe_malloc(sizeof(ProcHandle) * num_pids);
+    ProcessResourceInfo* fresh =
+        (ProcessResourceInfo*)safe_malloc(sizeof(ProcessResourceInfo) * num_pids);
+    FdSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    int status = 1;
+
+    if (scanned == NULL || handles == NULL || fresh == NULL) {
+        status = ERROR_OUT_OF_MEMORY;
+        goto cleanup;
+    }
+
+    memset(handles, 0, sizeof(ProcHandle) * num_pids);
+    for (int k = 0; k < num_pids; k++) {
+        handles[k].pid = (pid_t)pids[k];
+        handles[k].dir_fd = -1;
+        handles[k].fd_dir_fd = -1;
+    }
+
+    for (int k = 0; k < num_pids; k++) {
+        scanned[k] = NULL;
+        for (int j = 0; j < num_procs; j++) {
+            if (procs[j].pid == pids[k]) {
+                scanned[k] = &procs[j];
+                break;
+            }
+        }
+        if (scanned[k] == NULL) {
+            status = ERROR_INVALID_ARGUMENT;
+            goto cleanup;
+        }
+    }
+
+    /* The handles pin each member's identity for the whole run; a start time
+       other than the scan's means the PID was reused in between */
+    for (int k = 0; k < num_pids; k++) {
+        if (proc_handle_acquire(&handles[k]) != SUCCESS ||
+            (scanned[k]->start_time != 0 &&
+             handles[k].start_time != scanned[k]->start_time)) {
+            result->changed_pid = pids[k];
+            result->reason = "process exited";
+            status = 0;
+            goto cleanup;
+        }
+    }
+
+    while (result->rounds < rounds) {
+        if (spacing_ms > 0) {
+            sleep_ms(spacing_ms);
+        }
+
+        int prepare_result = fd_snapshot_prepare(&snapshot, num_pids);
+        if (prepare_result != SUCCESS) {
+            status = prepare_result;
+            break;
+        }
+
+        int num_fresh = 0;
+        status = reread_members(handles, scanned, num_pids, &snapshot,
+                                fresh, &num_fresh, result);
+
+        /* Wait edges among the members alone must close the cycle again */
+        if (status == 1) {
+            analyze_pipe_and_lock_dependencies(fresh, num_pids);
+            DeadlockReport* report = create_deadlock_report();
+            if (report == NULL) {
+                status = ERROR_OUT_OF_MEMORY;
+            } else {
+                /* Cycle search only: no explanations, and no alerts */
+                int found = find_deadlock_cycles(fresh, num_pids, report, NULL);
+                int missing = found == SUCCESS ? first_missing_member(pids, num_pids, report) : 0;
+                if (found != SUCCESS) {
+                    status = found;
+                } else if (missing != 0) {
+                    result->reason = "wait cycle dissolved";
+                    result->changed_pid = missing;
+                    status = 0;
+                }
+                free_deadlock_report(report);
+                free(report);
+            }
+        }
+
+        for (int k = 0; k < num_fresh; k++) {
+            free_process_resource_info(&fresh[k]);
+        }
+        if (status != 1) {
+            break;
+        }
+        result->rounds++;
+    }
+
+cleanup:
+    if (handles != NULL) {
+        for (int k = 0; k < num_pids; k++) {
+            proc_handle_close(&handles[k]);
+        }
+    }
+    free_fd_snapshot(&snapshot);
+    safe_free((void**)&scanned);
+    safe_free((void**)&handles);
+    safe_free((void**)&fresh);
+    result->elapsed_ms = confirm_clock_ms() - started_ms;
+    return status;
+}
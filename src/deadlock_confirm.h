@@ -0,0 +1,70 @@
+#ifndef DEADLOCK_CONFIRM_H
+#define DEADLOCK_CONFIRM_H
+
+/* =============================================================================
+ * DEADLOCK_CONFIRM.H - Suspected Deadlock Confirmation Interface
+ * =============================================================================
+ * This header defines the fast-path verifier for cycles found by a scan. A
+ * scan reads processes one after another, so a cycle can be assembled from
+ * waits that never existed at the same time. Instead of waiting a full
+ * interval and rescanning every PID, the verifier re-reads only the
+ * processes of the cycle a few times at a short spacing and reports the
+ * deadlock only if the cycle is still there every time.
+ * =============================================================================
+ */
+
+#include "config.h"
+#include "process_monitor.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * ConfirmResult - Outcome of a confirmation run
+ */
+typedef struct {
+    int rounds;                     /* Re-reads that found the cycle intact */
+    int changed_pid;                /* Member whose change broke the cycle (0 = none or unknown) */
+    const char* reason;             /* Static description of the change (NULL if confirmed) */
+    double elapsed_ms;              /* Time spent confirming, sleeps included */
+} ConfirmResult;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * confirm_deadlock - Re-verify the members of a suspected deadlock
+ * @pids: Deadlocked PIDs reported by the scan
+ * @num_pids: Number of PIDs
+ * @procs: Resource information the scan collected (must contain every PID)
+ * @num_procs: Number of entries in procs
+ * @rounds: Number of re-reads
+ * @spacing_ms: Sleep before each re-read
+ * @result: Output parameter describing the run (may be NULL)
+ * @return: 1 if every re-read found the cycle, 0 if it dissolved, negative
+ *          error code on failure
+ * Description: Holds a /proc/[PID] handle per member for the whole run and
+ *              checks that its start time is the one the scan recorded, so
+ *              a PID reused after the scan or during the run cannot stand
+ *              in for an exited member. Each re-read checks that every
+ *              member still has that start time and is asleep, re-reads its FDs, locks and blocking syscall
+ *              and compares the wait state with the scan's, then rebuilds
+ *              the pipe and lock wait edges among the members alone and
+ *              requires cycle detection to report all of them again. An
+ *              edge only survives if its holder still owns the pipe end or
+ *              lock. Stops at the first re-read that breaks the cycle.
+ *              Time complexity: O(rounds * (members' FDs + /proc/locks))
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for bad parameters or a PID
+ *                 missing from procs, ERROR_OUT_OF_MEMORY on allocation
+ *                 failure. A member that cannot be opened or read counts as
+ *                 a change, not an error
+ */
+int confirm_deadlock(const int* pids, int num_pids,
+                     const ProcessResourceInfo* procs, int num_procs,
+                     int rounds, long spacing_ms, ConfirmResult* result);
+
+#endif /* DEADLOCK_CONFIRM_H */
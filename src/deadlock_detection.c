@@ -10,7 +10,8 @@
 #include "process_monitor.h"
 #include "utility.h"
 #include "config.h"
-#include "email_alert.h"
+#include "pipe_index.h"
+#include "lock_index.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -48,38 +49,323 @@ static int is_pid_in_array(const int* pids, int count, int pid)
 }
 
 /*
- * add_pid_to_array - Add PID to array if not already present
- * @pids: Pointer to array of PIDs
+ * append_bounded_id - Append an ID to a fixed-capacity per-process array
+ * @arena: Arena of the owning process (NULL = heap)
+ * @ids: Pointer to array (allocated with @limit entries on first use)
  * @count: Pointer to current count
- * @capacity: Pointer to current capacity
- * @pid: PID to add
+ * @limit: Capacity of the array
+ * @id: ID to append
+ * @return: SUCCESS (0) on success, ERROR_BUFFER_OVERFLOW if full,
+ *          ERROR_OUT_OF_MEMORY on allocation failure
+ */
+static int append_bounded_id(Arena* arena, int** ids, int* count, int limit, int id)
+{
+    if (*ids == NULL) {
+        *ids = (int*)arena_alloc(arena, sizeof(int) * limit);
+        if (*ids == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        *count = 0;
+    }
+    
+    if (*count >= limit) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+    
+    (*ids)[(*count)++] = id;
+    return SUCCESS;
+}
+
+/*
+ * waited_pipe_inode - Find the pipe a decoded read or write waits on
+ * @proc: Process blocked on a pipe
+ * @inode: Output parameter for the pipe inode
+ * @return: 1 if the wait is narrowed to *inode, 0 if every pipe counts
+ *          (wait syscall unknown, wchan heuristics only)
+ */
+static int waited_pipe_inode(const ProcessResourceInfo* proc, unsigned long* inode)
+{
+    if (proc->wait.kind != WAIT_SYSCALL_READ && proc->wait.kind != WAIT_SYSCALL_WRITE) {
+        return 0;
+    }
+    
+    for (int k = 0; k < proc->num_pipe_inodes; k++) {
+        if (proc->pipe_fds[k] == proc->wait.fd) {
+            *inode = proc->pipe_inodes[k];
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * wanted_pipe_ends - Pick the pipe ends a blocked process waits for
+ * @proc: Process blocked on a pipe
+ * @exact_wait: 1 if its read or write syscall was decoded
+ * @own: PIPE_END_* bits of the ends it has open on the pipe
+ * @return: PIPE_END_* bits of the ends whose holders can unblock it
+ * Description: A reader waits for writers and a writer for readers. Without
+ *              a decoded syscall the ends opposite its own are taken.
+ */
+static int wanted_pipe_ends(const ProcessResourceInfo* proc, int exact_wait, int own)
+{
+    if (exact_wait) {
+        return proc->wait.kind == WAIT_SYSCALL_READ ? PIPE_END_WRITE : PIPE_END_READ;
+    }
+    
+    int wanted = 0;
+    if (own & PIPE_END_READ) {
+        wanted |= PIPE_END_WRITE;
+    }
+    if (own & PIPE_END_WRITE) {
+        wanted |= PIPE_END_READ;
+    }
+    return wanted;
+}
+
+/*
+ * analyze_pipe_dependencies - Derive pipe hold/wait relations from an inode index
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
  * @return: SUCCESS (0) on success, negative on error
+ * Description: Builds a PipeIndex once, then for each process visits each of
+ *              its pipe inodes once. Every process sharing a pipe with another
+ *              process holds the pipe resource; a process blocked on a pipe
+ *              also waits for it and for every peer process on that inode.
+ *              When its read or write syscall was decoded, only the pipe
+ *              behind that FD is waited on.
+ *              When every endpoint's end is known, the read and write ends
+ *              are separate resources: a reader waits only for write-end
+ *              holders and a writer only for read-end holders.
+ *              Stamp arrays replace the linear duplicate scans: one gathers
+ *              the ends a process has open per inode slot, the other records
+ *              which process last recorded a given peer.
+ *              Time complexity: O(E + W) where E = pipe endpoints and
+ *              W = endpoints visited on behalf of blocked processes
  */
-static int add_pid_to_array(int** pids, int* count, int* capacity, int pid)
+static int analyze_pipe_dependencies(ProcessResourceInfo* procs, int num_procs)
 {
-    if (pids == NULL || count == NULL || capacity == NULL) {
-        return ERROR_INVALID_ARGUMENT;
+    PipeIndex index;
+    memset(&index, 0, sizeof(index));
+    
+    int result = pipe_index_build(&index, procs, num_procs);
+    if (result != SUCCESS || index.num_inodes == 0) {
+        free_pipe_index(&index);
+        return result;
     }
     
-    /* Check if already present */
-    if (is_pid_in_array(*pids, *count, pid)) {
-        return SUCCESS; /* Already in array */
+    int* slot_seen = (int*)safe_malloc(sizeof(int) * index.num_slots);
+    int* slot_ends = (int*)safe_malloc(sizeof(int) * index.num_slots);
+    int* peer_seen = (int*)safe_malloc(sizeof(int) * num_procs);
+    if (slot_seen == NULL || slot_ends == NULL || peer_seen == NULL) {
+        free(slot_seen);
+        free(slot_ends);
+        free(peer_seen);
+        free_pipe_index(&index);
+        return ERROR_OUT_OF_MEMORY;
     }
     
-    /* Expand array if needed */
-    if (*count >= *capacity) {
-        int new_capacity = *capacity == 0 ? 10 : *capacity * 2;
-        int* new_pids = (int*)safe_realloc(*pids, sizeof(int) * new_capacity);
-        if (new_pids == NULL) {
-            return ERROR_OUT_OF_MEMORY;
+    for (int s = 0; s < index.num_slots; s++) {
+        slot_seen[s] = -1;
+    }
+    for (int p = 0; p < num_procs; p++) {
+        peer_seen[p] = -1;
+    }
+    
+    for (int i = 0; i < num_procs; i++) {
+        ProcessResourceInfo* proc = &procs[i];
+        unsigned long wait_inode = 0;
+        int exact_wait = waited_pipe_inode(proc, &wait_inode);
+        
+        /* Gather the ends this process has open, per inode */
+        for (int k = 0; k < proc->num_pipe_inodes; k++) {
+            int pos = pipe_index_find(&index, proc->pipe_inodes[k]);
+            if (pos < 0) {
+                continue;
+            }
+            if (slot_seen[pos] != i) {
+                slot_seen[pos] = i;
+                slot_ends[pos] = 0;
+            }
+            int end = proc->pipe_ends != NULL ? proc->pipe_ends[k] : PIPE_END_UNKNOWN;
+            slot_ends[pos] |= end != PIPE_END_UNKNOWN ? end : PIPE_END_READ | PIPE_END_WRITE;
         }
-        *pids = new_pids;
-        *capacity = new_capacity;
+        
+        for (int k = 0; k < proc->num_pipe_inodes; k++) {
+            int pos = pipe_index_find(&index, proc->pipe_inodes[k]);
+            if (pos < 0 || slot_ends[pos] == 0) {
+                continue; /* Unknown, or already handled for this process */
+            }
+            int own = slot_ends[pos];
+            slot_ends[pos] = 0;
+            
+            const PipeIndexSlot* slot = &index.slots[pos];
+            if (slot->num_procs < 2) {
+                continue; /* Pipe not shared with another process */
+            }
+            
+            /* Use last 6 digits of the inode as resource ID; with every end
+             * known the write end is a separate resource */
+            int split = slot->num_unknown_ends == 0;
+            int read_id = (int)(slot->inode % 1000000);
+            int write_id = split ? PIPE_WRITE_END_RESOURCE_BASE + read_id : read_id;
+            if (!split) {
+                own = PIPE_END_READ | PIPE_END_WRITE;
+            }
+            
+            int wanted = 0;
+            if (proc->is_blocked_on_pipe && (!exact_wait || slot->inode == wait_inode)) {
+                wanted = split ? wanted_pipe_ends(proc, exact_wait, own)
+                               : PIPE_END_READ | PIPE_END_WRITE;
+            }
+            
+            /* Sharing a pipe with a peer means holding the ends one has
+             * open; an exact waiter does not hold what it waits on, or it
+             * would close a cycle with itself */
+            int held = exact_wait ? own & ~wanted : own;
+            if (held & PIPE_END_READ) {
+                append_bounded_id(proc->arena, &proc->held_resources, &proc->num_held,
+                                  MAX_RESOURCES_PER_PROCESS, read_id);
+            }
+            if ((held & PIPE_END_WRITE) && write_id != read_id) {
+                append_bounded_id(proc->arena, &proc->held_resources, &proc->num_held,
+                                  MAX_RESOURCES_PER_PROCESS, write_id);
+            }
+            
+            if (wanted == 0) {
+                continue;
+            }
+            
+            /* Blocked on a pipe: wait for the wanted ends and their holders */
+            if (wanted & PIPE_END_READ) {
+                append_bounded_id(proc->arena, &proc->waiting_resources, &proc->num_waiting,
+                                  MAX_RESOURCES_PER_PROCESS, read_id);
+            }
+            if ((wanted & PIPE_END_WRITE) && write_id != read_id) {
+                append_bounded_id(proc->arena, &proc->waiting_resources, &proc->num_waiting,
+                                  MAX_RESOURCES_PER_PROCESS, write_id);
+            }
+            
+            for (int e = 0; e < slot->count; e++) {
+                const PipeEndpoint* endpoint = &index.endpoints[slot->first + e];
+                if (endpoint->proc_index == i || peer_seen[endpoint->proc_index] == i ||
+                    (split && !(endpoint->end & wanted))) {
+                    continue;
+                }
+                peer_seen[endpoint->proc_index] = i;
+                append_bounded_id(proc->arena, &proc->waiting_on_pids, &proc->num_waiting_on_pids,
+                                  MAX_WAITING_PIDS, endpoint->pid);
+            }
+        }
+    }
+    
+    free(slot_seen);
+    free(slot_ends);
+    free(peer_seen);
+    free_pipe_index(&index);
+    return SUCCESS;
+}
+
+/*
+ * compare_pid_index - qsort comparator for (pid, index) pairs by PID
+ */
+static int compare_pid_index(const void* a, const void* b)
+{
+    int pid_a = ((const int*)a)[0];
+    int pid_b = ((const int*)b)[0];
+    return (pid_a > pid_b) - (pid_a < pid_b);
+}
+
+/*
+ * sort_procs_by_pid - Build PID-sorted (pid, index) pairs of a process array
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @return: Array of 2 * num_procs ints (caller frees), or NULL on failure
+ */
+static int* sort_procs_by_pid(const ProcessResourceInfo* procs, int num_procs)
+{
+    int* by_pid = (int*)safe_malloc(sizeof(int) * 2 * num_procs);
+    if (by_pid == NULL) {
+        return NULL;
+    }
+    for (int i = 0; i < num_procs; i++) {
+        by_pid[2 * i] = procs[i].pid;
+        by_pid[2 * i + 1] = i;
+    }
+    qsort(by_pid, num_procs, sizeof(int) * 2, compare_pid_index);
+    return by_pid;
+}
+
+/*
+ * find_proc_by_pid - Look up a process in PID-sorted pairs
+ * @by_pid: Pairs from sort_procs_by_pid()
+ * @num_procs: Number of processes
+ * @pid: Process ID to find
+ * @return: Index into the process array, or -1 if not collected
+ */
+static int find_proc_by_pid(const int* by_pid, int num_procs, int pid)
+{
+    int key[2] = {pid, 0};
+    const int* found = (const int*)bsearch(key, by_pid, num_procs, sizeof(int) * 2,
+                                           compare_pid_index);
+    return found != NULL ? found[1] : -1;
+}
+
+/*
+ * analyze_child_dependencies - Derive wait edges of processes blocked in wait4()
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @return: SUCCESS (0) on success, negative on error
+ * Description: A child holds the resource "child exits"
+ *              (CHILD_EXIT_RESOURCE_BASE + PID) and a parent blocked in a
+ *              child wait waits for it. Only children that were collected
+ *              get an edge; a child that is not blocked will exit or run
+ *              and so cannot close a cycle. Children are looked up in a
+ *              PID-sorted copy of the process array.
+ *              Time complexity: O(P log P + C log P), C = child PIDs listed
+ */
+static int analyze_child_dependencies(ProcessResourceInfo* procs, int num_procs)
+{
+    int num_waiters = 0;
+    for (int i = 0; i < num_procs; i++) {
+        if (procs[i].is_blocked_on_child && procs[i].num_child_pids > 0) {
+            num_waiters++;
+        }
+    }
+    if (num_waiters == 0) {
+        return SUCCESS;
+    }
+    
+    int* by_pid = sort_procs_by_pid(procs, num_procs);
+    if (by_pid == NULL) {
+        return ERROR_OUT_OF_MEMORY;
     }
     
-    (*pids)[*count] = pid;
-    (*count)++;
+    for (int i = 0; i < num_procs; i++) {
+        ProcessResourceInfo* proc = &procs[i];
+        if (!proc->is_blocked_on_child) {
+            continue;
+        }
+        
+        for (int c = 0; c < proc->num_child_pids; c++) {
+            int found = find_proc_by_pid(by_pid, num_procs, proc->child_pids[c]);
+            if (found < 0 || found == i) {
+                continue;
+            }
+            
+            ProcessResourceInfo* child = &procs[found];
+            int exit_resource_id = CHILD_EXIT_RESOURCE_BASE + child->pid;
+            
+            append_bounded_id(child->arena, &child->held_resources, &child->num_held,
+                              MAX_RESOURCES_PER_PROCESS, exit_resource_id);
+            append_bounded_id(proc->arena, &proc->waiting_resources, &proc->num_waiting,
+                              MAX_RESOURCES_PER_PROCESS, exit_resource_id);
+            append_bounded_id(proc->arena, &proc->waiting_on_pids, &proc->num_waiting_on_pids,
+                              MAX_WAITING_PIDS, child->pid);
+        }
+    }
     
+    free(by_pid);
     return SUCCESS;
 }
 
@@ -122,8 +408,8 @@ DeadlockReport* create_deadlock_report(void)
  * @graph: Output parameter for created RAG
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Constructs RAG by adding processes, resources, and edges
- *              based on ProcessResourceInfo data. Creates vertices and edges
- *              for allocations and requests.
+ *              based on ProcessResourceInfo data. Edges are queued into the
+ *              graph's key buffer and frozen into CSR form once at the end.
  *              Time complexity: O(P * R) where P=processes, R=resources per process
  * Error handling: Returns error codes for allocation failures or invalid data
  */
@@ -138,11 +424,14 @@ int build_rag_from_processes(ProcessResourceInfo* procs, int num_procs,
         return ERROR_INVALID_ARGUMENT;
     }
     
-    /* Estimate max vertices: processes + resources */
-    int max_vertices = num_procs * 2; /* Rough estimate */
-    if (max_vertices > MAX_VERTICES) {
-        max_vertices = MAX_VERTICES;
+    /* Bound the vertices: every process plus every distinct resource it
+     * holds or waits for. A pruned candidate set can have more resources
+     * than processes (pipes, locks and child exits per process). */
+    long vertex_bound = num_procs;
+    for (int i = 0; i < num_procs; i++) {
+        vertex_bound += procs[i].num_held + procs[i].num_waiting;
     }
+    int max_vertices = vertex_bound > MAX_VERTICES ? MAX_VERTICES : (int)vertex_bound;
     
     /* Create graph */
     *graph = create_graph(max_vertices);
@@ -179,8 +468,8 @@ int build_rag_from_processes(ProcessResourceInfo* procs, int num_procs,
             
             resource_count++;
             
-            /* Add allocation edge: R->P */
-            int result = add_allocation_edge(*graph, rid, pid);
+            /* Queue allocation edge: R->P */
+            int result = queue_allocation_edge(*graph, rid, pid);
             if (result != SUCCESS) {
                 free_graph(*graph);
                 *graph = NULL;
@@ -204,8 +493,8 @@ int build_rag_from_processes(ProcessResourceInfo* procs, int num_procs,
                 resource_count++;
             }
             
-            /* Add request edge: P->R */
-            int result = add_request_edge(*graph, pid, rid);
+            /* Queue request edge: P->R */
+            int result = queue_request_edge(*graph, pid, rid);
             if (result != SUCCESS) {
                 free_graph(*graph);
                 *graph = NULL;
@@ -214,11 +503,12 @@ int build_rag_from_processes(ProcessResourceInfo* procs, int num_procs,
         }
     }
     
-    /* Update statistics */
-    if (*graph != NULL) {
-        int num_processes, num_resources, num_edges;
-        get_graph_statistics(*graph, &num_processes, &num_resources, &num_edges);
-        /* Resource count already tracked above */
+    /* Sort, dedup and lay out queued edges as CSR */
+    int freeze_result = freeze_graph(*graph);
+    if (freeze_result != SUCCESS) {
+        free_graph(*graph);
+        *graph = NULL;
+        return freeze_result;
     }
     
     return SUCCESS;
@@ -264,28 +554,44 @@ int is_deadlock_definite(const CycleInfo* cycle, const ResourceGraph* graph)
 }
 
 /*
- * identify_deadlocked_processes - Extract process IDs from cycles
+ * collect_deadlocked_pids - Extract unique process IDs from cycles
+ * @arena: Arena for the PID array (NULL = heap, caller must free)
  * @cycles: Array of CycleInfo structures
  * @num_cycles: Number of cycles
  * @graph: ResourceGraph for vertex lookup
  * @pids: Output parameter for array of deadlocked PIDs
  * @count: Output parameter for number of unique PIDs
  * @return: SUCCESS (0) on success, negative on error
- * Description: Extracts all unique process IDs involved in deadlock cycles.
- *              Allocates array for PIDs. Caller must free result.
- *              Time complexity: O(C * L) where C=cycles, L=avg cycle length
- * Error handling: Returns error codes for allocation failures
+ * Description: The array is sized once from the total number of process
+ *              entries in all cycles, so it never has to grow.
  */
-int identify_deadlocked_processes(const CycleInfo* cycles, int num_cycles,
-                                  const ResourceGraph* graph, int** pids, int* count)
+static int collect_deadlocked_pids(Arena* arena, const CycleInfo* cycles, int num_cycles,
+                                   const ResourceGraph* graph, int** pids, int* count)
 {
-    if (cycles == NULL || graph == NULL || pids == NULL || count == NULL) {
-        return ERROR_INVALID_ARGUMENT;
-    }
-    
     *pids = NULL;
     *count = 0;
-    int capacity = 0;
+    
+    int bound = 0;
+    for (int i = 0; i < num_cycles; i++) {
+        if (cycles[i].cycle_path == NULL) {
+            continue;
+        }
+        if (cycles[i].cycle_length > 1) {
+            bound += cycles[i].cycle_length - 1;
+        }
+        if (cycles[i].process_ids != NULL && cycles[i].num_processes > 0) {
+            bound += cycles[i].num_processes;
+        }
+    }
+    
+    if (bound == 0) {
+        return SUCCESS;
+    }
+    
+    *pids = (int*)arena_alloc(arena, sizeof(int) * bound);
+    if (*pids == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
     
     /* Extract unique PIDs from all cycles */
     for (int i = 0; i < num_cycles; i++) {
@@ -297,16 +603,11 @@ int identify_deadlocked_processes(const CycleInfo* cycles, int num_cycles,
         for (int j = 0; j < cycles[i].cycle_length - 1; j++) { /* Exclude last */
             int vertex = cycles[i].cycle_path[j];
             
-            if (vertex >= 0 && vertex < graph->num_vertices) {
-                if (graph->vertex_type[vertex] == VERTEX_TYPE_PROCESS) {
-                    int pid = graph->vertex_id[vertex];
-                    int result = add_pid_to_array(pids, count, &capacity, pid);
-                    if (result != SUCCESS) {
-                        free(*pids);
-                        *pids = NULL;
-                        *count = 0;
-                        return result;
-                    }
+            if (vertex >= 0 && vertex < graph->num_vertices &&
+                graph->vertex_type[vertex] == VERTEX_TYPE_PROCESS) {
+                int pid = graph->vertex_id[vertex];
+                if (!is_pid_in_array(*pids, *count, pid)) {
+                    (*pids)[(*count)++] = pid;
                 }
             }
         }
@@ -315,12 +616,8 @@ int identify_deadlocked_processes(const CycleInfo* cycles, int num_cycles,
         if (cycles[i].process_ids != NULL) {
             for (int j = 0; j < cycles[i].num_processes; j++) {
                 int pid = cycles[i].process_ids[j];
-                int result = add_pid_to_array(pids, count, &capacity, pid);
-                if (result != SUCCESS) {
-                    free(*pids);
-                    *pids = NULL;
-                    *count = 0;
-                    return result;
+                if (!is_pid_in_array(*pids, *count, pid)) {
+                    (*pids)[(*count)++] = pid;
                 }
             }
         }
@@ -329,6 +626,157 @@ int identify_deadlocked_processes(const CycleInfo* cycles, int num_cycles,
     return SUCCESS;
 }
 
+/*
+ * copy_cycle - Deep copy a cycle's arrays into an arena or the heap
+ * @arena: Arena for the copies (NULL = heap)
+ * @dest: Destination cycle (overwritten)
+ * @src: Cycle to copy
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ *          (heap copies made so far are freed)
+ */
+static int copy_cycle(Arena* arena, CycleInfo* dest, const CycleInfo* src)
+{
+    memset(dest, 0, sizeof(CycleInfo));
+    
+    /* Copy cycle data */
+    dest->cycle_length = src->cycle_length;
+    dest->cycle_start_vertex = src->cycle_start_vertex;
+    dest->cycle_end_vertex = src->cycle_end_vertex;
+    dest->num_processes = src->num_processes;
+    dest->num_resources = src->num_resources;
+    
+    /* Deep copy cycle_path */
+    if (src->cycle_path != NULL && src->cycle_length > 0) {
+        dest->cycle_path = (int*)arena_alloc(arena, sizeof(int) * src->cycle_length);
+        if (dest->cycle_path == NULL) {
+            goto fail;
+        }
+        memcpy(dest->cycle_path, src->cycle_path, sizeof(int) * src->cycle_length);
+    }
+    
+    /* Deep copy process_ids */
+    if (src->process_ids != NULL && src->num_processes > 0) {
+        dest->process_ids = (int*)arena_alloc(arena, sizeof(int) * src->num_processes);
+        if (dest->process_ids == NULL) {
+            goto fail;
+        }
+        memcpy(dest->process_ids, src->process_ids, sizeof(int) * src->num_processes);
+    }
+    
+    /* Deep copy resource_ids */
+    if (src->resource_ids != NULL && src->num_resources > 0) {
+        dest->resource_ids = (int*)arena_alloc(arena, sizeof(int) * src->num_resources);
+        if (dest->resource_ids == NULL) {
+            goto fail;
+        }
+        memcpy(dest->resource_ids, src->resource_ids, sizeof(int) * src->num_resources);
+    }
+    
+    return SUCCESS;
+    
+fail:
+    if (arena == NULL) {
+        free_cycle_info(dest);
+    }
+    return ERROR_OUT_OF_MEMORY;
+}
+
+/*
+ * filter_cycles - Split cycles into definite and potential deadlocks
+ * @arena: Arena for the lists and copies (NULL = heap)
+ * Other parameters and return value as for filter_actual_deadlocks().
+ * Description: Both lists are sized for num_cycles up front, so categorizing
+ *              is one allocation per list plus the per-cycle copies.
+ */
+static int filter_cycles(Arena* arena, const CycleInfo* cycles, int num_cycles,
+                         const ResourceGraph* graph,
+                         CycleInfo** definite_deadlocks, int* num_definite,
+                         CycleInfo** potential_deadlocks, int* num_potential)
+{
+    *definite_deadlocks = NULL;
+    *potential_deadlocks = NULL;
+    *num_definite = 0;
+    *num_potential = 0;
+    
+    if (num_cycles <= 0) {
+        return SUCCESS;
+    }
+    
+    *definite_deadlocks = (CycleInfo*)arena_alloc(arena, sizeof(CycleInfo) * num_cycles);
+    *potential_deadlocks = (CycleInfo*)arena_alloc(arena, sizeof(CycleInfo) * num_cycles);
+    
+    int result = SUCCESS;
+    if (*definite_deadlocks == NULL || *potential_deadlocks == NULL) {
+        result = ERROR_OUT_OF_MEMORY;
+    }
+    
+    /* Categorize each cycle */
+    for (int i = 0; i < num_cycles && result == SUCCESS; i++) {
+        if (is_deadlock_definite(&cycles[i], graph)) {
+            result = copy_cycle(arena, &(*definite_deadlocks)[*num_definite], &cycles[i]);
+            if (result == SUCCESS) {
+                (*num_definite)++;
+            }
+        } else {
+            result = copy_cycle(arena, &(*potential_deadlocks)[*num_potential], &cycles[i]);
+            if (result == SUCCESS) {
+                (*num_potential)++;
+            }
+        }
+    }
+    
+    if (result != SUCCESS) {
+        if (arena == NULL) {
+            free_cycle_list(*definite_deadlocks, *num_definite);
+            free_cycle_list(*potential_deadlocks, *num_potential);
+        }
+        *definite_deadlocks = NULL;
+        *potential_deadlocks = NULL;
+        *num_definite = 0;
+        *num_potential = 0;
+        return result;
+    }
+    
+    /* Empty lists are reported as NULL */
+    if (*num_definite == 0) {
+        if (arena == NULL) {
+            free(*definite_deadlocks);
+        }
+        *definite_deadlocks = NULL;
+    }
+    if (*num_potential == 0) {
+        if (arena == NULL) {
+            free(*potential_deadlocks);
+        }
+        *potential_deadlocks = NULL;
+    }
+    
+    return SUCCESS;
+}
+
+/*
+ * identify_deadlocked_processes - Extract process IDs from cycles
+ * @cycles: Array of CycleInfo structures
+ * @num_cycles: Number of cycles
+ * @graph: ResourceGraph for vertex lookup
+ * @pids: Output parameter for array of deadlocked PIDs
+ * @count: Output parameter for number of unique PIDs
+ * @return: SUCCESS (0) on success, negative on error
+ * Description: Extracts all unique process IDs involved in deadlock cycles.
+ *              Allocates array for PIDs. Caller must free result.
+ *              Time complexity: O(C * L) where C=cycles, L=avg cycle length
+ * Error handling: Returns error codes for allocation failures
+ */
+int identify_deadlocked_processes(const CycleInfo* cycles, int num_cycles,
+                                  const ResourceGraph* graph, int** pids, int* count)
+{
+    if (cycles == NULL || graph == NULL || pids == NULL || count == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    return collect_deadlocked_pids(NULL, cycles, num_cycles, graph, pids, count);
+}
+
 /*
  * filter_actual_deadlocks - Distinguish definite vs potential deadlocks
  * @cycles: Array of CycleInfo structures
@@ -341,6 +789,8 @@ int identify_deadlocked_processes(const CycleInfo* cycles, int num_cycles,
  * @return: SUCCESS (0) on success, negative on error
  * Description: Categorizes cycles into definite deadlocks (single-instance
  *              resources) and potential deadlocks (multi-instance resources).
+ *              Both result lists are heap-allocated; free them with
+ *              free_cycle_list().
  *              Time complexity: O(C * L)
  * Error handling: Returns error codes for allocation failures
  */
@@ -355,154 +805,9 @@ int filter_actual_deadlocks(const CycleInfo* cycles, int num_cycles,
         return ERROR_INVALID_ARGUMENT;
     }
     
-    *definite_deadlocks = NULL;
-    *potential_deadlocks = NULL;
-    *num_definite = 0;
-    *num_potential = 0;
-    
-    int definite_capacity = 0;
-    int potential_capacity = 0;
-    
-    /* Categorize each cycle */
-    for (int i = 0; i < num_cycles; i++) {
-        int is_definite = is_deadlock_definite(&cycles[i], graph);
-        
-        if (is_definite) {
-            /* Add to definite deadlocks */
-            if (*num_definite >= definite_capacity) {
-                int new_capacity = definite_capacity == 0 ? 10 : definite_capacity * 2;
-                CycleInfo* new_list = (CycleInfo*)safe_realloc(
-                    *definite_deadlocks, sizeof(CycleInfo) * new_capacity);
-                if (new_list == NULL) {
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                *definite_deadlocks = new_list;
-                definite_capacity = new_capacity;
-            }
-            
-            /* Copy cycle structure */
-            CycleInfo* dest = &(*definite_deadlocks)[*num_definite];
-            memset(dest, 0, sizeof(CycleInfo));
-            
-            /* Copy cycle data */
-            dest->cycle_length = cycles[i].cycle_length;
-            dest->cycle_start_vertex = cycles[i].cycle_start_vertex;
-            dest->cycle_end_vertex = cycles[i].cycle_end_vertex;
-            dest->num_processes = cycles[i].num_processes;
-            dest->num_resources = cycles[i].num_resources;
-            
-            /* Deep copy cycle_path */
-            if (cycles[i].cycle_path != NULL && cycles[i].cycle_length > 0) {
-                dest->cycle_path = (int*)safe_malloc(sizeof(int) * cycles[i].cycle_length);
-                if (dest->cycle_path == NULL) {
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                memcpy(dest->cycle_path, cycles[i].cycle_path,
-                       sizeof(int) * cycles[i].cycle_length);
-            }
-            
-            /* Deep copy process_ids */
-            if (cycles[i].process_ids != NULL && cycles[i].num_processes > 0) {
-                dest->process_ids = (int*)safe_malloc(sizeof(int) * cycles[i].num_processes);
-                if (dest->process_ids == NULL) {
-                    free(dest->cycle_path);
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                memcpy(dest->process_ids, cycles[i].process_ids,
-                       sizeof(int) * cycles[i].num_processes);
-            }
-            
-            /* Deep copy resource_ids */
-            if (cycles[i].resource_ids != NULL && cycles[i].num_resources > 0) {
-                dest->resource_ids = (int*)safe_malloc(sizeof(int) * cycles[i].num_resources);
-                if (dest->resource_ids == NULL) {
-                    free(dest->cycle_path);
-                    free(dest->process_ids);
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                memcpy(dest->resource_ids, cycles[i].resource_ids,
-                       sizeof(int) * cycles[i].num_resources);
-            }
-            
-            (*num_definite)++;
-        } else {
-            /* Add to potential deadlocks */
-            if (*num_potential >= potential_capacity) {
-                int new_capacity = potential_capacity == 0 ? 10 : potential_capacity * 2;
-                CycleInfo* new_list = (CycleInfo*)safe_realloc(
-                    *potential_deadlocks, sizeof(CycleInfo) * new_capacity);
-                if (new_list == NULL) {
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                *potential_deadlocks = new_list;
-                potential_capacity = new_capacity;
-            }
-            
-            /* Copy cycle structure */
-            CycleInfo* dest = &(*potential_deadlocks)[*num_potential];
-            memset(dest, 0, sizeof(CycleInfo));
-            
-            /* Copy cycle data */
-            dest->cycle_length = cycles[i].cycle_length;
-            dest->cycle_start_vertex = cycles[i].cycle_start_vertex;
-            dest->cycle_end_vertex = cycles[i].cycle_end_vertex;
-            dest->num_processes = cycles[i].num_processes;
-            dest->num_resources = cycles[i].num_resources;
-            
-            /* Deep copy cycle_path */
-            if (cycles[i].cycle_path != NULL && cycles[i].cycle_length > 0) {
-                dest->cycle_path = (int*)safe_malloc(sizeof(int) * cycles[i].cycle_length);
-                if (dest->cycle_path == NULL) {
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                memcpy(dest->cycle_path, cycles[i].cycle_path,
-                       sizeof(int) * cycles[i].cycle_length);
-            }
-            
-            /* Deep copy process_ids */
-            if (cycles[i].process_ids != NULL && cycles[i].num_processes > 0) {
-                dest->process_ids = (int*)safe_malloc(sizeof(int) * cycles[i].num_processes);
-                if (dest->process_ids == NULL) {
-                    free(dest->cycle_path);
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                memcpy(dest->process_ids, cycles[i].process_ids,
-                       sizeof(int) * cycles[i].num_processes);
-            }
-            
-            /* Deep copy resource_ids */
-            if (cycles[i].resource_ids != NULL && cycles[i].num_resources > 0) {
-                dest->resource_ids = (int*)safe_malloc(sizeof(int) * cycles[i].num_resources);
-                if (dest->resource_ids == NULL) {
-                    free(dest->cycle_path);
-                    free(dest->process_ids);
-                    free_cycle_list(*definite_deadlocks, *num_definite);
-                    free_cycle_list(*potential_deadlocks, *num_potential);
-                    return ERROR_OUT_OF_MEMORY;
-                }
-                memcpy(dest->resource_ids, cycles[i].resource_ids,
-                       sizeof(int) * cycles[i].num_resources);
-            }
-            
-            (*num_potential)++;
-        }
-    }
-    
-    return SUCCESS;
+    return filter_cycles(NULL, cycles, num_cycles, graph,
+                         definite_deadlocks, num_definite,
+                         potential_deadlocks, num_potential);
 }
 
 /*
@@ -537,9 +842,9 @@ int analyze_cycles_for_deadlock(const CycleInfo* cycles, int num_cycles,
     int num_definite = 0;
     int num_potential = 0;
     
-    int filter_result = filter_actual_deadlocks(cycles, num_cycles, graph,
-                                                &definite_cycles, &num_definite,
-                                                &potential_cycles, &num_potential);
+    int filter_result = filter_cycles(report->arena, cycles, num_cycles, graph,
+                                      &definite_cycles, &num_definite,
+                                      &potential_cycles, &num_potential);
     
     if (filter_result != SUCCESS) {
         return filter_result;
@@ -548,11 +853,20 @@ int analyze_cycles_for_deadlock(const CycleInfo* cycles, int num_cycles,
     /* Use definite deadlocks for report (or potential if no definite) */
     CycleInfo* deadlock_cycles = definite_cycles;
     int num_deadlock_cycles = num_definite;
+    CycleInfo* unused_cycles = potential_cycles;
+    int num_unused = num_potential;
     
     if (num_deadlock_cycles == 0 && num_potential > 0) {
         /* Use potential deadlocks if no definite ones */
         deadlock_cycles = potential_cycles;
         num_deadlock_cycles = num_potential;
+        unused_cycles = NULL;
+        num_unused = 0;
+    }
+    
+    /* Unused cycles are dropped; arena copies go with the next reset */
+    if (report->arena == NULL) {
+        free_cycle_list(unused_cycles, num_unused);
     }
     
     /* Store cycles in report */
@@ -563,28 +877,17 @@ int analyze_cycles_for_deadlock(const CycleInfo* cycles, int num_cycles,
         report->deadlock_detected = 1;
         
         /* Identify deadlocked processes */
-        int result = identify_deadlocked_processes(deadlock_cycles, num_deadlock_cycles,
-                                                  graph, &report->deadlocked_pids,
-                                                  &report->num_deadlocked);
+        int result = collect_deadlocked_pids(report->arena, deadlock_cycles,
+                                             num_deadlock_cycles, graph,
+                                             &report->deadlocked_pids,
+                                             &report->num_deadlocked);
         if (result != SUCCESS) {
-            /* Cleanup potential cycles that weren't used */
-            if (num_potential > 0 && num_definite > 0) {
-                free_cycle_list(potential_cycles, num_potential);
-            }
             return result;
         }
     } else {
         report->deadlock_detected = 0;
     }
     
-    /* Cleanup unused cycles */
-    if (num_potential > 0 && num_definite > 0) {
-        free_cycle_list(potential_cycles, num_potential);
-    } else if (num_potential > 0 && num_definite == 0) {
-        /* Potential cycles were used, free definite (should be NULL) */
-        free_cycle_list(definite_cycles, num_definite);
-    }
-    
     return SUCCESS;
 }
 
@@ -609,7 +912,7 @@ int generate_explanations(DeadlockReport* report, const ResourceGraph* graph)
     }
     
     /* Allocate explanations array */
-    report->explanations = (char**)safe_malloc(sizeof(char*) * report->num_cycles);
+    report->explanations = (char**)arena_alloc(report->arena, sizeof(char*) * report->num_cycles);
     if (report->explanations == NULL) {
         return ERROR_OUT_OF_MEMORY;
     }
@@ -657,13 +960,15 @@ int generate_explanations(DeadlockReport* report, const ResourceGraph* graph)
         }
         
         /* Allocate and copy explanation */
-        report->explanations[i] = str_dup(explanation);
+        report->explanations[i] = arena_strdup(report->arena, explanation);
         if (report->explanations[i] == NULL) {
             /* Free previous explanations */
-            for (int k = 0; k < i; k++) {
-                free(report->explanations[k]);
+            if (report->arena == NULL) {
+                for (int k = 0; k < i; k++) {
+                    free(report->explanations[k]);
+                }
+                free(report->explanations);
             }
-            free(report->explanations);
             report->explanations = NULL;
             return ERROR_OUT_OF_MEMORY;
         }
@@ -695,7 +1000,7 @@ int generate_recommendations(DeadlockReport* report, const ResourceGraph* graph)
     
     /* Allocate recommendations array */
     int max_recommendations = 5; /* Estimate */
-    report->recommendations = (char**)safe_malloc(sizeof(char*) * max_recommendations);
+    report->recommendations = (char**)arena_alloc(report->arena, sizeof(char*) * max_recommendations);
     if (report->recommendations == NULL) {
         return ERROR_OUT_OF_MEMORY;
     }
@@ -719,7 +1024,7 @@ int generate_recommendations(DeadlockReport* report, const ResourceGraph* graph)
         pos += snprintf(rec + pos, sizeof(rec) - pos,
                        ". This will break the circular wait chain.");
         
-        report->recommendations[rec_count] = str_dup(rec);
+        report->recommendations[rec_count] = arena_strdup(report->arena, rec);
         if (report->recommendations[rec_count] == NULL) {
             goto cleanup;
         }
@@ -729,7 +1034,7 @@ int generate_recommendations(DeadlockReport* report, const ResourceGraph* graph)
     /* Recommendation 2: Resource release */
     if (rec_count < max_recommendations) {
         char* rec = "Review resource allocation policies to prevent circular dependencies.";
-        report->recommendations[rec_count] = str_dup(rec);
+        report->recommendations[rec_count] = arena_strdup(report->arena, rec);
         if (report->recommendations[rec_count] == NULL) {
             goto cleanup;
         }
@@ -739,7 +1044,7 @@ int generate_recommendations(DeadlockReport* report, const ResourceGraph* graph)
     /* Recommendation 3: Timeout */
     if (rec_count < max_recommendations) {
         char* rec = "Implement resource request timeouts to automatically break deadlocks.";
-        report->recommendations[rec_count] = str_dup(rec);
+        report->recommendations[rec_count] = arena_strdup(report->arena, rec);
         if (report->recommendations[rec_count] == NULL) {
             goto cleanup;
         }
@@ -750,98 +1055,231 @@ int generate_recommendations(DeadlockReport* report, const ResourceGraph* graph)
     return SUCCESS;
     
 cleanup:
-    for (int i = 0; i < rec_count; i++) {
-        free(report->recommendations[i]);
+    if (report->arena == NULL) {
+        for (int i = 0; i < rec_count; i++) {
+            free(report->recommendations[i]);
+        }
+        free(report->recommendations);
     }
-    free(report->recommendations);
     report->recommendations = NULL;
     report->num_recommendations = 0;
     return ERROR_OUT_OF_MEMORY;
 }
 
 /*
- * detect_deadlock_in_system - Main deadlock detection entry point
- * @procs: Array of ProcessResourceInfo structures for all processes
- * @num_procs: Number of processes in array
- * @report: Output parameter for deadlock report
- * @return: 1 if deadlock detected, 0 if no deadlock, negative on error
- * Description: Main function that orchestrates deadlock detection:
- *              1. Builds RAG from process resource information
- *              2. Runs cycle detection algorithm
- *              3. Analyzes cycles to determine actual deadlocks
- *              4. Generates comprehensive report
- *              Time complexity: O(V + E + C) where V=vertices, E=edges, C=cycles
- * Error handling: Returns negative error code on failure, fills report with
- *                 partial results if possible
+ * count_waiting_processes - Count processes with at least one wait edge
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @limit: Stop counting once this many are found
+ * @return: Number of waiting processes, at most limit
  */
-int detect_deadlock_in_system(ProcessResourceInfo* procs, int num_procs,
-                              DeadlockReport* report)
+static int count_waiting_processes(const ProcessResourceInfo* procs, int num_procs, int limit)
+{
+    int count = 0;
+    for (int i = 0; i < num_procs && count < limit; i++) {
+        if (procs[i].num_waiting > 0 || procs[i].num_waiting_on_pids > 0) {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*
+ * find_deadlock_cycles - Build the RAG and record its deadlock cycles
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @report: Report to fill
+ * @graph: Output parameter for the built graph (caller frees; NULL = free it here)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+int find_deadlock_cycles(ProcessResourceInfo* procs, int num_procs,
+                         DeadlockReport* report, ResourceGraph** graph)
 {
-    if (procs == NULL || report == NULL) {
+    if ((procs == NULL && num_procs > 0) || report == NULL) {
         return ERROR_INVALID_ARGUMENT;
     }
     
-    if (num_procs <= 0) {
-        report->deadlock_detected = 0;
-        report->total_processes_scanned = 0;
-        return 0;
+    ResourceGraph* local_graph = NULL;
+    if (graph == NULL) {
+        int result = find_deadlock_cycles(procs, num_procs, report, &local_graph);
+        free_graph(local_graph);
+        return result;
     }
     
-    /* Initialize report */
-    report->deadlock_detected = 0;
-    report->total_processes_scanned = num_procs;
-    
     /* Step 1: Build Resource Allocation Graph */
-    ResourceGraph* graph = NULL;
-    int build_result = build_rag_from_processes(procs, num_procs, &graph);
+    int build_result = build_rag_from_processes(procs, num_procs, graph);
     if (build_result != SUCCESS) {
         error_log("Failed to build RAG: %d", build_result);
         return build_result;
     }
     
-    if (graph == NULL) {
+    if (*graph == NULL) {
         return ERROR_GRAPH_CREATION_FAILED;
     }
     
     /* Get resource count for statistics */
     int num_processes, num_resources, num_edges;
-    get_graph_statistics(graph, &num_processes, &num_resources, &num_edges);
+    get_graph_statistics(*graph, &num_processes, &num_resources, &num_edges);
     report->total_resources_found = num_resources;
     
-    /* Step 2: Run cycle detection */
+    /* Step 2: Run cycle detection (engine selected via set_cycle_engine) */
     CycleInfo* cycles = NULL;
     int num_cycles = 0;
     
-    reset_graph_colors(graph);
-    int cycle_result = find_all_cycles(graph, &cycles, &num_cycles);
+    int cycle_result = has_cycle(*graph, &cycles, &num_cycles);
     
-    if (cycle_result != SUCCESS) {
+    if (cycle_result < 0) {
         error_log("Cycle detection failed: %d", cycle_result);
-        free_graph(graph);
         return cycle_result;
     }
     
     /* Step 3: Analyze cycles for deadlocks */
     if (num_cycles > 0) {
-        int analyze_result = analyze_cycles_for_deadlock(cycles, num_cycles, graph, report);
+        int analyze_result = analyze_cycles_for_deadlock(cycles, num_cycles, *graph, report);
+        
+        /* Free original cycles list (analyze_cycles_for_deadlock creates copies) */
+        free_cycle_list(cycles, num_cycles);
+        
         if (analyze_result != SUCCESS) {
             error_log("Cycle analysis failed: %d", analyze_result);
-            free_cycle_list(cycles, num_cycles);
-            free_graph(graph);
             return analyze_result;
         }
+    }
+    
+    return SUCCESS;
+}
+
+/*
+ * filter_report_cycles - Drop the cycles a filter rejects
+ * @report: Report filled by find_deadlock_cycles()
+ * @graph: Graph the cycles were found in
+ * @keep: Filter called with each cycle's PIDs
+ * @context: Passed to keep
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Compacts report->cycles in place and rebuilds
+ *              deadlocked_pids from the cycles that remain.
+ * Error handling: Cycles not yet filtered when the filter or an allocation
+ *                 fails are kept, so the report stays consistent
+ */
+static int filter_report_cycles(DeadlockReport* report, const ResourceGraph* graph,
+                                DeadlockCycleFilterFn keep, void* context)
+{
+    int status = SUCCESS;
+    int kept = 0;
+    
+    for (int i = 0; i < report->num_cycles; i++) {
+        int verdict = 1;
+        
+        if (status == SUCCESS) {
+            int* pids = NULL;
+            int count = 0;
+            status = collect_deadlocked_pids(NULL, &report->cycles[i], 1, graph,
+                                             &pids, &count);
+            if (status == SUCCESS && count > 0) {
+                verdict = keep(context, pids, count);
+                if (verdict < 0) {
+                    status = verdict;
+                    verdict = 1;
+                }
+            }
+            safe_free((void**)&pids);
+        }
         
-        /* Free original cycles list (analyze_cycles_for_deadlock creates copies) */
-        free_cycle_list(cycles, num_cycles);
-        cycles = NULL;
-        num_cycles = 0;
-    } else {
-        report->deadlock_detected = 0;
+        if (verdict == 0) {
+            /* Arena copies go with the next reset */
+            if (report->arena == NULL) {
+                free_cycle_info(&report->cycles[i]);
+            }
+            continue;
+        }
+        if (kept != i) {
+            report->cycles[kept] = report->cycles[i];
+        }
+        kept++;
+    }
+    
+    if (kept == report->num_cycles) {
+        return status;
+    }
+    report->num_cycles = kept;
+    report->deadlock_detected = kept > 0;
+    
+    if (report->arena == NULL) {
+        safe_free((void**)&report->deadlocked_pids);
+    }
+    int collect_result = collect_deadlocked_pids(report->arena, report->cycles, kept, graph,
+                                                 &report->deadlocked_pids,
+                                                 &report->num_deadlocked);
+    return status != SUCCESS ? status : collect_result;
+}
+
+/*
+ * detect_deadlock_in_system - Main deadlock detection entry point
+ * @procs: Array of ProcessResourceInfo structures for all processes
+ * @num_procs: Number of processes in array
+ * @report: Output parameter for deadlock report
+ * @return: 1 if deadlock detected, 0 if no deadlock, negative on error
+ * Description: Main function that orchestrates deadlock detection:
+ *              1. Builds RAG from process resource information
+ *              2. Runs cycle detection algorithm
+ *              3. Analyzes cycles to determine actual deadlocks
+ *              4. Generates comprehensive report
+ *              Every process of a cycle waits, so with fewer than two
+ *              waiting processes steps 1-3 are skipped.
+ *              total_processes_scanned is only raised to num_procs, so a
+ *              caller that passes a pruned array can preset the full count.
+ *              No alert is sent; the caller decides what gets reported.
+ *              Time complexity: O(V + E + C) where V=vertices, E=edges, C=cycles
+ * Error handling: Returns negative error code on failure, fills report with
+ *                 partial results if possible
+ */
+int detect_deadlock_in_system(ProcessResourceInfo* procs, int num_procs,
+                              DeadlockReport* report)
+{
+    return detect_deadlock_filtered(procs, num_procs, report, NULL, NULL);
+}
+
+/*
+ * detect_deadlock_filtered - Detect deadlocks, reporting only cycles a filter keeps
+ * @procs: Array of ProcessResourceInfo structures for all processes
+ * @num_procs: Number of processes in array
+ * @report: Output parameter for deadlock report
+ * @keep: Called once per detected cycle (NULL = keep every cycle)
+ * @context: Passed to keep
+ * @return: 1 if a kept cycle remains, 0 if none, negative on error
+ */
+int detect_deadlock_filtered(ProcessResourceInfo* procs, int num_procs,
+                             DeadlockReport* report,
+                             DeadlockCycleFilterFn keep, void* context)
+{
+    if ((procs == NULL && num_procs > 0) || report == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    if (num_procs < 0) {
+        num_procs = 0;
+    }
+    
+    /* Initialize report */
+    report->deadlock_detected = 0;
+    if (report->total_processes_scanned < num_procs) {
+        report->total_processes_scanned = num_procs;
+    }
+    
+    ResourceGraph* graph = NULL;
+    if (count_waiting_processes(procs, num_procs, 2) >= 2) {
+        int cycle_status = find_deadlock_cycles(procs, num_procs, report, &graph);
+        if (cycle_status == SUCCESS && keep != NULL && report->deadlock_detected) {
+            cycle_status = filter_report_cycles(report, graph, keep, context);
+        }
+        if (cycle_status != SUCCESS) {
+            free_graph(graph);
+            return cycle_status;
+        }
     }
     
     /* Step 4: Generate explanations and recommendations */
     if (report->deadlock_detected) {
-        fprintf(stderr, "[DEBUG] Deadlock detected, checking if email alert enabled\n");
         int explain_result = generate_explanations(report, graph);
         if (explain_result != SUCCESS) {
             debug_log("Failed to generate explanations: %d", explain_result);
@@ -853,14 +1291,7 @@ int detect_deadlock_in_system(ProcessResourceInfo* procs, int num_procs,
             debug_log("Failed to generate recommendations: %d", rec_result);
             /* Non-fatal, continue */
         }
-    } else {
-        fprintf(stderr, "[DEBUG] No deadlock detected, deadlock_status = %d\n", 
-                report->deadlock_detected ? 1 : 0);
     }
-
-    fprintf(stderr, "[DEBUG] Calling email_alert_handle_detection with deadlock_status=%d\n",
-            report->deadlock_detected ? 1 : 0);
-    email_alert_handle_detection(report, report->deadlock_detected ? 1 : 0);
     
     /* Cleanup graph */
     free_graph(graph);
@@ -874,6 +1305,7 @@ int detect_deadlock_in_system(ProcessResourceInfo* procs, int num_procs,
  * @return: None
  * Description: Frees all dynamically allocated arrays and strings in report,
  *              including cycles, PIDs, explanations, and recommendations.
+ *              An arena-backed report only drops its pointers.
  *              Safe to call with NULL pointer.
  * Error handling: Handles NULL pointer and partially initialized reports safely
  */
@@ -883,6 +1315,16 @@ void free_deadlock_report(DeadlockReport* report)
         return;
     }
     
+    /* Arena-backed contents are released by arena_reset(); dropping the
+     * pointers turns the frees below into no-ops */
+    if (report->arena != NULL) {
+        report->deadlocked_pids = NULL;
+        report->cycles = NULL;
+        report->explanations = NULL;
+        report->recommendations = NULL;
+        report->arena = NULL;
+    }
+    
     /* Free deadlocked PIDs array */
     safe_free((void**)&report->deadlocked_pids);
     
@@ -921,6 +1363,187 @@ void free_deadlock_report(DeadlockReport* report)
     report->num_recommendations = 0;
 }
 
+/*
+ * record_lock - Add a lock to a process's held or waiting resources once
+ * @proc: Process to update
+ * @ids: Held or waiting resource IDs of proc
+ * @count: Number of IDs
+ * @files: Matching held or waiting file names
+ * @num_files: Number of file names
+ * @lock: Lock to record (its lock_id is the resource ID)
+ * @return: 1 if the lock was added, 0 if already present or the list is full
+ */
+static int record_lock(ProcessResourceInfo* proc, int** ids, int* count,
+                       char*** files, int* num_files, const FileLockInfo* lock)
+{
+    for (int k = 0; *ids != NULL && k < *count; k++) {
+        if ((*ids)[k] == lock->lock_id) {
+            return 0;
+        }
+    }
+    
+    if (append_bounded_id(proc->arena, ids, count, MAX_RESOURCES_PER_PROCESS,
+                          lock->lock_id) != SUCCESS) {
+        return 0;
+    }
+    
+    if (*files == NULL) {
+        *files = (char**)arena_alloc(proc->arena, sizeof(char*) * MAX_RESOURCES_PER_PROCESS);
+        *num_files = 0;
+    }
+    
+    if (*files != NULL && *num_files < MAX_RESOURCES_PER_PROCESS) {
+        if (lock->file_path[0] != '\0') {
+            (*files)[*num_files] = arena_strdup(proc->arena, lock->file_path);
+        } else {
+            char lock_file_str[64];
+            snprintf(lock_file_str, sizeof(lock_file_str), "lock_%d", lock->lock_id);
+            (*files)[*num_files] = arena_strdup(proc->arena, lock_file_str);
+        }
+        (*num_files)++;
+    }
+    
+    return 1;
+}
+
+/*
+ * add_lock_wait_edge - Make a process wait on a lock and its holder
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @i: Index of the waiting process
+ * @lock: Held lock it waits on
+ * @by_pid: PID-sorted pairs of procs
+ * @return: None
+ * Description: The waiter gets the lock as a waiting resource; the holder,
+ *              if collected, holds it and becomes a PID the waiter waits on.
+ */
+static void add_lock_wait_edge(ProcessResourceInfo* procs, int num_procs, int i,
+                               const FileLockInfo* lock, const int* by_pid)
+{
+    ProcessResourceInfo* proc = &procs[i];
+    if (!record_lock(proc, &proc->waiting_resources, &proc->num_waiting,
+                     &proc->waiting_files, &proc->num_waiting_files, lock)) {
+        return;
+    }
+    
+    int holder = find_proc_by_pid(by_pid, num_procs, lock->pid);
+    if (holder < 0) {
+        return;
+    }
+    
+    int pid_found = 0;
+    for (int m = 0; proc->waiting_on_pids != NULL && m < proc->num_waiting_on_pids; m++) {
+        if (proc->waiting_on_pids[m] == lock->pid) {
+            pid_found = 1;
+            break;
+        }
+    }
+    if (!pid_found) {
+        append_bounded_id(proc->arena, &proc->waiting_on_pids, &proc->num_waiting_on_pids,
+                          MAX_WAITING_PIDS, lock->pid);
+    }
+    
+    ProcessResourceInfo* owner = &procs[holder];
+    record_lock(owner, &owner->held_resources, &owner->num_held,
+                &owner->held_files, &owner->num_held_files, lock);
+}
+
+/*
+ * analyze_lock_wait - Derive the lock wait edges of one lock-blocked process
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @i: Index of the blocked process
+ * @locks: Indexed /proc/locks
+ * @by_pid: PID-sorted pairs of procs
+ * @return: None
+ * Description: Fallback for processes the kernel's waiter list does not
+ *              name. Each regular file the process has open is looked up by
+ *              inode in the lock index. A lock held by another process on
+ *              the same dev:inode is waited on, and its holder, if
+ *              collected, holds it. A decoded flock()/fcntl() restricts
+ *              this to one FD and one lock family.
+ */
+static void analyze_lock_wait(ProcessResourceInfo* procs, int num_procs, int i,
+                              const LockIndex* locks, const int* by_pid)
+{
+    ProcessResourceInfo* proc = &procs[i];
+    int exact_wait = proc->wait.kind == WAIT_SYSCALL_FLOCK ||
+                     proc->wait.kind == WAIT_SYSCALL_FCNTL_LOCK;
+    char wait_lock_type = proc->wait.kind == WAIT_SYSCALL_FLOCK ? 'F' : 'P';
+    
+    /* Use the scan's FD snapshot to find which files it's trying to lock;
+     * processes collected without one get a one-off table */
+    FdTable local_table;
+    memset(&local_table, 0, sizeof(local_table));
+    FdTable* fd_table = proc->fd_table;
+    if (fd_table == NULL &&
+        fd_table_collect((pid_t)proc->pid, &local_table) == SUCCESS) {
+        fd_table = &local_table;
+    }
+    
+    for (int fd_idx = 0; fd_table != NULL && fd_idx < fd_table->num_entries; fd_idx++) {
+        FdEntry* fd_entry = &fd_table->entries[fd_idx];
+        if (exact_wait && fd_entry->fd != proc->wait.fd) {
+            continue;
+        }
+        if (fd_entry->kind != FD_KIND_FILE ||
+            fd_entry_resolve_inode(fd_table, fd_entry) != SUCCESS) {
+            continue;
+        }
+        
+        /* Match dev:inode; where stat() and /proc/locks disagree on the
+         * device (btrfs subvolumes, overlays) the inode alone decides */
+        int match_device = lock_index_has_device(locks, fd_entry->inode, fd_entry->device);
+        
+        for (int j = lock_index_first_by_inode(locks, fd_entry->inode); j >= 0;
+             j = locks->next_by_inode[j]) {
+            const FileLockInfo* lock = &locks->locks[j];
+            
+            /* Skip locks held by this process; flock() and fcntl() locks
+             * never conflict */
+            if (lock->pid == proc->pid ||
+                (exact_wait && lock->lock_type != wait_lock_type) ||
+                (match_device && lock->device != fd_entry->device)) {
+                continue;
+            }
+            
+            add_lock_wait_edge(procs, num_procs, i, lock, by_pid);
+        }
+    }
+    
+    free_fd_table(&local_table);
+}
+
+/*
+ * analyze_lock_waiters - Turn the kernel's blocked-request list into wait edges
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @locks: Indexed /proc/locks
+ * @by_pid: PID-sorted pairs of procs
+ * @covered: Output flags, set for every process that got an edge here
+ * @return: None
+ * Description: Every "->" line of /proc/locks names a waiting PID and the
+ *              held lock it is queued on, so no FD of the waiter has to be
+ *              read. Requests without a PID (OFD locks) are left to
+ *              analyze_lock_wait().
+ *              Time complexity: O(W log P), W = blocked requests
+ */
+static void analyze_lock_waiters(ProcessResourceInfo* procs, int num_procs,
+                                 const LockIndex* locks, const int* by_pid, char* covered)
+{
+    for (int w = 0; w < locks->num_waiters; w++) {
+        const LockWaiter* waiter = &locks->waiters[w];
+        const FileLockInfo* lock = &locks->locks[waiter->blocker];
+        int i = find_proc_by_pid(by_pid, num_procs, waiter->pid);
+        if (i < 0 || lock->pid == waiter->pid) {
+            continue;
+        }
+        
+        covered[i] = 1;
+        add_lock_wait_edge(procs, num_procs, i, lock, by_pid);
+    }
+}
+
 /*
  * analyze_pipe_and_lock_dependencies - Analyze pipe and lock dependencies
  * @procs: Array of ProcessResourceInfo structures
@@ -930,7 +1553,17 @@ void free_deadlock_report(DeadlockReport* report)
  *              which processes are waiting on which resources/processes.
  *              Updates ProcessResourceInfo structures with waiting resources
  *              and waiting_on_pids. This enables detection of pipe and lock deadlocks.
- *              Time complexity: O(P * L + P * F) where P=processes, L=locks, F=FDs
+ *              FD information is read from each process's fd_table snapshot;
+ *              pipe peers are found through a pipe inode index.
+ *              A process whose blocking syscall was decoded waits only on
+ *              the pipe or lock behind its FD; a parent in wait4() waits on
+ *              its collected children.
+ *              /proc/locks is read once and indexed by inode and holder
+ *              PID. Its "->" waiter lines give lock wait edges without any
+ *              FD access; only lock-blocked processes they do not name have
+ *              their FDs probed against the index.
+ *              Time complexity: O(E + P log P + L + F) expected, where
+ *              E=pipe endpoints, P=processes, L=locks, F=FDs
  * Error handling: Returns error codes for allocation or access issues
  */
 int analyze_pipe_and_lock_dependencies(ProcessResourceInfo* procs, int num_procs)
@@ -939,379 +1572,68 @@ int analyze_pipe_and_lock_dependencies(ProcessResourceInfo* procs, int num_procs
         return ERROR_INVALID_ARGUMENT;
     }
     
-    /* Step 1: Parse system-wide locks */
-    FileLockInfo* system_locks = NULL;
-    int system_lock_count = 0;
-    int lock_result = parse_system_locks(&system_locks, &system_lock_count);
+    /* Step 1: Index system-wide locks by inode and holder PID */
+    LockIndex locks;
+    memset(&locks, 0, sizeof(locks));
+    int lock_result = lock_index_load(&locks);
     
     if (lock_result != SUCCESS && lock_result != ERROR_FILE_NOT_FOUND) {
         /* Non-fatal, continue without lock analysis */
         debug_log("Failed to parse system locks: %d", lock_result);
     }
     
-    /* Step 2: Build PID to ProcessResourceInfo map for quick lookup */
-    /* We'll iterate through procs array directly */
+    /* Step 3: Analyze pipe dependencies through the pipe inode index */
+    int pipe_result = analyze_pipe_dependencies(procs, num_procs);
+    if (pipe_result != SUCCESS) {
+        /* Non-fatal, continue with lock analysis */
+        debug_log("Failed to analyze pipe dependencies: %d", pipe_result);
+    }
+    
+    /* Parents blocked in wait4() wait for their collected children */
+    int child_result = analyze_child_dependencies(procs, num_procs);
+    if (child_result != SUCCESS) {
+        debug_log("Failed to analyze child dependencies: %d", child_result);
+    }
+    
+    if (locks.num_locks == 0) {
+        free_lock_index(&locks);
+        return SUCCESS;
+    }
+    
+    int* by_pid = sort_procs_by_pid(procs, num_procs);
+    char* covered = (char*)safe_malloc((size_t)num_procs);
+    if (by_pid == NULL || covered == NULL) {
+        free(by_pid);
+        free(covered);
+        free_lock_index(&locks);
+        return ERROR_OUT_OF_MEMORY;
+    }
+    memset(covered, 0, (size_t)num_procs);
+    
+    /* Step 4: Lock waits the kernel lists directly; FD matching only for
+     * lock-blocked processes it does not name */
+    analyze_lock_waiters(procs, num_procs, &locks, by_pid, covered);
     
-    /* Step 3: Analyze pipe dependencies */
-    /* For each process with pipes, check pipe relationships */
     for (int i = 0; i < num_procs; i++) {
         ProcessResourceInfo* proc = &procs[i];
         
-        /* Check if process has pipes (blocked or not, both can lead to deadlock) */
-        if (proc->num_pipe_inodes > 0) {
-            /* Find processes that share the same pipe inode */
-            for (int j = 0; j < num_procs; j++) {
-                if (i == j) {
-                    continue;
-                }
-                
-                ProcessResourceInfo* other_proc = &procs[j];
-                
-                /* Check if other process has matching pipe inode */
-                for (int k = 0; k < proc->num_pipe_inodes; k++) {
-                    unsigned long pipe_inode = proc->pipe_inodes[k];
-                    
-                    for (int l = 0; l < other_proc->num_pipe_inodes; l++) {
-                        if (other_proc->pipe_inodes[l] == pipe_inode) {
-                            /* Found pipe relationship! */
-                            /* Create resource ID from pipe inode */
-                            int pipe_resource_id = (int)(pipe_inode % 1000000); /* Use last 6 digits as resource ID */
-                            
-                            /* If proc is blocked on pipe, it's waiting for the pipe resource */
-                            if (proc->is_blocked_on_pipe) {
-                                /* Add other_proc->pid to waiting_on_pids */
-                                if (proc->waiting_on_pids == NULL) {
-                                    proc->waiting_on_pids = (int*)safe_malloc(sizeof(int) * MAX_WAITING_PIDS);
-                                    proc->num_waiting_on_pids = 0;
-                                }
-                                
-                                if (proc->num_waiting_on_pids < MAX_WAITING_PIDS) {
-                                    /* Check if PID already in array */
-                                    int found = 0;
-                                    for (int m = 0; m < proc->num_waiting_on_pids; m++) {
-                                        if (proc->waiting_on_pids[m] == other_proc->pid) {
-                                            found = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!found) {
-                                        proc->waiting_on_pids[proc->num_waiting_on_pids++] = other_proc->pid;
-                                    }
-                                }
-                                
-                                /* Add to waiting resources */
-                                if (proc->waiting_resources == NULL) {
-                                    proc->waiting_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                                    proc->num_waiting = 0;
-                                }
-                                
-                                if (proc->num_waiting < MAX_RESOURCES_PER_PROCESS) {
-                                    /* Check if resource already in array */
-                                    int res_found = 0;
-                                    for (int m = 0; m < proc->num_waiting; m++) {
-                                        if (proc->waiting_resources[m] == pipe_resource_id) {
-                                            res_found = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!res_found) {
-                                        proc->waiting_resources[proc->num_waiting++] = pipe_resource_id;
-                                    }
-                                }
-                            }
-                            
-                            /* other_proc holds the pipe (has the other end) */
-                            /* Add pipe as held resource for other_proc */
-                            if (other_proc->held_resources == NULL) {
-                                other_proc->held_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                                other_proc->num_held = 0;
-                            }
-                            
-                            if (other_proc->num_held < MAX_RESOURCES_PER_PROCESS) {
-                                int held_found = 0;
-                                for (int m = 0; m < other_proc->num_held; m++) {
-                                    if (other_proc->held_resources[m] == pipe_resource_id) {
-                                        held_found = 1;
-                                        break;
-                                    }
-                                }
-                                
-                                if (!held_found) {
-                                    other_proc->held_resources[other_proc->num_held++] = pipe_resource_id;
-                                }
-                            }
-                            
-                            /* If other_proc is also blocked on the same pipe, it creates mutual dependency */
-                            if (other_proc->is_blocked_on_pipe) {
-                                /* Reverse relationship: other_proc is waiting for proc */
-                                if (other_proc->waiting_on_pids == NULL) {
-                                    other_proc->waiting_on_pids = (int*)safe_malloc(sizeof(int) * MAX_WAITING_PIDS);
-                                    other_proc->num_waiting_on_pids = 0;
-                                }
-                                
-                                if (other_proc->num_waiting_on_pids < MAX_WAITING_PIDS) {
-                                    int found = 0;
-                                    for (int m = 0; m < other_proc->num_waiting_on_pids; m++) {
-                                        if (other_proc->waiting_on_pids[m] == proc->pid) {
-                                            found = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!found) {
-                                        other_proc->waiting_on_pids[other_proc->num_waiting_on_pids++] = proc->pid;
-                                    }
-                                }
-                                
-                                /* Add to waiting resources for other_proc */
-                                if (other_proc->waiting_resources == NULL) {
-                                    other_proc->waiting_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                                    other_proc->num_waiting = 0;
-                                }
-                                
-                                if (other_proc->num_waiting < MAX_RESOURCES_PER_PROCESS) {
-                                    int res_found = 0;
-                                    for (int m = 0; m < other_proc->num_waiting; m++) {
-                                        if (other_proc->waiting_resources[m] == pipe_resource_id) {
-                                            res_found = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!res_found) {
-                                        other_proc->waiting_resources[other_proc->num_waiting++] = pipe_resource_id;
-                                    }
-                                }
-                                
-                                /* proc also holds the pipe */
-                                if (proc->held_resources == NULL) {
-                                    proc->held_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                                    proc->num_held = 0;
-                                }
-                                
-                                if (proc->num_held < MAX_RESOURCES_PER_PROCESS) {
-                                    int held_found = 0;
-                                    for (int m = 0; m < proc->num_held; m++) {
-                                        if (proc->held_resources[m] == pipe_resource_id) {
-                                            held_found = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!held_found) {
-                                        proc->held_resources[proc->num_held++] = pipe_resource_id;
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-        }
-        
-        /* Step 4: Analyze file lock dependencies */
-        if (proc->is_blocked_on_lock && system_locks != NULL && system_lock_count > 0) {
-            /* Get file descriptors for this process to find which files it's trying to lock */
-            int* fds = NULL;
-            int fd_count = 0;
-            if (get_open_files((pid_t)proc->pid, &fds, &fd_count) == SUCCESS && fds != NULL) {
-                /* For each file descriptor, get file path and inode */
-                for (int fd_idx = 0; fd_idx < fd_count; fd_idx++) {
-                    char file_path[MAX_PATH_LEN];
-                    unsigned long file_inode = 0;
-                    
-                    if (get_file_path_from_fd((pid_t)proc->pid, fds[fd_idx], file_path, &file_inode) == SUCCESS) {
-                        /* Find locks that match this file (by path or inode) */
-                        for (int j = 0; j < system_lock_count; j++) {
-                            FileLockInfo* lock = &system_locks[j];
-                            
-                            /* Skip locks held by this process */
-                            if (lock->pid == proc->pid) {
-                                continue;
-                            }
-                            
-                            /* Match by file path or inode */
-                            int matches = 0;
-                            if (strlen(file_path) > 0 && strlen(lock->file_path) > 0) {
-                                if (strcmp(file_path, lock->file_path) == 0) {
-                                    matches = 1;
-                                }
-                            }
-                            if (!matches && file_inode > 0 && lock->inode > 0) {
-                                if (file_inode == lock->inode) {
-                                    matches = 1;
-                                }
-                            }
-                            
-                            if (matches) {
-                                /* This process is waiting for this lock */
-                                int lock_resource_id = lock->lock_id;
-                                
-                                /* Add to waiting resources */
-                                if (proc->waiting_resources == NULL) {
-                                    proc->waiting_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                                    proc->num_waiting = 0;
-                                }
-                                
-                                if (proc->num_waiting < MAX_RESOURCES_PER_PROCESS) {
-                                    /* Check if resource already in array */
-                                    int res_found = 0;
-                                    for (int k = 0; k < proc->num_waiting; k++) {
-                                        if (proc->waiting_resources[k] == lock_resource_id) {
-                                            res_found = 1;
-                                            break;
-                                        }
-                                    }
-                                    
-                                    if (!res_found) {
-                                        proc->waiting_resources[proc->num_waiting++] = lock_resource_id;
-                                        
-                                        /* Add waiting file */
-                                        if (proc->waiting_files == NULL) {
-                                            proc->waiting_files = (char**)safe_malloc(sizeof(char*) * MAX_RESOURCES_PER_PROCESS);
-                                            proc->num_waiting_files = 0;
-                                        }
-                                        
-                                        if (proc->num_waiting_files < MAX_RESOURCES_PER_PROCESS) {
-                                            if (strlen(lock->file_path) > 0) {
-                                                proc->waiting_files[proc->num_waiting_files] = str_dup(lock->file_path);
-                                            } else {
-                                                char lock_file_str[64];
-                                                snprintf(lock_file_str, sizeof(lock_file_str), "lock_%d", lock->lock_id);
-                                                proc->waiting_files[proc->num_waiting_files] = str_dup(lock_file_str);
-                                            }
-                                            proc->num_waiting_files++;
-                                        }
-                                        
-                                        /* Find process holding the lock and add to waiting_on_pids */
-                                        for (int k = 0; k < num_procs; k++) {
-                                            if (procs[k].pid == lock->pid) {
-                                                /* Add lock->pid to waiting_on_pids */
-                                                if (proc->waiting_on_pids == NULL) {
-                                                    proc->waiting_on_pids = (int*)safe_malloc(sizeof(int) * MAX_WAITING_PIDS);
-                                                    proc->num_waiting_on_pids = 0;
-                                                }
-                                                
-                                                if (proc->num_waiting_on_pids < MAX_WAITING_PIDS) {
-                                                    int pid_found = 0;
-                                                    for (int m = 0; m < proc->num_waiting_on_pids; m++) {
-                                                        if (proc->waiting_on_pids[m] == lock->pid) {
-                                                            pid_found = 1;
-                                                            break;
-                                                        }
-                                                    }
-                                                    
-                                                    if (!pid_found) {
-                                                        proc->waiting_on_pids[proc->num_waiting_on_pids++] = lock->pid;
-                                                    }
-                                                }
-                                                
-                                                /* Add lock as held resource for the process holding it */
-                                                if (procs[k].held_resources == NULL) {
-                                                    procs[k].held_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                                                    procs[k].num_held = 0;
-                                                }
-                                                
-                                                if (procs[k].num_held < MAX_RESOURCES_PER_PROCESS) {
-                                                    int held_found = 0;
-                                                    for (int m = 0; m < procs[k].num_held; m++) {
-                                                        if (procs[k].held_resources[m] == lock_resource_id) {
-                                                            held_found = 1;
-                                                            break;
-                                                        }
-                                                    }
-                                                    
-                                                    if (!held_found) {
-                                                        procs[k].held_resources[procs[k].num_held++] = lock_resource_id;
-                                                        
-                                                        /* Add held file */
-                                                        if (procs[k].held_files == NULL) {
-                                                            procs[k].held_files = (char**)safe_malloc(sizeof(char*) * MAX_RESOURCES_PER_PROCESS);
-                                                            procs[k].num_held_files = 0;
-                                                        }
-                                                        
-                                                        if (procs[k].num_held_files < MAX_RESOURCES_PER_PROCESS) {
-                                                            if (strlen(lock->file_path) > 0) {
-                                                                procs[k].held_files[procs[k].num_held_files] = str_dup(lock->file_path);
-                                                            } else {
-                                                                char lock_file_str[64];
-                                                                snprintf(lock_file_str, sizeof(lock_file_str), "lock_%d", lock->lock_id);
-                                                                procs[k].held_files[procs[k].num_held_files] = str_dup(lock_file_str);
-                                                            }
-                                                            procs[k].num_held_files++;
-                                                        }
-                                                    }
-                                                }
-                                                break;
-                                            }
-                                        }
-                                    }
-                                }
-                            }
-                        }
-                    }
-                }
-                
-                free(fds);
-            }
+        if (proc->is_blocked_on_lock && !covered[i]) {
+            analyze_lock_wait(procs, num_procs, i, &locks, by_pid);
         }
         
-        /* Step 5: Also check for processes that hold locks but are blocked waiting for other locks */
-        /* This handles the case where process holds lock1 and waits for lock2 */
-        if (system_locks != NULL && system_lock_count > 0) {
-            /* Find all locks held by this process */
-            for (int j = 0; j < system_lock_count; j++) {
-                FileLockInfo* lock = &system_locks[j];
-                if (lock->pid == proc->pid) {
-                    /* Process holds this lock - add to held resources if not already there */
-                    int lock_resource_id = lock->lock_id;
-                    
-                    if (proc->held_resources == NULL) {
-                        proc->held_resources = (int*)safe_malloc(sizeof(int) * MAX_RESOURCES_PER_PROCESS);
-                        proc->num_held = 0;
-                    }
-                    
-                    if (proc->num_held < MAX_RESOURCES_PER_PROCESS) {
-                        int held_found = 0;
-                        for (int k = 0; k < proc->num_held; k++) {
-                            if (proc->held_resources[k] == lock_resource_id) {
-                                held_found = 1;
-                                break;
-                            }
-                        }
-                        
-                        if (!held_found) {
-                            proc->held_resources[proc->num_held++] = lock_resource_id;
-                            
-                            /* Add held file */
-                            if (proc->held_files == NULL) {
-                                proc->held_files = (char**)safe_malloc(sizeof(char*) * MAX_RESOURCES_PER_PROCESS);
-                                proc->num_held_files = 0;
-                            }
-                            
-                            if (proc->num_held_files < MAX_RESOURCES_PER_PROCESS) {
-                                if (strlen(lock->file_path) > 0) {
-                                    proc->held_files[proc->num_held_files] = str_dup(lock->file_path);
-                                } else {
-                                    char lock_file_str[64];
-                                    snprintf(lock_file_str, sizeof(lock_file_str), "lock_%d", lock->lock_id);
-                                    proc->held_files[proc->num_held_files] = str_dup(lock_file_str);
-                                }
-                                proc->num_held_files++;
-                            }
-                        }
-                    }
-                }
-            }
+        /* Step 5: Also record the locks this process holds, so a process
+         * holding lock1 while waiting for lock2 is part of the graph */
+        for (int j = lock_index_first_by_pid(&locks, proc->pid); j >= 0;
+             j = locks.next_by_pid[j]) {
+            record_lock(proc, &proc->held_resources, &proc->num_held,
+                        &proc->held_files, &proc->num_held_files, &locks.locks[j]);
         }
     }
     
     /* Cleanup */
-    if (system_locks != NULL) {
-        free_file_lock_info(system_locks, system_lock_count);
-    }
+    free(by_pid);
+    free(covered);
+    free_lock_index(&locks);
     
     return SUCCESS;
 }
@@ -35,8 +35,19 @@ typedef struct {
     int timestamp;                   /* Detection timestamp (Unix time) */
     int total_processes_scanned;     /* Total number of processes analyzed */
     int total_resources_found;       /* Total number of resources found */
+    Arena* arena;                    /* Scan arena backing the arrays and strings above
+                                        (not owned; NULL = individually heap-allocated) */
 } DeadlockReport;
 
+/*
+ * DeadlockCycleFilterFn - Callback for detect_deadlock_filtered()
+ * @context: Caller-supplied context
+ * @pids: Processes of one detected cycle
+ * @num_pids: Number of processes
+ * @return: 1 to report the cycle, 0 to drop it, negative error code to stop
+ */
+typedef int (*DeadlockCycleFilterFn)(void* context, const int* pids, int num_pids);
+
 /* =============================================================================
  * FUNCTION PROTOTYPES
  * =============================================================================
@@ -53,6 +64,8 @@ typedef struct {
  *              2. Runs cycle detection algorithm
  *              3. Analyzes cycles to determine actual deadlocks
  *              4. Generates comprehensive report
+ *              It does not send alerts; callers alert on the status they
+ *              finally report.
  *              Time complexity: O(V + E + C) where V=vertices, E=edges, C=cycles
  * Error handling: Returns negative error code on failure, fills report with
  *                 partial results if possible
@@ -60,6 +73,44 @@ typedef struct {
 int detect_deadlock_in_system(ProcessResourceInfo* procs, int num_procs,
                               DeadlockReport* report);
 
+/*
+ * detect_deadlock_filtered - Detect deadlocks, reporting only cycles a filter keeps
+ * @procs: Array of ProcessResourceInfo structures for all processes
+ * @num_procs: Number of processes in array
+ * @report: Output parameter for deadlock report
+ * @keep: Called once per detected cycle (NULL = keep every cycle)
+ * @context: Passed to keep
+ * @return: 1 if a kept cycle remains, 0 if none, negative on error
+ * Description: detect_deadlock_in_system() with a decision per cycle before
+ *              step 4, so that one dropped cycle does not hide another.
+ *              Kept cycles keep their order, deadlocked_pids is rebuilt
+ *              from them alone, and explanations and recommendations are
+ *              generated for them only.
+ * Error handling: A negative filter result stops filtering and is returned;
+ *                 the report then still holds the unfiltered cycles
+ */
+int detect_deadlock_filtered(ProcessResourceInfo* procs, int num_procs,
+                             DeadlockReport* report,
+                             DeadlockCycleFilterFn keep, void* context);
+
+/*
+ * find_deadlock_cycles - Build the RAG and record its deadlock cycles
+ * @procs: Array of ProcessResourceInfo structures
+ * @num_procs: Number of processes
+ * @report: Report to fill with cycles and deadlocked PIDs
+ * @graph: Output parameter for the built graph (caller frees with
+ *         free_graph(); NULL = freed before returning)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Steps 1-3 of detect_deadlock_in_system() without
+ *              explanations or recommendations, for callers that only need
+ *              to know which processes are deadlocked.
+ *              Time complexity: O(V + E + C)
+ * Error handling: Returns error codes for invalid arguments, allocation
+ *                 failures or graph errors
+ */
+int find_deadlock_cycles(ProcessResourceInfo* procs, int num_procs,
+                         DeadlockReport* report, ResourceGraph** graph);
+
 /*
  * build_rag_from_processes - Build Resource Allocation Graph from process info
  * @procs: Array of ProcessResourceInfo structures
@@ -67,8 +118,8 @@ int detect_deadlock_in_system(ProcessResourceInfo* procs, int num_procs,
  * @graph: Output parameter for created RAG
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Constructs RAG by adding processes, resources, and edges
- *              based on ProcessResourceInfo data. Creates vertices and edges
- *              for allocations and requests.
+ *              based on ProcessResourceInfo data. Edges are queued into the
+ *              graph's key buffer and frozen into CSR form once at the end.
  *              Time complexity: O(P * R) where P=processes, R=resources per process
  * Error handling: Returns error codes for allocation failures or invalid data
  */
@@ -167,6 +218,7 @@ int generate_explanations(DeadlockReport* report, const ResourceGraph* graph);
  * @return: None
  * Description: Frees all dynamically allocated arrays and strings in report,
  *              including cycles, PIDs, explanations, and recommendations.
+ *              An arena-backed report only drops its pointers.
  *              Safe to call with NULL pointer.
  * Error handling: Handles NULL pointer and partially initialized reports safely
  */
@@ -194,7 +246,15 @@ int is_deadlock_definite(const CycleInfo* cycle, const ResourceGraph* graph);
  *              which processes are waiting on which resources/processes.
  *              Updates ProcessResourceInfo structures with waiting resources
  *              and waiting_on_pids. This enables detection of pipe and lock deadlocks.
- *              Time complexity: O(P * L + P * F) where P=processes, L=locks, F=FDs
+ *              Pipe peers are found through a pipe inode index.
+ *              Decoded blocking syscalls (ProcessResourceInfo.wait) narrow a
+ *              wait to the pipe or lock behind one FD; child waits become
+ *              edges to the waiter's collected children.
+ *              /proc/locks is tokenized once into a LockIndex; its blocked
+ *              request ("->") lines become lock wait edges directly, and
+ *              only processes they do not cover are matched by FD.
+ *              Time complexity: O(E + P log P + L + F) expected, where
+ *              E=pipe endpoints, P=processes, L=locks, F=FDs
  * Error handling: Returns error codes for allocation or access issues
  */
 int analyze_pipe_and_lock_dependencies(ProcessResourceInfo* procs, int num_procs);
@@ -0,0 +1,240 @@
+/* =============================================================================
+ * EVENT_LOOP.C - Continuous Monitoring Wait Loop Implementation
+ * =============================================================================
+ * timerfd with absolute deadlines plus signalfd, multiplexed with poll().
+ * =============================================================================
+ */
+
+#include "event_loop.h"
+#include "utility.h"
+#include "config.h"
+#include <string.h>
+#include <errno.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/signalfd.h>
+#include <sys/timerfd.h>
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+#define NS_PER_MS 1000000LL
+#define NS_PER_SEC 1000000000LL
+
+static long long timespec_to_ns(const struct timespec* ts)
+{
+    return (long long)ts->tv_sec * NS_PER_SEC + ts->tv_nsec;
+}
+
+static struct timespec ns_to_timespec(long long ns)
+{
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ns / NS_PER_SEC);
+    ts.tv_nsec = (long)(ns % NS_PER_SEC);
+    return ts;
+}
+
+/*
+ * set_timer - Arm the timerfd for the current deadline
+ * @loop: Open loop
+ * @return: SUCCESS (0) on success, ERROR_SYSTEM_CALL_FAILED on failure
+ */
+static int set_timer(EventLoop* loop)
+{
+    struct itimerspec spec;
+    memset(&spec, 0, sizeof(spec));
+    spec.it_value = loop->deadline;
+
+    /* A zero it_value would disarm the timer instead of firing it */
+    if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) {
+        spec.it_value.tv_nsec = 1;
+    }
+
+    if (timerfd_settime(loop->timer_fd, TFD_TIMER_ABSTIME, &spec, NULL) != 0) {
+        error_log("timerfd_settime failed: %s", strerror(errno));
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+    return SUCCESS;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * event_loop_open - Block the watched signals and create the descriptors
+ * @loop: Loop to initialize
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+int event_loop_open(EventLoop* loop)
+{
+    if (loop == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(loop, 0, sizeof(*loop));
+    loop->timer_fd = -1;
+    loop->signal_fd = -1;
+
+    sigemptyset(&loop->signals);
+    sigaddset(&loop->signals, SIGINT);
+    sigaddset(&loop->signals, SIGTERM);
+    sigaddset(&loop->signals, SIGHUP);
+
+    /* Blocked signals stay pending until read from the signalfd */
+    if (pthread_sigmask(SIG_BLOCK, &loop->signals, &loop->old_mask) != 0) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    loop->signal_fd = signalfd(-1, &loop->signals, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (loop->signal_fd < 0) {
+        error_log("signalfd failed: %s", strerror(errno));
+        pthread_sigmask(SIG_SETMASK, &loop->old_mask, NULL);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    loop->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (loop->timer_fd < 0) {
+        error_log("timerfd_create failed: %s", strerror(errno));
+        event_loop_close(loop);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &loop->deadline);
+    return SUCCESS;
+}
+
+/*
+ * event_loop_arm - Schedule the next tick
+ * @loop: Open loop
+ * @delay_ms: Time from the previous tick to the next one
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+int event_loop_arm(EventLoop* loop, long delay_ms)
+{
+    if (loop == NULL || loop->timer_fd < 0 || delay_ms <= 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    long long period = (long long)delay_ms * NS_PER_MS;
+    long long next = timespec_to_ns(&loop->deadline) + period;
+    long long now_ns = timespec_to_ns(&now);
+
+    /* Skip whole periods the scan overran instead of firing them at once */
+    if (next <= now_ns) {
+        long long missed = (now_ns - next) / period + 1;
+        next += missed * period;
+        loop->overruns += (unsigned long)missed;
+    }
+
+    loop->deadline = ns_to_timespec(next);
+    return set_timer(loop);
+}
+
+/*
+ * event_loop_rearm_now - Make the next tick due immediately
+ * @loop: Open loop
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+int event_loop_rearm_now(EventLoop* loop)
+{
+    if (loop == NULL || loop->timer_fd < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &loop->deadline);
+    return set_timer(loop);
+}
+
+/*
+ * event_loop_wait - Sleep until the next tick or a watched signal
+ * @loop: Open loop
+ * @signal_out: Receives the signal number for EVENT_LOOP_SIGNAL (may be NULL)
+ * @return: EVENT_LOOP_TIMER, EVENT_LOOP_SIGNAL, or negative error code
+ */
+int event_loop_wait(EventLoop* loop, int* signal_out)
+{
+    if (loop == NULL || loop->timer_fd < 0 || loop->signal_fd < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    for (;;) {
+        struct pollfd fds[2];
+        fds[0].fd = loop->signal_fd;
+        fds[0].events = POLLIN;
+        fds[0].revents = 0;
+        fds[1].fd = loop->timer_fd;
+        fds[1].events = POLLIN;
+        fds[1].revents = 0;
+
+        if (poll(fds, 2, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_log("poll failed: %s", strerror(errno));
+            return ERROR_SYSTEM_CALL_FAILED;
+        }
+
+        if (fds[0].revents & POLLIN) {
+            struct signalfd_siginfo info;
+            ssize_t n = read(loop->signal_fd, &info, sizeof(info));
+            if (n == (ssize_t)sizeof(info)) {
+                if (signal_out != NULL) {
+                    *signal_out = (int)info.ssi_signo;
+                }
+                return EVENT_LOOP_SIGNAL;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                error_log("signalfd read failed: %s", strerror(errno));
+                return ERROR_SYSTEM_CALL_FAILED;
+            }
+        }
+
+        if (fds[1].revents & POLLIN) {
+            uint64_t expirations;
+            ssize_t n = read(loop->timer_fd, &expirations, sizeof(expirations));
+            if (n == (ssize_t)sizeof(expirations)) {
+                return EVENT_LOOP_TIMER;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EINTR) {
+                error_log("timerfd read failed: %s", strerror(errno));
+                return ERROR_SYSTEM_CALL_FAILED;
+            }
+        }
+    }
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * event_loop_close - Close the descriptors and restore the signal mask
+ * @loop: Loop to clean up
+ * @return: None
+ */
+void event_loop_close(EventLoop* loop)
+{
+    if (loop == NULL || (loop->timer_fd < 0 && loop->signal_fd < 0)) {
+        return;
+    }
+
+    if (loop->timer_fd >= 0) {
+        close(loop->timer_fd);
+        loop->timer_fd = -1;
+    }
+    if (loop->signal_fd >= 0) {
+        close(loop->signal_fd);
+        loop->signal_fd = -1;
+    }
+    pthread_sigmask(SIG_SETMASK, &loop->old_mask, NULL);
+}
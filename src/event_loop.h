@@ -0,0 +1,109 @@
+#ifndef EVENT_LOOP_H
+#define EVENT_LOOP_H
+
+/* =============================================================================
+ * EVENT_LOOP.H - Continuous Monitoring Wait Loop Interface
+ * =============================================================================
+ * This header defines what the monitor waits on between scans: a timerfd
+ * armed with absolute CLOCK_MONOTONIC deadlines, so the time a scan takes
+ * does not push later scans back, and a signalfd receiving SIGINT, SIGTERM
+ * and SIGHUP as ordinary reads instead of through an asynchronous handler.
+ * Both are waited on with a single poll().
+ * =============================================================================
+ */
+
+#include <signal.h>
+#include <time.h>
+#include "config.h"
+
+/* =============================================================================
+ * CONSTANTS
+ * =============================================================================
+ */
+
+#define EVENT_LOOP_TIMER 1             /* The armed deadline passed */
+#define EVENT_LOOP_SIGNAL 2            /* A watched signal arrived */
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * EventLoop - Timer and signal descriptors of the monitoring loop
+ */
+typedef struct {
+    int timer_fd;                   /* CLOCK_MONOTONIC timerfd (-1 = closed) */
+    int signal_fd;                  /* signalfd for the watched signals (-1 = closed) */
+    sigset_t signals;               /* Watched signals, blocked while open */
+    sigset_t old_mask;              /* Signal mask to restore on close */
+    struct timespec deadline;       /* Absolute time of the next tick */
+    unsigned long overruns;         /* Ticks skipped because a scan ran past them */
+} EventLoop;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * event_loop_open - Block the watched signals and create the descriptors
+ * @loop: Loop to initialize
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Blocks SIGINT, SIGTERM and SIGHUP in the calling thread and
+ *              routes them to a signalfd. Threads created afterwards inherit
+ *              the mask, so open the loop before starting any, or a signal
+ *              may be delivered to a thread that still runs the default
+ *              action. No tick is armed until event_loop_rearm_now() or
+ *              event_loop_arm() is called.
+ * Error handling: Restores the signal mask and returns
+ *                 ERROR_SYSTEM_CALL_FAILED if a descriptor cannot be created
+ */
+int event_loop_open(EventLoop* loop);
+
+/*
+ * event_loop_arm - Schedule the next tick
+ * @loop: Open loop
+ * @delay_ms: Time from the previous tick to the next one
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: The deadline advances from the previous deadline, not from
+ *              now, so time spent scanning is not added to the period. If
+ *              the scan ran past one or more whole periods those ticks are
+ *              skipped (counted in overruns) rather than fired back to back.
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for a closed loop or a
+ *                 non-positive delay, ERROR_SYSTEM_CALL_FAILED if
+ *                 timerfd_settime() fails
+ */
+int event_loop_arm(EventLoop* loop, long delay_ms);
+
+/*
+ * event_loop_rearm_now - Make the next tick due immediately
+ * @loop: Open loop
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Later ticks are scheduled from the current time.
+ */
+int event_loop_rearm_now(EventLoop* loop);
+
+/*
+ * event_loop_wait - Sleep until the next tick or a watched signal
+ * @loop: Open loop
+ * @signal_out: Receives the signal number for EVENT_LOOP_SIGNAL (may be NULL)
+ * @return: EVENT_LOOP_TIMER, EVENT_LOOP_SIGNAL, or negative error code
+ * Description: A pending signal is reported before a pending tick, so a
+ *              shutdown request is never delayed by another scan.
+ * Error handling: Retries poll() on EINTR; returns ERROR_SYSTEM_CALL_FAILED
+ *                 if poll() or a read fails otherwise
+ */
+int event_loop_wait(EventLoop* loop, int* signal_out);
+
+/*
+ * event_loop_close - Close the descriptors and restore the signal mask
+ * @loop: Loop to clean up
+ * @return: None
+ * Description: Watched signals still pending are delivered to their
+ *              handlers once the mask is restored.
+ * Error handling: Handles NULL pointer and closed loops safely
+ */
+void event_loop_close(EventLoop* loop);
+
+#endif /* EVENT_LOOP_H */
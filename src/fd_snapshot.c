@@ -0,0 +1,415 @@
+/* =============================================================================
+ * FD_SNAPSHOT.C - Per-Scan File Descriptor Snapshot Implementation
+ * =============================================================================
+ * Lists /proc/[PID]/fd once per process per scan and classifies every link
+ * target once, so the collectors that need FD information share one view.
+ * Listing goes through the process's ProcHandle (getdents64 + readlinkat).
+ * =============================================================================
+ */
+
+#include "fd_snapshot.h"
+#include "utility.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+#define FD_TABLE_INITIAL_CAPACITY 16
+#define FD_SNAPSHOT_INITIAL_CAPACITY 256
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * parse_bracket_inode - Parse the inode out of "<prefix>[inode]"
+ * @target: Link target text
+ * @prefix_len: Length of prefix up to and including '['
+ * @inode: Output parameter for inode
+ * @return: 1 if parsed, 0 otherwise
+ */
+static int parse_bracket_inode(const char* target, size_t prefix_len,
+                               unsigned long* inode)
+{
+    char* endptr;
+    unsigned long value = strtoul(target + prefix_len, &endptr, 10);
+
+    if (endptr == target + prefix_len || *endptr != ']') {
+        return 0;
+    }
+
+    *inode = value;
+    return 1;
+}
+
+/*
+ * classify_fd_target - Classify a link target and fill the entry
+ * @target: NUL-terminated link target
+ * @entry: Entry to fill (fd already set)
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY if path copy fails
+ */
+static int classify_fd_target(const char* target, FdEntry* entry)
+{
+    entry->kind = FD_KIND_OTHER;
+    entry->inode = 0;
+    entry->device = 0;
+    entry->inode_resolved = 0;
+    entry->pipe_end = PIPE_END_UNKNOWN;
+    entry->path = NULL;
+
+    if (strncmp(target, "pipe:[", 6) == 0) {
+        if (parse_bracket_inode(target, 6, &entry->inode)) {
+            entry->kind = FD_KIND_PIPE;
+            entry->inode_resolved = 1;
+        }
+        return SUCCESS;
+    }
+
+    if (strncmp(target, "socket:[", 8) == 0) {
+        if (parse_bracket_inode(target, 8, &entry->inode)) {
+            entry->kind = FD_KIND_SOCKET;
+            entry->inode_resolved = 1;
+        }
+        return SUCCESS;
+    }
+
+    if (strncmp(target, "anon_inode:", 11) == 0) {
+        entry->kind = FD_KIND_ANON;
+        entry->inode_resolved = 1;
+        return SUCCESS;
+    }
+
+    if (target[0] == '/') {
+        entry->path = str_dup(target);
+        if (entry->path == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        entry->kind = FD_KIND_FILE;
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * fd_table_reserve - Make room for one more entry in a table
+ * @table: Table to grow
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+static int fd_table_reserve(FdTable* table)
+{
+    if (table->num_entries < table->capacity) {
+        return SUCCESS;
+    }
+
+    int new_capacity = table->capacity == 0 ?
+        FD_TABLE_INITIAL_CAPACITY : table->capacity * 2;
+    FdEntry* new_entries = (FdEntry*)safe_realloc(
+        table->entries, sizeof(FdEntry) * new_capacity);
+    if (new_entries == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+
+    table->entries = new_entries;
+    table->capacity = new_capacity;
+    return SUCCESS;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * fd_snapshot_prepare - Size a snapshot for a new scan
+ * @snapshot: Snapshot to prepare (zero-initialized on first use)
+ * @num_slots: Number of process slots needed for this scan
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Clears leftover tables and grows the table array if needed.
+ *              Newly added tables start empty.
+ * Error handling: Returns ERROR_OUT_OF_MEMORY if the table array cannot grow
+ */
+int fd_snapshot_prepare(FdSnapshot* snapshot, int num_slots)
+{
+    if (snapshot == NULL || num_slots < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    for (int i = 0; i < snapshot->num_tables; i++) {
+        fd_table_clear(&snapshot->tables[i]);
+    }
+    snapshot->num_tables = 0;
+
+    if (num_slots > snapshot->capacity) {
+        int new_capacity = snapshot->capacity == 0 ?
+            FD_SNAPSHOT_INITIAL_CAPACITY : snapshot->capacity;
+        while (new_capacity < num_slots) {
+            new_capacity *= 2;
+        }
+
+        FdTable* new_tables = (FdTable*)safe_realloc(
+            snapshot->tables, sizeof(FdTable) * new_capacity);
+        if (new_tables == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+
+        memset(&new_tables[snapshot->capacity], 0,
+               sizeof(FdTable) * (new_capacity - snapshot->capacity));
+        snapshot->tables = new_tables;
+        snapshot->capacity = new_capacity;
+    }
+
+    snapshot->num_tables = num_slots;
+    return SUCCESS;
+}
+
+/*
+ * fd_pipe_end_from_fdinfo - Tell which end of a pipe an FD is
+ * @fdinfo: Contents of /proc/[PID]/fdinfo/[FD] (may be NULL)
+ * @return: PIPE_END_READ, PIPE_END_WRITE, or PIPE_END_UNKNOWN
+ * Description: pipe(2) opens the read end O_RDONLY and the write end
+ *              O_WRONLY; the kernel prints the file flags in octal.
+ */
+int fd_pipe_end_from_fdinfo(const char* fdinfo)
+{
+    if (fdinfo == NULL) {
+        return PIPE_END_UNKNOWN;
+    }
+
+    const char* line = strstr(fdinfo, "flags:");
+    if (line == NULL || (line != fdinfo && line[-1] != '\n')) {
+        return PIPE_END_UNKNOWN;
+    }
+
+    char* endptr;
+    unsigned long flags = strtoul(line + 6, &endptr, 8);
+    if (endptr == line + 6) {
+        return PIPE_END_UNKNOWN;
+    }
+
+    switch (flags & O_ACCMODE) {
+        case O_RDONLY:
+            return PIPE_END_READ;
+        case O_WRONLY:
+            return PIPE_END_WRITE;
+        default:
+            return PIPE_END_UNKNOWN;
+    }
+}
+
+/*
+ * FdCollectContext - State shared with collect_fd_entry during one listing
+ */
+typedef struct {
+    ProcHandle* handle;             /* Handle of the process being listed */
+    FdTable* table;                 /* Table being filled */
+} FdCollectContext;
+
+/*
+ * collect_fd_entry - Read, classify and append one FD
+ * @context: FdCollectContext
+ * @fd: File descriptor number
+ * @name: Entry name in the fd directory
+ * @return: SUCCESS (0) to continue, ERROR_OUT_OF_MEMORY to stop
+ */
+static int collect_fd_entry(void* context, int fd, const char* name)
+{
+    FdCollectContext* ctx = (FdCollectContext*)context;
+    FdTable* table = ctx->table;
+    char link_target[MAX_PATH_LEN];
+
+    if (proc_handle_readlink_fd(ctx->handle, name, link_target,
+                                sizeof(link_target)) < 0) {
+        return SUCCESS; /* FD closed meanwhile */
+    }
+
+    int result = fd_table_reserve(table);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    FdEntry* entry = &table->entries[table->num_entries];
+    entry->fd = fd;
+    result = classify_fd_target(link_target, entry);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    if (entry->kind == FD_KIND_PIPE) {
+        /* Which end this is, read while the fd directory is being walked */
+        char fdinfo_name[32];
+        snprintf(fdinfo_name, sizeof(fdinfo_name), "fdinfo/%s", name);
+        entry->pipe_end = fd_pipe_end_from_fdinfo(
+            proc_handle_read(ctx->handle, fdinfo_name, thread_read_buffer(), NULL));
+        table->num_pipes++;
+    } else if (entry->kind == FD_KIND_FILE) {
+        table->num_files++;
+    }
+    table->num_entries++;
+    return SUCCESS;
+}
+
+/*
+ * fd_table_collect_at - List and classify FDs through an open process handle
+ * @handle: Open handle of the process to inspect
+ * @table: Table to fill (previous contents are discarded)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: One getdents64 walk over the handle's fd directory with one
+ *              readlinkat() per entry; no paths are formatted.
+ * Error handling: Returns error codes for directory access failures; FDs
+ *                 that disappear between listing and readlinkat are skipped
+ */
+int fd_table_collect_at(ProcHandle* handle, FdTable* table)
+{
+    if (handle == NULL || table == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    fd_table_clear(table);
+    table->pid = handle->pid;
+
+    FdCollectContext ctx = { handle, table };
+    return proc_handle_for_each_fd(handle, collect_fd_entry, &ctx);
+}
+
+/*
+ * fd_table_collect - List and classify a process's file descriptors
+ * @pid: Process ID to inspect
+ * @table: Table to fill (previous contents are discarded)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Opens a temporary handle for pid and calls
+ *              fd_table_collect_at().
+ * Error handling: Returns error codes for directory access failures
+ */
+int fd_table_collect(pid_t pid, FdTable* table)
+{
+    if (table == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        fd_table_clear(table);
+        table->pid = pid;
+        return result;
+    }
+
+    result = fd_table_collect_at(&handle, table);
+    proc_handle_close(&handle);
+    return result;
+}
+
+/*
+ * fd_entry_resolve_inode - Resolve inode and device of a file entry
+ * @table: Table the entry belongs to
+ * @entry: Entry to resolve
+ * @return: SUCCESS (0) if inode is known, negative error code otherwise
+ * Description: stat() on the /proc fd link follows it to the open file, so a
+ *              single call yields both inode and device even if the path was
+ *              since renamed or unlinked. The result is cached in the entry.
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED if stat fails
+ */
+int fd_entry_resolve_inode(const FdTable* table, FdEntry* entry)
+{
+    if (table == NULL || entry == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    if (entry->inode_resolved) {
+        return entry->inode != 0 ? SUCCESS : ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    entry->inode_resolved = 1;
+
+    char fd_path[MAX_PATH_LEN];
+    int result = snprintf(fd_path, sizeof(fd_path), "%s/%d/%s/%d",
+                          PROC_BASE_PATH, (int)table->pid, PROC_FD_DIR, entry->fd);
+    if (result < 0 || (size_t)result >= sizeof(fd_path)) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    struct stat st;
+    if (stat(fd_path, &st) != 0) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    entry->inode = (unsigned long)st.st_ino;
+    entry->device = st.st_dev;
+    return SUCCESS;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * fd_table_clear - Discard entries of a table but keep its storage
+ * @table: Table to clear
+ * @return: None
+ * Description: Frees per-entry paths and resets counters.
+ * Error handling: Handles NULL pointer safely
+ */
+void fd_table_clear(FdTable* table)
+{
+    if (table == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < table->num_entries; i++) {
+        if (table->entries[i].path != NULL) {
+            free(table->entries[i].path);
+            table->entries[i].path = NULL;
+        }
+    }
+
+    table->num_entries = 0;
+    table->num_pipes = 0;
+    table->num_files = 0;
+}
+
+/*
+ * free_fd_table - Free all memory owned by a table
+ * @table: Table to clean up
+ * @return: None
+ * Description: Frees entries and their paths. Does not free the table itself.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_fd_table(FdTable* table)
+{
+    if (table == NULL) {
+        return;
+    }
+
+    fd_table_clear(table);
+    safe_free((void**)&table->entries);
+    table->capacity = 0;
+}
+
+/*
+ * free_fd_snapshot - Free all memory owned by a snapshot
+ * @snapshot: Snapshot to clean up
+ * @return: None
+ * Description: Frees every allocated table and the table array.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_fd_snapshot(FdSnapshot* snapshot)
+{
+    if (snapshot == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < snapshot->capacity; i++) {
+        free_fd_table(&snapshot->tables[i]);
+    }
+
+    safe_free((void**)&snapshot->tables);
+    snapshot->num_tables = 0;
+    snapshot->capacity = 0;
+}
@@ -0,0 +1,182 @@
+#ifndef FD_SNAPSHOT_H
+#define FD_SNAPSHOT_H
+
+/* =============================================================================
+ * FD_SNAPSHOT.H - Per-Scan File Descriptor Snapshot Interface
+ * =============================================================================
+ * This header defines a snapshot of every scanned process's open file
+ * descriptors. Each /proc/[PID]/fd directory is listed once per scan and each
+ * link target is read and classified once; all later stages (resource
+ * collection, pipe matching, lock matching) consume the snapshot instead of
+ * going back to /proc.
+ * =============================================================================
+ */
+
+#include <sys/types.h>
+#include "config.h"
+#include "proc_handle.h"
+
+/* =============================================================================
+ * FD KINDS
+ * =============================================================================
+ */
+#define FD_KIND_OTHER 0             /* Unclassified target (e.g. /dev/null) */
+#define FD_KIND_FILE 1              /* Path on a filesystem */
+#define FD_KIND_PIPE 2              /* "pipe:[inode]" */
+#define FD_KIND_SOCKET 3            /* "socket:[inode]" */
+#define FD_KIND_ANON 4              /* "anon_inode:..." */
+
+/* =============================================================================
+ * PIPE ENDS
+ * =============================================================================
+ */
+#define PIPE_END_UNKNOWN 0          /* Access mode unknown or O_RDWR */
+#define PIPE_END_READ 1             /* Opened O_RDONLY */
+#define PIPE_END_WRITE 2            /* Opened O_WRONLY */
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * FdEntry - One open file descriptor of a process
+ * For pipes and sockets the inode comes straight from the link target.
+ * For files the inode and device are resolved lazily on first use.
+ */
+typedef struct {
+    int fd;                         /* File descriptor number */
+    int kind;                       /* FD_KIND_* classification */
+    unsigned long inode;            /* Pipe/socket inode, or file inode once resolved */
+    dev_t device;                   /* Device of file (valid once resolved) */
+    int inode_resolved;             /* 1 if inode/device lookup was attempted */
+    int pipe_end;                   /* PIPE_END_* for FD_KIND_PIPE, from fdinfo flags */
+    char* path;                     /* Link target for FD_KIND_FILE, NULL otherwise */
+} FdEntry;
+
+/*
+ * FdTable - All open file descriptors of one process
+ * Entry storage is kept when the table is cleared so it can be refilled on
+ * the next scan without reallocating.
+ */
+typedef struct {
+    pid_t pid;                      /* Process ID this table describes */
+    FdEntry* entries;               /* Array of file descriptor entries */
+    int num_entries;                /* Number of valid entries */
+    int capacity;                   /* Allocated capacity of entries array */
+    int num_pipes;                  /* Number of FD_KIND_PIPE entries */
+    int num_files;                  /* Number of FD_KIND_FILE entries */
+} FdTable;
+
+/*
+ * FdSnapshot - File descriptor tables for all processes of one scan
+ * Tables are addressed by scan slot; the caller decides the slot layout.
+ */
+typedef struct {
+    FdTable* tables;                /* Array of per-process tables */
+    int num_tables;                 /* Number of tables in use this scan */
+    int capacity;                   /* Allocated capacity of tables array */
+} FdSnapshot;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * fd_snapshot_prepare - Size a snapshot for a new scan
+ * @snapshot: Snapshot to prepare (zero-initialized on first use)
+ * @num_slots: Number of process slots needed for this scan
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Clears all tables left over from the previous scan and makes
+ *              sure at least num_slots tables are available. Existing table
+ *              storage is reused.
+ *              Time complexity: O(previous entries + num_slots)
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for bad parameters,
+ *                 ERROR_OUT_OF_MEMORY if the table array cannot grow
+ */
+int fd_snapshot_prepare(FdSnapshot* snapshot, int num_slots);
+
+/*
+ * fd_table_collect - List and classify a process's file descriptors
+ * @pid: Process ID to inspect
+ * @table: Table to fill (previous contents are discarded)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Lists /proc/[PID]/fd once and reads each link target once,
+ *              classifying it as pipe, socket, anon inode or file. Pipe and
+ *              socket inodes are parsed from the link text; file inodes are
+ *              left for fd_entry_resolve_inode(). Pipe FDs also have their
+ *              fdinfo read to record which end they are.
+ *              Time complexity: O(f) where f is number of FDs
+ * Error handling: Returns ERROR_FILE_NOT_FOUND if the process exited,
+ *                 ERROR_PERMISSION_DENIED if the fd directory is not readable.
+ *                 FDs closed while listing are skipped silently.
+ */
+int fd_table_collect(pid_t pid, FdTable* table);
+
+/*
+ * fd_table_collect_at - List and classify FDs through an open process handle
+ * @handle: Open handle of the process to inspect
+ * @table: Table to fill (previous contents are discarded)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Same as fd_table_collect() but resolves the fd directory and
+ *              every link relative to handle, so collectors that already
+ *              hold a handle pay no extra path walks.
+ *              Time complexity: O(f) where f is number of FDs
+ * Error handling: Same as fd_table_collect()
+ */
+int fd_table_collect_at(ProcHandle* handle, FdTable* table);
+
+/*
+ * fd_pipe_end_from_fdinfo - Tell which end of a pipe an FD is
+ * @fdinfo: Contents of /proc/[PID]/fdinfo/[FD] (may be NULL)
+ * @return: PIPE_END_READ, PIPE_END_WRITE, or PIPE_END_UNKNOWN
+ * Description: Decodes the access mode of the octal "flags:" line.
+ *              Time complexity: O(length of fdinfo)
+ * Error handling: Returns PIPE_END_UNKNOWN for NULL input, a missing flags
+ *                 line, or O_RDWR (e.g. a FIFO opened for both)
+ */
+int fd_pipe_end_from_fdinfo(const char* fdinfo);
+
+/*
+ * fd_entry_resolve_inode - Resolve inode and device of a file entry
+ * @table: Table the entry belongs to
+ * @entry: Entry to resolve
+ * @return: SUCCESS (0) if inode is known, negative error code otherwise
+ * Description: stat()s /proc/[PID]/fd/[FD] on first call and caches the
+ *              result in the entry; later calls return immediately.
+ *              Pipe and socket entries are always resolved.
+ *              Time complexity: O(1)
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED if stat fails
+ */
+int fd_entry_resolve_inode(const FdTable* table, FdEntry* entry);
+
+/*
+ * fd_table_clear - Discard entries of a table but keep its storage
+ * @table: Table to clear
+ * @return: None
+ * Description: Frees per-entry paths and resets counters.
+ * Error handling: Handles NULL pointer safely
+ */
+void fd_table_clear(FdTable* table);
+
+/*
+ * free_fd_table - Free all memory owned by a table
+ * @table: Table to clean up
+ * @return: None
+ * Description: Frees entries and their paths. Does not free the table itself.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_fd_table(FdTable* table);
+
+/*
+ * free_fd_snapshot - Free all memory owned by a snapshot
+ * @snapshot: Snapshot to clean up
+ * @return: None
+ * Description: Frees every table and the table array. Does not free the
+ *              snapshot structure itself.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_fd_snapshot(FdSnapshot* snapshot);
+
+#endif /* FD_SNAPSHOT_H */
@@ -0,0 +1,393 @@
+/* =============================================================================
+ * LOCK_INDEX.C - System Lock Table Index Implementation
+ * =============================================================================
+ * Single-read tokenizer for /proc/locks plus open-addressing hashes from
+ * inode and from holder PID to chains of parsed locks. Blocked requests are
+ * kept in a side array pointing at the lock they are listed under.
+ * =============================================================================
+ */
+
+#include "lock_index.h"
+#include "proc_handle.h"
+#include "utility.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/sysmacros.h>
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * hash_key - Hash an inode or PID into a power-of-two table
+ * @key: Key to hash
+ * @mask: Table size minus one
+ * @return: Initial probe position
+ */
+static int hash_key(unsigned long key, int mask)
+{
+    unsigned long long h = (unsigned long long)key * 0x9E3779B97F4A7C15ULL;
+    return (int)(h >> 32) & mask;
+}
+
+/*
+ * find_slot - Find the slot of key, or the empty slot ending its probe
+ * @slots: Table to search
+ * @num_slots: Table size (power of two, never full)
+ * @key: Inode or PID
+ * @return: Slot index
+ */
+static int find_slot(const LockIndexSlot* slots, int num_slots, unsigned long key)
+{
+    int mask = num_slots - 1;
+    int pos = hash_key(key, mask);
+
+    while (slots[pos].head >= 0 && slots[pos].key != key) {
+        pos = (pos + 1) & mask;
+    }
+
+    return pos;
+}
+
+/*
+ * next_token - Find the next space-separated token of a line
+ * @p: Position to start from
+ * @line_end: End of the line
+ * @token_end: Output parameter for the end of the token
+ * @return: Start of the token (== line_end if the line has no more tokens)
+ */
+static const char* next_token(const char* p, const char* line_end, const char** token_end)
+{
+    while (p < line_end && (*p == ' ' || *p == '\t')) {
+        p++;
+    }
+
+    const char* end = p;
+    while (end < line_end && *end != ' ' && *end != '\t') {
+        end++;
+    }
+
+    *token_end = end;
+    return p;
+}
+
+/*
+ * token_is - Compare a token with a literal
+ * @token: Token start
+ * @token_end: Token end
+ * @literal: NUL-terminated literal
+ * @return: 1 if equal, 0 otherwise
+ */
+static int token_is(const char* token, const char* token_end, const char* literal)
+{
+    size_t len = strlen(literal);
+    return (size_t)(token_end - token) == len && memcmp(token, literal, len) == 0;
+}
+
+/*
+ * parse_lock_line - Split one /proc/locks line into a FileLockInfo
+ * @line: Line start
+ * @line_end: Line end (the '\n' or the terminating NUL)
+ * @lock: Output lock (zeroed by the caller)
+ * @return: 1 for a holder line, 2 for a waiter line, 0 if malformed
+ * Description: "1: POSIX  ADVISORY  WRITE 1234 08:01:393231 0 EOF"; waiter
+ *              lines carry "->" (indented once per nesting level) before
+ *              the class. The device is printed in hex; an END of "EOF" is
+ *              stored as 0.
+ */
+static int parse_lock_line(const char* line, const char* line_end, FileLockInfo* lock)
+{
+    const char* end;
+    char* num_end;
+
+    /* "ID:" */
+    const char* token = next_token(line, line_end, &end);
+    long lock_id = strtol(token, &num_end, 10);
+    if (num_end == token || num_end >= end || *num_end != ':') {
+        return 0;
+    }
+
+    /* Lock class, after the "->" of a waiter */
+    token = next_token(end, line_end, &end);
+    int is_waiter = token_is(token, end, "->");
+    if (is_waiter) {
+        token = next_token(end, line_end, &end);
+    }
+    if (token == end) {
+        return 0;
+    }
+    char lock_type = token[0] == 'F' ? 'F' : 'P';
+
+    /* ADVISORY/MANDATORY, then READ/WRITE */
+    next_token(end, line_end, &end);
+    token = next_token(end, line_end, &end);
+    int is_write = token_is(token, end, "WRITE");
+
+    /* Holder PID */
+    token = next_token(end, line_end, &end);
+    long pid = strtol(token, &num_end, 10);
+    if (token == end || num_end != end) {
+        return 0;
+    }
+
+    lock->lock_id = (int)lock_id;
+    lock->lock_type = lock_type;
+    lock->pid = (int)pid;
+    lock->is_blocking = is_write;
+
+    /* "MAJ:MIN:INODE" */
+    token = next_token(end, line_end, &end);
+    unsigned long major_num = strtoul(token, &num_end, 16);
+    if (num_end < end && *num_end == ':') {
+        const char* minor_str = num_end + 1;
+        unsigned long minor_num = strtoul(minor_str, &num_end, 16);
+        if (num_end > minor_str && num_end < end && *num_end == ':') {
+            lock->inode = strtoul(num_end + 1, NULL, 10);
+            lock->device = makedev(major_num, minor_num);
+        }
+    }
+
+    /* START END [PATH] */
+    token = next_token(end, line_end, &end);
+    lock->start = strtoul(token, NULL, 10);
+    token = next_token(end, line_end, &end);
+    lock->end = token_is(token, end, "EOF") ? 0 : strtoul(token, NULL, 10);
+
+    token = next_token(end, line_end, &end);
+    size_t path_len = (size_t)(end - token);
+    if (path_len > 0) {
+        if (path_len >= MAX_PATH_LEN) {
+            path_len = MAX_PATH_LEN - 1;
+        }
+        memcpy(lock->file_path, token, path_len);
+        lock->file_path[path_len] = '\0';
+    }
+
+    return is_waiter ? 2 : 1;
+}
+
+/*
+ * link_chain - Prepend a lock to the chain of its key
+ * @slots: Hash table
+ * @num_slots: Table size
+ * @next: Chain links
+ * @key: Inode or PID of the lock
+ * @lock_idx: Lock to prepend
+ * @return: None
+ */
+static void link_chain(LockIndexSlot* slots, int num_slots, int* next,
+                       unsigned long key, int lock_idx)
+{
+    LockIndexSlot* slot = &slots[find_slot(slots, num_slots, key)];
+    slot->key = key;
+    next[lock_idx] = slot->head;
+    slot->head = lock_idx;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * lock_index_parse - Tokenize /proc/locks text and index it
+ * @index: Index to fill (previous contents are freed)
+ * @text: NUL-terminated contents of /proc/locks
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: A memchr pass sizes the arrays, one tokenizing pass fills
+ *              locks and waiters, and the chains are linked back to front
+ *              so they list locks in file order.
+ * Error handling: Returns ERROR_OUT_OF_MEMORY on allocation failure, leaving
+ *                 the index empty
+ */
+int lock_index_parse(LockIndex* index, const char* text)
+{
+    if (index == NULL || text == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    free_lock_index(index);
+
+    size_t text_len = strlen(text);
+    const char* text_end = text + text_len;
+    int num_lines = 0;
+    for (const char* p = text; p < text_end; num_lines++) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(text_end - p));
+        p = nl != NULL ? nl + 1 : text_end;
+    }
+
+    if (num_lines == 0) {
+        return SUCCESS;
+    }
+
+    int num_slots = 16;
+    while (num_slots < num_lines * 2) {
+        num_slots *= 2;
+    }
+
+    index->locks = (FileLockInfo*)safe_malloc(sizeof(FileLockInfo) * num_lines);
+    index->next_by_inode = (int*)safe_malloc(sizeof(int) * num_lines);
+    index->next_by_pid = (int*)safe_malloc(sizeof(int) * num_lines);
+    index->inode_slots = (LockIndexSlot*)safe_malloc(sizeof(LockIndexSlot) * num_slots);
+    index->pid_slots = (LockIndexSlot*)safe_malloc(sizeof(LockIndexSlot) * num_slots);
+    index->waiters = (LockWaiter*)safe_malloc(sizeof(LockWaiter) * num_lines);
+    if (index->locks == NULL || index->next_by_inode == NULL || index->next_by_pid == NULL ||
+        index->inode_slots == NULL || index->pid_slots == NULL || index->waiters == NULL) {
+        free_lock_index(index);
+        return ERROR_OUT_OF_MEMORY;
+    }
+
+    index->num_slots = num_slots;
+    for (int s = 0; s < num_slots; s++) {
+        index->inode_slots[s].head = -1;
+        index->pid_slots[s].head = -1;
+    }
+
+    /* Tokenize every line once */
+    const char* line = text;
+    while (line < text_end) {
+        const char* nl = (const char*)memchr(line, '\n', (size_t)(text_end - line));
+        const char* line_end = nl != NULL ? nl : text_end;
+
+        FileLockInfo* lock = &index->locks[index->num_locks];
+        memset(lock, 0, sizeof(FileLockInfo));
+        int kind = parse_lock_line(line, line_end, lock);
+        if (kind == 1) {
+            index->num_locks++;
+        } else if (kind == 2 && index->num_locks > 0 &&
+                   index->locks[index->num_locks - 1].lock_id == lock->lock_id) {
+            /* A waiter follows the held lock it is listed under */
+            LockWaiter* waiter = &index->waiters[index->num_waiters++];
+            waiter->pid = lock->pid;
+            waiter->lock_type = lock->lock_type;
+            waiter->blocker = index->num_locks - 1;
+        }
+
+        line = line_end + (nl != NULL ? 1 : 0);
+    }
+
+    /* Link back to front so every chain lists its locks in file order */
+    for (int j = index->num_locks - 1; j >= 0; j--) {
+        const FileLockInfo* lock = &index->locks[j];
+        index->next_by_inode[j] = -1;
+        if (lock->inode != 0) {
+            link_chain(index->inode_slots, num_slots, index->next_by_inode, lock->inode, j);
+        }
+        link_chain(index->pid_slots, num_slots, index->next_by_pid,
+                   (unsigned long)(unsigned int)lock->pid, j);
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * lock_index_load - Read /proc/locks and index it
+ * @index: Index to fill (previous contents are freed)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: The whole file is taken in one read_fd_into() call.
+ * Error handling: Maps open/read errno values to error codes
+ */
+int lock_index_load(LockIndex* index)
+{
+    if (index == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    free_lock_index(index);
+
+    int fd = open(PROC_SYSTEM_LOCKS_FILE, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return proc_error_from_errno(errno);
+    }
+
+    char* text = read_fd_into(fd, thread_read_buffer(), NULL);
+    int saved_errno = errno;
+    close(fd);
+    if (text == NULL) {
+        return proc_error_from_errno(saved_errno);
+    }
+
+    return lock_index_parse(index, text);
+}
+
+/*
+ * lock_index_first_by_inode - Find the first lock on an inode
+ * @index: Built index
+ * @inode: Inode of the locked file
+ * @return: Index into index->locks, or -1 if the inode holds no lock
+ */
+int lock_index_first_by_inode(const LockIndex* index, unsigned long inode)
+{
+    if (index == NULL || index->num_slots == 0 || inode == 0) {
+        return -1;
+    }
+
+    return index->inode_slots[find_slot(index->inode_slots, index->num_slots, inode)].head;
+}
+
+/*
+ * lock_index_first_by_pid - Find the first lock held by a process
+ * @index: Built index
+ * @pid: Holder process ID
+ * @return: Index into index->locks, or -1 if the process holds no lock
+ */
+int lock_index_first_by_pid(const LockIndex* index, int pid)
+{
+    if (index == NULL || index->num_slots == 0) {
+        return -1;
+    }
+
+    unsigned long key = (unsigned long)(unsigned int)pid;
+    return index->pid_slots[find_slot(index->pid_slots, index->num_slots, key)].head;
+}
+
+/*
+ * lock_index_has_device - Check whether any lock on an inode names a device
+ * @index: Built index
+ * @inode: Inode of the locked file
+ * @device: Device of the file as reported by stat()
+ * @return: 1 if some lock on inode is on device, 0 otherwise
+ */
+int lock_index_has_device(const LockIndex* index, unsigned long inode, dev_t device)
+{
+    for (int j = lock_index_first_by_inode(index, inode); j >= 0; j = index->next_by_inode[j]) {
+        if (index->locks[j].device == device) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * free_lock_index - Free memory owned by a lock index
+ * @index: Index to clean up
+ * @return: None
+ * Description: Frees all arrays and resets counters.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_lock_index(LockIndex* index)
+{
+    if (index == NULL) {
+        return;
+    }
+
+    safe_free((void**)&index->locks);
+    safe_free((void**)&index->next_by_inode);
+    safe_free((void**)&index->next_by_pid);
+    safe_free((void**)&index->inode_slots);
+    safe_free((void**)&index->pid_slots);
+    safe_free((void**)&index->waiters);
+    index->num_locks = 0;
+    index->num_waiters = 0;
+    index->num_slots = 0;
+}
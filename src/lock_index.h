@@ -0,0 +1,141 @@
+#ifndef LOCK_INDEX_H
+#define LOCK_INDEX_H
+
+/* =============================================================================
+ * LOCK_INDEX.H - System Lock Table Index Interface
+ * =============================================================================
+ * This header defines an index over the locks listed in /proc/locks. The
+ * file is read once per analysis and tokenized in place; the parsed locks
+ * are then reachable by the inode they lock and by the PID holding them, so
+ * matching a blocked process's files against the lock table is a hash probe
+ * instead of a scan of every lock. Blocked requests listed by the kernel
+ * are kept with the lock blocking them, giving wait edges directly.
+ * =============================================================================
+ */
+
+#include "process_monitor.h"
+#include "config.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * LockIndexSlot - Hash slot mapping a key to the first lock in its chain
+ */
+typedef struct {
+    unsigned long key;              /* Inode or PID (valid if head >= 0) */
+    int head;                       /* Index of first lock with this key (-1 = empty slot) */
+} LockIndexSlot;
+
+/*
+ * LockWaiter - A blocked lock request ("ID: -> ..." line)
+ * The kernel lists a request under the lock it conflicts with; requests
+ * blocked behind other requests are indented further under the same ID and
+ * are attributed to the held lock at the root of that list.
+ */
+typedef struct {
+    int pid;                        /* Waiting process (-1 for OFD locks) */
+    char lock_type;                 /* 'F' for FLOCK, 'P' for POSIX/OFD */
+    int blocker;                    /* Index into LockIndex.locks of the held lock */
+} LockWaiter;
+
+/*
+ * LockIndex - Locks of /proc/locks with inode and holder-PID chains
+ * Locks sharing a key are linked through next_by_inode / next_by_pid in the
+ * order they appear in /proc/locks.
+ */
+typedef struct {
+    FileLockInfo* locks;            /* Parsed holder lines, in file order */
+    int num_locks;                  /* Number of parsed locks */
+    LockWaiter* waiters;            /* Blocked requests, in file order */
+    int num_waiters;                /* Number of blocked requests */
+    int* next_by_inode;             /* Next lock on the same inode (-1 = end) */
+    int* next_by_pid;               /* Next lock of the same holder (-1 = end) */
+    LockIndexSlot* inode_slots;     /* Inode hash (power-of-two size, linear probing) */
+    LockIndexSlot* pid_slots;       /* Holder PID hash (same size) */
+    int num_slots;                  /* Size of each hash table */
+} LockIndex;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * lock_index_parse - Tokenize /proc/locks text and index it
+ * @index: Index to fill (zero-initialize before first use; old contents are freed)
+ * @text: NUL-terminated contents of /proc/locks
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Walks the text once, splitting each line into its fields by
+ *              hand ("ID: TYPE MODE ACCESS PID MAJ:MIN:INODE START END").
+ *              The device is hexadecimal as printed by the kernel. Waiter
+ *              lines ("ID: -> ...") go to index->waiters, attributed to the
+ *              held lock they are listed under; lines without a PID are
+ *              skipped.
+ *              Time complexity: O(n) expected, n = length of text
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for NULL parameters,
+ *                 ERROR_OUT_OF_MEMORY on allocation failure, leaving the
+ *                 index empty
+ */
+int lock_index_parse(LockIndex* index, const char* text);
+
+/*
+ * lock_index_load - Read /proc/locks and index it
+ * @index: Index to fill (zero-initialize before first use; old contents are freed)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: One read into the calling thread's read buffer, then
+ *              lock_index_parse().
+ *              Time complexity: O(n), n = size of /proc/locks
+ * Error handling: Returns ERROR_FILE_NOT_FOUND / ERROR_PERMISSION_DENIED /
+ *                 ERROR_SYSTEM_CALL_FAILED if the file cannot be read
+ */
+int lock_index_load(LockIndex* index);
+
+/*
+ * lock_index_first_by_inode - Find the first lock on an inode
+ * @index: Built index
+ * @inode: Inode of the locked file
+ * @return: Index into index->locks, or -1 if the inode holds no lock;
+ *          follow index->next_by_inode for the rest
+ * Description: Time complexity: O(1) expected
+ * Error handling: Returns -1 for NULL or empty index
+ */
+int lock_index_first_by_inode(const LockIndex* index, unsigned long inode);
+
+/*
+ * lock_index_first_by_pid - Find the first lock held by a process
+ * @index: Built index
+ * @pid: Holder process ID
+ * @return: Index into index->locks, or -1 if the process holds no lock;
+ *          follow index->next_by_pid for the rest
+ * Description: Time complexity: O(1) expected
+ * Error handling: Returns -1 for NULL or empty index
+ */
+int lock_index_first_by_pid(const LockIndex* index, int pid);
+
+/*
+ * lock_index_has_device - Check whether any lock on an inode names a device
+ * @index: Built index
+ * @inode: Inode of the locked file
+ * @device: Device of the file as reported by stat()
+ * @return: 1 if some lock on inode is on device, 0 otherwise
+ * Description: Lets callers match on dev:inode, and fall back to the inode
+ *              alone where stat() and /proc/locks disagree on the device
+ *              (e.g. btrfs subvolumes).
+ *              Time complexity: O(locks on inode)
+ */
+int lock_index_has_device(const LockIndex* index, unsigned long inode, dev_t device);
+
+/*
+ * free_lock_index - Free memory owned by a lock index
+ * @index: Index to clean up
+ * @return: None
+ * Description: Frees all arrays and resets counters. Does not free the
+ *              index structure itself.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_lock_index(LockIndex* index);
+
+#endif /* LOCK_INDEX_H */
@@ -12,20 +12,27 @@
 #include <unistd.h>
 #include <signal.h>
 #include <errno.h>
+#include <time.h>
 #include "config.h"
 #include "utility.h"
 #include "process_monitor.h"
 #include "resource_graph.h"
+#include "cycle_detection.h"
 #include "deadlock_detection.h"
 #include "output_handler.h"
 #include "email_alert.h"
+#include "proc_events.h"
+#include "proc_uring.h"
+#include "scan_schedule.h"
+#include "event_loop.h"
+#include "deadlock_confirm.h"
 
 /* =============================================================================
  * GLOBAL VARIABLES
  * =============================================================================
  */
 
-static volatile int g_running = 1;  /* Signal flag for graceful shutdown */
+static volatile sig_atomic_t g_stop_signal = 0;  /* Signal that requested shutdown (0 = none) */
 
 /* =============================================================================
  * DATA STRUCTURES
@@ -35,7 +42,7 @@ static volatile int g_running = 1;  /* Signal flag for graceful shutdown */
 typedef struct {
     int verbose;                    /* Verbose output flag */
     int continuous_monitor;          /* Continuous monitoring flag */
-    int interval;                    /* Monitoring interval in seconds */
+    long interval_ms;                /* Monitoring interval in milliseconds */
     char output_format[32];          /* Output format: text, json, verbose */
     char output_file[256];           /* Output file path (empty if stdout) */
     int alert_email;                 /* Email alert enabled flag */
@@ -45,23 +52,56 @@ typedef struct {
     char smtp_server[256];
     int smtp_port;
     char from_email[MAX_EMAIL_RECIPIENTS_LEN];
+    int threads;                     /* Collector threads (0 = one per CPU) */
+    int engine;                      /* Cycle detection engine (CYCLE_ENGINE_*) */
+    int incremental;                 /* Reuse unchanged processes between scans (-c only) */
+    int proc_events;                 /* Track processes through the event connector (-c only) */
+    int io_uring;                    /* Batch /proc reads through io_uring */
+    int adaptive;                    /* Adapt the interval to blocked-process pressure (-c only) */
+    long interval_floor_ms;          /* Adaptive: shortest delay between scans */
+    long interval_ceiling_ms;        /* Adaptive: longest delay between scans */
+    double interval_ramp;            /* Adaptive: back-off factor per quiet scan */
+    int confirm_rounds;              /* Re-reads of a suspected deadlock (0 = off) */
+    long confirm_interval_ms;        /* Spacing between confirmation re-reads */
 } CommandLineArgs;
 
+/*
+ * ScanState - State carried across detection cycles
+ * Lives for the whole run so continuous monitoring can reuse buffers
+ * instead of reallocating them on every scan
+ */
+typedef struct {
+    PidVector pid_list;              /* PID vector refilled by every scan */
+    FdSnapshot fd_snapshots[2];      /* Per-scan FD tables, one slot per PID; the
+                                        incremental mode alternates between them */
+    int current_snapshot;            /* Index of the snapshot the next scan fills */
+    WorkerPool* pool;                /* Collector threads (NULL = serial) */
+    Arena** arenas;                  /* Scan arenas, one per collector (NULL = heap) */
+    int num_arenas;                  /* Number of arenas */
+    ProcHandleCache handle_cache;    /* /proc/[PID] handles kept between scans */
+    int use_handle_cache;            /* 1 in continuous mode once the cache is set up */
+    ScanHistory history;             /* Per-PID records of the previous scan */
+    int incremental;                 /* 1 if unchanged processes are reused */
+    ProcEventFeed events;            /* Live PID set fed by process events */
+    int use_events;                  /* 1 while the event feed replaces /proc walks */
+} ScanState;
+
 /* =============================================================================
  * SIGNAL HANDLING
  * =============================================================================
  */
 
 /*
- * signal_handler - Handle SIGINT (Ctrl+C) for graceful shutdown
+ * signal_handler - Handle SIGINT (Ctrl+C) and SIGTERM for graceful shutdown
  * @sig: Signal number
  * @return: None
+ * Description: Only records the signal; the main loop reports it. Continuous
+ *              monitoring reads these signals from its event loop instead,
+ *              so the handler serves one-shot runs and the sleep fallback.
  */
 static void signal_handler(int sig)
 {
-    (void)sig; /* Suppress unused parameter warning */
-    g_running = 0;
-    printf("\nReceived interrupt signal. Shutting down gracefully...\n");
+    g_stop_signal = sig;
 }
 
 /*
@@ -80,10 +120,65 @@ static int setup_signal_handlers(void)
         error_log("Failed to register SIGINT handler: %s", strerror(errno));
         return ERROR_SYSTEM_CALL_FAILED;
     }
+    if (sigaction(SIGTERM, &sa, NULL) != 0) {
+        error_log("Failed to register SIGTERM handler: %s", strerror(errno));
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
     
     return SUCCESS;
 }
 
+/*
+ * wait_for_next_scan - Sleep until the next scan is due
+ * @loop: Event loop, or NULL to sleep with nanosleep()
+ * @delay_ms: Delay from the start of this scan's period to the next
+ * @verbose: Log SIGHUP-triggered scans
+ * @return: 1 to scan again, 0 on shutdown, negative error code on failure
+ * Description: With an event loop the deadline is absolute, so the time
+ *              the scan took is not added to the delay. SIGHUP makes the
+ *              next scan run immediately; SIGINT and SIGTERM stop.
+ */
+static int wait_for_next_scan(EventLoop* loop, long delay_ms, int verbose)
+{
+    if (loop == NULL) {
+        /* Sleep in slices of at most a second to check the stop flag */
+        while (delay_ms > 0 && !g_stop_signal) {
+            long slice_ms = delay_ms < 1000 ? delay_ms : 1000;
+            struct timespec slice = { slice_ms / 1000, (slice_ms % 1000) * 1000000L };
+            nanosleep(&slice, NULL);
+            delay_ms -= slice_ms;
+        }
+        return g_stop_signal ? 0 : 1;
+    }
+    
+    int result = event_loop_arm(loop, delay_ms);
+    if (result != SUCCESS) {
+        return result;
+    }
+    
+    for (;;) {
+        int sig = 0;
+        result = event_loop_wait(loop, &sig);
+        if (result == EVENT_LOOP_TIMER) {
+            return 1;
+        }
+        if (result != EVENT_LOOP_SIGNAL) {
+            return result;
+        }
+        if (sig != SIGHUP) {
+            g_stop_signal = sig;
+            return 0;
+        }
+        if (verbose) {
+            info_log("SIGHUP received, scanning now");
+        }
+        result = event_loop_rearm_now(loop);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+}
+
 static void apply_email_configuration(CommandLineArgs* args)
 {
     if (args == NULL) {
@@ -160,7 +255,7 @@ static void print_usage(const char* program_name)
     printf("  -h, --help              Show this help message\n");
     printf("  -v, --verbose           Enable verbose output\n");
     printf("  -c, --continuous        Continuous monitoring mode\n");
-    printf("  -i, --interval SEC      Monitoring interval in seconds (default: %d)\n",
+    printf("  -i, --interval SEC      Monitoring interval in seconds, e.g. 0.25 (default: %d)\n",
            DEFAULT_MONITORING_INTERVAL);
     printf("  -f, --format FORMAT     Output format: text, json, verbose (default: text)\n");
     printf("  -o, --output FILE       Write output to file instead of stdout\n");
@@ -170,6 +265,26 @@ static void print_usage(const char* program_name)
     printf("      --smtp-server HOST  SMTP server hostname (e.g., smtp.gmail.com)\n");
     printf("      --smtp-port PORT    SMTP server port (e.g., 25, 587)\n");
     printf("      --from-email EMAIL  Sender email address\n");
+    printf("      --threads N         Collector threads, 0 = one per CPU (default: %d)\n",
+           DEFAULT_WORKER_THREADS);
+    printf("      --engine ENGINE     Cycle detection engine: dfs, scc (default: %s)\n",
+           DEFAULT_CYCLE_ENGINE == CYCLE_ENGINE_SCC ? "scc" : "dfs");
+    printf("      --incremental       With -c, reuse data of processes unchanged since the last scan\n");
+    printf("      --proc-events       With -c, track processes via the kernel event connector (root)\n");
+    printf("      --io-uring          Batch /proc reads through io_uring (falls back if unavailable)\n");
+    printf("      --adaptive          With -c, back off while nothing is blocked and rescan quickly\n");
+    printf("                          when blocked processes or wait edges appear\n");
+    printf("      --min-interval MS   Adaptive floor in milliseconds (default: %d)\n",
+           ADAPTIVE_FLOOR_MS);
+    printf("      --max-interval MS   Adaptive ceiling in milliseconds (default: %d)\n",
+           ADAPTIVE_CEILING_MS);
+    printf("      --ramp FACTOR       Adaptive back-off factor per quiet scan (default: %.1f)\n",
+           ADAPTIVE_RAMP);
+    printf("      --confirm N         Report a deadlock only after N re-reads of its processes\n");
+    printf("                          still find the cycle (default: %d = off)\n",
+           DEFAULT_CONFIRM_ROUNDS);
+    printf("      --confirm-interval MS  Spacing between confirmation re-reads (default: %d)\n",
+           DEFAULT_CONFIRM_INTERVAL_MS);
     printf("  --version               Show version information\n");
     printf("\n");
     printf("Examples:\n");
@@ -206,7 +321,7 @@ static int parse_arguments(int argc, char** argv, CommandLineArgs* args)
     /* Initialize defaults */
     args->verbose = 0;
     args->continuous_monitor = 0;
-    args->interval = DEFAULT_MONITORING_INTERVAL;
+    args->interval_ms = DEFAULT_MONITORING_INTERVAL * 1000L;
     strncpy(args->output_format, "text", sizeof(args->output_format) - 1);
     args->output_format[sizeof(args->output_format) - 1] = '\0';
     strncpy(args->output_file, "", sizeof(args->output_file) - 1);
@@ -218,6 +333,17 @@ static int parse_arguments(int argc, char** argv, CommandLineArgs* args)
     args->smtp_server[0] = '\0';
     args->smtp_port = 0;
     args->from_email[0] = '\0';
+    args->threads = DEFAULT_WORKER_THREADS;
+    args->engine = DEFAULT_CYCLE_ENGINE;
+    args->incremental = 0;
+    args->proc_events = 0;
+    args->io_uring = 0;
+    args->adaptive = 0;
+    args->interval_floor_ms = ADAPTIVE_FLOOR_MS;
+    args->interval_ceiling_ms = ADAPTIVE_CEILING_MS;
+    args->interval_ramp = ADAPTIVE_RAMP;
+    args->confirm_rounds = DEFAULT_CONFIRM_ROUNDS;
+    args->confirm_interval_ms = DEFAULT_CONFIRM_INTERVAL_MS;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
@@ -237,13 +363,16 @@ static int parse_arguments(int argc, char** argv, CommandLineArgs* args)
                 fprintf(stderr, "Error: -i/--interval requires an argument\n");
                 return ERROR_INVALID_ARGUMENT;
             }
-            int interval = atoi(argv[++i]);
-            if (interval < MIN_MONITORING_INTERVAL || interval > MAX_MONITORING_INTERVAL) {
-                fprintf(stderr, "Error: interval must be between %d and %d seconds\n",
-                       MIN_MONITORING_INTERVAL, MAX_MONITORING_INTERVAL);
+            char* end = NULL;
+            double seconds = strtod(argv[++i], &end);
+            if (end == argv[i] || *end != '\0' ||
+                !(seconds * 1000.0 >= MIN_MONITORING_INTERVAL_MS) ||
+                seconds > MAX_MONITORING_INTERVAL) {
+                fprintf(stderr, "Error: interval must be between %.2f and %d seconds\n",
+                        MIN_MONITORING_INTERVAL_MS / 1000.0, MAX_MONITORING_INTERVAL);
                 return ERROR_INVALID_ARGUMENT;
             }
-            args->interval = interval;
+            args->interval_ms = (long)(seconds * 1000.0 + 0.5);
         }
         else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--format") == 0) {
             if (i + 1 >= argc) {
@@ -323,6 +452,103 @@ static int parse_arguments(int argc, char** argv, CommandLineArgs* args)
             strncpy(args->from_email, argv[++i], sizeof(args->from_email) - 1);
             args->from_email[sizeof(args->from_email) - 1] = '\0';
         }
+        else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --threads requires an argument\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+            int threads = atoi(argv[++i]);
+            if (threads < 0 || threads > MAX_WORKER_THREADS) {
+                fprintf(stderr, "Error: threads must be between 0 and %d\n",
+                       MAX_WORKER_THREADS);
+                return ERROR_INVALID_ARGUMENT;
+            }
+            args->threads = threads;
+        }
+        else if (strcmp(argv[i], "--engine") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --engine requires an argument\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+            i++;
+            if (strcmp(argv[i], "dfs") == 0) {
+                args->engine = CYCLE_ENGINE_DFS;
+            } else if (strcmp(argv[i], "scc") == 0) {
+                args->engine = CYCLE_ENGINE_SCC;
+            } else {
+                fprintf(stderr, "Error: engine must be 'dfs' or 'scc'\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+        }
+        else if (strcmp(argv[i], "--incremental") == 0) {
+            args->incremental = 1;
+        }
+        else if (strcmp(argv[i], "--proc-events") == 0) {
+            args->proc_events = 1;
+        }
+        else if (strcmp(argv[i], "--io-uring") == 0) {
+            args->io_uring = 1;
+        }
+        else if (strcmp(argv[i], "--adaptive") == 0) {
+            args->adaptive = 1;
+        }
+        else if (strcmp(argv[i], "--min-interval") == 0 ||
+                 strcmp(argv[i], "--max-interval") == 0) {
+            const char* option = argv[i];
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: %s requires an argument\n", option);
+                return ERROR_INVALID_ARGUMENT;
+            }
+            long ms = atol(argv[++i]);
+            if (ms < MIN_MONITORING_INTERVAL_MS || ms > MAX_MONITORING_INTERVAL * 1000L) {
+                fprintf(stderr, "Error: %s must be between %d and %ld milliseconds\n",
+                        option, MIN_MONITORING_INTERVAL_MS, MAX_MONITORING_INTERVAL * 1000L);
+                return ERROR_INVALID_ARGUMENT;
+            }
+            if (strcmp(option, "--min-interval") == 0) {
+                args->interval_floor_ms = ms;
+            } else {
+                args->interval_ceiling_ms = ms;
+            }
+        }
+        else if (strcmp(argv[i], "--ramp") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --ramp requires an argument\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+            double ramp = atof(argv[++i]);
+            if (ramp < 1.0 || ramp > 16.0) {
+                fprintf(stderr, "Error: ramp must be between 1 and 16\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+            args->interval_ramp = ramp;
+        }
+        else if (strcmp(argv[i], "--confirm") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --confirm requires an argument\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+            int rounds = atoi(argv[++i]);
+            if (rounds < 0 || rounds > MAX_CONFIRM_ROUNDS) {
+                fprintf(stderr, "Error: confirm rounds must be between 0 and %d\n",
+                        MAX_CONFIRM_ROUNDS);
+                return ERROR_INVALID_ARGUMENT;
+            }
+            args->confirm_rounds = rounds;
+        }
+        else if (strcmp(argv[i], "--confirm-interval") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --confirm-interval requires an argument\n");
+                return ERROR_INVALID_ARGUMENT;
+            }
+            long ms = atol(argv[++i]);
+            if (ms < 0 || ms > MAX_CONFIRM_INTERVAL_MS) {
+                fprintf(stderr, "Error: --confirm-interval must be between 0 and %d milliseconds\n",
+                        MAX_CONFIRM_INTERVAL_MS);
+                return ERROR_INVALID_ARGUMENT;
+            }
+            args->confirm_interval_ms = ms;
+        }
         else {
             fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
             fprintf(stderr, "Use -h or --help for usage information\n");
@@ -330,6 +556,13 @@ static int parse_arguments(int argc, char** argv, CommandLineArgs* args)
         }
     }
     
+    /* The bounds are unused without --adaptive, defaults included */
+    if (args->adaptive && args->interval_floor_ms > args->interval_ceiling_ms) {
+        fprintf(stderr, "Error: --min-interval (%ld ms) must not exceed --max-interval (%ld ms)\n",
+                args->interval_floor_ms, args->interval_ceiling_ms);
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
     return SUCCESS;
 }
 
@@ -338,41 +571,131 @@ static int parse_arguments(int argc, char** argv, CommandLineArgs* args)
  * =============================================================================
  */
 
+/*
+ * destroy_scan_arenas - Free the scan arenas of a ScanState
+ * @state: Scan state owning the arenas
+ * @return: None
+ */
+static void destroy_scan_arenas(ScanState* state)
+{
+    for (int i = 0; i < state->num_arenas; i++) {
+        arena_destroy(state->arenas[i]);
+    }
+    safe_free((void**)&state->arenas);
+    state->num_arenas = 0;
+}
+
+/*
+ * CycleConfirmation - Context of confirm_cycle()
+ */
+typedef struct {
+    const CommandLineArgs* args;            /* Confirmation rounds and spacing */
+    const ProcessResourceInfo* procs;       /* Resource information of the scan */
+    int num_procs;                          /* Number of entries in procs */
+} CycleConfirmation;
+
+/*
+ * confirm_cycle - Detection filter re-reading the members of one cycle
+ * @context: CycleConfirmation of the scan
+ * @pids: Members of the cycle
+ * @num_pids: Number of members
+ * @return: 1 if confirmed, 0 if the cycle dissolved, negative error code
+ *          on failure
+ */
+static int confirm_cycle(void* context, const int* pids, int num_pids)
+{
+    const CycleConfirmation* confirmation = (const CycleConfirmation*)context;
+    const CommandLineArgs* args = confirmation->args;
+    ConfirmResult confirm;
+    
+    int status = confirm_deadlock(pids, num_pids, confirmation->procs,
+                                  confirmation->num_procs, args->confirm_rounds,
+                                  args->confirm_interval_ms, &confirm);
+    if (status < 0) {
+        error_log("Deadlock confirmation failed: %d", status);
+    } else if (status == 0 && args->verbose && confirm.changed_pid > 0) {
+        info_log("Suspected deadlock cycle of %d processes not confirmed after %d of %d "
+                 "re-reads (%.1f ms): PID %d, %s", num_pids, confirm.rounds,
+                 args->confirm_rounds, confirm.elapsed_ms, confirm.changed_pid,
+                 confirm.reason);
+    } else if (status == 0 && args->verbose) {
+        info_log("Suspected deadlock cycle of %d processes not confirmed after %d of %d "
+                 "re-reads (%.1f ms): %s", num_pids, confirm.rounds,
+                 args->confirm_rounds, confirm.elapsed_ms, confirm.reason);
+    } else if (status > 0 && args->verbose) {
+        info_log("Deadlock cycle of %d processes confirmed by %d re-reads in %.1f ms",
+                 num_pids, confirm.rounds, confirm.elapsed_ms);
+    }
+    return status;
+}
+
 /*
  * run_detection - Run one deadlock detection cycle
  * @args: Command-line arguments
+ * @state: Scan state reused across cycles
+ * @outcome: Output: blocked processes, wait edges and deadlock status seen
+ *           by the scan (timing is left to the caller)
  * @return: SUCCESS (0) on success, negative on error
  * Description: Performs one complete deadlock detection cycle:
- *              1. Collect process information
+ *              1. Collect process information: the wait channel of every
+ *                 process, then locks and FDs of the blocked ones only
  *              2. Build Resource Allocation Graph
  *              3. Detect cycles
  *              4. Analyze and report deadlocks
+ *              Per-scan data (process slots, their arrays and strings, and
+ *              the report contents) is carved out of the scan arenas, which
+ *              are reset once at the end instead of freeing each piece.
  * Note: All allocated resources are properly freed, including DeadlockReport
  *       structure itself, even on error paths.
  */
-static int run_detection(const CommandLineArgs* args)
+static int run_detection(const CommandLineArgs* args, ScanState* state, ScanOutcome* outcome)
 {
-    if (args == NULL) {
+    if (args == NULL || state == NULL || outcome == NULL) {
         return ERROR_INVALID_ARGUMENT;
     }
     
+    /* Arena 0 belongs to the calling thread and backs the serial stages */
+    Arena* scan_arena = state->arenas != NULL ? state->arenas[0] : NULL;
+    
     /* Initialize all pointers to NULL for proper cleanup */
-    pid_t* pids = NULL;
     ProcessResourceInfo* procs = NULL;
+    int* slot_results = NULL;
+    char* blocked = NULL;
+    ProcHandle* handles = NULL;
+    ScanRecord* records = NULL;
+    int* slot_of = NULL;
+    int num_procs = 0;
+    int num_triaged = 0;
+    int num_records = 0;
     DeadlockReport* report = NULL;
     int success_count = 0;
     int return_code = SUCCESS;
     
-    /* Step 1: Collect process information */
-    int num_procs = 0;
-    pids = get_all_processes(&num_procs);
-    
-    if (pids == NULL) {
-        error_log("Failed to get process list");
-        return_code = ERROR_SYSTEM_CALL_FAILED;
+    /* Step 1: Collect process information; with the event feed the PID
+     * list is kept current without walking /proc */
+    int enum_result;
+    if (state->use_events) {
+        enum_result = proc_events_poll(&state->events, &state->pid_list);
+        for (int i = 0; i < state->events.num_execs; i++) {
+            scan_history_forget(&state->history, state->events.execs[i]);
+        }
+        if (state->events.fd < 0) {
+            info_log("Process events are not delivered, scanning /proc instead");
+            proc_events_close(&state->events);
+            state->use_events = 0;
+        }
+    } else {
+        enum_result = enumerate_processes(&state->pid_list);
+    }
+    if (enum_result != SUCCESS) {
+        error_log("Failed to get process list: %d", enum_result);
+        return_code = enum_result;
         goto cleanup;
     }
     
+    pid_t* pids = state->pid_list.pids;
+    num_procs = state->pid_list.count;
+    
     if (num_procs == 0) {
         info_log("No processes found");
         return_code = SUCCESS;
@@ -383,42 +706,163 @@ static int run_detection(const CommandLineArgs* args)
         info_log("Collected %d processes", num_procs);
     }
     
-    /* Step 2: Get process resource information */
-    procs = (ProcessResourceInfo*)safe_malloc(
-        sizeof(ProcessResourceInfo) * num_procs);
-    if (procs == NULL) {
+    /* In continuous mode stable processes keep their /proc/[PID] handle */
+    if (state->use_handle_cache) {
+        handles = (ProcHandle*)arena_alloc(scan_arena, sizeof(ProcHandle) * num_procs);
+        if (handles != NULL) {
+            proc_handle_cache_checkout(&state->handle_cache, pids, num_procs, handles);
+        }
+    }
+    
+    /* Step 2: Triage - read only the wait channel of every process */
+    blocked = (char*)arena_alloc(scan_arena, num_procs);
+    slot_results = (int*)arena_alloc(scan_arena, sizeof(int) * num_procs);
+    if (blocked == NULL || slot_results == NULL) {
         return_code = ERROR_OUT_OF_MEMORY;
         goto cleanup;
     }
     
-    /* Initialize and collect resource info for each process */
+    int triage_result = triage_processes(state->pool, pids, num_procs, handles,
+                                         blocked, slot_results);
+    if (triage_result != SUCCESS) {
+        return_code = triage_result;
+        goto cleanup;
+    }
+    
+    /* Move blocked processes to the front of the PID and handle arrays; the
+     * cache check-in does not depend on slot order */
+    int num_candidates = 0;
     for (int i = 0; i < num_procs; i++) {
-        memset(&procs[success_count], 0, sizeof(ProcessResourceInfo));
-        int result = get_process_resources(pids[i], &procs[success_count]);
-        if (result == SUCCESS) {
-            success_count++;
-        } else if (args->verbose) {
-            debug_log("Failed to get resources for PID %d: %d", (int)pids[i], result);
+        if (slot_results[i] != SUCCESS) {
+            continue;
         }
+        num_triaged++;
+        if (!blocked[i]) {
+            continue;
+        }
+        if (i != num_candidates) {
+            pid_t pid = pids[i];
+            pids[i] = pids[num_candidates];
+            pids[num_candidates] = pid;
+            if (handles != NULL) {
+                ProcHandle handle = handles[i];
+                handles[i] = handles[num_candidates];
+                handles[num_candidates] = handle;
+            }
+        }
+        num_candidates++;
     }
     
-    if (success_count == 0) {
-        info_log("No process resource information available");
-        return_code = SUCCESS;
-        goto cleanup;
+    if (args->verbose) {
+        info_log("%d of %d processes are blocked on a pipe or lock",
+                 num_candidates, num_triaged);
     }
+    outcome->num_blocked = num_candidates;
     
-    if (args->verbose) {
-        info_log("Collected resource info for %d processes", success_count);
+    /* A deadlock needs two blocked processes; otherwise nothing more is read */
+    if (num_candidates >= 2) {
+        /* Step 2.1: Get resource information of the blocked processes */
+        procs = (ProcessResourceInfo*)arena_alloc(
+            scan_arena, sizeof(ProcessResourceInfo) * num_candidates);
+        if (procs == NULL) {
+            return_code = ERROR_OUT_OF_MEMORY;
+            goto cleanup;
+        }
+        
+        /* One FD table per PID; each /proc/[PID]/fd is listed once per scan */
+        FdSnapshot* snapshot = &state->fd_snapshots[state->current_snapshot];
+        int snapshot_result = fd_snapshot_prepare(snapshot, num_candidates);
+        if (snapshot_result != SUCCESS) {
+            return_code = snapshot_result;
+            goto cleanup;
+        }
+        
+        /* Incremental scans record every slot so the next scan can reuse it */
+        IncrementalScan incremental;
+        IncrementalScan* incremental_scan = NULL;
+        if (state->incremental && handles != NULL) {
+            records = (ScanRecord*)arena_alloc(scan_arena, sizeof(ScanRecord) * num_candidates);
+            slot_of = (int*)arena_alloc(scan_arena, sizeof(int) * num_candidates);
+            if (records != NULL && slot_of != NULL) {
+                memset(records, 0, sizeof(ScanRecord) * num_candidates);
+                incremental.history = &state->history;
+                incremental.previous = &state->fd_snapshots[1 - state->current_snapshot];
+                incremental.records = records;
+                incremental.num_reused = 0;
+                incremental_scan = &incremental;
+                num_records = num_candidates;
+            } else {
+                if (scan_arena == NULL) {
+                    safe_free((void**)&records);
+                    safe_free((void**)&slot_of);
+                }
+                records = NULL;
+                slot_of = NULL;
+            }
+        }
+        
+        /* Collect resource info for each process (in parallel if a pool exists) */
+        int collect_result = collect_process_resources(state->pool, pids, num_candidates,
+                                                       snapshot, state->arenas,
+                                                       handles, incremental_scan,
+                                                       procs, slot_results);
+        if (collect_result != SUCCESS) {
+            return_code = collect_result;
+            goto cleanup;
+        }
+        
+        if (incremental_scan != NULL && args->verbose) {
+            info_log("Reused %d of %d processes from the previous scan",
+                     incremental.num_reused, num_candidates);
+        }
+        
+        /* Compact successful slots to the front */
+        for (int i = 0; i < num_candidates; i++) {
+            if (slot_results[i] == SUCCESS) {
+                if (i != success_count) {
+                    procs[success_count] = procs[i];
+                }
+                if (slot_of != NULL) {
+                    slot_of[success_count] = i;
+                }
+                success_count++;
+            } else {
+                free_process_resource_info(&procs[i]);
+                if (args->verbose) {
+                    debug_log("Failed to get resources for PID %d: %d", (int)pids[i], slot_results[i]);
+                }
+            }
+        }
+        
+        if (args->verbose) {
+            info_log("Collected resource info for %d processes", success_count);
+        }
     }
     
     /* Step 2.5: Analyze pipe and lock dependencies */
-    int dep_result = analyze_pipe_and_lock_dependencies(procs, success_count);
-    if (dep_result != SUCCESS && args->verbose) {
-        debug_log("Warning: Failed to analyze dependencies: %d", dep_result);
-        /* Continue anyway, partial analysis may still work */
-    } else if (args->verbose) {
-        info_log("Analyzed pipe and lock dependencies");
+    if (success_count >= 2) {
+        int dep_result = analyze_pipe_and_lock_dependencies(procs, success_count);
+        if (dep_result != SUCCESS && args->verbose) {
+            debug_log("Warning: Failed to analyze dependencies: %d", dep_result);
+            /* Continue anyway, partial analysis may still work */
+        } else if (args->verbose) {
+            info_log("Analyzed pipe and lock dependencies");
+        }
+        
+        for (int k = 0; k < success_count; k++) {
+            if (procs[k].num_waiting > 0 || procs[k].num_waiting_on_pids > 0) {
+                outcome->num_waiting++;
+            }
+        }
+        
+        /* Graph participants are collected in full next time */
+        if (records != NULL) {
+            for (int k = 0; k < success_count; k++) {
+                records[slot_of[k]].participant = procs[k].num_held > 0 ||
+                                                  procs[k].num_waiting > 0 ||
+                                                  procs[k].num_waiting_on_pids > 0;
+            }
+        }
     }
     
     /* Step 3: Detect deadlock */
@@ -427,8 +871,16 @@ static int run_detection(const CommandLineArgs* args)
         return_code = ERROR_OUT_OF_MEMORY;
         goto cleanup;
     }
+    report->arena = scan_arena;
+    report->total_processes_scanned = num_triaged;
     
-    int deadlock_status = detect_deadlock_in_system(procs, success_count, report);
+    /* A cycle assembled from a non-atomic snapshot may be transient; with
+     * --confirm each cycle's processes are re-read on their own before it
+     * is reported, so a transient cycle does not hide a stable one */
+    CycleConfirmation confirmation = { args, procs, success_count };
+    int deadlock_status = detect_deadlock_filtered(procs, success_count, report,
+                                                   args->confirm_rounds > 0 ? confirm_cycle : NULL,
+                                                   &confirmation);
     
     if (deadlock_status < 0) {
         error_log("Deadlock detection failed: %d", deadlock_status);
@@ -436,7 +888,11 @@ static int run_detection(const CommandLineArgs* args)
         goto cleanup;
     }
     
+    /* Alert only on what is reported, after confirmation */
+    email_alert_handle_detection(report, deadlock_status > 0 ? 1 : 0);
+    
     /* Step 4: Display results */
+    outcome->deadlock = deadlock_status > 0;
     if (deadlock_status > 0) {
         if (args->verbose) {
             info_log("DEADLOCK DETECTED!");
@@ -477,9 +933,25 @@ static int run_detection(const CommandLineArgs* args)
     
 cleanup:
     /* Step 5: Cleanup - ensure all resources are freed */
+    /* Once collected, the records must replace the history: unchanged slots
+     * have taken their FD tables out of the previous snapshot */
+    if (records != NULL) {
+        scan_history_commit(&state->history, records, num_records);
+        state->current_snapshot = 1 - state->current_snapshot;
+    }
+    
+    if (handles != NULL) {
+        proc_handle_cache_checkin(&state->handle_cache, handles, num_procs);
+        if (scan_arena == NULL) {
+            free(handles);
+        }
+        handles = NULL;
+    }
+    
     /* Free DeadlockReport (frees structure and all nested allocations) */
     if (report != NULL) {
         free_deadlock_report(report);
+        free(report);
         report = NULL;
     }
     
@@ -488,14 +960,22 @@ cleanup:
         for (int i = 0; i < success_count; i++) {
             free_process_resource_info(&procs[i]);
         }
-        free(procs);
+        if (scan_arena == NULL) {
+            free(procs);
+        }
         procs = NULL;
     }
     
-    /* Free process list */
-    if (pids != NULL) {
-        free_process_list(pids);
-        pids = NULL;
+    if (scan_arena == NULL) {
+        safe_free((void**)&slot_results);
+        safe_free((void**)&blocked);
+        safe_free((void**)&records);
+        safe_free((void**)&slot_of);
+    }
+    
+    /* Release everything carved out of the arenas in one step */
+    for (int i = 0; i < state->num_arenas; i++) {
+        arena_reset(state->arenas[i]);
     }
     
     return return_code;
@@ -550,6 +1030,8 @@ int main(int argc, char** argv)
     alert_options.from_email[sizeof(alert_options.from_email) - 1] = '\0';
 
     email_alert_set_options(&alert_options);
+    set_cycle_engine(args.engine);
+    proc_uring_set_enabled(args.io_uring);
     
     fprintf(stderr, "[DEBUG] Email alert configuration:\n");
     fprintf(stderr, "[DEBUG]   enable_email: %d\n", alert_options.enable_email);
@@ -565,6 +1047,67 @@ int main(int argc, char** argv)
         return 1;
     }
     
+    /* Continuous monitoring waits on a timerfd and a signalfd. Open them
+     * before the collector threads start so the threads inherit the
+     * blocked signals; without them fall back to sleeping */
+    EventLoop loop;
+    EventLoop* event_loop = NULL;
+    if (args.continuous_monitor) {
+        if (event_loop_open(&loop) == SUCCESS) {
+            event_loop = &loop;
+        } else if (args.verbose) {
+            info_log("timerfd/signalfd unavailable, sleeping between scans");
+        }
+    }
+    
+    /* Scan state and collector pool live for the whole run */
+    ScanState state;
+    memset(&state, 0, sizeof(state));
+    state.events.fd = -1;
+    
+    int num_threads = args.threads;
+    if (num_threads == 0) {
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        num_threads = cpus > 0 ? (int)cpus : 1;
+        if (num_threads > MAX_WORKER_THREADS) {
+            num_threads = MAX_WORKER_THREADS;
+        }
+    }
+    if (num_threads > 1) {
+        state.pool = worker_pool_create(num_threads);
+        if (state.pool == NULL) {
+            error_log("Failed to start %d collector threads, collecting serially",
+                      num_threads);
+        }
+    }
+    
+    /* One scan arena per collector; without them scans use the heap */
+    int num_arenas = state.pool != NULL ? state.pool->num_threads : 1;
+    state.arenas = (Arena**)safe_malloc(sizeof(Arena*) * num_arenas);
+    if (state.arenas != NULL) {
+        for (int i = 0; i < num_arenas; i++) {
+            state.arenas[i] = arena_create(ARENA_CHUNK_SIZE);
+            if (state.arenas[i] == NULL) {
+                destroy_scan_arenas(&state);
+                break;
+            }
+            state.num_arenas = i + 1;
+        }
+    }
+    
+    /* Handles only pay off when the same processes are scanned again */
+    if (args.continuous_monitor) {
+        state.use_handle_cache = proc_handle_cache_init(&state.handle_cache) == SUCCESS;
+        state.incremental = args.incremental && state.use_handle_cache;
+        if (args.proc_events) {
+            int events_result = proc_events_open(&state.events);
+            state.use_events = events_result == SUCCESS;
+            if (!state.use_events && args.verbose) {
+                info_log("Process events unavailable (%d), scanning /proc", events_result);
+            }
+        }
+    }
+    
     /* Print startup information */
     if (args.verbose) {
         info_log("Deadlock Detection System Started");
@@ -572,7 +1115,19 @@ int main(int argc, char** argv)
         info_log("Format: %s", args.output_format);
         info_log("Continuous: %s", args.continuous_monitor ? "yes" : "no");
         if (args.continuous_monitor) {
-            info_log("Interval: %d seconds", args.interval);
+            if (args.adaptive) {
+                info_log("Interval: adaptive, %ld-%ld ms, ramp %.2f",
+                         args.interval_floor_ms, args.interval_ceiling_ms, args.interval_ramp);
+            } else {
+                info_log("Interval: %ld ms", args.interval_ms);
+            }
+            info_log("Process list: %s", state.use_events ? "process events" : "/proc scan");
+        }
+        info_log("Collector threads: %d", state.pool != NULL ? state.pool->num_threads : 1);
+        info_log("Cycle engine: %s", args.engine == CYCLE_ENGINE_SCC ? "scc" : "dfs");
+        if (args.io_uring) {
+            info_log("I/O backend: %s", thread_proc_uring() != NULL ? "io_uring" :
+                                        "synchronous (io_uring unavailable)");
         }
         if (strlen(args.output_file) > 0) {
             info_log("Output file: %s", args.output_file);
@@ -580,19 +1135,44 @@ int main(int argc, char** argv)
         printf("\n");
     }
     
+    /* A fixed interval is a schedule whose floor and ceiling coincide */
+    ScanSchedule schedule;
+    long interval_ms = args.interval_ms;
+    if (args.adaptive) {
+        scan_schedule_init(&schedule, args.interval_floor_ms, args.interval_ceiling_ms,
+                           args.interval_ramp, interval_ms);
+    } else {
+        scan_schedule_init(&schedule, interval_ms, interval_ms, 1.0, interval_ms);
+    }
+    
+    /* Periods are counted from the start of the first scan */
+    if (event_loop != NULL) {
+        event_loop_rearm_now(event_loop);
+    }
+    
     /* Main detection loop */
     int result = SUCCESS;
+    int scan_again = 1;
     do {
-        /* Check if we should continue running */
-        if (!g_running) {
-            if (args.verbose) {
-                info_log("Shutdown requested, exiting...");
-            }
-            break;
-        }
         
         /* Run detection */
-        result = run_detection(&args);
+        ScanOutcome outcome;
+        memset(&outcome, 0, sizeof(outcome));
+        outcome.start_ms = scan_clock_ms();
+        result = run_detection(&args, &state, &outcome);
+        outcome.end_ms = scan_clock_ms();
+        
+        int was_deadlocked = schedule.in_deadlock;
+        long delay_ms = scan_schedule_update(&schedule, &outcome);
+        if (args.verbose && args.continuous_monitor) {
+            info_log("Scan took %.1f ms (%.2f%% of run time), next scan in %ld ms",
+                     schedule.last_scan_ms,
+                     100.0 * scan_schedule_overhead(&schedule, outcome.end_ms), delay_ms);
+            if (outcome.deadlock && !was_deadlocked && schedule.last_latency_ms >= 0.0) {
+                info_log("Deadlock reported at most %.0f ms after it formed",
+                         schedule.last_latency_ms);
+            }
+        }
         
         if (result != SUCCESS) {
             error_log("Detection cycle failed: %d", result);
@@ -602,14 +1182,48 @@ int main(int argc, char** argv)
         }
         
         /* Wait before next cycle if continuous */
-        if (args.continuous_monitor && g_running) {
-            /* Sleep in small intervals to check g_running flag */
-            for (int i = 0; i < args.interval && g_running; i++) {
-                sleep(1);
+        if (args.continuous_monitor && !g_stop_signal) {
+            scan_again = wait_for_next_scan(event_loop, delay_ms, args.verbose);
+            if (scan_again < 0) {
+                error_log("Waiting for the next scan failed: %d", scan_again);
+                result = scan_again;
             }
         }
         
-    } while (args.continuous_monitor && g_running);
+    } while (args.continuous_monitor && scan_again > 0 && !g_stop_signal);
+    
+    if (g_stop_signal) {
+        printf("\nReceived %s signal. Shutting down gracefully...\n",
+               g_stop_signal == SIGTERM ? "termination" : "interrupt");
+        if (args.verbose) {
+            info_log("Shutdown requested, exiting...");
+        }
+    }
+    
+    if (args.verbose && args.continuous_monitor && schedule.num_scans > 0) {
+        info_log("Scans: %lu, average %.1f ms, %.2f%% of run time",
+                 schedule.num_scans, schedule.total_scan_ms / (double)schedule.num_scans,
+                 100.0 * scan_schedule_overhead(&schedule, scan_clock_ms()));
+        if (schedule.worst_latency_ms >= 0.0) {
+            info_log("Worst deadlock detection latency: %.0f ms", schedule.worst_latency_ms);
+        }
+        if (event_loop != NULL && event_loop->overruns > 0) {
+            info_log("Ticks skipped after overrunning scans: %lu", event_loop->overruns);
+        }
+    }
+    
+    free_pid_vector(&state.pid_list);
+    free_fd_snapshot(&state.fd_snapshots[0]);
+    free_fd_snapshot(&state.fd_snapshots[1]);
+    free_scan_history(&state.history);
+    worker_pool_destroy(state.pool);
+    event_loop_close(event_loop);
+    destroy_scan_arenas(&state);
+    proc_handle_cache_destroy(&state.handle_cache);
+    proc_events_close(&state.events);
+    free_read_buffer(thread_read_buffer());
+    release_thread_proc_uring();
+    free_cycle_workspace();
     
     if (args.verbose) {
         info_log("Deadlock Detection System Stopped");
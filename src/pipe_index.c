@@ -0,0 +1,212 @@
+/* =============================================================================
+ * PIPE_INDEX.C - Pipe Inode Index Implementation
+ * =============================================================================
+ * Open-addressing hash from pipe inode to its endpoints, built in two linear
+ * passes over the collected pipe FDs.
+ * =============================================================================
+ */
+
+#include "pipe_index.h"
+#include "utility.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * hash_inode - Hash a pipe inode into a power-of-two table
+ * @inode: Pipe inode
+ * @mask: Table size minus one
+ * @return: Initial probe position
+ */
+static int hash_inode(unsigned long inode, int mask)
+{
+    unsigned long long h = (unsigned long long)inode * 0x9E3779B97F4A7C15ULL;
+    return (int)(h >> 32) & mask;
+}
+
+/*
+ * find_or_insert_slot - Locate slot for inode, claiming an empty one if absent
+ * @index: Index being built (must have free slots)
+ * @inode: Pipe inode
+ * @return: Slot index
+ */
+static int find_or_insert_slot(PipeIndex* index, unsigned long inode)
+{
+    int mask = index->num_slots - 1;
+    int pos = hash_inode(inode, mask);
+
+    while (index->slots[pos].num_procs != 0) {
+        if (index->slots[pos].inode == inode) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    /* Caller counts the first endpoint, which marks the slot occupied */
+    index->slots[pos].inode = inode;
+    index->slots[pos].last_proc = -1;
+    index->inode_slots[index->num_inodes++] = pos;
+    return pos;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * pipe_index_build - Build pipe index from collected processes
+ * @index: Index to fill (previous contents are freed)
+ * @procs: Array of ProcessResourceInfo with pipe_inodes/pipe_fds filled
+ * @num_procs: Number of processes
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Pass 1 counts endpoints and distinct processes per inode.
+ *              Offsets are then assigned per inode, and pass 2 writes each
+ *              endpoint into its inode's range. The table is kept at most
+ *              half full so probe sequences stay short.
+ * Error handling: Returns ERROR_OUT_OF_MEMORY on allocation failure, leaving
+ *                 the index empty
+ */
+int pipe_index_build(PipeIndex* index, const ProcessResourceInfo* procs, int num_procs)
+{
+    if (index == NULL || (procs == NULL && num_procs > 0) || num_procs < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    free_pipe_index(index);
+
+    int total = 0;
+    for (int i = 0; i < num_procs; i++) {
+        if (procs[i].pipe_inodes != NULL && procs[i].pipe_fds != NULL) {
+            total += procs[i].num_pipe_inodes;
+        }
+    }
+
+    if (total == 0) {
+        return SUCCESS;
+    }
+
+    int num_slots = 16;
+    while (num_slots < total * 2) {
+        num_slots *= 2;
+    }
+
+    index->slots = (PipeIndexSlot*)safe_malloc(sizeof(PipeIndexSlot) * num_slots);
+    index->inode_slots = (int*)safe_malloc(sizeof(int) * total);
+    index->endpoints = (PipeEndpoint*)safe_malloc(sizeof(PipeEndpoint) * total);
+    if (index->slots == NULL || index->inode_slots == NULL || index->endpoints == NULL) {
+        free_pipe_index(index);
+        return ERROR_OUT_OF_MEMORY;
+    }
+
+    memset(index->slots, 0, sizeof(PipeIndexSlot) * num_slots);
+    index->num_slots = num_slots;
+
+    /* Pass 1: count endpoints and distinct processes per inode */
+    for (int i = 0; i < num_procs; i++) {
+        if (procs[i].pipe_inodes == NULL || procs[i].pipe_fds == NULL) {
+            continue;
+        }
+        for (int k = 0; k < procs[i].num_pipe_inodes; k++) {
+            PipeIndexSlot* slot =
+                &index->slots[find_or_insert_slot(index, procs[i].pipe_inodes[k])];
+            slot->count++;
+            if (slot->last_proc != i) {
+                slot->last_proc = i;
+                slot->num_procs++;
+            }
+        }
+    }
+
+    /* Assign each inode a contiguous endpoint range; count restarts as cursor */
+    int offset = 0;
+    for (int n = 0; n < index->num_inodes; n++) {
+        PipeIndexSlot* slot = &index->slots[index->inode_slots[n]];
+        slot->first = offset;
+        offset += slot->count;
+        slot->count = 0;
+    }
+
+    /* Pass 2: place endpoints */
+    for (int i = 0; i < num_procs; i++) {
+        if (procs[i].pipe_inodes == NULL || procs[i].pipe_fds == NULL) {
+            continue;
+        }
+        for (int k = 0; k < procs[i].num_pipe_inodes; k++) {
+            int pos = pipe_index_find(index, procs[i].pipe_inodes[k]);
+            PipeIndexSlot* slot = &index->slots[pos];
+            PipeEndpoint* endpoint = &index->endpoints[slot->first + slot->count];
+            endpoint->proc_index = i;
+            endpoint->pid = procs[i].pid;
+            endpoint->fd = procs[i].pipe_fds[k];
+            endpoint->end = procs[i].pipe_ends != NULL ? procs[i].pipe_ends[k]
+                                                       : PIPE_END_UNKNOWN;
+            if (endpoint->end == PIPE_END_UNKNOWN) {
+                slot->num_unknown_ends++;
+            }
+            slot->count++;
+        }
+    }
+
+    index->num_endpoints = total;
+    return SUCCESS;
+}
+
+/*
+ * pipe_index_find - Look up the slot of a pipe inode
+ * @index: Built index
+ * @inode: Pipe inode to find
+ * @return: Slot index (into index->slots), or -1 if not present
+ * Description: Linear probing from the hashed position until the inode or an
+ *              empty slot is found.
+ * Error handling: Returns -1 for NULL or empty index
+ */
+int pipe_index_find(const PipeIndex* index, unsigned long inode)
+{
+    if (index == NULL || index->num_slots == 0) {
+        return -1;
+    }
+
+    int mask = index->num_slots - 1;
+    int pos = hash_inode(inode, mask);
+
+    while (index->slots[pos].num_procs != 0) {
+        if (index->slots[pos].inode == inode) {
+            return pos;
+        }
+        pos = (pos + 1) & mask;
+    }
+
+    return -1;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * free_pipe_index - Free memory owned by a pipe index
+ * @index: Index to clean up
+ * @return: None
+ * Description: Frees all arrays and resets counters.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_pipe_index(PipeIndex* index)
+{
+    if (index == NULL) {
+        return;
+    }
+
+    safe_free((void**)&index->slots);
+    safe_free((void**)&index->inode_slots);
+    safe_free((void**)&index->endpoints);
+    index->num_slots = 0;
+    index->num_inodes = 0;
+    index->num_endpoints = 0;
+}
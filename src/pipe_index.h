@@ -0,0 +1,100 @@
+#ifndef PIPE_INDEX_H
+#define PIPE_INDEX_H
+
+/* =============================================================================
+ * PIPE_INDEX.H - Pipe Inode Index Interface
+ * =============================================================================
+ * This header defines a hash index from pipe inode to the list of
+ * (process, fd) endpoints that have the pipe open. It is built once per scan
+ * from the collected process information so pipe relationships can be found
+ * by walking each inode's endpoint list instead of comparing every pair of
+ * processes.
+ * =============================================================================
+ */
+
+#include "process_monitor.h"
+#include "config.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * PipeEndpoint - One open end of a pipe
+ */
+typedef struct {
+    int proc_index;                 /* Index into the procs array used to build */
+    int pid;                        /* Process ID holding the endpoint */
+    int fd;                         /* File descriptor number in that process */
+    int end;                        /* PIPE_END_* of this FD */
+} PipeEndpoint;
+
+/*
+ * PipeIndexSlot - Hash slot for one pipe inode
+ * Endpoints of the inode are stored contiguously in PipeIndex.endpoints,
+ * grouped by process in the order processes were indexed.
+ */
+typedef struct {
+    unsigned long inode;            /* Pipe inode (valid if num_procs > 0) */
+    int first;                      /* Index of first endpoint */
+    int count;                      /* Number of endpoints */
+    int num_procs;                  /* Distinct processes among endpoints (0 = empty slot) */
+    int last_proc;                  /* Last proc_index seen while building */
+    int num_unknown_ends;           /* Endpoints whose end is PIPE_END_UNKNOWN */
+} PipeIndexSlot;
+
+/*
+ * PipeIndex - Open-addressing hash from pipe inode to endpoint list
+ */
+typedef struct {
+    PipeIndexSlot* slots;           /* Hash table (power-of-two size, linear probing) */
+    int num_slots;                  /* Number of slots */
+    int* inode_slots;               /* Indices of occupied slots, in insertion order */
+    int num_inodes;                 /* Number of distinct pipe inodes */
+    PipeEndpoint* endpoints;        /* Endpoint storage grouped by inode */
+    int num_endpoints;              /* Total number of endpoints */
+} PipeIndex;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * pipe_index_build - Build pipe index from collected processes
+ * @index: Index to fill (zero-initialize before first use; old contents are freed)
+ * @procs: Array of ProcessResourceInfo with pipe_inodes/pipe_fds filled
+ *         (pipe_ends optional; NULL marks every end unknown)
+ * @num_procs: Number of processes
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Counts endpoints per inode in one pass, assigns each inode a
+ *              contiguous range, then places endpoints in a second pass.
+ *              Time complexity: O(E) expected, E = total pipe endpoints
+ *              Space complexity: O(E)
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for bad parameters,
+ *                 ERROR_OUT_OF_MEMORY on allocation failure
+ */
+int pipe_index_build(PipeIndex* index, const ProcessResourceInfo* procs, int num_procs);
+
+/*
+ * pipe_index_find - Look up the slot of a pipe inode
+ * @index: Built index
+ * @inode: Pipe inode to find
+ * @return: Slot index (into index->slots), or -1 if not present
+ * Description: Time complexity: O(1) expected
+ * Error handling: Returns -1 for NULL or empty index
+ */
+int pipe_index_find(const PipeIndex* index, unsigned long inode);
+
+/*
+ * free_pipe_index - Free memory owned by a pipe index
+ * @index: Index to clean up
+ * @return: None
+ * Description: Frees all arrays and resets counters. Does not free the
+ *              index structure itself.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_pipe_index(PipeIndex* index);
+
+#endif /* PIPE_INDEX_H */
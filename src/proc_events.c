@@ -0,0 +1,512 @@
+/* =============================================================================
+ * PROC_EVENTS.C - Process Event Feed Implementation
+ * =============================================================================
+ * Netlink process connector subscription and the PID bitmap it maintains.
+ * =============================================================================
+ */
+
+#include "proc_events.h"
+#include "proc_handle.h"
+#include "utility.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
+
+#define LIVE_WORD_BITS ((int)(sizeof(unsigned long) * 8))
+#define LIVE_INITIAL_WORDS 1024         /* Covers PIDs below 65536 on 64-bit */
+
+/* Bytes of a proc_event needed to read one member of event_data */
+#define PROC_EVENT_NEEDS(member) \
+    (offsetof(struct proc_event, event_data) + sizeof(((struct proc_event*)0)->event_data.member))
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * live_set_add - Add a PID to the live set, growing the bitmap if needed
+ * @feed: Feed owning the set
+ * @pid: Process ID
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+static int live_set_add(ProcEventFeed* feed, pid_t pid)
+{
+    if (pid <= 0) {
+        return SUCCESS;
+    }
+
+    int word = pid / LIVE_WORD_BITS;
+    if (word >= feed->live_words) {
+        int words = feed->live_words > 0 ? feed->live_words : LIVE_INITIAL_WORDS;
+        while (words <= word) {
+            words *= 2;
+        }
+        unsigned long* grown = (unsigned long*)safe_realloc(feed->live,
+                                                            sizeof(unsigned long) * words);
+        if (grown == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        memset(grown + feed->live_words, 0,
+               sizeof(unsigned long) * (words - feed->live_words));
+        feed->live = grown;
+        feed->live_words = words;
+    }
+
+    unsigned long bit = 1UL << (pid % LIVE_WORD_BITS);
+    if ((feed->live[word] & bit) == 0) {
+        feed->live[word] |= bit;
+        feed->num_live++;
+    }
+    return SUCCESS;
+}
+
+/*
+ * live_set_remove - Remove a PID from the live set
+ * @feed: Feed owning the set
+ * @pid: Process ID
+ * @return: None
+ */
+static void live_set_remove(ProcEventFeed* feed, pid_t pid)
+{
+    if (pid <= 0 || pid / LIVE_WORD_BITS >= feed->live_words) {
+        return;
+    }
+
+    unsigned long bit = 1UL << (pid % LIVE_WORD_BITS);
+    unsigned long* word = &feed->live[pid / LIVE_WORD_BITS];
+    if (*word & bit) {
+        *word &= ~bit;
+        feed->num_live--;
+    }
+}
+
+/*
+ * record_exec - Remember that a process replaced its program image
+ * @feed: Feed owning the exec list
+ * @pid: Process ID
+ * @return: None
+ * Error handling: On allocation failure the feed is flagged for
+ *                 reconciliation instead, which callers treat the same way
+ */
+static void record_exec(ProcEventFeed* feed, pid_t pid)
+{
+    if (feed->num_execs == feed->exec_capacity) {
+        int capacity = feed->exec_capacity > 0 ? feed->exec_capacity * 2 : 64;
+        pid_t* grown = (pid_t*)safe_realloc(feed->execs, sizeof(pid_t) * capacity);
+        if (grown == NULL) {
+            feed->need_reconcile = 1;
+            return;
+        }
+        feed->execs = grown;
+        feed->exec_capacity = capacity;
+    }
+    feed->execs[feed->num_execs++] = pid;
+}
+
+/*
+ * reconcile - Rebuild the live set from a full /proc walk
+ * @feed: Feed owning the set
+ * @changes: Output: PIDs added or removed by the rebuild (may be NULL)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Error handling: The set is left unchanged if /proc cannot be read
+ */
+static int reconcile(ProcEventFeed* feed, int* changes)
+{
+    int result = enumerate_processes(&feed->scan);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    if (changes != NULL) {
+        int matches = 0;
+        for (int i = 0; i < feed->scan.count; i++) {
+            pid_t pid = feed->scan.pids[i];
+            if (pid > 0 && pid / LIVE_WORD_BITS < feed->live_words &&
+                (feed->live[pid / LIVE_WORD_BITS] & (1UL << (pid % LIVE_WORD_BITS)))) {
+                matches++;
+            }
+        }
+        *changes = (feed->scan.count - matches) + (feed->num_live - matches);
+    }
+
+    if (feed->live != NULL) {
+        memset(feed->live, 0, sizeof(unsigned long) * feed->live_words);
+    }
+    feed->num_live = 0;
+
+    for (int i = 0; i < feed->scan.count; i++) {
+        result = live_set_add(feed, feed->scan.pids[i]);
+        if (result != SUCCESS) {
+            return result;
+        }
+    }
+
+    feed->need_reconcile = 0;
+    feed->scans_since_reconcile = 0;
+    feed->num_events = 0;
+    return SUCCESS;
+}
+
+/*
+ * receive_events - Read and apply one datagram from the connector socket
+ * @feed: Subscribed feed
+ * @return: 1 if a datagram was handled, 0 if none is pending,
+ *          negative error code on failure
+ * Description: Datagrams not sent by the kernel are dropped. ENOBUFS means
+ *              the socket overflowed and events were lost.
+ */
+static int receive_events(ProcEventFeed* feed)
+{
+    unsigned long buf[PROC_EVENTS_RECV_BUFFER / sizeof(unsigned long)];
+    struct sockaddr_nl from;
+    socklen_t from_len = sizeof(from);
+
+    for (;;) {
+        ssize_t n = recvfrom(feed->fd, buf, sizeof(buf), 0,
+                             (struct sockaddr*)&from, &from_len);
+        if (n >= 0) {
+            if (from.nl_pid == 0) {
+                feed->num_events++;
+                proc_events_dispatch(feed, buf, (size_t)n);
+            }
+            return 1;
+        }
+        if (errno == EINTR) {
+            continue;
+        }
+        if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return 0;
+        }
+        if (errno == ENOBUFS) {
+            feed->num_events++;
+            feed->need_reconcile = 1;
+            return 1;
+        }
+        return proc_error_from_errno(errno);
+    }
+}
+
+/*
+ * subscribe - Ask the kernel to multicast process events to the socket
+ * @fd: Connector socket bound to CN_IDX_PROC
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+static int subscribe(int fd)
+{
+    unsigned long msg[(NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op)) +
+                       sizeof(unsigned long) - 1) / sizeof(unsigned long)];
+    memset(msg, 0, sizeof(msg));
+
+    struct nlmsghdr* nlh = (struct nlmsghdr*)msg;
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(enum proc_cn_mcast_op));
+    nlh->nlmsg_type = NLMSG_DONE;
+    nlh->nlmsg_pid = (__u32)getpid();
+
+    struct cn_msg* cn = (struct cn_msg*)NLMSG_DATA(nlh);
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(enum proc_cn_mcast_op);
+
+    enum proc_cn_mcast_op op = PROC_CN_MCAST_LISTEN;
+    memcpy(cn->data, &op, sizeof(op));
+
+    if (send(fd, msg, nlh->nlmsg_len, 0) < 0) {
+        return proc_error_from_errno(errno);
+    }
+    return SUCCESS;
+}
+
+/*
+ * probe_delivery - Check that events actually reach the socket
+ * @feed: Freshly subscribed feed
+ * @return: SUCCESS (0) if events of a probe child were delivered,
+ *          ERROR_SYSTEM_CALL_FAILED otherwise
+ * Description: Outside the initial network namespace the subscription
+ *              succeeds but no event is ever delivered, so a short-lived
+ *              child is forked and its events awaited.
+ */
+static int probe_delivery(ProcEventFeed* feed)
+{
+    pid_t child = fork();
+    if (child < 0) {
+        return proc_error_from_errno(errno);
+    }
+    if (child == 0) {
+        _exit(0);
+    }
+
+    int seen = 0;
+    int waited_ms = 0;
+    while (!seen && waited_ms < PROC_EVENTS_PROBE_TIMEOUT_MS) {
+        struct pollfd pfd = { feed->fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, 100);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+        waited_ms += 100;
+        if (ready <= 0) {
+            continue;
+        }
+
+        /* Any kernel message proves delivery; the /proc walk that follows
+         * supersedes whatever the events did to the set */
+        while (receive_events(feed) > 0) {
+            /* keep draining */
+        }
+        seen = feed->num_events > 0;
+    }
+
+    waitpid(child, NULL, 0);
+    return seen ? SUCCESS : ERROR_SYSTEM_CALL_FAILED;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * proc_events_dispatch - Apply one netlink datagram to the PID set
+ * @feed: Feed to update
+ * @buf: Datagram as received from the connector socket
+ * @len: Length of buf in bytes
+ * @return: Number of process events applied
+ * Description: Events are copied out of the datagram before use since the
+ *              payload follows the 20-byte cn_msg header unaligned.
+ */
+int proc_events_dispatch(ProcEventFeed* feed, const void* buf, size_t len)
+{
+    if (feed == NULL || buf == NULL) {
+        return 0;
+    }
+
+    int applied = 0;
+    int remaining = len > (size_t)PROC_EVENTS_RECV_BUFFER ? PROC_EVENTS_RECV_BUFFER : (int)len;
+    const struct nlmsghdr* nlh = (const struct nlmsghdr*)buf;
+
+    for (; NLMSG_OK(nlh, remaining); nlh = NLMSG_NEXT(nlh, remaining)) {
+        if (nlh->nlmsg_type == NLMSG_OVERRUN) {
+            feed->need_reconcile = 1;
+            continue;
+        }
+        if (nlh->nlmsg_type == NLMSG_NOOP || nlh->nlmsg_type == NLMSG_ERROR ||
+            nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct cn_msg))) {
+            continue;
+        }
+
+        const struct cn_msg* cn = (const struct cn_msg*)NLMSG_DATA(nlh);
+        if (cn->id.idx != CN_IDX_PROC || cn->id.val != CN_VAL_PROC ||
+            nlh->nlmsg_len < NLMSG_LENGTH(sizeof(struct cn_msg) + cn->len)) {
+            continue;
+        }
+
+        struct proc_event event;
+        size_t event_len = cn->len < sizeof(event) ? cn->len : sizeof(event);
+        memset(&event, 0, sizeof(event));
+        memcpy(&event, cn->data, event_len);
+
+        switch (event.what) {
+            case PROC_EVENT_FORK:
+                if (event_len >= PROC_EVENT_NEEDS(fork) &&
+                    event.event_data.fork.child_pid == event.event_data.fork.child_tgid) {
+                    if (live_set_add(feed, event.event_data.fork.child_tgid) != SUCCESS) {
+                        feed->need_reconcile = 1;
+                    }
+                    applied++;
+                }
+                break;
+            case PROC_EVENT_EXEC:
+                if (event_len >= PROC_EVENT_NEEDS(exec)) {
+                    record_exec(feed, event.event_data.exec.process_tgid);
+                    applied++;
+                }
+                break;
+            case PROC_EVENT_EXIT:
+                if (event_len >= PROC_EVENT_NEEDS(exit) &&
+                    event.event_data.exit.process_pid == event.event_data.exit.process_tgid) {
+                    live_set_remove(feed, event.event_data.exit.process_tgid);
+                    applied++;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    return applied;
+}
+
+/*
+ * proc_events_open - Subscribe to process events and seed the PID set
+ * @feed: Feed to open
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: The socket buffer is enlarged (best effort) so a burst of
+ *              forks between two scans does not overflow it.
+ */
+int proc_events_open(ProcEventFeed* feed)
+{
+    if (feed == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(feed, 0, sizeof(*feed));
+    feed->fd = socket(PF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC | SOCK_NONBLOCK,
+                      NETLINK_CONNECTOR);
+    if (feed->fd < 0) {
+        int result = proc_error_from_errno(errno);
+        feed->fd = -1;
+        return result;
+    }
+
+    int rcvbuf = PROC_EVENTS_SOCKET_BUFFER;
+    setsockopt(feed->fd, SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    struct sockaddr_nl addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.nl_family = AF_NETLINK;
+    addr.nl_groups = CN_IDX_PROC;
+    addr.nl_pid = 0;
+
+    int result = SUCCESS;
+    if (bind(feed->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        result = proc_error_from_errno(errno);
+    }
+    if (result == SUCCESS) {
+        result = subscribe(feed->fd);
+    }
+    if (result == SUCCESS) {
+        result = probe_delivery(feed);
+    }
+    if (result == SUCCESS) {
+        result = reconcile(feed, NULL);
+    }
+
+    if (result != SUCCESS) {
+        proc_events_close(feed);
+    }
+    feed->num_execs = 0;
+    return result;
+}
+
+/*
+ * proc_events_poll - Apply pending events and list the live processes
+ * @feed: Open feed
+ * @vec: PidVector to fill
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+int proc_events_poll(ProcEventFeed* feed, PidVector* vec)
+{
+    if (feed == NULL || vec == NULL || feed->fd < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    feed->num_execs = 0;
+
+    int received;
+    while ((received = receive_events(feed)) > 0) {
+        /* keep draining */
+    }
+    if (received < 0) {
+        feed->need_reconcile = 1;
+    }
+
+    feed->scans_since_reconcile++;
+    if (feed->need_reconcile || feed->scans_since_reconcile >= PROC_EVENTS_RECONCILE_SCANS) {
+        int silent = feed->num_events == 0;
+        int changes = 0;
+        if (reconcile(feed, &changes) == SUCCESS && silent && changes > 0) {
+            /* A fork or exit between the drain and the walk has its event
+             * queued only now; drain again before blaming delivery */
+            while ((received = receive_events(feed)) > 0) {
+                /* keep draining */
+            }
+            if (received < 0) {
+                feed->need_reconcile = 1;
+            } else if (feed->num_events == 0) {
+                /* The walk saw changes no event announced: delivery has stopped */
+                close(feed->fd);
+                feed->fd = -1;
+            }
+        }
+    }
+
+    return proc_events_fill(feed, vec);
+}
+
+/*
+ * proc_events_fill - Copy the live PID set into a vector
+ * @feed: Feed holding the set
+ * @vec: PidVector to fill
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+int proc_events_fill(const ProcEventFeed* feed, PidVector* vec)
+{
+    if (feed == NULL || vec == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    vec->count = 0;
+    if (feed->num_live > vec->capacity) {
+        pid_t* grown = (pid_t*)safe_realloc(vec->pids, sizeof(pid_t) * feed->num_live);
+        if (grown == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        vec->pids = grown;
+        vec->capacity = feed->num_live;
+    }
+
+    for (int w = 0; w < feed->live_words && vec->count < feed->num_live; w++) {
+        unsigned long word = feed->live[w];
+        while (word != 0) {
+            int bit = __builtin_ctzl(word);
+            vec->pids[vec->count++] = (pid_t)(w * LIVE_WORD_BITS + bit);
+            word &= word - 1;
+        }
+    }
+
+    return SUCCESS;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * proc_events_close - Unsubscribe and free a feed
+ * @feed: Feed to clean up
+ * @return: None
+ * Error handling: Handles NULL pointer and closed feeds safely
+ */
+void proc_events_close(ProcEventFeed* feed)
+{
+    if (feed == NULL) {
+        return;
+    }
+
+    if (feed->fd >= 0) {
+        close(feed->fd);
+    }
+    feed->fd = -1;
+
+    safe_free((void**)&feed->live);
+    safe_free((void**)&feed->execs);
+    free_pid_vector(&feed->scan);
+    feed->live_words = 0;
+    feed->num_live = 0;
+    feed->num_execs = 0;
+    feed->exec_capacity = 0;
+    feed->num_events = 0;
+    feed->scans_since_reconcile = 0;
+    feed->need_reconcile = 0;
+}
@@ -0,0 +1,119 @@
+#ifndef PROC_EVENTS_H
+#define PROC_EVENTS_H
+
+/* =============================================================================
+ * PROC_EVENTS.H - Process Event Feed Interface
+ * =============================================================================
+ * This header defines a live PID set kept up to date by the kernel's process
+ * events connector (NETLINK_CONNECTOR, CN_IDX_PROC). Fork and exit events
+ * add and remove processes as they happen, so a continuous scan gets its
+ * process list without walking /proc; exec events are reported so callers
+ * can drop anything they remembered about the old program image. A full
+ * /proc walk is only done to seed the set, to recover from lost events, and
+ * for periodic reconciliation. Subscribing requires CAP_NET_ADMIN.
+ * =============================================================================
+ */
+
+#include <sys/types.h>
+#include "process_monitor.h"
+#include "config.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * ProcEventFeed - Connector subscription and the PID set it maintains
+ * Only thread group leaders are tracked; thread creation and exit are
+ * ignored. Zero-initialize before use with fd set to -1 (see proc_events_open).
+ */
+typedef struct {
+    int fd;                         /* Connector socket (-1 = not subscribed) */
+    unsigned long* live;            /* Bitmap of live PIDs */
+    int live_words;                 /* Words in live */
+    int num_live;                   /* Number of bits set in live */
+    pid_t* execs;                   /* PIDs that exec'd since the last poll */
+    int num_execs;                  /* Number of entries in execs */
+    int exec_capacity;              /* Allocated capacity of execs */
+    unsigned long num_events;       /* Messages received since the last reconciliation */
+    int scans_since_reconcile;      /* Polls since the set was last rebuilt from /proc */
+    int need_reconcile;             /* 1 if events were lost and the set must be rebuilt */
+    PidVector scan;                 /* Scratch vector for /proc walks */
+} ProcEventFeed;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * proc_events_open - Subscribe to process events and seed the PID set
+ * @feed: Feed to open (contents are overwritten)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Binds a connector socket to the process events group and asks
+ *              the kernel to start multicasting, then seeds the set from one
+ *              /proc walk. Subscribing before the walk means no process can
+ *              start or exit unseen in between.
+ * Error handling: Returns ERROR_PERMISSION_DENIED without CAP_NET_ADMIN,
+ *                 ERROR_SYSTEM_CALL_FAILED if the connector is unavailable;
+ *                 the feed is left closed (fd -1) and callers should
+ *                 enumerate /proc themselves
+ */
+int proc_events_open(ProcEventFeed* feed);
+
+/*
+ * proc_events_poll - Apply pending events and list the live processes
+ * @feed: Open feed
+ * @vec: PidVector to fill (previous contents are discarded, storage is kept)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Drains the socket without blocking and fills vec in ascending
+ *              PID order. feed->execs lists the processes that exec'd since
+ *              the previous poll. The set is rebuilt from /proc after lost
+ *              events and every PROC_EVENTS_RECONCILE_SCANS polls; if a
+ *              rebuild finds changes although not a single event arrived
+ *              since the last one, nor while the rebuild walked /proc, the
+ *              kernel is not delivering events to this namespace and the
+ *              feed closes itself.
+ *              Time complexity: O(events + pid_max / word size)
+ * Error handling: Returns ERROR_INVALID_ARGUMENT if the feed is not open,
+ *                 ERROR_OUT_OF_MEMORY if vec cannot grow. When the feed
+ *                 closes itself vec is still filled from /proc.
+ */
+int proc_events_poll(ProcEventFeed* feed, PidVector* vec);
+
+/*
+ * proc_events_dispatch - Apply one netlink datagram to the PID set
+ * @feed: Feed to update (need not be subscribed)
+ * @buf: Datagram as received from the connector socket
+ * @len: Length of buf in bytes
+ * @return: Number of process events applied
+ * Description: Handles fork, exec and exit events of thread group leaders
+ *              and flags the feed for reconciliation on NLMSG_OVERRUN.
+ *              Used by proc_events_poll(); callable directly with
+ *              synthesized messages.
+ * Error handling: Truncated messages and other connector traffic are
+ *                 ignored
+ */
+int proc_events_dispatch(ProcEventFeed* feed, const void* buf, size_t len);
+
+/*
+ * proc_events_fill - Copy the live PID set into a vector
+ * @feed: Feed holding the set
+ * @vec: PidVector to fill (previous contents are discarded, storage is kept)
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ * Description: Time complexity: O(pid_max / word size + live PIDs)
+ */
+int proc_events_fill(const ProcEventFeed* feed, PidVector* vec);
+
+/*
+ * proc_events_close - Unsubscribe and free a feed
+ * @feed: Feed to clean up
+ * @return: None
+ * Description: Closes the socket and frees the set. Does not free the feed
+ *              structure itself.
+ * Error handling: Handles NULL pointer and closed feeds safely
+ */
+void proc_events_close(ProcEventFeed* feed);
+
+#endif /* PROC_EVENTS_H */
@@ -0,0 +1,787 @@
+/* =============================================================================
+ * PROC_HANDLE.C - Per-Process /proc Directory Handle Implementation
+ * =============================================================================
+ * Every per-process lookup goes through openat()/readlinkat()/fstatat()
+ * relative to a directory descriptor opened once per process. The handle
+ * cache keeps those descriptors open across continuous-mode scans.
+ * =============================================================================
+ */
+
+#define _GNU_SOURCE  /* syscall() */
+
+#include "proc_handle.h"
+#include "utility.h"
+#include "config.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <sys/file.h>
+#include <sys/wait.h>
+
+/* Enough for a few hundred FD entries per getdents64 call */
+#define FD_DIRENT_BUFFER_SIZE 8192
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * parse_fd_name - Parse a /proc/[PID]/fd entry name as an FD number
+ * @name: NUL-terminated entry name
+ * @return: FD number (>= 0), or -1 if name is not numeric
+ */
+static int parse_fd_name(const char* name)
+{
+    int value = 0;
+
+    if (*name == '\0') {
+        return -1;
+    }
+
+    for (const char* p = name; *p != '\0'; p++) {
+        if (*p < '0' || *p > '9' || value > (0x7fffffff - 9) / 10) {
+            return -1;
+        }
+        value = value * 10 + (*p - '0');
+    }
+
+    return value;
+}
+
+/*
+ * open_fd_dir - Open the fd directory of a handle if not yet open
+ * @handle: Open handle
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+static int open_fd_dir(ProcHandle* handle)
+{
+    if (handle->fd_dir_fd >= 0) {
+        return SUCCESS;
+    }
+
+    if (handle->dir_fd < 0) {
+        errno = EBADF;
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    handle->fd_dir_fd = openat(handle->dir_fd, PROC_FD_DIR,
+                               O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (handle->fd_dir_fd < 0) {
+        return proc_error_from_errno(errno);
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * hash_pid - Hash a PID into a power-of-two table
+ * @pid: Process ID
+ * @mask: Table size minus one
+ * @return: Initial probe position
+ */
+static int hash_pid(pid_t pid, int mask)
+{
+    unsigned long long h = (unsigned long long)(unsigned int)pid * 0x9E3779B97F4A7C15ULL;
+    return (int)(h >> 32) & mask;
+}
+
+/*
+ * cache_find_slot - Find the slot of pid, or the empty slot ending its probe
+ * @slots: Table to search
+ * @num_slots: Table size (power of two, never full)
+ * @pid: Process ID
+ * @return: Slot index
+ */
+static int cache_find_slot(const ProcHandleCacheEntry* slots, int num_slots, pid_t pid)
+{
+    int mask = num_slots - 1;
+    int pos = hash_pid(pid, mask);
+
+    while (slots[pos].pid != 0 && slots[pos].pid != pid) {
+        pos = (pos + 1) & mask;
+    }
+
+    return pos;
+}
+
+/*
+ * close_cache_slots - Close every handle of a table that is still owned by it
+ * @slots: Table
+ * @num_slots: Table size
+ * @return: None
+ */
+static void close_cache_slots(ProcHandleCacheEntry* slots, int num_slots)
+{
+    for (int i = 0; i < num_slots; i++) {
+        if (slots[i].pid != 0 && !slots[i].claimed) {
+            close(slots[i].dir_fd);
+        }
+    }
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * proc_error_from_errno - Map an errno from /proc access to an error code
+ * @err: errno value
+ * @return: Matching negative error code
+ */
+int proc_error_from_errno(int err)
+{
+    if (err == ENOENT || err == ESRCH) {
+        return ERROR_FILE_NOT_FOUND;
+    } else if (err == EACCES || err == EPERM) {
+        return ERROR_PERMISSION_DENIED;
+    }
+    return ERROR_SYSTEM_CALL_FAILED;
+}
+
+/*
+ * proc_handle_open - Open the /proc directory of a process
+ * @handle: Handle to initialize
+ * @pid: Process ID
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Formats "/proc/[PID]" once; every later lookup is relative
+ *              to the returned directory descriptor.
+ * Error handling: Leaves the handle closed on failure
+ */
+int proc_handle_open(ProcHandle* handle, pid_t pid)
+{
+    if (handle == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    handle->pid = pid;
+    handle->dir_fd = -1;
+    handle->fd_dir_fd = -1;
+    handle->start_time = 0;
+    handle->state = 0;
+
+    if (pid <= 0) {
+        return ERROR_INVALID_PROCESS_ID;
+    }
+
+    char path[64];
+    int result = snprintf(path, sizeof(path), "%s/%d", PROC_BASE_PATH, (int)pid);
+    if (result < 0 || (size_t)result >= sizeof(path)) {
+        return ERROR_BUFFER_OVERFLOW;
+    }
+
+    handle->dir_fd = open(path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (handle->dir_fd < 0) {
+        return proc_error_from_errno(errno);
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * proc_handle_read - Read a per-process file through the handle
+ * @handle: Open handle
+ * @filename: Name relative to /proc/[PID]
+ * @buffer: Buffer to read into
+ * @len: Output parameter for content length (may be NULL)
+ * @return: NUL-terminated content inside buffer, or NULL on error (errno set)
+ * Description: openat() + read_fd_into() + close().
+ * Error handling: Preserves errno from openat/read across close()
+ */
+char* proc_handle_read(ProcHandle* handle, const char* filename,
+                       ReadBuffer* buffer, size_t* len)
+{
+    if (handle == NULL || handle->dir_fd < 0 || filename == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+
+    int fd = openat(handle->dir_fd, filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+
+    char* content = read_fd_into(fd, buffer, len);
+    int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return content;
+}
+
+/*
+ * proc_handle_for_each_fd - Visit every open file descriptor of the process
+ * @handle: Open handle
+ * @visit: Callback invoked once per FD
+ * @context: Passed to visit
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Rewinds the fd directory and walks getdents64 records,
+ *              skipping "." and ".." and any non-numeric names.
+ * Error handling: Stops at the first error from getdents64 or visit
+ */
+int proc_handle_for_each_fd(ProcHandle* handle, ProcFdVisitFn visit, void* context)
+{
+    if (handle == NULL || visit == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    int result = open_fd_dir(handle);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    if (lseek(handle->fd_dir_fd, 0, SEEK_SET) < 0) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    char buffer[FD_DIRENT_BUFFER_SIZE] __attribute__((aligned(8)));
+
+    for (;;) {
+        long nread = syscall(SYS_getdents64, handle->fd_dir_fd, buffer, sizeof(buffer));
+        if (nread < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return proc_error_from_errno(errno);
+        }
+        if (nread == 0) {
+            return SUCCESS;
+        }
+
+        long offset = 0;
+        while (offset < nread) {
+            const struct linux_dirent64* entry =
+                (const struct linux_dirent64*)(buffer + offset);
+            offset += entry->d_reclen;
+
+            int fd = parse_fd_name(entry->d_name);
+            if (fd < 0) {
+                continue;
+            }
+
+            result = visit(context, fd, entry->d_name);
+            if (result != SUCCESS) {
+                return result;
+            }
+        }
+    }
+}
+
+/*
+ * proc_handle_readlink_fd - Read the link target of one open FD
+ * @handle: Open handle
+ * @name: Entry name in the fd directory
+ * @target: Output buffer for the NUL-terminated target
+ * @size: Size of target in bytes
+ * @return: Length of target, or -1 on error (errno set)
+ * Description: Targets longer than size - 1 are truncated.
+ * Error handling: Returns -1 with errno from readlinkat
+ */
+ssize_t proc_handle_readlink_fd(ProcHandle* handle, const char* name,
+                                char* target, size_t size)
+{
+    if (handle == NULL || name == NULL || target == NULL || size == 0) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    int result = open_fd_dir(handle);
+    if (result != SUCCESS) {
+        return -1;
+    }
+
+    ssize_t link_len = readlinkat(handle->fd_dir_fd, name, target, size - 1);
+    if (link_len < 0) {
+        return -1;
+    }
+
+    target[link_len] = '\0';
+    return link_len;
+}
+
+/*
+ * proc_handle_stat_fd - stat() the file behind one open FD
+ * @handle: Open handle
+ * @name: Entry name in the fd directory
+ * @st: Output stat buffer
+ * @return: SUCCESS (0) on success, ERROR_SYSTEM_CALL_FAILED on failure
+ */
+int proc_handle_stat_fd(ProcHandle* handle, const char* name, struct stat* st)
+{
+    if (handle == NULL || name == NULL || st == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    if (open_fd_dir(handle) != SUCCESS) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    if (fstatat(handle->fd_dir_fd, name, st, 0) != 0) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * proc_stat_parse - Extract state and start time from /proc/[PID]/stat text
+ * @stat: Contents of /proc/[PID]/stat
+ * @state: Output parameter for field 3
+ * @start_time: Output parameter for field 22
+ * @return: SUCCESS (0) on success, ERROR_INVALID_FORMAT on failure
+ * Description: Skips to the last ')' (end of the command name, field 2);
+ *              the state follows after one space, then fields 4..21.
+ */
+int proc_stat_parse(const char* stat, char* state, unsigned long long* start_time)
+{
+    if (stat == NULL || state == NULL || start_time == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    const char* p = strrchr(stat, ')');
+    if (p == NULL) {
+        return ERROR_INVALID_FORMAT;
+    }
+    p++;
+    if (p[0] != ' ' || p[1] == '\0') {
+        return ERROR_INVALID_FORMAT;
+    }
+    char value_state = p[1];
+
+    /* p is now just before field 3; field 22 follows 19 more separators */
+    for (int field = 3; field < 22; field++) {
+        p = strchr(p + 1, ' ');
+        if (p == NULL) {
+            return ERROR_INVALID_FORMAT;
+        }
+    }
+
+    char* endptr;
+    unsigned long long value = strtoull(p + 1, &endptr, 10);
+    if (endptr == p + 1) {
+        return ERROR_INVALID_FORMAT;
+    }
+
+    *state = value_state;
+    *start_time = value;
+    return SUCCESS;
+}
+
+/*
+ * proc_handle_read_stat - Read state and start time of the handle's process
+ * @handle: Open handle
+ * @state: Output parameter for field 3 of /proc/[PID]/stat
+ * @start_time: Output parameter for field 22 of /proc/[PID]/stat
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Error handling: Maps read errors with proc_error_from_errno()
+ */
+int proc_handle_read_stat(ProcHandle* handle, char* state, unsigned long long* start_time)
+{
+    if (handle == NULL || state == NULL || start_time == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    const char* stat = proc_handle_read(handle, PROC_STAT_FILE, thread_read_buffer(), NULL);
+    if (stat == NULL) {
+        return proc_error_from_errno(errno);
+    }
+
+    return proc_stat_parse(stat, state, start_time);
+}
+
+/* Compare a syscall number with the SYS_* constant of a syscall name */
+#define IS_SYSCALL(nr, name) ((nr) == (long)SYS_##name)
+
+/*
+ * classify_syscall - Decode the wait kind of a syscall and its arguments
+ * @nr: Syscall number
+ * @args: The six syscall arguments
+ * @wait: Output wait description (fd and child preset to -1)
+ * @return: None
+ * Description: Syscalls missing on an architecture are compiled out.
+ *              Only syscalls known to wait on no pipe, lock or child are
+ *              NONE; any other syscall (splice, tee, sendfile, preadv2, ...)
+ *              is UNKNOWN, so the wchan guess stays in effect for it.
+ */
+static void classify_syscall(long nr, const unsigned long* args, WaitSyscall* wait)
+{
+    int fd = (int)args[0];
+
+    wait->kind = WAIT_SYSCALL_UNKNOWN;
+
+    if (IS_SYSCALL(nr, read) || IS_SYSCALL(nr, readv) || IS_SYSCALL(nr, pread64)) {
+        wait->kind = WAIT_SYSCALL_READ;
+        wait->fd = fd;
+    } else if (IS_SYSCALL(nr, write) || IS_SYSCALL(nr, writev) || IS_SYSCALL(nr, pwrite64)) {
+        wait->kind = WAIT_SYSCALL_WRITE;
+        wait->fd = fd;
+    } else if (IS_SYSCALL(nr, flock)) {
+        wait->kind = WAIT_SYSCALL_NONE;
+        if (((int)args[1] & LOCK_NB) == 0) {
+            wait->kind = WAIT_SYSCALL_FLOCK;
+            wait->fd = fd;
+        }
+    } else if (IS_SYSCALL(nr, fcntl)) {
+        int cmd = (int)args[1];
+#ifdef F_OFD_SETLKW
+        int blocking = cmd == F_SETLKW || cmd == F_OFD_SETLKW;
+#else
+        int blocking = cmd == F_SETLKW;
+#endif
+        wait->kind = WAIT_SYSCALL_NONE;
+        if (blocking) {
+            wait->kind = WAIT_SYSCALL_FCNTL_LOCK;
+            wait->fd = fd;
+        }
+    } else if (IS_SYSCALL(nr, wait4)) {
+        /* The pid argument is an int; only a positive one names a child */
+        int pid = (int)args[0];
+        wait->kind = WAIT_SYSCALL_CHILD;
+        wait->child = pid > 0 ? pid : -1;
+    } else if (IS_SYSCALL(nr, waitid)) {
+        wait->kind = WAIT_SYSCALL_CHILD;
+        wait->child = (int)args[0] == P_PID ? (int)args[1] : -1;
+    } else if (IS_SYSCALL(nr, ppoll) || IS_SYSCALL(nr, pselect6) ||
+               IS_SYSCALL(nr, epoll_pwait)
+#ifdef SYS_poll
+               || IS_SYSCALL(nr, poll)
+#endif
+#ifdef SYS_select
+               || IS_SYSCALL(nr, select)
+#endif
+#ifdef SYS_epoll_wait
+               || IS_SYSCALL(nr, epoll_wait)
+#endif
+               ) {
+        /* Waits on a set of FDs that /proc does not show */
+        wait->kind = WAIT_SYSCALL_UNKNOWN;
+    } else if (IS_SYSCALL(nr, futex) || IS_SYSCALL(nr, nanosleep) ||
+               IS_SYSCALL(nr, clock_nanosleep) || IS_SYSCALL(nr, rt_sigsuspend) ||
+               IS_SYSCALL(nr, rt_sigtimedwait)
+#ifdef SYS_futex_waitv
+               || IS_SYSCALL(nr, futex_waitv)
+#endif
+#ifdef SYS_pause
+               || IS_SYSCALL(nr, pause)
+#endif
+               ) {
+        /* Sleeps that no pipe, lock or child can end */
+        wait->kind = WAIT_SYSCALL_NONE;
+    }
+}
+
+/*
+ * proc_handle_read_syscall - Decode the syscall the handle's process sleeps in
+ * @handle: Open handle
+ * @wait: Output; kind WAIT_SYSCALL_UNKNOWN on failure
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: The file holds "running", "-1 sp pc" for a task blocked
+ *              outside a syscall, or the number and six hex arguments.
+ * Error handling: Maps read errors with proc_error_from_errno()
+ */
+int proc_handle_read_syscall(ProcHandle* handle, WaitSyscall* wait)
+{
+    if (handle == NULL || wait == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    wait->kind = WAIT_SYSCALL_UNKNOWN;
+    wait->fd = -1;
+    wait->child = -1;
+
+    const char* line = proc_handle_read(handle, PROC_SYSCALL_FILE, thread_read_buffer(), NULL);
+    if (line == NULL) {
+        return proc_error_from_errno(errno);
+    }
+
+    if (strncmp(line, "running", 7) == 0) {
+        wait->kind = WAIT_SYSCALL_NONE;
+        return SUCCESS;
+    }
+
+    char* endptr;
+    long nr = strtol(line, &endptr, 10);
+    if (endptr == line) {
+        return ERROR_INVALID_FORMAT;
+    }
+    if (nr < 0) {
+        wait->kind = WAIT_SYSCALL_NONE;
+        return SUCCESS;
+    }
+
+    unsigned long args[6];
+    const char* p = endptr;
+    for (int i = 0; i < 6; i++) {
+        args[i] = strtoul(p, &endptr, 16);
+        if (endptr == p) {
+            return ERROR_INVALID_FORMAT;
+        }
+        p = endptr;
+    }
+
+    classify_syscall(nr, args, wait);
+    return SUCCESS;
+}
+
+/*
+ * proc_handle_acquire - Validate a cached handle or open a fresh one
+ * @handle: Handle with pid set; dir_fd may hold a cached directory or -1
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: A cached directory costs one stat read through openat(); only
+ *              a miss pays for the /proc/[PID] lookup.
+ * Error handling: Leaves the handle closed on failure
+ */
+int proc_handle_acquire(ProcHandle* handle)
+{
+    if (handle == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    unsigned long long start_time = 0;
+    char state = 0;
+
+    if (handle->dir_fd >= 0) {
+        int result = proc_handle_read_stat(handle, &state, &start_time);
+        if (result == SUCCESS && start_time == handle->start_time) {
+            handle->state = state;
+            return SUCCESS;
+        }
+
+        /* Process exited (ESRCH) or the PID now names another process */
+        proc_handle_close(handle);
+    }
+
+    int result = proc_handle_open(handle, handle->pid);
+    if (result != SUCCESS) {
+        return result;
+    }
+
+    result = proc_handle_read_stat(handle, &state, &start_time);
+    if (result != SUCCESS) {
+        proc_handle_close(handle);
+        return result;
+    }
+
+    handle->start_time = start_time;
+    handle->state = state;
+    return SUCCESS;
+}
+
+/*
+ * proc_handle_cache_init - Initialize an empty handle cache
+ * @cache: Cache to initialize
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Sizing by RLIMIT_NOFILE keeps the cache from starving the
+ *              collectors and the rest of the program of descriptors.
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED if getrlimit fails
+ */
+int proc_handle_cache_init(ProcHandleCache* cache)
+{
+    if (cache == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(cache, 0, sizeof(ProcHandleCache));
+
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    if (limit.rlim_cur < limit.rlim_max) {
+        struct rlimit raised = limit;
+        raised.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &raised) == 0) {
+            limit = raised;
+        }
+    }
+
+    rlim_t available = limit.rlim_cur;
+    if (available == RLIM_INFINITY || available > 0x7fffffff) {
+        available = 0x7fffffff;
+    }
+
+    cache->max_entries = available > PROC_HANDLE_CACHE_FD_RESERVE ?
+        (int)(available - PROC_HANDLE_CACHE_FD_RESERVE) : 0;
+    return SUCCESS;
+}
+
+/*
+ * proc_handle_cache_checkout - Hand cached handles to the slots of a scan
+ * @cache: Handle cache
+ * @pids: PIDs of the scan
+ * @num_pids: Number of PIDs
+ * @handles: Output array of num_pids handles
+ * @return: None
+ * Description: Claimed entries stay in the table only so check-in can tell
+ *              them apart from processes that disappeared.
+ */
+void proc_handle_cache_checkout(ProcHandleCache* cache, const pid_t* pids,
+                                int num_pids, ProcHandle* handles)
+{
+    if (pids == NULL || handles == NULL) {
+        return;
+    }
+
+    for (int i = 0; i < num_pids; i++) {
+        ProcHandle* handle = &handles[i];
+        handle->pid = pids[i];
+        handle->dir_fd = -1;
+        handle->fd_dir_fd = -1;
+        handle->start_time = 0;
+        handle->state = 0;
+
+        if (cache == NULL || cache->count == 0) {
+            continue;
+        }
+
+        ProcHandleCacheEntry* entry =
+            &cache->slots[cache_find_slot(cache->slots, cache->num_slots, pids[i])];
+        if (entry->pid == pids[i] && !entry->claimed) {
+            handle->dir_fd = entry->dir_fd;
+            handle->start_time = entry->start_time;
+            entry->claimed = 1;
+        }
+    }
+}
+
+/*
+ * proc_handle_cache_checkin - Take back the handles of a finished scan
+ * @cache: Handle cache
+ * @handles: Handles returned by proc_handle_cache_checkout()
+ * @num_handles: Number of handles
+ * @return: None
+ * Description: The new table is built in the spare array and the arrays are
+ *              swapped, so steady-state scans allocate nothing.
+ */
+void proc_handle_cache_checkin(ProcHandleCache* cache, ProcHandle* handles,
+                               int num_handles)
+{
+    if (cache == NULL || handles == NULL) {
+        return;
+    }
+
+    /* Cached processes this scan did not see have exited */
+    close_cache_slots(cache->slots, cache->num_slots);
+
+    int keep = 0;
+    for (int i = 0; i < num_handles; i++) {
+        if (handles[i].fd_dir_fd >= 0) {
+            close(handles[i].fd_dir_fd);
+            handles[i].fd_dir_fd = -1;
+        }
+        if (handles[i].dir_fd >= 0) {
+            keep++;
+        }
+    }
+    if (keep > cache->max_entries) {
+        keep = cache->max_entries;
+    }
+
+    int num_slots = 16;
+    while (num_slots < keep * 2) {
+        num_slots *= 2;
+    }
+
+    if (num_slots > cache->spare_slots) {
+        ProcHandleCacheEntry* grown = (ProcHandleCacheEntry*)safe_realloc(
+            cache->spare, sizeof(ProcHandleCacheEntry) * num_slots);
+        if (grown == NULL) {
+            for (int i = 0; i < num_handles; i++) {
+                proc_handle_close(&handles[i]);
+            }
+            memset(cache->slots, 0, sizeof(ProcHandleCacheEntry) * cache->num_slots);
+            cache->count = 0;
+            return;
+        }
+        cache->spare = grown;
+        cache->spare_slots = num_slots;
+    }
+
+    ProcHandleCacheEntry* slots = cache->spare;
+    memset(slots, 0, sizeof(ProcHandleCacheEntry) * num_slots);
+
+    int count = 0;
+    for (int i = 0; i < num_handles; i++) {
+        ProcHandle* handle = &handles[i];
+        if (handle->dir_fd < 0) {
+            continue;
+        }
+        if (count == keep) {
+            proc_handle_close(handle);
+            continue;
+        }
+
+        ProcHandleCacheEntry* entry =
+            &slots[cache_find_slot(slots, num_slots, handle->pid)];
+        if (entry->pid == handle->pid) {
+            proc_handle_close(handle); /* Duplicate PID in one scan */
+            continue;
+        }
+
+        entry->pid = handle->pid;
+        entry->dir_fd = handle->dir_fd;
+        entry->start_time = handle->start_time;
+        handle->dir_fd = -1;
+        count++;
+    }
+
+    /* Swap tables; the old one becomes the next spare */
+    cache->spare = cache->slots;
+    cache->spare_slots = cache->num_slots;
+    cache->slots = slots;
+    cache->num_slots = num_slots;
+    cache->count = count;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * proc_handle_close - Close all descriptors held by a handle
+ * @handle: Handle to close
+ * @return: None
+ * Error handling: Handles NULL and already closed handles safely
+ */
+void proc_handle_close(ProcHandle* handle)
+{
+    if (handle == NULL) {
+        return;
+    }
+
+    if (handle->fd_dir_fd >= 0) {
+        close(handle->fd_dir_fd);
+        handle->fd_dir_fd = -1;
+    }
+    if (handle->dir_fd >= 0) {
+        close(handle->dir_fd);
+        handle->dir_fd = -1;
+    }
+}
+
+/*
+ * proc_handle_cache_destroy - Close every cached handle and free the cache
+ * @cache: Cache to destroy
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void proc_handle_cache_destroy(ProcHandleCache* cache)
+{
+    if (cache == NULL) {
+        return;
+    }
+
+    close_cache_slots(cache->slots, cache->num_slots);
+    safe_free((void**)&cache->slots);
+    safe_free((void**)&cache->spare);
+    cache->num_slots = 0;
+    cache->spare_slots = 0;
+    cache->count = 0;
+}
@@ -0,0 +1,316 @@
+#ifndef PROC_HANDLE_H
+#define PROC_HANDLE_H
+
+/* =============================================================================
+ * PROC_HANDLE.H - Per-Process /proc Directory Handle Interface
+ * =============================================================================
+ * This header defines a handle that opens /proc/[PID] once and resolves every
+ * per-process file relative to that directory with openat(), readlinkat()
+ * and fstatat(). The kernel walks "/proc/[PID]" once per process instead of
+ * once per file, and no path strings are formatted per read.
+ *
+ * The directory descriptor is bound to the process that owned the PID when
+ * the handle was opened. If that process exits and the PID is reused during
+ * the scan, lookups through the handle fail with ESRCH instead of silently
+ * reading the new process.
+ * =============================================================================
+ */
+
+#include <stdint.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include "config.h"
+#include "utility.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * linux_dirent64 - Raw directory record returned by getdents64(2)
+ * glibc does not export this layout, so it is declared here
+ */
+struct linux_dirent64 {
+    uint64_t d_ino;                 /* Inode number */
+    int64_t d_off;                  /* Offset to next record */
+    unsigned short d_reclen;        /* Length of this record */
+    unsigned char d_type;           /* File type (DT_*) */
+    char d_name[];                  /* NUL-terminated file name */
+};
+
+/*
+ * ProcHandle - Open /proc/[PID] directory of one process
+ * Identity is pid plus start time (field 22 of /proc/[PID]/stat); the start
+ * time is only read by proc_handle_acquire().
+ */
+typedef struct {
+    pid_t pid;                      /* Process ID the handle was opened for */
+    int dir_fd;                     /* /proc/[PID] directory, -1 if closed */
+    int fd_dir_fd;                  /* /proc/[PID]/fd, opened on first use, -1 if not open */
+    unsigned long long start_time;  /* Start time in clock ticks (set by acquire) */
+    char state;                     /* State seen by the stat read of acquire */
+} ProcHandle;
+
+/*
+ * WaitSyscallKind - What a sleeping task waits for, from /proc/[PID]/syscall
+ */
+typedef enum {
+    WAIT_SYSCALL_UNKNOWN = 0,       /* Not read, unreadable, poll/select/epoll (the
+                                       fds are not known) or a syscall not decoded
+                                       (splice, sendfile, ...): use wchan */
+    WAIT_SYSCALL_NONE,              /* Running, or a sleep no pipe, lock or child ends
+                                       (futex, nanosleep, ...) */
+    WAIT_SYSCALL_READ,              /* read/readv/pread64 on fd */
+    WAIT_SYSCALL_WRITE,             /* write/writev/pwrite64 on fd */
+    WAIT_SYSCALL_FLOCK,             /* Blocking flock() on fd */
+    WAIT_SYSCALL_FCNTL_LOCK,        /* fcntl() F_SETLKW / F_OFD_SETLKW on fd */
+    WAIT_SYSCALL_CHILD              /* wait4() / waitid() */
+} WaitSyscallKind;
+
+/*
+ * WaitSyscall - Decoded blocking syscall of a task
+ */
+typedef struct {
+    WaitSyscallKind kind;           /* Kind of wait */
+    int fd;                         /* FD argument of read/write/lock waits (-1 = none) */
+    int child;                      /* Child PID of a child wait (-1 = any child) */
+} WaitSyscall;
+
+/*
+ * ProcHandleCacheEntry - Cached directory handle of one process
+ */
+typedef struct {
+    pid_t pid;                      /* Process ID (0 = empty slot) */
+    int dir_fd;                     /* Open /proc/[PID] directory */
+    unsigned long long start_time;  /* Start time recorded when validated */
+    int claimed;                    /* 1 once handed out by the current scan */
+} ProcHandleCacheEntry;
+
+/*
+ * ProcHandleCache - PID-keyed directory handles kept across scans
+ * Open-addressing hash (power-of-two size, linear probing), rebuilt by every
+ * check-in into the spare slot array so no entry is ever deleted in place.
+ */
+typedef struct {
+    ProcHandleCacheEntry* slots;    /* Current table */
+    ProcHandleCacheEntry* spare;    /* Table the next check-in rebuilds into */
+    int num_slots;                  /* Size of slots */
+    int spare_slots;                /* Size of spare */
+    int count;                      /* Cached handles */
+    int max_entries;                /* Cap derived from RLIMIT_NOFILE */
+} ProcHandleCache;
+
+/*
+ * ProcFdVisitFn - Callback for proc_handle_for_each_fd()
+ * @context: Caller-supplied context
+ * @fd: File descriptor number
+ * @name: Entry name in the fd directory (decimal form of fd)
+ * @return: SUCCESS (0) to continue, negative error code to stop the walk
+ */
+typedef int (*ProcFdVisitFn)(void* context, int fd, const char* name);
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * proc_handle_open - Open the /proc directory of a process
+ * @handle: Handle to initialize
+ * @pid: Process ID
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Opens /proc/[PID] with O_DIRECTORY. The fd directory is not
+ *              opened until a caller needs it.
+ *              Time complexity: O(1)
+ * Error handling: Returns ERROR_FILE_NOT_FOUND if the process does not exist,
+ *                 ERROR_PERMISSION_DENIED if access is denied; the handle is
+ *                 left closed on failure
+ */
+int proc_handle_open(ProcHandle* handle, pid_t pid);
+
+/*
+ * proc_handle_read - Read a per-process file through the handle
+ * @handle: Open handle
+ * @filename: Name relative to /proc/[PID] (e.g. "status", "fdinfo/3")
+ * @buffer: Buffer to read into (see read_fd_into())
+ * @len: Output parameter for content length (may be NULL)
+ * @return: NUL-terminated content inside buffer, or NULL on error (errno set)
+ * Description: openat() relative to the process directory followed by the
+ *              shared read loop.
+ *              Time complexity: O(file_size)
+ * Error handling: Returns NULL with errno from openat/read; ESRCH means the
+ *                 process behind the handle has exited
+ */
+char* proc_handle_read(ProcHandle* handle, const char* filename,
+                       ReadBuffer* buffer, size_t* len);
+
+/*
+ * proc_handle_for_each_fd - Visit every open file descriptor of the process
+ * @handle: Open handle
+ * @visit: Callback invoked once per FD
+ * @context: Passed to visit
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Opens /proc/[PID]/fd relative to the handle on first use and
+ *              drains it with getdents64 into a stack buffer. The directory
+ *              is rewound first, so a handle can be listed more than once.
+ *              Time complexity: O(f) where f is number of FDs
+ * Error handling: Returns ERROR_FILE_NOT_FOUND / ERROR_PERMISSION_DENIED if
+ *                 the fd directory cannot be opened, ERROR_SYSTEM_CALL_FAILED
+ *                 if listing fails, or the first error returned by visit
+ */
+int proc_handle_for_each_fd(ProcHandle* handle, ProcFdVisitFn visit, void* context);
+
+/*
+ * proc_handle_readlink_fd - Read the link target of one open FD
+ * @handle: Open handle
+ * @name: Entry name in the fd directory
+ * @target: Output buffer for the NUL-terminated target
+ * @size: Size of target in bytes
+ * @return: Length of target, or -1 on error (errno set)
+ * Description: readlinkat() relative to the fd directory.
+ *              Time complexity: O(1)
+ * Error handling: Returns -1 if the FD was closed or the process exited
+ */
+ssize_t proc_handle_readlink_fd(ProcHandle* handle, const char* name,
+                                char* target, size_t size);
+
+/*
+ * proc_handle_stat_fd - stat() the file behind one open FD
+ * @handle: Open handle
+ * @name: Entry name in the fd directory
+ * @st: Output stat buffer
+ * @return: SUCCESS (0) on success, ERROR_SYSTEM_CALL_FAILED on failure
+ * Description: fstatat() relative to the fd directory; the link is followed
+ *              to the open file, so renamed or unlinked files still resolve.
+ *              Time complexity: O(1)
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED with errno set
+ */
+int proc_handle_stat_fd(ProcHandle* handle, const char* name, struct stat* st);
+
+/*
+ * proc_stat_parse - Extract state and start time from /proc/[PID]/stat text
+ * @stat: Contents of /proc/[PID]/stat
+ * @state: Output parameter for field 3
+ * @start_time: Output parameter for field 22
+ * @return: SUCCESS (0) on success, ERROR_INVALID_FORMAT if the line cannot
+ *          be parsed
+ * Description: Shared by proc_handle_read_stat() and callers that read the
+ *              file some other way (batched reads).
+ *              Time complexity: O(line length)
+ */
+int proc_stat_parse(const char* stat, char* state, unsigned long long* start_time);
+
+/*
+ * proc_handle_read_stat - Read state and start time of the handle's process
+ * @handle: Open handle
+ * @state: Output parameter for field 3 of /proc/[PID]/stat
+ * @start_time: Output parameter for field 22 of /proc/[PID]/stat
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: The command name in field 2 may contain spaces and ')', so
+ *              fields are counted from the last ')'.
+ *              Time complexity: O(1)
+ * Error handling: Returns ERROR_FILE_NOT_FOUND if the process has exited,
+ *                 ERROR_INVALID_FORMAT if the line cannot be parsed
+ */
+int proc_handle_read_stat(ProcHandle* handle, char* state, unsigned long long* start_time);
+
+/*
+ * proc_handle_read_syscall - Decode the syscall the handle's process sleeps in
+ * @handle: Open handle
+ * @wait: Output; kind WAIT_SYSCALL_UNKNOWN on failure
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Parses the syscall number and arguments of the main thread
+ *              from /proc/[PID]/syscall and keeps the FD or child PID
+ *              argument of the waits that can form a deadlock.
+ *              Time complexity: O(1)
+ * Error handling: Returns ERROR_PERMISSION_DENIED without ptrace access,
+ *                 ERROR_FILE_NOT_FOUND if the process has exited,
+ *                 ERROR_INVALID_FORMAT if the line cannot be parsed
+ */
+int proc_handle_read_syscall(ProcHandle* handle, WaitSyscall* wait);
+
+/*
+ * proc_handle_acquire - Validate a cached handle or open a fresh one
+ * @handle: Handle with pid set; dir_fd may hold a cached directory or -1
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: A cached directory is kept if its stat file is still readable
+ *              and reports the recorded start time. handle->state is
+ *              refreshed from the same read. Otherwise (ESRCH, exit,
+ *              or a start-time mismatch) it is closed and /proc/[PID] is
+ *              opened again, recording the new start time.
+ *              Time complexity: O(1)
+ * Error handling: Returns ERROR_FILE_NOT_FOUND if the process is gone; the
+ *                 handle is left closed on failure
+ */
+int proc_handle_acquire(ProcHandle* handle);
+
+/*
+ * proc_handle_cache_init - Initialize an empty handle cache
+ * @cache: Cache to initialize
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Raises the soft RLIMIT_NOFILE to the hard limit and caps the
+ *              cache at the resulting limit minus
+ *              PROC_HANDLE_CACHE_FD_RESERVE. One descriptor is held per
+ *              cached process.
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED if getrlimit fails
+ */
+int proc_handle_cache_init(ProcHandleCache* cache);
+
+/*
+ * proc_handle_cache_checkout - Hand cached handles to the slots of a scan
+ * @cache: Handle cache
+ * @pids: PIDs of the scan
+ * @num_pids: Number of PIDs
+ * @handles: Output array of num_pids handles; slot i is for pids[i]
+ * @return: None
+ * Description: Slots of cached PIDs receive the cached directory and start
+ *              time, the rest start closed. Ownership of every descriptor
+ *              moves to handles until proc_handle_cache_checkin().
+ *              Time complexity: O(n) expected, no syscalls
+ */
+void proc_handle_cache_checkout(ProcHandleCache* cache, const pid_t* pids,
+                                int num_pids, ProcHandle* handles);
+
+/*
+ * proc_handle_cache_checkin - Take back the handles of a finished scan
+ * @cache: Handle cache
+ * @handles: Handles returned by proc_handle_cache_checkout()
+ * @num_handles: Number of handles
+ * @return: None
+ * Description: Rebuilds the cache from the open handles of this scan (up to
+ *              max_entries) and closes everything else: fd directories,
+ *              handles over the cap, and cached processes the scan no longer
+ *              saw. Every handle is left closed.
+ *              Time complexity: O(n) expected
+ * Error handling: If the table cannot grow, all handles are closed and the
+ *                 cache is emptied
+ */
+void proc_handle_cache_checkin(ProcHandleCache* cache, ProcHandle* handles,
+                               int num_handles);
+
+/*
+ * proc_handle_cache_destroy - Close every cached handle and free the cache
+ * @cache: Cache to destroy
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void proc_handle_cache_destroy(ProcHandleCache* cache);
+
+/*
+ * proc_error_from_errno - Map an errno from /proc access to an error code
+ * @err: errno value
+ * @return: ERROR_FILE_NOT_FOUND for ENOENT/ESRCH, ERROR_PERMISSION_DENIED for
+ *          EACCES/EPERM, ERROR_SYSTEM_CALL_FAILED otherwise
+ */
+int proc_error_from_errno(int err);
+
+/*
+ * proc_handle_close - Close all descriptors held by a handle
+ * @handle: Handle to close
+ * @return: None
+ * Error handling: Handles NULL and already closed handles safely
+ */
+void proc_handle_close(ProcHandle* handle);
+
+#endif /* PROC_HANDLE_H */
@@ -0,0 +1,455 @@
+/* =============================================================================
+ * PROC_URING.C - Batched /proc Reads Through io_uring
+ * =============================================================================
+ * Raw-syscall io_uring setup plus a two-submission open / read+close batch.
+ * =============================================================================
+ */
+
+#define _GNU_SOURCE  /* syscall() */
+
+#include "proc_uring.h"
+#include "utility.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+/* Consecutive io_uring_enter() failures (EAGAIN/EBUSY) tolerated per batch */
+#define URING_ENTER_RETRIES 100
+
+static int s_uring_enabled = 0;             /* Set by proc_uring_set_enabled() */
+static __thread ProcUring s_thread_uring;   /* Ring of the calling thread */
+static __thread int s_thread_uring_state;   /* 0 = not tried, 1 = ready, -1 = unavailable */
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * probe_operations - Check that the kernel supports the operations we use
+ * @fd: Ring file descriptor
+ * @return: 1 if OPENAT, READ and CLOSE are supported, 0 otherwise
+ * Description: IORING_REGISTER_PROBE itself appeared together with OPENAT
+ *              and CLOSE (5.6), so a failing probe means an older kernel.
+ */
+static int probe_operations(int fd)
+{
+    const int num_ops = 256;
+    struct io_uring_probe* probe = (struct io_uring_probe*)safe_malloc(
+        sizeof(struct io_uring_probe) + sizeof(struct io_uring_probe_op) * num_ops);
+    if (probe == NULL) {
+        return 0;
+    }
+    memset(probe, 0, sizeof(struct io_uring_probe) + sizeof(struct io_uring_probe_op) * num_ops);
+
+    int supported = 0;
+    if (syscall(__NR_io_uring_register, fd, IORING_REGISTER_PROBE, probe, num_ops) == 0) {
+        static const int needed[] = { IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_CLOSE };
+        supported = 1;
+        for (size_t i = 0; i < sizeof(needed) / sizeof(needed[0]); i++) {
+            if (needed[i] > probe->last_op ||
+                !(probe->ops[needed[i]].flags & IO_URING_OP_SUPPORTED)) {
+                supported = 0;
+            }
+        }
+    }
+
+    free(probe);
+    return supported;
+}
+
+/*
+ * get_sqe - Claim the next submission queue entry
+ * @ring: Ring
+ * @tail: In/out: local submission tail, published by the caller
+ * @return: Zeroed entry, or NULL if the submission ring is full
+ */
+static struct io_uring_sqe* get_sqe(ProcUring* ring, unsigned* tail)
+{
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    if (*tail - head >= ring->sq_entries) {
+        return NULL;
+    }
+
+    unsigned index = *tail & *ring->sq_mask;
+    struct io_uring_sqe* sqe = &((struct io_uring_sqe*)ring->sqes)[index];
+    memset(sqe, 0, sizeof(*sqe));
+    ring->sq_array[index] = index;
+    (*tail)++;
+    return sqe;
+}
+
+/*
+ * submit_and_reap - Submit queued entries and collect a number of completions
+ * @ring: Ring
+ * @expected: Completions to wait for
+ * @user_data: Output array of expected user_data values, in completion order
+ * @res: Output array of expected results, in completion order
+ * @num_reaped: Output parameter for the completions collected
+ * @return: SUCCESS (0) on success, ERROR_SYSTEM_CALL_FAILED if the ring fails
+ * Description: Loops until every completion arrived, resubmitting whatever
+ *              the kernel did not consume yet. On failure the completions
+ *              already posted are still collected, so the caller can release
+ *              what they opened.
+ */
+static int submit_and_reap(ProcUring* ring, unsigned expected,
+                           unsigned long long* user_data, int* res,
+                           unsigned* num_reaped)
+{
+    unsigned reaped = 0;
+    int failures = 0;
+    int result = SUCCESS;
+
+    while (reaped < expected) {
+        unsigned to_submit = *ring->sq_tail - __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+        long entered = syscall(__NR_io_uring_enter, ring->fd, to_submit, 1,
+                               IORING_ENTER_GETEVENTS, NULL, 0);
+        if (entered < 0) {
+            if ((errno != EINTR && errno != EAGAIN && errno != EBUSY) ||
+                ++failures > URING_ENTER_RETRIES) {
+                result = ERROR_SYSTEM_CALL_FAILED;
+            }
+        } else {
+            failures = 0;
+        }
+
+        unsigned head = *ring->cq_head;
+        unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        const struct io_uring_cqe* cqes = (const struct io_uring_cqe*)ring->cqes;
+        while (head != tail && reaped < expected) {
+            const struct io_uring_cqe* cqe = &cqes[head & *ring->cq_mask];
+            user_data[reaped] = cqe->user_data;
+            res[reaped] = cqe->res;
+            reaped++;
+            head++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+
+        if (result != SUCCESS) {
+            break;
+        }
+    }
+
+    *num_reaped = reaped;
+    return result;
+}
+
+/*
+ * close_opened - Close files a failed batch opened but did not close
+ * @fds: Per-request FD from the opens (negative = not open)
+ * @num_requests: Number of requests
+ * @closed: Per-request flag, 1 if its CLOSE completed (may be NULL)
+ * @return: None
+ */
+static void close_opened(const int* fds, int num_requests, const char* closed)
+{
+    for (int i = 0; i < num_requests; i++) {
+        if (fds[i] >= 0 && (closed == NULL || !closed[i])) {
+            close(fds[i]);
+        }
+    }
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * proc_uring_init - Set up a ring for batched reads
+ * @ring: Ring to initialize
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Each ring has a single submitter, so completions are run
+ *              when it waits (SINGLE_ISSUER / DEFER_TASKRUN, 6.1+; set up
+ *              without them on older kernels). The rings are mapped as one
+ *              region where the kernel allows it (IORING_FEAT_SINGLE_MMAP).
+ */
+int proc_uring_init(ProcUring* ring)
+{
+    if (ring == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    int fd = (int)syscall(__NR_io_uring_setup, PROC_URING_ENTRIES, &params);
+    if (fd < 0 && errno == EINVAL) {
+        memset(&params, 0, sizeof(params));
+        fd = (int)syscall(__NR_io_uring_setup, PROC_URING_ENTRIES, &params);
+    }
+    if (fd < 0) {
+        return errno == EPERM ? ERROR_PERMISSION_DENIED : ERROR_SYSTEM_CALL_FAILED;
+    }
+    ring->fd = fd;
+    ring->sq_entries = params.sq_entries;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    int single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single_mmap && cq_size > ring->sq_ring_size) {
+        ring->sq_ring_size = cq_size;
+    }
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                         fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        ring->sq_ring = NULL;
+        proc_uring_destroy(ring);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    if (single_mmap) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring_size = cq_size;
+        ring->cq_ring = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                             fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) {
+            ring->cq_ring = NULL;
+            proc_uring_destroy(ring);
+            return ERROR_SYSTEM_CALL_FAILED;
+        }
+    }
+
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                      fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        ring->sqes = NULL;
+        proc_uring_destroy(ring);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    char* sq = (char*)ring->sq_ring;
+    char* cq = (char*)ring->cq_ring;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = cq + params.cq_off.cqes;
+
+    if (!probe_operations(fd) || ring->sq_entries < 2 * PROC_URING_MAX_BATCH) {
+        proc_uring_destroy(ring);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    ring->buffers = (char*)safe_malloc((size_t)PROC_URING_MAX_BATCH * PROC_URING_READ_SIZE);
+    if (ring->buffers == NULL) {
+        proc_uring_destroy(ring);
+        return ERROR_OUT_OF_MEMORY;
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * proc_uring_read - Read a batch of small files
+ * @ring: Initialized ring
+ * @requests: Files to read
+ * @num_requests: Number of requests
+ * @return: SUCCESS (0) on success, negative error code if the ring failed
+ * Description: Hard links make the close run even when its read fails. A
+ *              read that fills its buffer may have been cut short and is
+ *              reported as -EOVERFLOW. A ring that fails is destroyed,
+ *              after closing every opened file whose CLOSE did not
+ *              complete, so a failed batch leaks no descriptors.
+ */
+int proc_uring_read(ProcUring* ring, ProcReadRequest* requests, int num_requests)
+{
+    if (ring == NULL || ring->fd < 0 || requests == NULL ||
+        num_requests < 0 || num_requests > PROC_URING_MAX_BATCH) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    if (num_requests == 0) {
+        return SUCCESS;
+    }
+
+    unsigned long long user_data[2 * PROC_URING_MAX_BATCH];
+    int res[2 * PROC_URING_MAX_BATCH];
+    int fds[PROC_URING_MAX_BATCH];
+    char closed[PROC_URING_MAX_BATCH];
+    unsigned reaped = 0;
+
+    /* Submission 1: every open. Entries are only seen by the kernel once
+     * the tail is published, so a full ring just abandons the batch */
+    unsigned tail = *ring->sq_tail;
+    for (int i = 0; i < num_requests; i++) {
+        struct io_uring_sqe* sqe = get_sqe(ring, &tail);
+        if (sqe == NULL) {
+            return ERROR_SYSTEM_CALL_FAILED;
+        }
+        sqe->opcode = IORING_OP_OPENAT;
+        sqe->fd = requests[i].dir_fd;
+        sqe->addr = (unsigned long long)(uintptr_t)requests[i].name;
+        sqe->open_flags = O_RDONLY | O_CLOEXEC;
+        sqe->user_data = (unsigned long long)i;
+        requests[i].data = NULL;
+        requests[i].len = -EIO;
+    }
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+    for (int i = 0; i < num_requests; i++) {
+        fds[i] = -1;
+    }
+    int submit_result = submit_and_reap(ring, (unsigned)num_requests, user_data, res, &reaped);
+    for (unsigned c = 0; c < reaped; c++) {
+        fds[user_data[c]] = res[c];
+    }
+    if (submit_result != SUCCESS) {
+        close_opened(fds, num_requests, NULL);
+        proc_uring_destroy(ring);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    /* Submission 2: each read hard-linked to its close */
+    unsigned expected = 0;
+    for (int i = 0; i < num_requests; i++) {
+        if (fds[i] < 0) {
+            requests[i].len = fds[i];
+            continue;
+        }
+
+        struct io_uring_sqe* sqe = get_sqe(ring, &tail);
+        struct io_uring_sqe* close_sqe = sqe != NULL ? get_sqe(ring, &tail) : NULL;
+        if (close_sqe == NULL) {
+            close_opened(fds, num_requests, NULL);
+            return ERROR_SYSTEM_CALL_FAILED;
+        }
+        sqe->opcode = IORING_OP_READ;
+        sqe->flags = IOSQE_IO_HARDLINK;
+        sqe->fd = fds[i];
+        sqe->addr = (unsigned long long)(uintptr_t)(ring->buffers + (size_t)i * PROC_URING_READ_SIZE);
+        sqe->len = PROC_URING_READ_SIZE - 1;
+        sqe->off = 0;
+        sqe->user_data = (unsigned long long)i * 2;
+
+        close_sqe->opcode = IORING_OP_CLOSE;
+        close_sqe->fd = fds[i];
+        close_sqe->user_data = (unsigned long long)i * 2 + 1;
+        expected += 2;
+    }
+    __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+    if (expected > 0 &&
+        submit_and_reap(ring, expected, user_data, res, &reaped) != SUCCESS) {
+        memset(closed, 0, sizeof(closed));
+        for (unsigned c = 0; c < reaped; c++) {
+            if (user_data[c] % 2 != 0) {
+                closed[user_data[c] / 2] = 1;
+            }
+        }
+        close_opened(fds, num_requests, closed);
+        proc_uring_destroy(ring);
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    for (unsigned c = 0; c < expected; c++) {
+        if (user_data[c] % 2 != 0) {
+            continue; /* close */
+        }
+        int i = (int)(user_data[c] / 2);
+        char* buf = ring->buffers + (size_t)i * PROC_URING_READ_SIZE;
+        if (res[c] < 0) {
+            requests[i].len = res[c];
+        } else if (res[c] >= PROC_URING_READ_SIZE - 1) {
+            requests[i].len = -EOVERFLOW;
+        } else {
+            buf[res[c]] = '\0';
+            requests[i].data = buf;
+            requests[i].len = res[c];
+        }
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * proc_uring_set_enabled - Select the batched backend for scans
+ * @enabled: 1 to batch reads through io_uring where available
+ * @return: None
+ */
+void proc_uring_set_enabled(int enabled)
+{
+    s_uring_enabled = enabled;
+}
+
+/*
+ * thread_proc_uring - Get the calling thread's ring
+ * @return: Ready ring, or NULL if unavailable
+ */
+ProcUring* thread_proc_uring(void)
+{
+    if (!s_uring_enabled || s_thread_uring_state < 0) {
+        return NULL;
+    }
+
+    if (s_thread_uring_state == 0) {
+        s_thread_uring_state = proc_uring_init(&s_thread_uring) == SUCCESS ? 1 : -1;
+    } else if (s_thread_uring.fd < 0) {
+        /* Destroyed after a failed batch */
+        s_thread_uring_state = -1;
+    }
+
+    return s_thread_uring_state > 0 ? &s_thread_uring : NULL;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * proc_uring_destroy - Unmap and close a ring
+ * @ring: Ring to clean up
+ * @return: None
+ * Error handling: Handles NULL pointer and closed rings safely
+ */
+void proc_uring_destroy(ProcUring* ring)
+{
+    if (ring == NULL) {
+        return;
+    }
+
+    if (ring->sqes != NULL) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring != NULL && ring->cq_ring != ring->sq_ring) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring != NULL) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+    safe_free((void**)&ring->buffers);
+
+    memset(ring, 0, sizeof(*ring));
+    ring->fd = -1;
+}
+
+/*
+ * release_thread_proc_uring - Destroy the calling thread's ring
+ * @return: None
+ */
+void release_thread_proc_uring(void)
+{
+    if (s_thread_uring_state > 0) {
+        proc_uring_destroy(&s_thread_uring);
+    }
+    s_thread_uring_state = 0;
+}
@@ -0,0 +1,130 @@
+#ifndef PROC_URING_H
+#define PROC_URING_H
+
+/* =============================================================================
+ * PROC_URING.H - Batched /proc Reads Through io_uring
+ * =============================================================================
+ * This header defines an optional I/O backend that reads many small /proc
+ * files with a handful of io_uring_enter() calls instead of an openat(),
+ * read() and close() each. The ring is driven with raw syscalls, so no
+ * liburing is needed. Every thread that batches reads gets its own ring on
+ * first use; where io_uring is missing (old kernel, ENOSYS, disabled by
+ * sysctl or seccomp) the lookup returns NULL and callers keep using the
+ * synchronous readers.
+ * =============================================================================
+ */
+
+#include <stddef.h>
+#include <sys/types.h>
+#include "config.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * ProcReadRequest - One file to read in a batch
+ */
+typedef struct {
+    int dir_fd;                     /* Directory name is relative to */
+    const char* name;               /* File name, e.g. "wchan" */
+    char* data;                     /* Output: NUL-terminated content, NULL on error */
+    ssize_t len;                    /* Output: content length, or -errno on error
+                                       (-EOVERFLOW if it did not fit) */
+} ProcReadRequest;
+
+/*
+ * ProcUring - A mapped io_uring instance and its read buffers
+ */
+typedef struct {
+    int fd;                         /* Ring file descriptor (-1 = none) */
+    void* sq_ring;                  /* Mapped submission ring */
+    void* cq_ring;                  /* Mapped completion ring (may equal sq_ring) */
+    void* sqes;                     /* Mapped submission queue entries */
+    size_t sq_ring_size;            /* Bytes mapped for sq_ring */
+    size_t cq_ring_size;            /* Bytes mapped for cq_ring (0 if shared) */
+    size_t sqes_size;               /* Bytes mapped for sqes */
+    unsigned* sq_head;              /* Kernel-owned submission head */
+    unsigned* sq_tail;              /* Submission tail */
+    unsigned* sq_mask;              /* Submission ring mask */
+    unsigned* sq_array;             /* Submission index array */
+    unsigned* cq_head;              /* Completion head */
+    unsigned* cq_tail;              /* Kernel-owned completion tail */
+    unsigned* cq_mask;              /* Completion ring mask */
+    void* cqes;                     /* Completion queue entries */
+    unsigned sq_entries;            /* Submission ring size */
+    char* buffers;                  /* PROC_URING_MAX_BATCH buffers of PROC_URING_READ_SIZE */
+} ProcUring;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * proc_uring_init - Set up a ring for batched reads
+ * @ring: Ring to initialize (contents are overwritten)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: io_uring_setup() with PROC_URING_ENTRIES entries, mmap of the
+ *              rings, and a probe that the kernel supports OPENAT, READ and
+ *              CLOSE (Linux 5.6+).
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED if io_uring or one of the
+ *                 operations is unavailable, ERROR_PERMISSION_DENIED if it
+ *                 is disabled; the ring is left closed
+ */
+int proc_uring_init(ProcUring* ring);
+
+/*
+ * proc_uring_read - Read a batch of small files
+ * @ring: Initialized ring
+ * @requests: Files to read; data and len are filled in
+ * @num_requests: Number of requests (at most PROC_URING_MAX_BATCH)
+ * @return: SUCCESS (0) if every request completed, negative error code if
+ *          the ring failed (request outputs are then unspecified)
+ * Description: Submits all opens in one io_uring_enter(), then each read
+ *              hard-linked to the close of its file in a second one. Each
+ *              file gets one read of up to PROC_URING_READ_SIZE - 1 bytes,
+ *              which returns single-record files such as stat and wchan
+ *              whole. Contents point into the ring's buffers and stay
+ *              valid until the next call.
+ *              Time complexity: O(n), 2 syscalls per batch
+ * Error handling: Per-file failures are reported through len
+ */
+int proc_uring_read(ProcUring* ring, ProcReadRequest* requests, int num_requests);
+
+/*
+ * proc_uring_destroy - Unmap and close a ring
+ * @ring: Ring to clean up
+ * @return: None
+ * Error handling: Handles NULL pointer and closed rings safely
+ */
+void proc_uring_destroy(ProcUring* ring);
+
+/*
+ * proc_uring_set_enabled - Select the batched backend for scans
+ * @enabled: 1 to batch reads through io_uring where available, 0 for
+ *           synchronous reads only
+ * @return: None
+ * Description: Call before scanning starts; threads read the setting when
+ *              they first ask for their ring.
+ */
+void proc_uring_set_enabled(int enabled);
+
+/*
+ * thread_proc_uring - Get the calling thread's ring
+ * @return: Ready ring, or NULL if the backend is disabled or io_uring is
+ *          unavailable
+ * Description: Initializes the ring on first use; a failed setup is not
+ *              retried by the same thread. Release it with
+ *              release_thread_proc_uring().
+ */
+ProcUring* thread_proc_uring(void);
+
+/*
+ * release_thread_proc_uring - Destroy the calling thread's ring
+ * @return: None
+ */
+void release_thread_proc_uring(void);
+
+#endif /* PROC_URING_H */
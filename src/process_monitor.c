@@ -6,7 +6,11 @@
  * =============================================================================
  */
 
+#define _GNU_SOURCE  /* syscall(), O_DIRECTORY, O_CLOEXEC */
+
 #include "process_monitor.h"
+#include "lock_index.h"
+#include "proc_uring.h"
 #include "utility.h"
 #include "config.h"
 #include <stdio.h>
@@ -19,6 +23,11 @@
 #include <sys/types.h>
 #include <ctype.h>
 #include <time.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdint.h>
+#include <sys/syscall.h>
+#include <pthread.h>
 
 /* Ensure dirent types are available */
 #ifndef DT_DIR
@@ -27,6 +36,13 @@
 #ifndef DT_LNK
 #define DT_LNK 10
 #endif
+#ifndef DT_UNKNOWN
+#define DT_UNKNOWN 0
+#endif
+
+/* Handle-based readers shared by the public pid-based wrappers */
+static int list_open_fds(ProcHandle* handle, int** fds, int* count);
+static int read_process_wchan(ProcHandle* handle, Arena* arena, char** wchan);
 
 /* =============================================================================
  * CACHE STRUCTURE
@@ -35,10 +51,12 @@
 
 /*
  * CacheEntry - Cache entry for process information
+ * Holds the parsed status fields, so a hit costs one struct copy instead of
+ * a string copy and a re-parse
  */
 typedef struct {
     pid_t pid;                      /* Process ID */
-    char* status_content;            /* Cached status file content */
+    ProcessInfo status;             /* Parsed status fields (fds/wchan unused) */
     time_t timestamp;                /* Cache timestamp */
     int valid;                      /* 1 if cache entry is valid */
 } CacheEntry;
@@ -47,6 +65,9 @@ static CacheEntry* s_cache = NULL;  /* Static cache array */
 static int s_cache_size = 0;        /* Current cache size */
 static int s_cache_capacity = 0;    /* Cache capacity */
 
+/* Guards s_cache; collectors may run on several worker threads */
+static pthread_mutex_t s_cache_mutex = PTHREAD_MUTEX_INITIALIZER;
+
 #define CACHE_INITIAL_CAPACITY 100
 #define CACHE_TTL_SECONDS 5
 
@@ -59,6 +80,7 @@ static int s_cache_capacity = 0;    /* Cache capacity */
  * find_cache_entry - Find cache entry for a PID
  * @pid: Process ID to find
  * @return: Index of cache entry, or -1 if not found
+ * Note: Caller must hold s_cache_mutex
  */
 static int find_cache_entry(pid_t pid)
 {
@@ -74,6 +96,8 @@ static int find_cache_entry(pid_t pid)
  * get_cache_entry - Get or create cache entry for PID
  * @pid: Process ID
  * @return: Pointer to cache entry, or NULL on error
+ * Note: Caller must hold s_cache_mutex; the pointer is only valid while
+ *       the mutex is held because the cache array may be reallocated
  */
 static CacheEntry* get_cache_entry(pid_t pid)
 {
@@ -86,8 +110,7 @@ static CacheEntry* get_cache_entry(pid_t pid)
         if (now - s_cache[idx].timestamp < CACHE_TTL_SECONDS) {
             return &s_cache[idx];
         }
-        /* Cache expired, free it */
-        safe_free((void**)&s_cache[idx].status_content);
+        /* Cache expired, reuse the slot */
         s_cache[idx].valid = 0;
     }
     
@@ -119,13 +142,224 @@ static CacheEntry* get_cache_entry(pid_t pid)
     
     /* Initialize cache entry */
     s_cache[idx].pid = pid;
-    s_cache[idx].status_content = NULL;
+    memset(&s_cache[idx].status, 0, sizeof(ProcessInfo));
     s_cache[idx].timestamp = now;
     s_cache[idx].valid = 1;
     
     return &s_cache[idx];
 }
 
+/*
+ * copy_status_fields - Copy the fields parsed from /proc/[PID]/status
+ * @dest: Destination (fds, wchan and pid are left untouched)
+ * @src: Source
+ * @return: None
+ */
+static void copy_status_fields(ProcessInfo* dest, const ProcessInfo* src)
+{
+    memcpy(dest->name, src->name, sizeof(dest->name));
+    dest->state = src->state;
+    dest->ppid = src->ppid;
+    dest->uid = src->uid;
+    dest->gid = src->gid;
+    dest->vm_rss = src->vm_rss;
+    dest->num_threads = src->num_threads;
+}
+
+/*
+ * cache_lookup_status - Fill status fields from the cache
+ * @pid: Process ID
+ * @info: Structure receiving the cached fields
+ * @return: 1 on a cache hit, 0 if not cached or expired
+ * Description: Copies the fields while holding s_cache_mutex so another
+ *              thread expiring the entry or growing the cache cannot change
+ *              it underneath the caller.
+ */
+static int cache_lookup_status(pid_t pid, ProcessInfo* info)
+{
+    int hit = 0;
+    time_t now = time(NULL);
+    
+    pthread_mutex_lock(&s_cache_mutex);
+    int idx = find_cache_entry(pid);
+    if (idx >= 0 && now - s_cache[idx].timestamp < CACHE_TTL_SECONDS) {
+        copy_status_fields(info, &s_cache[idx].status);
+        hit = 1;
+    }
+    pthread_mutex_unlock(&s_cache_mutex);
+    
+    return hit;
+}
+
+/*
+ * cache_store_status - Store parsed status fields in the cache
+ * @pid: Process ID
+ * @info: Parsed fields to cache (caller keeps ownership)
+ * @return: None
+ * Description: Failure to cache is not an error; the next lookup simply
+ *              misses.
+ */
+static void cache_store_status(pid_t pid, const ProcessInfo* info)
+{
+    pthread_mutex_lock(&s_cache_mutex);
+    CacheEntry* entry = get_cache_entry(pid);
+    if (entry != NULL) {
+        copy_status_fields(&entry->status, info);
+        entry->timestamp = time(NULL);
+    }
+    pthread_mutex_unlock(&s_cache_mutex);
+}
+
+/* =============================================================================
+ * PID ENUMERATION
+ * =============================================================================
+ */
+
+#define PID_VECTOR_INITIAL_CAPACITY 1024
+#define GETDENTS_BUFFER_SIZE (256 * 1024)
+
+/* Large enough that a typical /proc fits in one or two getdents64 calls */
+static char s_dirent_buffer[GETDENTS_BUFFER_SIZE] __attribute__((aligned(8)));
+
+/*
+ * parse_pid_name - Parse a /proc entry name as a PID
+ * @name: NUL-terminated directory entry name
+ * @return: PID value (> 0), or -1 if name is not a valid PID
+ */
+static long parse_pid_name(const char* name)
+{
+    long value = 0;
+
+    if (*name == '\0') {
+        return -1;
+    }
+
+    for (const char* p = name; *p != '\0'; p++) {
+        if (*p < '0' || *p > '9') {
+            return -1;
+        }
+        value = value * 10 + (*p - '0');
+        if (value > INT_MAX) {
+            return -1;
+        }
+    }
+
+    return value > 0 ? value : -1;
+}
+
+/*
+ * pid_vector_push - Append a PID to vector, growing storage if needed
+ * @vec: PidVector to append to
+ * @pid: Process ID to append
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+static int pid_vector_push(PidVector* vec, pid_t pid)
+{
+    if (vec->count >= vec->capacity) {
+        int new_capacity = vec->capacity == 0 ?
+            PID_VECTOR_INITIAL_CAPACITY : vec->capacity * 2;
+        pid_t* new_pids = (pid_t*)safe_realloc(vec->pids,
+                                               sizeof(pid_t) * new_capacity);
+        if (new_pids == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        vec->pids = new_pids;
+        vec->capacity = new_capacity;
+    }
+
+    vec->pids[vec->count++] = pid;
+    return SUCCESS;
+}
+
+/*
+ * enumerate_processes - Enumerate all process IDs into a reusable vector
+ * @vec: PidVector to fill (previous contents are discarded, storage is kept)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Opens /proc once and drains it with getdents64 into a static
+ *              buffer, so each kernel call returns hundreds of entries and no
+ *              per-entry libc bookkeeping is done. Only numeric directories
+ *              are kept. Time complexity: O(n) where n is number of entries
+ * Error handling: Returns ERROR_SYSTEM_CALL_FAILED / ERROR_PERMISSION_DENIED
+ *                 on open or getdents64 failure, ERROR_OUT_OF_MEMORY if the
+ *                 vector cannot grow
+ */
+int enumerate_processes(PidVector* vec)
+{
+    if (vec == NULL) {
+        error_log("enumerate_processes: vec is NULL");
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    vec->count = 0;
+
+    int dir_fd = open(PROC_BASE_PATH, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dir_fd < 0) {
+        error_log("Failed to open /proc directory: %s", strerror(errno));
+        return errno == EACCES ? ERROR_PERMISSION_DENIED : ERROR_SYSTEM_CALL_FAILED;
+    }
+
+    int result = SUCCESS;
+
+    for (;;) {
+        long nread = syscall(SYS_getdents64, dir_fd, s_dirent_buffer,
+                             sizeof(s_dirent_buffer));
+        if (nread < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error_log("getdents64 on /proc failed: %s", strerror(errno));
+            result = ERROR_SYSTEM_CALL_FAILED;
+            break;
+        }
+        if (nread == 0) {
+            break;
+        }
+
+        long offset = 0;
+        while (offset < nread) {
+            const struct linux_dirent64* entry =
+                (const struct linux_dirent64*)(s_dirent_buffer + offset);
+            offset += entry->d_reclen;
+
+            if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
+                continue;
+            }
+
+            long pid_val = parse_pid_name(entry->d_name);
+            if (pid_val <= 0) {
+                continue;
+            }
+
+            if (pid_vector_push(vec, (pid_t)pid_val) != SUCCESS) {
+                error_log("enumerate_processes: out of memory");
+                close(dir_fd);
+                return ERROR_OUT_OF_MEMORY;
+            }
+        }
+    }
+
+    close(dir_fd);
+    return result;
+}
+
+/*
+ * free_pid_vector - Release storage held by a PidVector
+ * @vec: PidVector to clean up
+ * @return: None
+ * Description: Frees the PID array and resets count and capacity.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_pid_vector(PidVector* vec)
+{
+    if (vec == NULL) {
+        return;
+    }
+
+    safe_free((void**)&vec->pids);
+    vec->count = 0;
+    vec->capacity = 0;
+}
+
 /* =============================================================================
  * MAIN FUNCTIONS
  * =============================================================================
@@ -135,9 +369,11 @@ static CacheEntry* get_cache_entry(pid_t pid)
  * get_all_processes - Get list of all running process IDs
  * @count: Output parameter for number of processes found
  * @return: Array of PIDs (caller must free with free_process_list), or NULL on error
- * Description: Scans /proc directory to find all process IDs.
- *              Returns array of valid PIDs. Time complexity: O(n) where n is
- *              number of processes. Memory: O(n) for PID array.
+ * Description: Convenience wrapper around enumerate_processes() that hands
+ *              ownership of the PID array to the caller. Callers that scan
+ *              repeatedly should keep a PidVector and call
+ *              enumerate_processes() directly instead.
+ *              Time complexity: O(n) where n is number of processes.
  * Error handling: Returns NULL on error, sets count to 0
  */
 pid_t* get_all_processes(int* count)
@@ -146,68 +382,19 @@ pid_t* get_all_processes(int* count)
         error_log("get_all_processes: count is NULL");
         return NULL;
     }
-    
+
     *count = 0;
-    
-    DIR* proc_dir = opendir(PROC_BASE_PATH);
-    if (proc_dir == NULL) {
-        error_log("Failed to open /proc directory: %s", strerror(errno));
-        return NULL;
-    }
-    
-    /* First pass: count numeric directories */
-    struct dirent* entry;
-    int pid_count = 0;
-    
-    while ((entry = readdir(proc_dir)) != NULL) {
-        if (entry->d_type == DT_DIR) {
-            /* Check if directory name is numeric (PID) */
-            char* endptr;
-            long pid_val = strtol(entry->d_name, &endptr, 10);
-            if (*endptr == '\0' && pid_val > 0) {
-                pid_count++;
-            }
-        }
-    }
-    
-    if (pid_count == 0) {
-        closedir(proc_dir);
-        *count = 0;
-        return NULL;
-    }
-    
-    /* Allocate array for PIDs */
-    pid_t* pids = (pid_t*)safe_malloc(sizeof(pid_t) * pid_count);
-    if (pids == NULL) {
-        closedir(proc_dir);
-        *count = 0;
-        return NULL;
-    }
-    
-    /* Second pass: collect PIDs */
-    closedir(proc_dir);
-    proc_dir = opendir(PROC_BASE_PATH);
-    if (proc_dir == NULL) {
-        free(pids);
-        *count = 0;
+
+    PidVector vec;
+    memset(&vec, 0, sizeof(vec));
+
+    if (enumerate_processes(&vec) != SUCCESS || vec.count == 0) {
+        free_pid_vector(&vec);
         return NULL;
     }
-    
-    int idx = 0;
-    
-    while ((entry = readdir(proc_dir)) != NULL) {
-        if (entry->d_type == DT_DIR) {
-            char* endptr;
-            long pid_val = strtol(entry->d_name, &endptr, 10);
-            if (*endptr == '\0' && pid_val > 0) {
-                pids[idx++] = (pid_t)pid_val;
-            }
-        }
-    }
-    
-    closedir(proc_dir);
-    *count = pid_count;
-    return pids;
+
+    *count = vec.count;
+    return vec.pids;
 }
 
 /*
@@ -232,15 +419,68 @@ char* read_proc_file(pid_t pid, const char* filename)
     return read_proc_file_safe((int)pid, filename);
 }
 
+/* Bits of the status fields parse_process_status() looks for */
+#define STATUS_FIELD_NAME    0x01
+#define STATUS_FIELD_STATE   0x02
+#define STATUS_FIELD_PPID    0x04
+#define STATUS_FIELD_UID     0x08
+#define STATUS_FIELD_GID     0x10
+#define STATUS_FIELD_VMRSS   0x20
+#define STATUS_FIELD_THREADS 0x40
+#define STATUS_FIELDS_ALL    0x7f
+
+/*
+ * status_key_matches - Check a status line for "<key>:" and skip past it
+ * @line: Start of the line
+ * @key: Key including the trailing ':'
+ * @len: Length of key
+ * @value: Output parameter for the first non-blank character after the key
+ * @return: 1 if the line starts with key, 0 otherwise
+ */
+static int status_key_matches(const char* line, const char* key, size_t len,
+                              const char** value)
+{
+    if (strncmp(line, key, len) != 0) {
+        return 0;
+    }
+    
+    const char* p = line + len;
+    while (*p == ' ' || *p == '\t') {
+        p++;
+    }
+    *value = p;
+    return 1;
+}
+
+/*
+ * parse_status_number - Parse the leading decimal number of a status value
+ * @p: First character of the value
+ * @return: Parsed value (0 if the value does not start with a digit)
+ */
+static unsigned long parse_status_number(const char* p)
+{
+    unsigned long value = 0;
+    while (*p >= '0' && *p <= '9') {
+        value = value * 10 + (unsigned long)(*p - '0');
+        p++;
+    }
+    return value;
+}
+
 /*
  * parse_process_status - Parse /proc/[PID]/status file content
  * @content: Content of status file
  * @info: Output structure to fill
  * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Parses status file format and extracts process information.
- *              Handles missing fields gracefully.
- *              Time complexity: O(n) where n is file size
- * Error handling: Returns ERROR_INVALID_ARGUMENT if content is malformed
+ * Description: Walks the buffer once without copying or modifying it. Each
+ *              line is dispatched on its first character, so only lines
+ *              that can hold a wanted field are compared, and values are
+ *              converted in place. Parsing stops as soon as every field has
+ *              been seen (Threads: comes before the long signal and CPU
+ *              mask lines). Missing fields are left zero.
+ *              Time complexity: O(n) where n is the bytes up to the last
+ *              wanted field
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for NULL parameters
  */
 int parse_process_status(const char* content, ProcessInfo* info)
 {
@@ -253,84 +493,83 @@ int parse_process_status(const char* content, ProcessInfo* info)
     info->fds = NULL;
     info->num_fds = 0;
     
-    /* Parse line by line */
-    char* content_copy = str_dup(content);
-    if (content_copy == NULL) {
-        return ERROR_OUT_OF_MEMORY;
-    }
-    
-    char* line = content_copy;
+    unsigned int found = 0;
+    const char* line = content;
     
-    while (*line != '\0') {
-        char* line_end = strchr(line, '\n');
-        if (line_end != NULL) {
-            *line_end = '\0';
-        }
+    while (*line != '\0' && found != STATUS_FIELDS_ALL) {
+        const char* value = NULL;
         
-        /* Parse Name: field */
-        if (str_starts_with(line, "Name:")) {
-            char* name_start = line + 5; /* Skip "Name:" */
-            str_trim(name_start);
-            size_t name_len = strlen(name_start);
-            if (name_len > 0 && name_len < MAX_PROCESS_NAME_LEN) {
-                strncpy(info->name, name_start, MAX_PROCESS_NAME_LEN - 1);
-                info->name[MAX_PROCESS_NAME_LEN - 1] = '\0';
+        switch (*line) {
+        case 'N':
+            if (status_key_matches(line, "Name:", 5, &value)) {
+                /* Name runs to end of line, minus trailing whitespace */
+                const char* end = value;
+                while (*end != '\0' && *end != '\n') {
+                    end++;
+                }
+                while (end > value && (end[-1] == ' ' || end[-1] == '\t' || end[-1] == '\r')) {
+                    end--;
+                }
+                size_t name_len = (size_t)(end - value);
+                if (name_len > 0 && name_len < MAX_PROCESS_NAME_LEN) {
+                    memcpy(info->name, value, name_len);
+                    info->name[name_len] = '\0';
+                }
+                found |= STATUS_FIELD_NAME;
             }
-        }
-        
-        /* Parse State: field */
-        else if (str_starts_with(line, "State:")) {
-            char* state_start = line + 6; /* Skip "State:" */
-            str_trim(state_start);
-            if (*state_start != '\0') {
-                info->state = *state_start;
+            break;
+        case 'S':
+            if (status_key_matches(line, "State:", 6, &value)) {
+                if (*value != '\0' && *value != '\n') {
+                    info->state = *value;
+                }
+                found |= STATUS_FIELD_STATE;
             }
+            break;
+        case 'P':
+            if (status_key_matches(line, "PPid:", 5, &value)) {
+                info->ppid = (pid_t)parse_status_number(value);
+                found |= STATUS_FIELD_PPID;
+            }
+            break;
+        case 'U':
+            /* First value is the real UID */
+            if (status_key_matches(line, "Uid:", 4, &value)) {
+                info->uid = (uid_t)parse_status_number(value);
+                found |= STATUS_FIELD_UID;
+            }
+            break;
+        case 'G':
+            /* First value is the real GID */
+            if (status_key_matches(line, "Gid:", 4, &value)) {
+                info->gid = (gid_t)parse_status_number(value);
+                found |= STATUS_FIELD_GID;
+            }
+            break;
+        case 'V':
+            /* Resident Set Size in KB; the number precedes "kB" */
+            if (status_key_matches(line, "VmRSS:", 6, &value)) {
+                info->vm_rss = parse_status_number(value);
+                found |= STATUS_FIELD_VMRSS;
+            }
+            break;
+        case 'T':
+            if (status_key_matches(line, "Threads:", 8, &value)) {
+                info->num_threads = (int)parse_status_number(value);
+                found |= STATUS_FIELD_THREADS;
+            }
+            break;
+        default:
+            break;
         }
         
-        /* Parse PPid: field */
-        else if (str_starts_with(line, "PPid:")) {
-            char* ppid_start = line + 5; /* Skip "PPid:" */
-            str_trim(ppid_start);
-            info->ppid = (pid_t)strtol(ppid_start, NULL, 10);
-        }
-        
-        /* Parse Uid: field (first value is real UID) */
-        else if (str_starts_with(line, "Uid:")) {
-            char* uid_start = line + 4; /* Skip "Uid:" */
-            str_trim(uid_start);
-            info->uid = (uid_t)strtol(uid_start, NULL, 10);
-        }
-        
-        /* Parse Gid: field (first value is real GID) */
-        else if (str_starts_with(line, "Gid:")) {
-            char* gid_start = line + 4; /* Skip "Gid:" */
-            str_trim(gid_start);
-            info->gid = (gid_t)strtol(gid_start, NULL, 10);
-        }
-        
-        /* Parse VmRSS: field (Resident Set Size in KB) */
-        else if (str_starts_with(line, "VmRSS:")) {
-            char* rss_start = line + 6; /* Skip "VmRSS:" */
-            str_trim(rss_start);
-            /* Extract number before "kB" */
-            info->vm_rss = (unsigned long)strtoul(rss_start, NULL, 10);
-        }
-        
-        /* Parse Threads: field */
-        else if (str_starts_with(line, "Threads:")) {
-            char* threads_start = line + 8; /* Skip "Threads:" */
-            str_trim(threads_start);
-            info->num_threads = (int)strtol(threads_start, NULL, 10);
-        }
-        
-        if (line_end != NULL) {
-            line = line_end + 1;
-        } else {
+        const char* line_end = strchr(line, '\n');
+        if (line_end == NULL) {
             break;
         }
+        line = line_end + 1;
     }
     
-    free(content_copy);
     return SUCCESS;
 }
 
@@ -358,47 +597,40 @@ int get_process_info(pid_t pid, ProcessInfo* info)
     
     info->pid = pid;
     
-    /* Check cache first */
-    CacheEntry* cache_entry = get_cache_entry(pid);
-    char* status_content = NULL;
+    /* One directory handle serves status, fd and wchan */
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        return result;
+    }
     
-    if (cache_entry != NULL && cache_entry->status_content != NULL) {
-        status_content = cache_entry->status_content;
-    } else {
+    /* Check cache first; a hit skips both the read and the parse */
+    if (!cache_lookup_status(pid, info)) {
         /* Read from file */
-        status_content = read_proc_file(pid, PROC_STATUS_FILE);
+        char* status_content = proc_handle_read(&handle, PROC_STATUS_FILE,
+                                                thread_read_buffer(), NULL);
         if (status_content == NULL) {
-            if (errno == ENOENT) {
-                return ERROR_FILE_NOT_FOUND;
-            } else if (errno == EACCES) {
-                return ERROR_PERMISSION_DENIED;
-            } else {
-                return ERROR_SYSTEM_CALL_FAILED;
-            }
+            result = proc_error_from_errno(errno);
+            proc_handle_close(&handle);
+            return result;
         }
         
-        /* Store in cache */
-        if (cache_entry != NULL) {
-            cache_entry->status_content = status_content;
-            cache_entry->timestamp = time(NULL);
+        /* Parse status content */
+        result = parse_process_status(status_content, info);
+        
+        if (result != SUCCESS) {
+            proc_handle_close(&handle);
+            return result;
         }
+        
+        /* Store parsed fields in cache */
+        cache_store_status(pid, info);
     }
     
-    /* Parse status content */
-    int result = parse_process_status(status_content, info);
     info->pid = pid; /* Ensure PID is set */
     
-    /* Don't free cached content */
-    if (cache_entry == NULL || cache_entry->status_content != status_content) {
-        free(status_content);
-    }
-    
-    if (result != SUCCESS) {
-        return result;
-    }
-    
     /* Get open file descriptors */
-    int fd_result = get_open_files(pid, &info->fds, &info->num_fds);
+    int fd_result = list_open_fds(&handle, &info->fds, &info->num_fds);
     if (fd_result != SUCCESS) {
         /* Non-fatal error, continue without FDs */
         debug_log("Failed to get open files for PID %d", pid);
@@ -407,13 +639,74 @@ int get_process_info(pid_t pid, ProcessInfo* info)
     }
     
     /* Get wait channel (wchan) */
-    int wchan_result = get_process_wchan(pid, &info->wchan);
+    int wchan_result = read_process_wchan(&handle, NULL, &info->wchan);
     if (wchan_result != SUCCESS) {
         /* Non-fatal error, continue without wchan */
         debug_log("Failed to get wchan for PID %d", pid);
         info->wchan = NULL;
     }
     
+    proc_handle_close(&handle);
+    return SUCCESS;
+}
+
+/*
+ * FdListContext - Growable FD number array filled by append_fd_number
+ */
+typedef struct {
+    int* fds;                       /* FD numbers collected so far */
+    int count;                      /* Number of valid entries */
+    int capacity;                   /* Allocated entries */
+} FdListContext;
+
+/*
+ * append_fd_number - proc_handle_for_each_fd() callback recording one FD
+ * @context: FdListContext
+ * @fd: File descriptor number
+ * @name: Entry name (unused)
+ * @return: SUCCESS (0), or ERROR_OUT_OF_MEMORY if the array cannot grow
+ */
+static int append_fd_number(void* context, int fd, const char* name)
+{
+    FdListContext* list = (FdListContext*)context;
+    (void)name;
+    
+    if (list->count == list->capacity) {
+        int new_capacity = list->capacity == 0 ? 16 : list->capacity * 2;
+        int* grown = (int*)safe_realloc(list->fds, sizeof(int) * new_capacity);
+        if (grown == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        list->fds = grown;
+        list->capacity = new_capacity;
+    }
+    
+    list->fds[list->count++] = fd;
+    return SUCCESS;
+}
+
+/*
+ * list_open_fds - Collect FD numbers through an open process handle
+ * @handle: Open handle
+ * @fds: Output array of file descriptor numbers (caller must free)
+ * @count: Output parameter for number of FDs found
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+static int list_open_fds(ProcHandle* handle, int** fds, int* count)
+{
+    FdListContext list = { NULL, 0, 0 };
+    
+    *fds = NULL;
+    *count = 0;
+    
+    int result = proc_handle_for_each_fd(handle, append_fd_number, &list);
+    if (result != SUCCESS) {
+        free(list.fds);
+        return result;
+    }
+    
+    *fds = list.fds;
+    *count = list.count;
     return SUCCESS;
 }
 
@@ -423,7 +716,8 @@ int get_process_info(pid_t pid, ProcessInfo* info)
  * @fds: Output array of file descriptor numbers
  * @count: Output parameter for number of FDs found
  * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Reads /proc/[PID]/fd directory to enumerate open FDs.
+ * Description: Lists /proc/[PID]/fd in a single getdents64 pass through a
+ *              process handle, growing the array as entries arrive.
  *              Allocates array for FDs. Caller must free fds array.
  *              Time complexity: O(f) where f is number of FDs
  * Error handling: Returns error codes for access issues
@@ -437,74 +731,99 @@ int get_open_files(pid_t pid, int** fds, int* count)
     *fds = NULL;
     *count = 0;
     
-    char fd_dir_path[MAX_PATH_LEN];
-    int result = snprintf(fd_dir_path, sizeof(fd_dir_path), 
-                          "%s/%d/%s", PROC_BASE_PATH, (int)pid, PROC_FD_DIR);
-    if (result < 0 || (size_t)result >= sizeof(fd_dir_path)) {
-        return ERROR_BUFFER_OVERFLOW;
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        return result;
     }
     
-    DIR* fd_dir = opendir(fd_dir_path);
-    if (fd_dir == NULL) {
-        if (errno == ENOENT) {
-            return ERROR_FILE_NOT_FOUND;
-        } else if (errno == EACCES) {
-            return ERROR_PERMISSION_DENIED;
-        } else {
-            return ERROR_SYSTEM_CALL_FAILED;
-        }
-    }
+    result = list_open_fds(&handle, fds, count);
+    proc_handle_close(&handle);
+    return result;
+}
+
+/*
+ * read_file_locks - Parse /proc/[PID]/locks through an open process handle
+ * @handle: Open handle
+ * @locks: Output array of FileLockInfo structures (caller must free)
+ * @count: Output parameter for number of locks found
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+static int read_file_locks(ProcHandle* handle, FileLockInfo** locks, int* count)
+{
+    *locks = NULL;
+    *count = 0;
     
-    /* Count file descriptors */
-    struct dirent* entry;
-    int fd_count = 0;
+    char* locks_content = proc_handle_read(handle, PROC_LOCKS_FILE,
+                                           thread_read_buffer(), NULL);
+    if (locks_content == NULL) {
+        return proc_error_from_errno(errno);
+    }
     
-    while ((entry = readdir(fd_dir)) != NULL) {
-        if (entry->d_type == DT_LNK || isdigit((unsigned char)entry->d_name[0])) {
-            char* endptr;
-            long fd_val = strtol(entry->d_name, &endptr, 10);
-            if (*endptr == '\0' && fd_val >= 0) {
-                fd_count++;
-            }
+    /* Count locks (each line is a lock) */
+    int lock_count = 0;
+    const char* p = locks_content;
+    while (*p != '\0') {
+        if (*p == '\n') {
+            lock_count++;
         }
+        p++;
+    }
+    if (*locks_content != '\0' && locks_content[strlen(locks_content) - 1] != '\n') {
+        lock_count++;
     }
     
-    if (fd_count == 0) {
-        closedir(fd_dir);
+    if (lock_count == 0) {
         return SUCCESS;
     }
     
     /* Allocate array */
-    *fds = (int*)safe_malloc(sizeof(int) * fd_count);
-    if (*fds == NULL) {
-        closedir(fd_dir);
+    *locks = (FileLockInfo*)safe_malloc(sizeof(FileLockInfo) * lock_count);
+    if (*locks == NULL) {
         return ERROR_OUT_OF_MEMORY;
     }
     
-    /* Collect file descriptors */
-    closedir(fd_dir);
-    fd_dir = opendir(fd_dir_path);
-    if (fd_dir == NULL) {
-        free(*fds);
-        *fds = NULL;
-        *count = 0;
-        return ERROR_SYSTEM_CALL_FAILED;
-    }
-    
+    /* Parse locks */
+    char* line = locks_content;
     int idx = 0;
     
-    while ((entry = readdir(fd_dir)) != NULL) {
-        if (entry->d_type == DT_LNK || isdigit((unsigned char)entry->d_name[0])) {
-            char* endptr;
-            long fd_val = strtol(entry->d_name, &endptr, 10);
-            if (*endptr == '\0' && fd_val >= 0) {
-                (*fds)[idx++] = (int)fd_val;
+    while (*line != '\0' && idx < lock_count) {
+        char* line_end = strchr(line, '\n');
+        if (line_end != NULL) {
+            *line_end = '\0';
+        }
+        
+        /* Parse lock line format: "1: FLOCK ADVISORY WRITE 1234 00:12:345678 0 EOF" */
+        FileLockInfo* lock = &(*locks)[idx];
+        memset(lock, 0, sizeof(FileLockInfo));
+        
+        /* Basic parsing - extract lock ID and type */
+        if (sscanf(line, "%d: %cLOCK", &lock->lock_id, &lock->lock_type) >= 2) {
+            /* Try to extract PID from line */
+            char* pid_str = strstr(line, " ");
+            if (pid_str != NULL) {
+                pid_str = strchr(pid_str + 1, ' ');
+                if (pid_str != NULL) {
+                    pid_str = strchr(pid_str + 1, ' ');
+                    if (pid_str != NULL) {
+                        pid_str = strchr(pid_str + 1, ' ');
+                        if (pid_str != NULL) {
+                            lock->pid = (int)strtol(pid_str + 1, NULL, 10);
+                        }
+                    }
+                }
             }
+            idx++;
+        }
+        
+        if (line_end != NULL) {
+            line = line_end + 1;
+        } else {
+            break;
         }
     }
     
-    closedir(fd_dir);
-    *count = fd_count;
+    *count = idx;
     return SUCCESS;
 }
 
@@ -528,10 +847,40 @@ int get_file_locks(pid_t pid, FileLockInfo** locks, int* count)
     *locks = NULL;
     *count = 0;
     
-    char* locks_content = read_proc_file(pid, PROC_LOCKS_FILE);
-    if (locks_content == NULL) {
-        if (errno == ENOENT) {
-            return ERROR_FILE_NOT_FOUND;
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        return result;
+    }
+    
+    result = read_file_locks(&handle, locks, count);
+    proc_handle_close(&handle);
+    return result;
+}
+
+/*
+ * read_process_wchan - Read /proc/[PID]/wchan into an arena or heap string
+ * @handle: Open handle of the process to query
+ * @arena: Arena for the result (NULL = heap, caller must free)
+ * @wchan: Output parameter for wait channel string
+ * @return: SUCCESS (0) on success, negative error code on failure
+ */
+static int read_process_wchan(ProcHandle* handle, Arena* arena, char** wchan)
+{
+    if (wchan == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    *wchan = NULL;
+    
+    size_t len = 0;
+    char* wchan_content = proc_handle_read(handle, PROC_WCHAN_FILE,
+                                           thread_read_buffer(), &len);
+    if (wchan_content == NULL) {
+        if (errno == ENOENT || errno == ESRCH) {
+            /* Process doesn't exist or wchan not available */
+            *wchan = arena_strdup(arena, "");
+            return SUCCESS;
         } else if (errno == EACCES) {
             return ERROR_PERMISSION_DENIED;
         } else {
@@ -539,191 +888,779 @@ int get_file_locks(pid_t pid, FileLockInfo** locks, int* count)
         }
     }
     
-    /* Count locks (each line is a lock) */
-    int lock_count = 0;
-    const char* p = locks_content;
-    while (*p != '\0') {
-        if (*p == '\n') {
-            lock_count++;
+    /* Remove trailing newline if present */
+    if (len > 0 && wchan_content[len - 1] == '\n') {
+        wchan_content[len - 1] = '\0';
+    }
+    
+    *wchan = arena_strdup(arena, wchan_content);
+    
+    return *wchan != NULL ? SUCCESS : ERROR_OUT_OF_MEMORY;
+}
+
+/*
+ * wchan_waits_on_pipe - Check whether a wait channel is a pipe wait
+ * @wchan: Wait channel string
+ * @return: 1 if the process sleeps on a pipe (or futex), 0 otherwise
+ */
+static int wchan_waits_on_pipe(const char* wchan)
+{
+    return strstr(wchan, "pipe") != NULL || strstr(wchan, "futex") != NULL;
+}
+
+/*
+ * wchan_waits_on_lock - Check whether a wait channel is a file lock wait
+ * @wchan: Wait channel string
+ * @return: 1 if the process sleeps on a lock, 0 otherwise
+ */
+static int wchan_waits_on_lock(const char* wchan)
+{
+    return strstr(wchan, "flock") != NULL || strstr(wchan, "lock") != NULL;
+}
+
+/*
+ * wchan_waits_on_child - Check whether a wait channel is a child wait
+ * @wchan: Wait channel string
+ * @return: 1 if the process sleeps in wait4()/waitid(), 0 otherwise
+ */
+static int wchan_waits_on_child(const char* wchan)
+{
+    return strstr(wchan, "do_wait") != NULL;
+}
+
+/*
+ * classify_wchan - Set the blocked flags of res_info from its wait channel
+ * @res_info: Resource info with wchan filled
+ * @return: None
+ */
+static void classify_wchan(ProcessResourceInfo* res_info)
+{
+    if (res_info->wchan != NULL && strlen(res_info->wchan) > 0) {
+        if (wchan_waits_on_pipe(res_info->wchan)) {
+            res_info->is_blocked_on_pipe = 1;
+        }
+        if (wchan_waits_on_lock(res_info->wchan)) {
+            res_info->is_blocked_on_lock = 1;
+        }
+        if (wchan_waits_on_child(res_info->wchan)) {
+            res_info->is_blocked_on_child = 1;
         }
-        p++;
     }
-    if (*locks_content != '\0' && locks_content[strlen(locks_content) - 1] != '\n') {
-        lock_count++;
+}
+
+/*
+ * apply_wait_syscall - Replace the wchan guesses with the decoded syscall
+ * @res_info: Resource info with wait and pipe_fds filled
+ * @return: None
+ * Description: A read or write only counts as a pipe wait if its FD is a
+ *              pipe. With kind WAIT_SYSCALL_UNKNOWN the flags are kept.
+ */
+static void apply_wait_syscall(ProcessResourceInfo* res_info)
+{
+    WaitSyscallKind kind = res_info->wait.kind;
+    if (kind == WAIT_SYSCALL_UNKNOWN) {
+        return;
     }
     
-    if (lock_count == 0) {
-        free(locks_content);
-        return SUCCESS;
+    res_info->is_blocked_on_pipe = 0;
+    if (kind == WAIT_SYSCALL_READ || kind == WAIT_SYSCALL_WRITE) {
+        for (int i = 0; i < res_info->num_pipe_inodes; i++) {
+            if (res_info->pipe_fds[i] == res_info->wait.fd) {
+                res_info->is_blocked_on_pipe = 1;
+                break;
+            }
+        }
+    }
+    res_info->is_blocked_on_lock = kind == WAIT_SYSCALL_FLOCK ||
+                                   kind == WAIT_SYSCALL_FCNTL_LOCK;
+    res_info->is_blocked_on_child = kind == WAIT_SYSCALL_CHILD;
+}
+
+/*
+ * read_child_pids - Fill the children a blocked child wait can return for
+ * @handle: Open handle of the waiting process
+ * @arena: Arena for the array (NULL = heap)
+ * @res_info: Resource info with wait filled
+ * @return: None
+ * Description: A wait for one PID needs no read; a wait for any child lists
+ *              task/[PID]/children (children of the main thread).
+ */
+static void read_child_pids(ProcHandle* handle, Arena* arena, ProcessResourceInfo* res_info)
+{
+    if (res_info->wait.kind == WAIT_SYSCALL_CHILD && res_info->wait.child > 0) {
+        res_info->child_pids = (int*)arena_alloc(arena, sizeof(int));
+        if (res_info->child_pids != NULL) {
+            res_info->child_pids[0] = res_info->wait.child;
+            res_info->num_child_pids = 1;
+        }
+        return;
     }
     
-    /* Allocate array */
-    *locks = (FileLockInfo*)safe_malloc(sizeof(FileLockInfo) * lock_count);
-    if (*locks == NULL) {
-        free(locks_content);
-        return ERROR_OUT_OF_MEMORY;
+    char name[64];
+    snprintf(name, sizeof(name), "task/%d/children", (int)handle->pid);
+    const char* p = proc_handle_read(handle, name, thread_read_buffer(), NULL);
+    if (p == NULL || *p == '\0') {
+        return;
     }
     
-    /* Parse locks */
-    char* line = locks_content;
-    int idx = 0;
+    res_info->child_pids = (int*)arena_alloc(arena, sizeof(int) * MAX_WAITING_PIDS);
+    if (res_info->child_pids == NULL) {
+        return;
+    }
     
-    while (*line != '\0' && idx < lock_count) {
-        char* line_end = strchr(line, '\n');
-        if (line_end != NULL) {
-            *line_end = '\0';
+    char* endptr;
+    while (res_info->num_child_pids < MAX_WAITING_PIDS) {
+        long child = strtol(p, &endptr, 10);
+        if (endptr == p) {
+            break;
         }
+        res_info->child_pids[res_info->num_child_pids++] = (int)child;
+        p = endptr;
+    }
+}
+
+/*
+ * fill_pipes_from_table - Copy pipe inodes and FDs out of res_info's FD table
+ * @res_info: Resource info whose fd_table is set (or NULL)
+ * @arena: Arena for the arrays (NULL = heap)
+ * @return: None
+ */
+static void fill_pipes_from_table(ProcessResourceInfo* res_info, Arena* arena)
+{
+    const FdTable* fd_table = res_info->fd_table;
+    if (fd_table == NULL || fd_table->num_pipes == 0) {
+        return;
+    }
+    
+    int pipe_count = fd_table->num_pipes;
+    res_info->pipe_inodes = (unsigned long*)arena_alloc(arena, sizeof(unsigned long) * pipe_count);
+    res_info->pipe_fds = (int*)arena_alloc(arena, sizeof(int) * pipe_count);
+    res_info->pipe_ends = (int*)arena_alloc(arena, sizeof(int) * pipe_count);
+    
+    if (res_info->pipe_inodes != NULL && res_info->pipe_fds != NULL &&
+        res_info->pipe_ends != NULL) {
+        int idx = 0;
+        for (int i = 0; i < fd_table->num_entries; i++) {
+            const FdEntry* entry = &fd_table->entries[i];
+            if (entry->kind == FD_KIND_PIPE) {
+                res_info->pipe_inodes[idx] = entry->inode;
+                res_info->pipe_fds[idx] = entry->fd;
+                res_info->pipe_ends[idx] = entry->pipe_end;
+                idx++;
+            }
+        }
+        res_info->num_pipe_inodes = idx;
+    }
+}
+
+/*
+ * get_process_resources - Get resource allocation information for a process
+ * @pid: Process ID to query
+ * @res_info: Output structure to fill with resource information
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Standalone variant of get_process_resources_with_table() that
+ *              uses a temporary FD table. res_info->fd_table is left NULL.
+ *              Time complexity: O(f + l) where f=num FDs, l=num locks
+ * Error handling: Returns error codes for file access issues,
+ *                 partial success if some data unavailable
+ */
+int get_process_resources(pid_t pid, ProcessResourceInfo* res_info)
+{
+    FdTable table;
+    memset(&table, 0, sizeof(table));
+    
+    int result = get_process_resources_with_table(pid, &table, NULL, res_info);
+    
+    if (res_info != NULL) {
+        res_info->fd_table = NULL;
+    }
+    free_fd_table(&table);
+    return result;
+}
+
+/*
+ * get_process_resources_with_table - Get resource information using an FD table
+ * @pid: Process ID to query
+ * @fd_table: FD table to fill for this process
+ * @arena: Scan arena for res_info's arrays and strings (NULL = heap)
+ * @res_info: Output structure to fill with resource information
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Opens a temporary handle for pid and runs
+ *              get_process_resources_at() through it.
+ *              Time complexity: O(f + l) where f=num FDs, l=num locks
+ * Error handling: Returns ERROR_FILE_NOT_FOUND if the process is gone,
+ *                 partial success if some data unavailable
+ */
+int get_process_resources_with_table(pid_t pid, FdTable* fd_table, Arena* arena,
+                                     ProcessResourceInfo* res_info)
+{
+    if (res_info == NULL || fd_table == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        memset(res_info, 0, sizeof(ProcessResourceInfo));
+        res_info->pid = (int)pid;
+        fd_table_clear(fd_table);
+        return result;
+    }
+    
+    result = get_process_resources_at(&handle, fd_table, arena, res_info);
+    proc_handle_close(&handle);
+    return result;
+}
+
+/*
+ * record_start_time - Record which incarnation of the PID was collected
+ * @handle: Open handle of the process
+ * @res_info: Resource information being filled
+ * @return: None
+ * Description: Acquired handles already carry the start time; handles from
+ *              proc_handle_open() do not, so it is read from stat. Left 0
+ *              if the read fails.
+ */
+static void record_start_time(ProcHandle* handle, ProcessResourceInfo* res_info)
+{
+    if (handle->start_time != 0) {
+        res_info->start_time = handle->start_time;
+        return;
+    }
+    
+    char state = 0;
+    unsigned long long start_time = 0;
+    if (proc_handle_read_stat(handle, &state, &start_time) == SUCCESS) {
+        res_info->start_time = start_time;
+    }
+}
+
+/*
+ * get_process_resources_at - Get resource information through a process handle
+ * @handle: Open handle of the process to query
+ * @fd_table: FD table to fill for this process
+ * @arena: Scan arena for res_info's arrays and strings (NULL = heap)
+ * @res_info: Output structure to fill with resource information
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Analyzes /proc/[PID]/locks, wchan and the FD table to determine
+ *              which resources the process holds and is waiting for.
+ *              Every file and FD link is resolved relative to the handle,
+ *              which also pins the process against PID reuse for the
+ *              duration of the collection.
+ *              The FD directory is listed once into fd_table; pipe inodes are
+ *              taken from the classified entries without further syscalls.
+ *              A process the wait channel marks as blocked also has
+ *              /proc/[PID]/syscall decoded, which replaces the wchan guess
+ *              with the exact FD (or child) it waits on, and its start time
+ *              recorded so later re-reads can tell a reused PID apart.
+ *              Held arrays get MAX_RESOURCES_PER_PROCESS entries because
+ *              dependency analysis appends pipe and lock resources to them.
+ *              Time complexity: O(f + l) where f=num FDs, l=num locks
+ * Error handling: Returns error codes for bad parameters,
+ *                 partial success if some data unavailable
+ */
+int get_process_resources_at(ProcHandle* handle, FdTable* fd_table, Arena* arena,
+                             ProcessResourceInfo* res_info)
+{
+    if (handle == NULL || res_info == NULL || fd_table == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    memset(res_info, 0, sizeof(ProcessResourceInfo));
+    res_info->pid = (int)handle->pid;
+    res_info->arena = arena;
+    
+    /* Get file locks (held resources) */
+    FileLockInfo* locks = NULL;
+    int lock_count = 0;
+    int lock_result = read_file_locks(handle, &locks, &lock_count);
+    
+    if (lock_result == SUCCESS && lock_count > 0) {
+        int num_locks = lock_count < MAX_RESOURCES_PER_PROCESS ?
+                        lock_count : MAX_RESOURCES_PER_PROCESS;
         
-        /* Parse lock line format: "1: FLOCK ADVISORY WRITE 1234 00:12:345678 0 EOF" */
-        FileLockInfo* lock = &(*locks)[idx];
-        memset(lock, 0, sizeof(FileLockInfo));
+        /* Allocate arrays for held resources */
+        res_info->held_resources = (int*)arena_alloc(arena, sizeof(int) * MAX_RESOURCES_PER_PROCESS);
+        res_info->held_files = (char**)arena_alloc(arena, sizeof(char*) * MAX_RESOURCES_PER_PROCESS);
         
-        /* Basic parsing - extract lock ID and type */
-        if (sscanf(line, "%d: %cLOCK", &lock->lock_id, &lock->lock_type) >= 2) {
-            /* Try to extract PID from line */
-            char* pid_str = strstr(line, " ");
-            if (pid_str != NULL) {
-                pid_str = strchr(pid_str + 1, ' ');
-                if (pid_str != NULL) {
-                    pid_str = strchr(pid_str + 1, ' ');
-                    if (pid_str != NULL) {
-                        pid_str = strchr(pid_str + 1, ' ');
-                        if (pid_str != NULL) {
-                            lock->pid = (int)strtol(pid_str + 1, NULL, 10);
-                        }
-                    }
+        if (res_info->held_resources != NULL && res_info->held_files != NULL) {
+            res_info->num_held = num_locks;
+            res_info->num_held_files = num_locks;
+            
+            for (int i = 0; i < num_locks; i++) {
+                /* Use lock ID as resource ID */
+                res_info->held_resources[i] = locks[i].lock_id;
+                /* Copy file path if available */
+                if (strlen(locks[i].file_path) > 0) {
+                    res_info->held_files[i] = arena_strdup(arena, locks[i].file_path);
+                } else {
+                    char lock_id_str[32];
+                    snprintf(lock_id_str, sizeof(lock_id_str), "lock_%d", locks[i].lock_id);
+                    res_info->held_files[i] = arena_strdup(arena, lock_id_str);
                 }
             }
-            idx++;
         }
         
-        if (line_end != NULL) {
-            line = line_end + 1;
-        } else {
-            break;
+        free_file_lock_info(locks, lock_count);
+    }
+    
+    /* Get wait channel (wchan) */
+    int wchan_result = read_process_wchan(handle, arena, &res_info->wchan);
+    if (wchan_result != SUCCESS) {
+        res_info->wchan = NULL;
+    }
+    
+    /* Check if blocked on pipe or lock based on wchan */
+    classify_wchan(res_info);
+    
+    /* Blocked tasks: decode the exact syscall, FD and child they wait on */
+    if (res_info->is_blocked_on_pipe || res_info->is_blocked_on_lock ||
+        res_info->is_blocked_on_child) {
+        proc_handle_read_syscall(handle, &res_info->wait);
+        record_start_time(handle, res_info);
+    }
+    
+    /* Snapshot file descriptors once; every later stage reads the table */
+    if (fd_table_collect_at(handle, fd_table) == SUCCESS) {
+        res_info->fd_table = fd_table;
+    }
+    
+    /* Get pipe information from the FD table */
+    fill_pipes_from_table(res_info, arena);
+    
+    apply_wait_syscall(res_info);
+    if (res_info->is_blocked_on_child) {
+        read_child_pids(handle, arena, res_info);
+    }
+    
+    /* Waiting resources stay empty until analyze_pipe_and_lock_dependencies() */
+    return SUCCESS;
+}
+
+/*
+ * CollectJob - Shared state of one parallel collection run
+ */
+typedef struct {
+    const pid_t* pids;              /* PIDs to collect */
+    int num_pids;                   /* Number of PIDs */
+    FdSnapshot* snapshot;           /* FD tables, one per slot */
+    Arena** arenas;                 /* Scan arenas, one per worker (may be NULL) */
+    ProcHandle* handles;            /* Per-slot handles to acquire (NULL = temporary) */
+    IncrementalScan* incremental;   /* Incremental scan state (NULL = full collection) */
+    char* blocked;                  /* Triage output flags (NULL = collect resources) */
+    ProcessResourceInfo* procs;     /* Output slots */
+    int* results;                   /* Output result codes */
+    int cursor;                     /* Next unclaimed slot (atomic) */
+} CollectJob;
+
+/*
+ * read_process_fingerprint - Read the fingerprint of an acquired process
+ * @handle: Handle validated by proc_handle_acquire() (state, start time set)
+ * @fingerprint: Output fingerprint
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: State and start time come from the stat read done by
+ *              acquire; the thread count and the two context switch
+ *              counters are read here from /proc/[PID]/status.
+ */
+static int read_process_fingerprint(ProcHandle* handle, ProcessFingerprint* fingerprint)
+{
+    const char* status = proc_handle_read(handle, PROC_STATUS_FILE,
+                                          thread_read_buffer(), NULL);
+    if (status == NULL) {
+        return proc_error_from_errno(errno);
+    }
+    
+    const char* threads = strstr(status, "\nThreads:");
+    const char* voluntary = strstr(status, "\nvoluntary_ctxt_switches:");
+    const char* nonvoluntary = strstr(status, "\nnonvoluntary_ctxt_switches:");
+    if (threads == NULL || voluntary == NULL || nonvoluntary == NULL) {
+        return ERROR_INVALID_FORMAT;
+    }
+    
+    fingerprint->state = handle->state;
+    fingerprint->start_time = handle->start_time;
+    fingerprint->voluntary_ctxt = strtoul(voluntary + 25, NULL, 10);
+    fingerprint->nonvoluntary_ctxt = strtoul(nonvoluntary + 28, NULL, 10);
+    fingerprint->num_threads = (int)strtol(threads + 9, NULL, 10);
+    return SUCCESS;
+}
+
+/*
+ * reuse_process_resources - Rebuild a slot from the previous scan's record
+ * @handle: Handle of the unchanged process
+ * @record: Its record from the previous scan
+ * @previous: FD snapshot of the previous scan
+ * @table: This slot's FD table; swapped with the recorded table
+ * @arena: Arena for res_info's arrays and strings (NULL = heap)
+ * @res_info: Output structure
+ * @return: None
+ * Description: The recorded FD table is moved into this slot by swapping
+ *              the two table structs, so no entries are copied. Each
+ *              previous slot belongs to exactly one PID, so concurrent
+ *              workers never swap the same table.
+ */
+static void reuse_process_resources(const ProcHandle* handle, const ScanRecord* record,
+                                    FdSnapshot* previous, FdTable* table,
+                                    Arena* arena, ProcessResourceInfo* res_info)
+{
+    memset(res_info, 0, sizeof(ProcessResourceInfo));
+    res_info->pid = (int)handle->pid;
+    res_info->arena = arena;
+    res_info->wchan = arena_strdup(arena, record->wchan);
+    res_info->wait = record->wait;
+    res_info->start_time = handle->start_time;
+    classify_wchan(res_info);
+    
+    if (record->slot >= 0) {
+        FdTable swapped = previous->tables[record->slot];
+        previous->tables[record->slot] = *table;
+        *table = swapped;
+        res_info->fd_table = table;
+    } else {
+        fd_table_clear(table);
+    }
+    
+    fill_pipes_from_table(res_info, arena);
+    apply_wait_syscall(res_info);
+}
+
+/*
+ * collect_slot - Collect one slot of a job
+ * @job: CollectJob being processed
+ * @slot: Slot index
+ * @arena: Arena of the calling worker
+ * @return: Result code of the slot
+ */
+static int collect_slot(CollectJob* job, int slot, Arena* arena)
+{
+    FdTable* table = &job->snapshot->tables[slot];
+    ProcessResourceInfo* proc = &job->procs[slot];
+    
+    if (job->handles == NULL) {
+        return get_process_resources_with_table(job->pids[slot], table, arena, proc);
+    }
+    
+    /* Cached handles are revalidated here, on the worker, not serially */
+    ProcHandle* handle = &job->handles[slot];
+    int result = proc_handle_acquire(handle);
+    if (result != SUCCESS) {
+        if (job->incremental != NULL) {
+            job->incremental->records[slot].pid = 0;
         }
+        memset(proc, 0, sizeof(ProcessResourceInfo));
+        proc->pid = (int)job->pids[slot];
+        fd_table_clear(table);
+        return result;
     }
     
-    free(locks_content);
-    *count = idx;
-    return SUCCESS;
+    if (job->incremental == NULL) {
+        return get_process_resources_at(handle, table, arena, proc);
+    }
+    
+    IncrementalScan* incremental = job->incremental;
+    ScanRecord* record = &incremental->records[slot];
+    memset(record, 0, sizeof(ScanRecord));
+    
+    ProcessFingerprint fingerprint;
+    if (read_process_fingerprint(handle, &fingerprint) != SUCCESS) {
+        /* Unrecorded; the next scan collects it in full again */
+        return get_process_resources_at(handle, table, arena, proc);
+    }
+    
+    const ScanRecord* previous = scan_history_find(incremental->history, handle->pid);
+    if (scan_record_unchanged(previous, &fingerprint) &&
+        previous->slot < incremental->previous->num_tables) {
+        reuse_process_resources(handle, previous, incremental->previous, table, arena, proc);
+        __atomic_fetch_add(&incremental->num_reused, 1, __ATOMIC_RELAXED);
+        result = SUCCESS;
+    } else {
+        result = get_process_resources_at(handle, table, arena, proc);
+    }
+    
+    if (result == SUCCESS) {
+        record->pid = handle->pid;
+        record->fingerprint = fingerprint;
+        record->slot = proc->fd_table != NULL ? slot : -1;
+        record->wait = proc->wait;
+        size_t wchan_len = proc->wchan != NULL ? strlen(proc->wchan) : 0;
+        record->reusable = proc->wchan != NULL && proc->num_held == 0 &&
+                           !proc->is_blocked_on_child &&
+                           wchan_len < sizeof(record->wchan);
+        if (record->reusable) {
+            memcpy(record->wchan, proc->wchan, wchan_len + 1);
+        }
+    }
+    return result;
 }
 
+/* Every triage chunk reads at most a stat and a wchan per slot in one batch */
+#if 2 * COLLECT_CHUNK_SIZE > PROC_URING_MAX_BATCH
+#error "PROC_URING_MAX_BATCH must cover two reads per COLLECT_CHUNK_SIZE slot"
+#endif
+
 /*
- * get_process_resources - Get resource allocation information for a process
- * @pid: Process ID to query
- * @res_info: Output structure to fill with resource information
- * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Analyzes /proc/[PID]/fd and /proc/[PID]/locks to determine
- *              which resources the process holds and is waiting for.
- *              Builds ProcessResourceInfo structure.
- *              Time complexity: O(f + l) where f=num FDs, l=num locks
- * Error handling: Returns error codes for file access issues,
- *                 partial success if some data unavailable
+ * wchan_blocks - Decide from a wait channel whether triage flags a process
+ * @wchan: Wait channel as read (trailing newline is stripped in place)
+ * @len: Length of wchan
+ * @return: 1 for pipe, lock and child waits, 0 otherwise
  */
-int get_process_resources(pid_t pid, ProcessResourceInfo* res_info)
+static char wchan_blocks(char* wchan, size_t len)
 {
-    if (res_info == NULL) {
-        return ERROR_INVALID_ARGUMENT;
+    if (len > 0 && wchan[len - 1] == '\n') {
+        wchan[len - 1] = '\0';
     }
+    return (char)(wchan_waits_on_pipe(wchan) || wchan_waits_on_lock(wchan) ||
+                  wchan_waits_on_child(wchan));
+}
+
+/*
+ * triage_slot - Classify one slot of a triage job from its wait channel
+ * @job: CollectJob being processed (blocked set)
+ * @slot: Slot index
+ * @return: Result code of the slot
+ */
+static int triage_slot(CollectJob* job, int slot)
+{
+    job->blocked[slot] = 0;
     
-    memset(res_info, 0, sizeof(ProcessResourceInfo));
-    res_info->pid = (int)pid;
+    ProcHandle local;
+    ProcHandle* handle = job->handles != NULL ? &job->handles[slot] : &local;
+    int result = job->handles != NULL ? proc_handle_acquire(handle) :
+                                        proc_handle_open(&local, job->pids[slot]);
+    if (result != SUCCESS) {
+        return result;
+    }
     
-    /* Get file locks (held resources) */
-    FileLockInfo* locks = NULL;
-    int lock_count = 0;
-    int lock_result = get_file_locks(pid, &locks, &lock_count);
+    size_t len = 0;
+    char* wchan = proc_handle_read(handle, PROC_WCHAN_FILE, thread_read_buffer(), &len);
+    if (wchan != NULL) {
+        job->blocked[slot] = wchan_blocks(wchan, len);
+    } else if (errno == ESRCH) {
+        /* Exited between the open and the read */
+        result = ERROR_FILE_NOT_FOUND;
+    }
     
-    if (lock_result == SUCCESS && lock_count > 0) {
-        /* Allocate arrays for held resources */
-        res_info->held_resources = (int*)safe_malloc(sizeof(int) * lock_count);
-        res_info->held_files = (char**)safe_malloc(sizeof(char*) * lock_count);
+    if (handle == &local) {
+        proc_handle_close(&local);
+    }
+    return result;
+}
+
+/*
+ * triage_range_batched - Triage a range of slots with one io_uring batch
+ * @job: CollectJob being processed (blocked set)
+ * @start: First slot
+ * @end: One past the last slot (at most COLLECT_CHUNK_SIZE slots)
+ * @ring: The calling thread's ring
+ * @return: None
+ * Description: Cached handles are revalidated from a batched stat read and
+ *              every wait channel is read in the same batch, so a chunk
+ *              costs two io_uring_enter() calls instead of six syscalls per
+ *              process. Handles that are not open yet are opened directly.
+ *              Slots the batch cannot settle (stale handle, failed read of
+ *              stat, overlong wchan, failed ring) go through triage_slot().
+ */
+static void triage_range_batched(CollectJob* job, int start, int end, ProcUring* ring)
+{
+    ProcHandle locals[COLLECT_CHUNK_SIZE];
+    ProcReadRequest requests[PROC_URING_MAX_BATCH];
+    int stat_request[COLLECT_CHUNK_SIZE];
+    int wchan_request[COLLECT_CHUNK_SIZE];
+    int num_requests = 0;
+    
+    for (int i = start; i < end; i++) {
+        int k = i - start;
+        stat_request[k] = -1;
+        wchan_request[k] = -1;
+        job->blocked[i] = 0;
         
-        if (res_info->held_resources != NULL && res_info->held_files != NULL) {
-            res_info->num_held = lock_count;
-            res_info->num_held_files = lock_count;
-            
-            for (int i = 0; i < lock_count; i++) {
-                /* Use lock ID as resource ID */
-                res_info->held_resources[i] = locks[i].lock_id;
-                /* Copy file path if available */
-                if (strlen(locks[i].file_path) > 0) {
-                    res_info->held_files[i] = str_dup(locks[i].file_path);
-                } else {
-                    char lock_id_str[32];
-                    snprintf(lock_id_str, sizeof(lock_id_str), "lock_%d", locks[i].lock_id);
-                    res_info->held_files[i] = str_dup(lock_id_str);
-                }
+        ProcHandle* handle;
+        int result = SUCCESS;
+        if (job->handles != NULL) {
+            handle = &job->handles[i];
+            if (handle->dir_fd >= 0) {
+                stat_request[k] = num_requests;
+                requests[num_requests].dir_fd = handle->dir_fd;
+                requests[num_requests].name = PROC_STAT_FILE;
+                num_requests++;
+            } else {
+                result = proc_handle_acquire(handle);
             }
+        } else {
+            handle = &locals[k];
+            result = proc_handle_open(handle, job->pids[i]);
         }
         
-        free_file_lock_info(locks, lock_count);
+        job->results[i] = result;
+        if (result == SUCCESS) {
+            wchan_request[k] = num_requests;
+            requests[num_requests].dir_fd = handle->dir_fd;
+            requests[num_requests].name = PROC_WCHAN_FILE;
+            num_requests++;
+        }
     }
     
-    /* Get wait channel (wchan) */
-    int wchan_result = get_process_wchan(pid, &res_info->wchan);
-    if (wchan_result != SUCCESS) {
-        res_info->wchan = NULL;
-    }
+    int batched = proc_uring_read(ring, requests, num_requests) == SUCCESS;
     
-    /* Check if blocked on pipe or lock based on wchan */
-    if (res_info->wchan != NULL && strlen(res_info->wchan) > 0) {
-        if (strstr(res_info->wchan, "pipe") != NULL || 
-            strstr(res_info->wchan, "futex") != NULL) {
-            res_info->is_blocked_on_pipe = 1;
+    for (int i = start; i < end; i++) {
+        int k = i - start;
+        if (wchan_request[k] < 0) {
+            continue; /* Could not be opened; result already set */
         }
-        if (strstr(res_info->wchan, "flock") != NULL ||
-            strstr(res_info->wchan, "lock") != NULL) {
-            res_info->is_blocked_on_lock = 1;
+        
+        ProcHandle* handle = job->handles != NULL ? &job->handles[i] : &locals[k];
+        int settled = batched;
+        if (settled && stat_request[k] >= 0) {
+            const ProcReadRequest* stat = &requests[stat_request[k]];
+            char state = 0;
+            unsigned long long start_time = 0;
+            settled = stat->data != NULL &&
+                      proc_stat_parse(stat->data, &state, &start_time) == SUCCESS &&
+                      start_time == handle->start_time;
+            if (settled) {
+                handle->state = state;
+            } else {
+                /* Exited or the PID was reused; triage_slot() reopens */
+                proc_handle_close(handle);
+            }
+        }
+        
+        ProcReadRequest* wchan = &requests[wchan_request[k]];
+        if (settled && wchan->len == -EOVERFLOW) {
+            settled = 0;
+        }
+        
+        if (job->handles == NULL) {
+            proc_handle_close(handle);
+        }
+        
+        if (!settled) {
+            job->results[i] = triage_slot(job, i);
+        } else if (wchan->data != NULL) {
+            job->blocked[i] = wchan_blocks(wchan->data, (size_t)wchan->len);
+        } else if (wchan->len == -ESRCH) {
+            /* Exited between the open and the read */
+            job->results[i] = ERROR_FILE_NOT_FOUND;
         }
     }
+}
+
+/*
+ * collect_worker - Worker task claiming slot ranges from the job cursor
+ * @context: CollectJob being processed
+ * @worker_id: Worker ID selecting this worker's arena
+ * @return: None
+ */
+static void collect_worker(void* context, int worker_id)
+{
+    CollectJob* job = (CollectJob*)context;
+    Arena* arena = job->arenas != NULL ? job->arenas[worker_id] : NULL;
+    ProcUring* ring = job->blocked != NULL ? thread_proc_uring() : NULL;
     
-    /* Get pipe information from file descriptors */
-    int* fds = NULL;
-    int fd_count = 0;
-    if (get_open_files(pid, &fds, &fd_count) == SUCCESS && fds != NULL) {
-        /* Count pipes */
-        int pipe_count = 0;
-        for (int i = 0; i < fd_count; i++) {
-            unsigned long inode;
-            int is_read_end;
-            if (get_pipe_info_from_fd(pid, fds[i], &inode, &is_read_end) == SUCCESS) {
-                pipe_count++;
-            }
+    for (;;) {
+        int start = __atomic_fetch_add(&job->cursor, COLLECT_CHUNK_SIZE, __ATOMIC_RELAXED);
+        if (start >= job->num_pids) {
+            break;
         }
         
-        if (pipe_count > 0) {
-            res_info->pipe_inodes = (unsigned long*)safe_malloc(sizeof(unsigned long) * pipe_count);
-            res_info->pipe_fds = (int*)safe_malloc(sizeof(int) * pipe_count);
-            
-            if (res_info->pipe_inodes != NULL && res_info->pipe_fds != NULL) {
-                int idx = 0;
-                for (int i = 0; i < fd_count; i++) {
-                    unsigned long inode;
-                    int is_read_end;
-                    if (get_pipe_info_from_fd(pid, fds[i], &inode, &is_read_end) == SUCCESS) {
-                        res_info->pipe_inodes[idx] = inode;
-                        res_info->pipe_fds[idx] = fds[i];
-                        idx++;
-                    }
-                }
-                res_info->num_pipe_inodes = pipe_count;
-            }
+        int end = start + COLLECT_CHUNK_SIZE;
+        if (end > job->num_pids) {
+            end = job->num_pids;
         }
         
-        free(fds);
+        if (ring != NULL) {
+            triage_range_batched(job, start, end, ring);
+            continue;
+        }
+        
+        for (int i = start; i < end; i++) {
+            job->results[i] = job->blocked != NULL ? triage_slot(job, i) :
+                                                     collect_slot(job, i, arena);
+        }
+    }
+}
+
+/*
+ * collect_process_resources - Collect resource information for many processes
+ * @pool: Worker pool to spread the work over (NULL collects serially)
+ * @pids: Array of process IDs
+ * @num_pids: Number of process IDs
+ * @snapshot: FD snapshot prepared with at least num_pids tables
+ * @arenas: One scan arena per pool participant (NULL = heap)
+ * @handles: Per-slot handles from a handle cache (NULL = temporary handles)
+ * @procs: Output array of num_pids entries; slot i describes pids[i]
+ * @results: Output array of num_pids result codes, one per slot
+ * @return: SUCCESS (0) on success, negative error code for invalid arguments
+ * Description: Runs collect_worker on every pool participant. Slots and
+ *              arenas are disjoint, so workers never write shared data apart
+ *              from the cursor and the status cache (which is locked).
+ * Error handling: Per-process failures are reported through results
+ */
+int collect_process_resources(WorkerPool* pool, const pid_t* pids, int num_pids,
+                              FdSnapshot* snapshot, Arena** arenas,
+                              ProcHandle* handles, IncrementalScan* incremental,
+                              ProcessResourceInfo* procs, int* results)
+{
+    if (pids == NULL || snapshot == NULL || procs == NULL || results == NULL ||
+        num_pids < 0 || snapshot->num_tables < num_pids) {
+        return ERROR_INVALID_ARGUMENT;
     }
     
-    /* Initialize waiting resources (will be filled by analyze_dependencies) */
-    res_info->num_waiting = 0;
-    res_info->waiting_resources = NULL;
-    res_info->num_waiting_files = 0;
-    res_info->waiting_files = NULL;
-    res_info->num_waiting_on_pids = 0;
-    res_info->waiting_on_pids = NULL;
+    CollectJob job;
+    job.pids = pids;
+    job.num_pids = num_pids;
+    job.snapshot = snapshot;
+    job.arenas = arenas;
+    job.handles = handles;
+    job.incremental = handles != NULL ? incremental : NULL;
+    job.blocked = NULL;
+    job.procs = procs;
+    job.results = results;
+    job.cursor = 0;
+    
+    if (pool == NULL) {
+        collect_worker(&job, 0);
+        return SUCCESS;
+    }
     
-    return SUCCESS;
+    return worker_pool_run(pool, collect_worker, &job);
+}
+
+/*
+ * triage_processes - Find the processes that sleep on a pipe or a lock
+ * @pool: Worker pool to spread the work over (NULL triages serially)
+ * @pids: Array of process IDs
+ * @num_pids: Number of process IDs
+ * @handles: Per-slot handles from a handle cache (NULL = temporary handles)
+ * @blocked: Output array of num_pids flags, 1 if pids[i] is blocked
+ * @results: Output array of num_pids result codes, one per slot
+ * @return: SUCCESS (0) on success, negative error code for invalid arguments
+ * Description: Runs the collection workers in triage mode, which read only
+ *              the wait channel of each process. With the io_uring backend
+ *              enabled, each worker batches the reads of a whole chunk.
+ * Error handling: Per-process failures are reported through results
+ */
+int triage_processes(WorkerPool* pool, const pid_t* pids, int num_pids,
+                     ProcHandle* handles, char* blocked, int* results)
+{
+    if (pids == NULL || blocked == NULL || results == NULL || num_pids < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    CollectJob job;
+    memset(&job, 0, sizeof(job));
+    job.pids = pids;
+    job.num_pids = num_pids;
+    job.handles = handles;
+    job.blocked = blocked;
+    job.results = results;
+    
+    if (pool == NULL) {
+        collect_worker(&job, 0);
+        return SUCCESS;
+    }
+    
+    return worker_pool_run(pool, collect_worker, &job);
 }
 
 /* =============================================================================
@@ -747,40 +1684,21 @@ int get_process_wchan(pid_t pid, char** wchan)
         return ERROR_INVALID_ARGUMENT;
     }
     
-    *wchan = NULL;
-    
-    char* wchan_content = read_proc_file(pid, PROC_WCHAN_FILE);
-    if (wchan_content == NULL) {
-        if (errno == ENOENT) {
-            /* Process doesn't exist or wchan not available */
-            *wchan = str_dup("");
-            return SUCCESS;
-        } else if (errno == EACCES) {
-            return ERROR_PERMISSION_DENIED;
-        } else {
-            return ERROR_SYSTEM_CALL_FAILED;
-        }
-    }
-    
-    /* Remove trailing newline if present */
-    size_t len = strlen(wchan_content);
-    if (len > 0 && wchan_content[len - 1] == '\n') {
-        wchan_content[len - 1] = '\0';
-        len--;
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result == ERROR_FILE_NOT_FOUND) {
+        /* Process doesn't exist: not blocked on anything */
+        *wchan = str_dup("");
+        return *wchan != NULL ? SUCCESS : ERROR_OUT_OF_MEMORY;
     }
-    
-    /* Allocate and copy wchan string */
-    *wchan = (char*)safe_malloc(len + 1);
-    if (*wchan == NULL) {
-        free(wchan_content);
-        return ERROR_OUT_OF_MEMORY;
+    if (result != SUCCESS) {
+        *wchan = NULL;
+        return result;
     }
     
-    strncpy(*wchan, wchan_content, len);
-    (*wchan)[len] = '\0';
-    
-    free(wchan_content);
-    return SUCCESS;
+    result = read_process_wchan(&handle, NULL, wchan);
+    proc_handle_close(&handle);
+    return result;
 }
 
 /*
@@ -788,7 +1706,7 @@ int get_process_wchan(pid_t pid, char** wchan)
  * @locks: Output array of FileLockInfo structures
  * @count: Output parameter for number of locks found
  * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Parses system-wide /proc/locks file to extract all file locks.
+ * Description: Loads a LockIndex and takes over its lock array.
  *              Allocates array for locks. Caller must free locks array.
  *              Time complexity: O(l) where l is number of locks
  * Error handling: Returns error codes for file access or parse errors
@@ -802,112 +1720,20 @@ int parse_system_locks(FileLockInfo** locks, int* count)
     *locks = NULL;
     *count = 0;
     
-    FILE* locks_file = fopen(PROC_SYSTEM_LOCKS_FILE, "r");
-    if (locks_file == NULL) {
-        if (errno == ENOENT) {
-            return ERROR_FILE_NOT_FOUND;
-        } else if (errno == EACCES) {
-            return ERROR_PERMISSION_DENIED;
-        } else {
-            return ERROR_SYSTEM_CALL_FAILED;
-        }
-    }
-    
-    /* Count locks (each line is a lock) */
-    int lock_count = 0;
-    char line[MAX_LINE_LEN];
-    while (fgets(line, sizeof(line), locks_file) != NULL) {
-        if (strlen(line) > 0 && line[0] != '\n') {
-            lock_count++;
-        }
-    }
-    
-    if (lock_count == 0) {
-        fclose(locks_file);
-        return SUCCESS;
-    }
-    
-    /* Allocate array */
-    *locks = (FileLockInfo*)safe_malloc(sizeof(FileLockInfo) * lock_count);
-    if (*locks == NULL) {
-        fclose(locks_file);
-        return ERROR_OUT_OF_MEMORY;
+    LockIndex index;
+    memset(&index, 0, sizeof(index));
+    int result = lock_index_load(&index);
+    if (result != SUCCESS) {
+        return result;
     }
     
-    /* Rewind and parse locks */
-    rewind(locks_file);
-    int idx = 0;
-    
-    while (fgets(line, sizeof(line), locks_file) != NULL && idx < lock_count) {
-        if (strlen(line) == 0 || line[0] == '\n') {
-            continue;
-        }
-        
-        /* Remove trailing newline */
-        size_t line_len = strlen(line);
-        if (line_len > 0 && line[line_len - 1] == '\n') {
-            line[line_len - 1] = '\0';
-            line_len--;
-        }
-        
-        FileLockInfo* lock = &(*locks)[idx];
-        memset(lock, 0, sizeof(FileLockInfo));
-        
-        /* Parse lock line format: "1: FLOCK  ADVISORY  WRITE 1234 00:12:345678 0 EOF [/path/to/file]" */
-        /* Format: lock_id: lock_type ADVISORY/MANDATORY READ/WRITE pid major:minor:inode start end [file_path] */
-        int lock_id;
-        char lock_type_str[16];
-        char advisory_str[16];
-        char rw_str[16];
-        int pid_val;
-        unsigned int major, minor;
-        unsigned long inode_val;
-        unsigned long start_val, end_val;
-        char file_path_buf[MAX_PATH_LEN] = {0};
-        
-        /* Try to parse with file path at the end */
-        int parsed = sscanf(line, "%d: %15s %15s %15s %d %u:%u:%lu %lu %lu %s",
-                           &lock_id, lock_type_str, advisory_str, rw_str,
-                           &pid_val, &major, &minor, &inode_val,
-                           &start_val, &end_val, file_path_buf);
-        
-        /* If file path not found, try without it */
-        if (parsed < 5) {
-            parsed = sscanf(line, "%d: %15s %15s %15s %d %u:%u:%lu %lu %lu",
-                           &lock_id, lock_type_str, advisory_str, rw_str,
-                           &pid_val, &major, &minor, &inode_val,
-                           &start_val, &end_val);
-        }
-        
-        if (parsed >= 5) {
-            lock->lock_id = lock_id;
-            lock->lock_type = (lock_type_str[0] == 'F') ? 'F' : 'P';
-            lock->pid = pid_val;
-            lock->inode = inode_val;
-            lock->start = start_val;
-            lock->end = (parsed >= 10) ? end_val : 0;
-            
-            /* Copy file path if available */
-            if (parsed >= 11 && strlen(file_path_buf) > 0) {
-                strncpy(lock->file_path, file_path_buf, MAX_PATH_LEN - 1);
-                lock->file_path[MAX_PATH_LEN - 1] = '\0';
-            } else {
-                lock->file_path[0] = '\0';
-            }
-            
-            /* Determine if this lock might be blocking (WRITE locks can block) */
-            if (strcmp(rw_str, "WRITE") == 0) {
-                lock->is_blocking = 1;
-            } else {
-                lock->is_blocking = 0;
-            }
-            
-            idx++;
-        }
+    if (index.num_locks > 0) {
+        *locks = index.locks;
+        *count = index.num_locks;
+        index.locks = NULL;
     }
     
-    fclose(locks_file);
-    *count = idx;
+    free_lock_index(&index);
     return SUCCESS;
 }
 
@@ -916,10 +1742,11 @@ int parse_system_locks(FileLockInfo** locks, int* count)
  * @pid: Process ID
  * @fd: File descriptor number
  * @inode: Output parameter for pipe inode
- * @is_read_end: Output parameter (1 if read end, 0 if write end)
+ * @is_read_end: Output parameter (1 if read end, 0 if write end or unknown)
  * @return: SUCCESS (0) if FD is a pipe, negative error code otherwise
  * Description: Reads /proc/[PID]/fd/[FD] to determine if it's a pipe
- *              and extract its inode number. Determines read/write end.
+ *              and extract its inode number, then the "flags:" line of
+ *              /proc/[PID]/fdinfo/[FD] for the end. Both share one handle.
  *              Time complexity: O(1) file read
  * Error handling: Returns error if FD is not a pipe or access denied
  */
@@ -932,46 +1759,39 @@ int get_pipe_info_from_fd(pid_t pid, int fd, unsigned long* inode, int* is_read_
     *inode = 0;
     *is_read_end = 0;
     
-    char fd_path[MAX_PATH_LEN];
-    int result = snprintf(fd_path, sizeof(fd_path), "%s/%d/fd/%d",
-                         PROC_BASE_PATH, (int)pid, fd);
-    if (result < 0 || (size_t)result >= sizeof(fd_path)) {
-        return ERROR_BUFFER_OVERFLOW;
+    char fd_name[16];
+    snprintf(fd_name, sizeof(fd_name), "%d", fd);
+    
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        return result;
     }
     
     char link_target[MAX_PATH_LEN];
-    ssize_t link_len = readlink(fd_path, link_target, sizeof(link_target) - 1);
-    if (link_len < 0) {
-        if (errno == ENOENT) {
-            return ERROR_FILE_NOT_FOUND;
-        } else if (errno == EACCES) {
-            return ERROR_PERMISSION_DENIED;
-        } else {
-            return ERROR_SYSTEM_CALL_FAILED;
-        }
+    if (proc_handle_readlink_fd(&handle, fd_name, link_target, sizeof(link_target)) < 0) {
+        result = proc_error_from_errno(errno);
+        proc_handle_close(&handle);
+        return result;
     }
     
-    link_target[link_len] = '\0';
-    
     /* Check if it's a pipe: format is "pipe:[inode]" */
-    if (strncmp(link_target, "pipe:[", 6) == 0) {
-        /* Extract inode */
-        unsigned long inode_val;
-        if (sscanf(link_target, "pipe:[%lu]", &inode_val) == 1) {
-            *inode = inode_val;
-            
-            /* Determine read/write end by checking open mode
-             * This is a heuristic: we can't easily determine from /proc
-             * For now, assume it could be either, caller must check wchan
-             */
-            *is_read_end = 0; /* Default, will be determined by blocking state */
-            
-            return SUCCESS;
-        }
+    unsigned long inode_val;
+    if (strncmp(link_target, "pipe:[", 6) != 0 ||
+        sscanf(link_target, "pipe:[%lu]", &inode_val) != 1) {
+        proc_handle_close(&handle);
+        return ERROR_INVALID_FORMAT;
     }
+    *inode = inode_val;
     
-    /* Not a pipe */
-    return ERROR_INVALID_FORMAT;
+    /* The end follows from the open mode recorded in fdinfo */
+    char fdinfo_name[32];
+    snprintf(fdinfo_name, sizeof(fdinfo_name), "fdinfo/%d", fd);
+    *is_read_end = fd_pipe_end_from_fdinfo(
+        proc_handle_read(&handle, fdinfo_name, thread_read_buffer(), NULL)) == PIPE_END_READ;
+    
+    proc_handle_close(&handle);
+    return SUCCESS;
 }
 
 /*
@@ -982,7 +1802,9 @@ int get_pipe_info_from_fd(pid_t pid, int fd, unsigned long* inode, int* is_read_
  * @inode: Output parameter for file inode (optional, can be NULL)
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Reads /proc/[PID]/fd/[FD] symlink to get file path and inode.
- *              Extracts inode from /proc/[PID]/fdinfo/[FD] if needed.
+ *              Extracts inode from /proc/[PID]/fdinfo/[FD] if needed, falling
+ *              back to fstatat() on the FD link. All three lookups share one
+ *              process handle.
  *              Time complexity: O(1) file read
  * Error handling: Returns error if FD access denied or not a regular file
  */
@@ -997,31 +1819,27 @@ int get_file_path_from_fd(pid_t pid, int fd, char* file_path, unsigned long* ino
         *inode = 0;
     }
     
-    char fd_path[MAX_PATH_LEN];
-    int result = snprintf(fd_path, sizeof(fd_path), "%s/%d/fd/%d",
-                         PROC_BASE_PATH, (int)pid, fd);
-    if (result < 0 || (size_t)result >= sizeof(fd_path)) {
-        return ERROR_BUFFER_OVERFLOW;
+    char fd_name[16];
+    snprintf(fd_name, sizeof(fd_name), "%d", fd);
+    
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, pid);
+    if (result != SUCCESS) {
+        return result;
     }
     
     char link_target[MAX_PATH_LEN];
-    ssize_t link_len = readlink(fd_path, link_target, sizeof(link_target) - 1);
-    if (link_len < 0) {
-        if (errno == ENOENT) {
-            return ERROR_FILE_NOT_FOUND;
-        } else if (errno == EACCES) {
-            return ERROR_PERMISSION_DENIED;
-        } else {
-            return ERROR_SYSTEM_CALL_FAILED;
-        }
+    if (proc_handle_readlink_fd(&handle, fd_name, link_target, sizeof(link_target)) < 0) {
+        result = proc_error_from_errno(errno);
+        proc_handle_close(&handle);
+        return result;
     }
     
-    link_target[link_len] = '\0';
-    
     /* Check if it's a pipe or socket - skip those */
     if (strncmp(link_target, "pipe:[", 6) == 0 ||
         strncmp(link_target, "socket:[", 8) == 0 ||
         strncmp(link_target, "anon_inode:", 11) == 0) {
+        proc_handle_close(&handle);
         return ERROR_INVALID_FORMAT;
     }
     
@@ -1031,36 +1849,26 @@ int get_file_path_from_fd(pid_t pid, int fd, char* file_path, unsigned long* ino
     
     /* Try to get inode from /proc/[PID]/fdinfo/[FD] */
     if (inode != NULL) {
-        char fdinfo_path[MAX_PATH_LEN];
-        result = snprintf(fdinfo_path, sizeof(fdinfo_path), "%s/%d/fdinfo/%d",
-                         PROC_BASE_PATH, (int)pid, fd);
-        if (result >= 0 && (size_t)result < sizeof(fdinfo_path)) {
-            FILE* fdinfo_file = fopen(fdinfo_path, "r");
-            if (fdinfo_file != NULL) {
-                char line[MAX_LINE_LEN];
-                while (fgets(line, sizeof(line), fdinfo_file) != NULL) {
-                    /* Look for "ino:" line */
-                    if (strncmp(line, "ino:", 4) == 0) {
-                        unsigned long inode_val;
-                        if (sscanf(line, "ino: %lu", &inode_val) == 1) {
-                            *inode = inode_val;
-                            break;
-                        }
-                    }
-                }
-                fclose(fdinfo_file);
-            }
+        char fdinfo_name[32];
+        snprintf(fdinfo_name, sizeof(fdinfo_name), "fdinfo/%d", fd);
+        
+        const char* fdinfo = proc_handle_read(&handle, fdinfo_name,
+                                              thread_read_buffer(), NULL);
+        const char* ino_line = fdinfo != NULL ? strstr(fdinfo, "ino:") : NULL;
+        if (ino_line != NULL && (ino_line == fdinfo || ino_line[-1] == '\n')) {
+            *inode = strtoul(ino_line + 4, NULL, 10);
         }
         
-        /* If inode not found from fdinfo, try to get from stat */
-        if (*inode == 0 && strlen(file_path) > 0) {
+        /* If inode not found from fdinfo, stat the open file itself */
+        if (*inode == 0) {
             struct stat st;
-            if (stat(file_path, &st) == 0) {
+            if (proc_handle_stat_fd(&handle, fd_name, &st) == SUCCESS) {
                 *inode = (unsigned long)st.st_ino;
             }
         }
     }
     
+    proc_handle_close(&handle);
     return SUCCESS;
 }
 
@@ -1068,43 +1876,31 @@ int get_file_path_from_fd(pid_t pid, int fd, char* file_path, unsigned long* ino
  * detect_pipe_dependencies - Detect pipe relationships between processes
  * @all_pipes: Output array of PipeInfo structures for all processes
  * @pipe_count: Output parameter for number of pipes found
- * @pids: Array of process IDs to analyze
- * @num_pids: Number of processes
+ * @procs: Array of collected processes (pipes are taken from their fd_table)
+ * @num_procs: Number of processes
  * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Analyzes all processes to find pipe relationships.
- *              Matches pipe inodes between processes to detect dependencies.
+ * Description: Flattens the pipe FDs recorded in each process's FD snapshot
+ *              into one PipeInfo array. Blocked state comes from the already
+ *              collected wchan, so no /proc I/O is performed here.
  *              Allocates array for pipes. Caller must free pipes array.
- *              Time complexity: O(P * F) where P=processes, F=FDs per process
- * Error handling: Returns error codes for allocation or access issues
+ *              Time complexity: O(P + total pipe FDs)
+ * Error handling: Returns error codes for allocation issues
  */
 int detect_pipe_dependencies(PipeInfo** all_pipes, int* pipe_count,
-                             pid_t* pids, int num_pids)
+                             const ProcessResourceInfo* procs, int num_procs)
 {
-    if (all_pipes == NULL || pipe_count == NULL || pids == NULL || num_pids <= 0) {
+    if (all_pipes == NULL || pipe_count == NULL || procs == NULL || num_procs <= 0) {
         return ERROR_INVALID_ARGUMENT;
     }
     
     *all_pipes = NULL;
     *pipe_count = 0;
     
-    /* First pass: count all pipes */
+    /* Pipe counts are known from the snapshot */
     int total_pipes = 0;
-    for (int i = 0; i < num_pids; i++) {
-        int* fds = NULL;
-        int fd_count = 0;
-        
-        if (get_open_files(pids[i], &fds, &fd_count) == SUCCESS && fds != NULL) {
-            for (int j = 0; j < fd_count; j++) {
-                unsigned long inode;
-                int is_read_end;
-                if (get_pipe_info_from_fd(pids[i], fds[j], &inode, &is_read_end) == SUCCESS) {
-                    total_pipes++;
-                }
-            }
-            
-            if (fds != NULL) {
-                free(fds);
-            }
+    for (int i = 0; i < num_procs; i++) {
+        if (procs[i].fd_table != NULL) {
+            total_pipes += procs[i].fd_table->num_pipes;
         }
     }
     
@@ -1118,41 +1914,24 @@ int detect_pipe_dependencies(PipeInfo** all_pipes, int* pipe_count,
         return ERROR_OUT_OF_MEMORY;
     }
     
-    /* Second pass: collect pipe information */
+    /* Collect pipe information */
     int idx = 0;
-    for (int i = 0; i < num_pids; i++) {
-        int* fds = NULL;
-        int fd_count = 0;
+    for (int i = 0; i < num_procs; i++) {
+        const FdTable* table = procs[i].fd_table;
+        if (table == NULL) {
+            continue;
+        }
         
-        if (get_open_files(pids[i], &fds, &fd_count) == SUCCESS && fds != NULL) {
-            /* Get wchan to determine if blocked on pipe */
-            char* wchan = NULL;
-            int is_blocked_on_pipe = 0;
-            if (get_process_wchan(pids[i], &wchan) == SUCCESS && wchan != NULL) {
-                /* Check if blocked on pipe operations */
-                if (strstr(wchan, "pipe") != NULL || 
-                    strstr(wchan, "futex") != NULL) {
-                    is_blocked_on_pipe = 1;
-                }
-                safe_free((void**)&wchan);
-            }
-            
-            for (int j = 0; j < fd_count && idx < total_pipes; j++) {
-                unsigned long inode;
-                int is_read_end;
-                if (get_pipe_info_from_fd(pids[i], fds[j], &inode, &is_read_end) == SUCCESS) {
-                    PipeInfo* pipe = &(*all_pipes)[idx];
-                    pipe->inode = inode;
-                    pipe->fd = fds[j];
-                    pipe->pid = pids[i];
-                    pipe->is_read_end = is_read_end;
-                    pipe->is_blocked = is_blocked_on_pipe;
-                    idx++;
-                }
-            }
-            
-            if (fds != NULL) {
-                free(fds);
+        for (int j = 0; j < table->num_entries && idx < total_pipes; j++) {
+            const FdEntry* entry = &table->entries[j];
+            if (entry->kind == FD_KIND_PIPE) {
+                PipeInfo* pipe = &(*all_pipes)[idx];
+                pipe->inode = entry->inode;
+                pipe->fd = entry->fd;
+                pipe->pid = (pid_t)procs[i].pid;
+                pipe->is_read_end = entry->pipe_end == PIPE_END_READ;
+                pipe->is_blocked = procs[i].is_blocked_on_pipe;
+                idx++;
             }
         }
     }
@@ -1227,6 +2006,7 @@ void free_process_list(pid_t* pids)
  * @res_info: ProcessResourceInfo structure to clean up
  * @return: None
  * Description: Frees all dynamically allocated arrays in ProcessResourceInfo.
+ *              Arena-backed structures only drop their pointers.
  *              Safe to call with partially initialized structures.
  * Error handling: Handles NULL pointers gracefully
  */
@@ -1236,6 +2016,22 @@ void free_process_resource_info(ProcessResourceInfo* res_info)
         return;
     }
     
+    /* Arena-backed memory is released by arena_reset(); dropping the
+     * pointers turns the frees below into no-ops */
+    if (res_info->arena != NULL) {
+        res_info->held_resources = NULL;
+        res_info->waiting_resources = NULL;
+        res_info->held_files = NULL;
+        res_info->waiting_files = NULL;
+        res_info->wchan = NULL;
+        res_info->waiting_on_pids = NULL;
+        res_info->pipe_inodes = NULL;
+        res_info->pipe_fds = NULL;
+        res_info->pipe_ends = NULL;
+        res_info->child_pids = NULL;
+        res_info->arena = NULL;
+    }
+    
     if (res_info->held_resources != NULL) {
         free(res_info->held_resources);
         res_info->held_resources = NULL;
@@ -1286,6 +2082,16 @@ void free_process_resource_info(ProcessResourceInfo* res_info)
         res_info->pipe_fds = NULL;
     }
     
+    if (res_info->pipe_ends != NULL) {
+        free(res_info->pipe_ends);
+        res_info->pipe_ends = NULL;
+    }
+    
+    if (res_info->child_pids != NULL) {
+        free(res_info->child_pids);
+        res_info->child_pids = NULL;
+    }
+    
     res_info->num_held = 0;
     res_info->num_waiting = 0;
     res_info->num_held_files = 0;
@@ -1294,6 +2100,9 @@ void free_process_resource_info(ProcessResourceInfo* res_info)
     res_info->num_pipe_inodes = 0;
     res_info->is_blocked_on_pipe = 0;
     res_info->is_blocked_on_lock = 0;
+    res_info->is_blocked_on_child = 0;
+    res_info->num_child_pids = 0;
+    res_info->fd_table = NULL; /* Owned by the FdSnapshot, not freed here */
 }
 
 /*
@@ -11,6 +11,10 @@
 
 #include <sys/types.h>
 #include "config.h"
+#include "fd_snapshot.h"
+#include "scan_history.h"
+#include "worker_pool.h"
+#include "utility.h"
 
 /* =============================================================================
  * DATA STRUCTURES
@@ -55,10 +59,43 @@ typedef struct {
     unsigned long* pipe_inodes;     /* Array of pipe inodes this process has open */
     int num_pipe_inodes;            /* Number of pipe inodes */
     int* pipe_fds;                  /* Array of file descriptors corresponding to pipe_inodes */
+    int* pipe_ends;                 /* PIPE_END_* of each pipe_fds entry (NULL = all unknown) */
     int is_blocked_on_pipe;         /* 1 if process is blocked waiting on pipe read/write */
     int is_blocked_on_lock;         /* 1 if process is blocked waiting on file lock */
+    int is_blocked_on_child;        /* 1 if process is blocked waiting for a child to exit */
+    WaitSyscall wait;               /* Decoded blocking syscall (kind UNKNOWN if not read);
+                                       narrows pipe and lock waits to one FD */
+    int* child_pids;                /* Children a blocked child wait can return for */
+    int num_child_pids;             /* Number of child PIDs */
+    unsigned long long start_time;  /* Field 22 of stat when collected (blocked tasks only, 0 = unknown) */
+    FdTable* fd_table;              /* FD snapshot of this process (not owned, may be NULL) */
+    Arena* arena;                   /* Scan arena backing all arrays and strings above
+                                       (not owned; NULL = individually heap-allocated) */
 } ProcessResourceInfo;
 
+/*
+ * PidVector - Growable array of process IDs
+ * Filled by enumerate_processes(); can be kept across scans so that repeated
+ * enumeration reuses the same allocation
+ */
+typedef struct {
+    pid_t* pids;                    /* Array of process IDs */
+    int count;                      /* Number of PIDs currently stored */
+    int capacity;                   /* Allocated capacity of pids array */
+} PidVector;
+
+/*
+ * IncrementalScan - Inputs and outputs of an incremental collection
+ * Slots whose process is unchanged since the previous scan take over that
+ * scan's FD table and wait channel instead of reading /proc again.
+ */
+typedef struct {
+    const ScanHistory* history;     /* Records of the previous scan (read-only) */
+    FdSnapshot* previous;           /* FD snapshot the history's slots refer to */
+    ScanRecord* records;            /* Output: one record per slot for the next scan */
+    int num_reused;                 /* Output: slots served from history (atomic) */
+} IncrementalScan;
+
 /*
  * FileLockInfo - Information about a file lock
  * Parsed from /proc/[PID]/locks or /proc/locks
@@ -71,6 +108,7 @@ typedef struct {
     unsigned long start;            /* Start offset */
     unsigned long end;              /* End offset */
     unsigned long inode;            /* Inode number of locked file */
+    dev_t device;                   /* Device of locked file (0 if unknown) */
     int is_blocking;                /* 1 if this lock is blocking another process */
 } FileLockInfo;
 
@@ -102,6 +140,30 @@ typedef struct {
  */
 pid_t* get_all_processes(int* count);
 
+/*
+ * enumerate_processes - Enumerate all process IDs into a reusable vector
+ * @vec: PidVector to fill (previous contents are discarded, storage is kept)
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Reads /proc in a single pass using raw getdents64 records
+ *              into a large static buffer and appends numeric entries to vec.
+ *              The vector only grows, so passing the same vector on every
+ *              scan performs no allocation once it has reached steady size.
+ *              Time complexity: O(n) where n is number of /proc entries
+ * Error handling: Returns error codes for open/getdents failures or
+ *                 ERROR_OUT_OF_MEMORY if the vector cannot grow. On error
+ *                 vec->count holds the PIDs collected so far.
+ */
+int enumerate_processes(PidVector* vec);
+
+/*
+ * free_pid_vector - Release storage held by a PidVector
+ * @vec: PidVector to clean up
+ * @return: None
+ * Description: Frees the PID array and resets count and capacity.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_pid_vector(PidVector* vec);
+
 /*
  * get_process_info - Get detailed information about a specific process
  * @pid: Process ID to query
@@ -130,6 +192,96 @@ int get_process_info(pid_t pid, ProcessInfo* info);
  */
 int get_process_resources(pid_t pid, ProcessResourceInfo* res_info);
 
+/*
+ * get_process_resources_with_table - Get resource information using an FD table
+ * @pid: Process ID to query
+ * @fd_table: FD table to fill for this process (owned by an FdSnapshot)
+ * @arena: Scan arena for res_info's arrays and strings (NULL = heap)
+ * @res_info: Output structure to fill with resource information
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Same as get_process_resources(), but lists the process's FDs
+ *              into fd_table exactly once and links res_info->fd_table to it,
+ *              so later stages can reuse the classified FDs without touching
+ *              /proc again. fd_table must outlive res_info, and so must the
+ *              arena until it is reset.
+ *              Time complexity: O(f + l) where f=num FDs, l=num locks
+ * Error handling: Returns error codes for file access issues,
+ *                 partial success if some data unavailable
+ */
+int get_process_resources_with_table(pid_t pid, FdTable* fd_table, Arena* arena,
+                                     ProcessResourceInfo* res_info);
+
+/*
+ * get_process_resources_at - Get resource information through a process handle
+ * @handle: Open (or acquired) handle of the process to query
+ * @fd_table: FD table to fill for this process (owned by an FdSnapshot)
+ * @arena: Scan arena for res_info's arrays and strings (NULL = heap)
+ * @res_info: Output structure to fill with resource information
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Same as get_process_resources_with_table() but reads through
+ *              a handle the caller owns, e.g. one kept by a ProcHandleCache.
+ *              The handle is left open.
+ *              Time complexity: O(f + l) where f=num FDs, l=num locks
+ * Error handling: Returns ERROR_INVALID_ARGUMENT for NULL parameters,
+ *                 partial success if some data unavailable
+ */
+int get_process_resources_at(ProcHandle* handle, FdTable* fd_table, Arena* arena,
+                             ProcessResourceInfo* res_info);
+
+/*
+ * collect_process_resources - Collect resource information for many processes
+ * @pool: Worker pool to spread the work over (NULL collects serially)
+ * @pids: Array of process IDs
+ * @num_pids: Number of process IDs
+ * @snapshot: FD snapshot prepared with at least num_pids tables
+ * @arenas: One scan arena per pool participant, indexed by worker ID
+ *          (NULL = heap-allocate every slot)
+ * @handles: Per-slot handles from proc_handle_cache_checkout(), acquired on
+ *           the workers and left open for check-in (NULL = open and close a
+ *           temporary handle per slot)
+ * @incremental: Incremental scan state (NULL = collect every slot in full;
+ *               ignored without handles)
+ * @procs: Output array of num_pids entries; slot i describes pids[i]
+ * @results: Output array of num_pids result codes, one per slot
+ * @return: SUCCESS (0) on success, negative error code for invalid arguments
+ * Description: Workers repeatedly claim the next COLLECT_CHUNK_SIZE slots
+ *              from a shared atomic cursor and run
+ *              get_process_resources_at() for each (acquiring the slot's
+ *              handle first when handles are given), writing only to
+ *              their own slots and their own arena. Slots whose result is
+ *              not SUCCESS must still be released with
+ *              free_process_resource_info().
+ *              Time complexity: O(total work / threads)
+ * Error handling: Per-process failures are reported through results
+ */
+int collect_process_resources(WorkerPool* pool, const pid_t* pids, int num_pids,
+                              FdSnapshot* snapshot, Arena** arenas,
+                              ProcHandle* handles, IncrementalScan* incremental,
+                              ProcessResourceInfo* procs, int* results);
+
+/*
+ * triage_processes - Find the processes that sleep on a pipe or a lock
+ * @pool: Worker pool to spread the work over (NULL triages serially)
+ * @pids: Array of process IDs
+ * @num_pids: Number of process IDs
+ * @handles: Per-slot handles from proc_handle_cache_checkout(), acquired and
+ *           left open for a later collection or check-in (NULL = temporary)
+ * @blocked: Output array of num_pids flags, 1 if pids[i] is blocked
+ * @results: Output array of num_pids result codes, one per slot
+ * @return: SUCCESS (0) on success, negative error code for invalid arguments
+ * Description: First phase of a scan. Reads only /proc/[PID]/wchan and
+ *              classifies it exactly like get_process_resources_at() (pipe,
+ *              lock or child wait), so an unflagged process would get no
+ *              wait edge from dependency analysis and cannot be part of a
+ *              cycle. Only flagged processes need their locks and FDs
+ *              collected.
+ *              Time complexity: O(n / threads)
+ * Error handling: Per-process failures are reported through results;
+ *                 ERROR_FILE_NOT_FOUND marks processes that have exited
+ */
+int triage_processes(WorkerPool* pool, const pid_t* pids, int num_pids,
+                     ProcHandle* handles, char* blocked, int* results);
+
 /*
  * read_proc_file - Read a file from /proc filesystem
  * @pid: Process ID (0 for system-wide /proc files)
@@ -205,6 +357,8 @@ void free_process_list(pid_t* pids);
  * @res_info: ProcessResourceInfo structure to clean up
  * @return: None
  * Description: Frees all dynamically allocated arrays in ProcessResourceInfo.
+ *              Arena-backed structures only drop their pointers; the memory
+ *              is released when the arena is reset.
  *              Safe to call with partially initialized structures.
  * Error handling: Handles NULL pointers gracefully
  */
@@ -247,7 +401,8 @@ int get_process_wchan(pid_t pid, char** wchan);
  * @locks: Output array of FileLockInfo structures
  * @count: Output parameter for number of locks found
  * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Parses system-wide /proc/locks file to extract all file locks.
+ * Description: Reads system-wide /proc/locks once and tokenizes it through
+ *              lock_index_load(). Waiter lines are not returned.
  *              Allocates array for locks. Caller must free locks array.
  *              Time complexity: O(l) where l is number of locks
  * Error handling: Returns error codes for file access or parse errors
@@ -259,10 +414,11 @@ int parse_system_locks(FileLockInfo** locks, int* count);
  * @pid: Process ID
  * @fd: File descriptor number
  * @inode: Output parameter for pipe inode
- * @is_read_end: Output parameter (1 if read end, 0 if write end)
+ * @is_read_end: Output parameter (1 if read end, 0 if write end or unknown)
  * @return: SUCCESS (0) if FD is a pipe, negative error code otherwise
  * Description: Reads /proc/[PID]/fd/[FD] to determine if it's a pipe
- *              and extract its inode number. Determines read/write end.
+ *              and extract its inode number. The end is taken from the
+ *              access mode in /proc/[PID]/fdinfo/[FD].
  *              Time complexity: O(1) file read
  * Error handling: Returns error if FD is not a pipe or access denied
  */
@@ -286,17 +442,17 @@ int get_file_path_from_fd(pid_t pid, int fd, char* file_path, unsigned long* ino
  * detect_pipe_dependencies - Detect pipe relationships between processes
  * @all_pipes: Output array of PipeInfo structures for all processes
  * @pipe_count: Output parameter for number of pipes found
- * @pids: Array of process IDs to analyze
- * @num_pids: Number of processes
+ * @procs: Array of collected processes (pipes are taken from their fd_table)
+ * @num_procs: Number of processes
  * @return: SUCCESS (0) on success, negative error code on failure
- * Description: Analyzes all processes to find pipe relationships.
- *              Matches pipe inodes between processes to detect dependencies.
- *              Allocates array for pipes. Caller must free pipes array.
- *              Time complexity: O(P * F) where P=processes, F=FDs per process
- * Error handling: Returns error codes for allocation or access issues
+ * Description: Flattens the pipe FDs of every process's FD snapshot into one
+ *              PipeInfo array, tagging each with the owner's blocked state.
+ *              Performs no /proc I/O. Caller must free pipes array.
+ *              Time complexity: O(P + total pipe FDs)
+ * Error handling: Returns error codes for allocation issues
  */
 int detect_pipe_dependencies(PipeInfo** all_pipes, int* pipe_count,
-                             pid_t* pids, int num_pids);
+                             const ProcessResourceInfo* procs, int num_procs);
 
 /*
  * free_pipe_info - Free array of PipeInfo structures
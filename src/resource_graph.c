@@ -1,8 +1,8 @@
 /* =============================================================================
  * RESOURCE_GRAPH.C - Resource Allocation Graph Implementation
  * =============================================================================
- * Implementation of Resource Allocation Graph (RAG) using adjacency list
- * representation for efficient sparse graph storage.
+ * Implementation of Resource Allocation Graph (RAG). Edges are recorded as
+ * packed keys and frozen into a compressed sparse row layout for analysis.
  * =============================================================================
  */
 
@@ -13,6 +13,10 @@
 #include <stdlib.h>
 #include <string.h>
 
+/* Radix sort digit width for edge keys */
+#define EDGE_RADIX_BITS 11
+#define EDGE_RADIX_SIZE (1 << EDGE_RADIX_BITS)
+
 /* =============================================================================
  * HELPER FUNCTIONS
  * =============================================================================
@@ -43,7 +47,7 @@ static GraphNode* create_graph_node(int vertex_id, int edge_type)
  * @head: Pointer to head of adjacency list (may be modified)
  * @vertex_id: ID of destination vertex
  * @edge_type: Type of edge (0=request, 1=allocation)
- * @return: SUCCESS (0) on success, negative on failure
+ * @return: 1 if added, 0 if already present, negative on failure
  */
 static int add_edge_to_list(GraphNode** head, int vertex_id, int edge_type)
 {
@@ -56,7 +60,7 @@ static int add_edge_to_list(GraphNode** head, int vertex_id, int edge_type)
     while (current != NULL) {
         if (current->vertex_id == vertex_id && current->edge_type == edge_type) {
             /* Edge already exists, skip */
-            return SUCCESS;
+            return 0;
         }
         current = current->next;
     }
@@ -71,9 +75,141 @@ static int add_edge_to_list(GraphNode** head, int vertex_id, int edge_type)
     new_node->next = *head;
     *head = new_node;
     
+    return 1;
+}
+
+/*
+ * record_edge_key - Append an edge to the key buffer
+ * @graph: ResourceGraph to modify
+ * @from_vertex: Source vertex index
+ * @to_vertex: Target vertex index
+ * @edge_type: Type of edge (0=request, 1=allocation)
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ */
+static int record_edge_key(ResourceGraph* graph, int from_vertex, int to_vertex,
+                           int edge_type)
+{
+    if (graph->num_edge_keys >= graph->edge_key_capacity) {
+        int new_capacity = graph->edge_key_capacity == 0 ?
+            256 : graph->edge_key_capacity * 2;
+        unsigned long long* new_keys = (unsigned long long*)safe_realloc(
+            graph->edge_keys, sizeof(unsigned long long) * new_capacity);
+        if (new_keys == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        graph->edge_keys = new_keys;
+        graph->edge_key_capacity = new_capacity;
+    }
+    
+    graph->edge_keys[graph->num_edge_keys++] =
+        ((unsigned long long)(unsigned int)from_vertex << 32) |
+        ((unsigned long long)(unsigned int)to_vertex << 1) |
+        (unsigned long long)(edge_type & 1);
+    graph->csr_valid = 0;
     return SUCCESS;
 }
 
+/*
+ * radix_sort_edge_keys - LSD radix sort of edge keys
+ * @keys: Keys to sort (sorted in place)
+ * @scratch: Buffer of the same size
+ * @count: Number of keys
+ * @return: None
+ * Description: Sorts EDGE_RADIX_BITS bits per pass, only up to the highest
+ *              bit in use, and skips passes where every key has the same
+ *              digit.
+ */
+static void radix_sort_edge_keys(unsigned long long* keys,
+                                 unsigned long long* scratch, int count)
+{
+    unsigned long long max_key = 0;
+    for (int i = 0; i < count; i++) {
+        if (keys[i] > max_key) {
+            max_key = keys[i];
+        }
+    }
+    
+    unsigned long long* src = keys;
+    unsigned long long* dst = scratch;
+    int buckets[EDGE_RADIX_SIZE];
+    
+    for (int shift = 0; shift < 64 && (max_key >> shift) != 0; shift += EDGE_RADIX_BITS) {
+        memset(buckets, 0, sizeof(buckets));
+        for (int i = 0; i < count; i++) {
+            buckets[(src[i] >> shift) & (EDGE_RADIX_SIZE - 1)]++;
+        }
+        
+        if (buckets[(src[0] >> shift) & (EDGE_RADIX_SIZE - 1)] == count) {
+            continue; /* All keys share this digit */
+        }
+        
+        int offset = 0;
+        for (int b = 0; b < EDGE_RADIX_SIZE; b++) {
+            int n = buckets[b];
+            buckets[b] = offset;
+            offset += n;
+        }
+        for (int i = 0; i < count; i++) {
+            dst[buckets[(src[i] >> shift) & (EDGE_RADIX_SIZE - 1)]++] = src[i];
+        }
+        
+        unsigned long long* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+    
+    if (src != keys) {
+        memcpy(keys, src, sizeof(unsigned long long) * count);
+    }
+}
+
+/*
+ * hash_vertex_key - Hash a (vertex type, id) pair
+ * @type: VERTEX_TYPE_PROCESS or VERTEX_TYPE_RESOURCE
+ * @id: PID or RID
+ * @mask: Index size minus one
+ * @return: Initial probe position
+ */
+static int hash_vertex_key(int type, int id, int mask)
+{
+    unsigned long long key = ((unsigned long long)(unsigned int)type << 32) |
+                             (unsigned int)id;
+    key *= 0x9E3779B97F4A7C15ULL;
+    return (int)(key >> 32) & mask;
+}
+
+/*
+ * find_indexed_vertex - Look up a vertex by (type, id) in the vertex index
+ * @graph: ResourceGraph to search
+ * @type: Vertex type
+ * @id: PID or RID
+ * @slot_out: Output for the probe position where the search stopped
+ *            (the empty slot to insert into if not found), may be NULL
+ * @return: Vertex index if found, -1 otherwise
+ */
+static int find_indexed_vertex(const ResourceGraph* graph, int type, int id,
+                               int* slot_out)
+{
+    int mask = graph->vertex_index_mask;
+    int pos = hash_vertex_key(type, id, mask);
+    
+    while (graph->vertex_index[pos] >= 0) {
+        int v = graph->vertex_index[pos];
+        if (graph->vertex_type[v] == type && graph->vertex_id[v] == id) {
+            if (slot_out != NULL) {
+                *slot_out = pos;
+            }
+            return v;
+        }
+        pos = (pos + 1) & mask;
+    }
+    
+    if (slot_out != NULL) {
+        *slot_out = pos;
+    }
+    return -1;
+}
+
 /* =============================================================================
  * MAIN FUNCTIONS
  * =============================================================================
@@ -84,7 +220,7 @@ static int add_edge_to_list(GraphNode** head, int vertex_id, int edge_type)
  * @max_vertices: Maximum number of vertices the graph can hold
  * @return: Pointer to allocated ResourceGraph, or NULL on failure
  * Description: Allocates and initializes a new RAG with specified capacity.
- *              Uses adjacency list representation for efficient sparse graphs.
+ *              Edge storage (key buffer and CSR arrays) is allocated lazily.
  *              Memory: O(V) where V is max_vertices.
  * Error handling: Returns NULL on allocation failure, logs error
  */
@@ -105,6 +241,13 @@ ResourceGraph* create_graph(int max_vertices)
     graph->max_vertices = max_vertices;
     graph->num_edges = 0;
     graph->next_vertex_index = 0;
+    graph->edge_keys = NULL;
+    graph->num_edge_keys = 0;
+    graph->edge_key_capacity = 0;
+    graph->csr_offsets = NULL;
+    graph->csr_targets = NULL;
+    graph->csr_edge_types = NULL;
+    graph->csr_valid = 0;
     
     /* Allocate adjacency list array */
     graph->adjacency_list = (GraphNode**)safe_malloc(
@@ -169,6 +312,27 @@ ResourceGraph* create_graph(int max_vertices)
         return NULL;
     }
     
+    /* Allocate vertex index, kept at most half full */
+    int index_size = 16;
+    while (index_size < max_vertices * 2) {
+        index_size *= 2;
+    }
+    graph->vertex_index = (int*)safe_malloc(sizeof(int) * index_size);
+    if (graph->vertex_index == NULL) {
+        free(graph->vertex_instances);
+        free(graph->vertex_id);
+        free(graph->vertex_type);
+        free(graph->parent);
+        free(graph->color);
+        free(graph->adjacency_list);
+        free(graph);
+        return NULL;
+    }
+    graph->vertex_index_mask = index_size - 1;
+    for (int i = 0; i < index_size; i++) {
+        graph->vertex_index[i] = -1;
+    }
+    
     /* Initialize arrays */
     for (int i = 0; i < max_vertices; i++) {
         graph->color[i] = COLOR_WHITE;
@@ -186,8 +350,8 @@ ResourceGraph* create_graph(int max_vertices)
  * @graph: ResourceGraph to search
  * @pid: Process ID to find
  * @return: Vertex index if found, -1 if not found
- * Description: Searches for process vertex with given PID.
- *              Time complexity: O(V) linear search
+ * Description: Looks up process vertex with given PID in the vertex index.
+ *              Time complexity: O(1) expected
  * Error handling: Returns -1 if not found or graph is NULL
  */
 int find_vertex_by_pid(const ResourceGraph* graph, int pid)
@@ -196,14 +360,7 @@ int find_vertex_by_pid(const ResourceGraph* graph, int pid)
         return -1;
     }
     
-    for (int i = 0; i < graph->num_vertices; i++) {
-        if (graph->vertex_type[i] == VERTEX_TYPE_PROCESS &&
-            graph->vertex_id[i] == pid) {
-            return i;
-        }
-    }
-    
-    return -1;
+    return find_indexed_vertex(graph, VERTEX_TYPE_PROCESS, pid, NULL);
 }
 
 /*
@@ -211,8 +368,8 @@ int find_vertex_by_pid(const ResourceGraph* graph, int pid)
  * @graph: ResourceGraph to search
  * @rid: Resource ID to find
  * @return: Vertex index if found, -1 if not found
- * Description: Searches for resource vertex with given RID.
- *              Time complexity: O(V) linear search
+ * Description: Looks up resource vertex with given RID in the vertex index.
+ *              Time complexity: O(1) expected
  * Error handling: Returns -1 if not found or graph is NULL
  */
 int find_vertex_by_rid(const ResourceGraph* graph, int rid)
@@ -221,14 +378,7 @@ int find_vertex_by_rid(const ResourceGraph* graph, int rid)
         return -1;
     }
     
-    for (int i = 0; i < graph->num_vertices; i++) {
-        if (graph->vertex_type[i] == VERTEX_TYPE_RESOURCE &&
-            graph->vertex_id[i] == rid) {
-            return i;
-        }
-    }
-    
-    return -1;
+    return find_indexed_vertex(graph, VERTEX_TYPE_RESOURCE, rid, NULL);
 }
 
 /*
@@ -238,7 +388,7 @@ int find_vertex_by_rid(const ResourceGraph* graph, int rid)
  * @return: Vertex index on success, -1 on failure
  * Description: Adds a process vertex to the graph if not already present.
  *              Returns the vertex index for this process.
- *              Time complexity: O(V) worst case to check for duplicates
+ *              Time complexity: O(1) expected (hashed duplicate check)
  * Error handling: Returns -1 if graph is full or PID already exists
  */
 int add_process_vertex(ResourceGraph* graph, int pid)
@@ -253,7 +403,8 @@ int add_process_vertex(ResourceGraph* graph, int pid)
     }
     
     /* Check if vertex already exists */
-    int existing = find_vertex_by_pid(graph, pid);
+    int slot = 0;
+    int existing = find_indexed_vertex(graph, VERTEX_TYPE_PROCESS, pid, &slot);
     if (existing >= 0) {
         return existing;
     }
@@ -273,8 +424,10 @@ int add_process_vertex(ResourceGraph* graph, int pid)
     graph->color[vertex_index] = COLOR_WHITE;
     graph->parent[vertex_index] = -1;
     graph->adjacency_list[vertex_index] = NULL;
+    graph->vertex_index[slot] = vertex_index;
     
     graph->num_vertices++;
+    graph->csr_valid = 0;
     
     return vertex_index;
 }
@@ -286,7 +439,7 @@ int add_process_vertex(ResourceGraph* graph, int pid)
  * @instances: Number of instances for this resource (1 for single-instance)
  * @return: Vertex index on success, -1 on failure
  * Description: Adds a resource vertex with specified number of instances.
- *              Time complexity: O(V) worst case to check for duplicates
+ *              Time complexity: O(1) expected (hashed duplicate check)
  * Error handling: Returns -1 if graph is full or RID already exists
  */
 int add_resource_vertex(ResourceGraph* graph, int rid, int instances)
@@ -305,7 +458,8 @@ int add_resource_vertex(ResourceGraph* graph, int rid, int instances)
     }
     
     /* Check if vertex already exists */
-    int existing = find_vertex_by_rid(graph, rid);
+    int slot = 0;
+    int existing = find_indexed_vertex(graph, VERTEX_TYPE_RESOURCE, rid, &slot);
     if (existing >= 0) {
         /* Update instances if different */
         if (graph->vertex_instances[existing] != instances) {
@@ -329,8 +483,10 @@ int add_resource_vertex(ResourceGraph* graph, int rid, int instances)
     graph->color[vertex_index] = COLOR_WHITE;
     graph->parent[vertex_index] = -1;
     graph->adjacency_list[vertex_index] = NULL;
+    graph->vertex_index[slot] = vertex_index;
     
     graph->num_vertices++;
+    graph->csr_valid = 0;
     
     return vertex_index;
 }
@@ -343,7 +499,7 @@ int add_resource_vertex(ResourceGraph* graph, int rid, int instances)
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Adds edge P->R indicating process is waiting for resource.
  *              Creates vertices if they don't exist.
- *              Time complexity: O(V + E) worst case
+ *              Time complexity: O(deg) for the duplicate edge check
  * Error handling: Returns error codes for invalid arguments or graph full
  */
 int add_request_edge(ResourceGraph* graph, int pid, int rid)
@@ -367,11 +523,18 @@ int add_request_edge(ResourceGraph* graph, int pid, int rid)
     /* Add edge from process to resource (request edge) */
     int result = add_edge_to_list(&graph->adjacency_list[process_vertex],
                                   resource_vertex, 0); /* 0 = request edge */
-    if (result == SUCCESS) {
+    if (result < 0) {
+        return result;
+    }
+    if (result == 1) {
+        result = record_edge_key(graph, process_vertex, resource_vertex, 0);
+        if (result != SUCCESS) {
+            return result;
+        }
         graph->num_edges++;
     }
     
-    return result;
+    return SUCCESS;
 }
 
 /*
@@ -382,7 +545,7 @@ int add_request_edge(ResourceGraph* graph, int pid, int rid)
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Adds edge R->P indicating resource is allocated to process.
  *              Creates vertices if they don't exist.
- *              Time complexity: O(V + E) worst case
+ *              Time complexity: O(deg) for the duplicate edge check
  * Error handling: Returns error codes for invalid arguments or graph full
  */
 int add_allocation_edge(ResourceGraph* graph, int rid, int pid)
@@ -406,6 +569,85 @@ int add_allocation_edge(ResourceGraph* graph, int rid, int pid)
     /* Add edge from resource to process (allocation edge) */
     int result = add_edge_to_list(&graph->adjacency_list[resource_vertex],
                                   process_vertex, 1); /* 1 = allocation edge */
+    if (result < 0) {
+        return result;
+    }
+    if (result == 1) {
+        result = record_edge_key(graph, resource_vertex, process_vertex, 1);
+        if (result != SUCCESS) {
+            return result;
+        }
+        graph->num_edges++;
+    }
+    
+    return SUCCESS;
+}
+
+/*
+ * queue_request_edge - Record a request edge for the next freeze
+ * @graph: ResourceGraph to modify
+ * @pid: Process ID requesting the resource
+ * @rid: Resource ID being requested
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Creates vertices if needed and appends the P->R key.
+ *              Duplicates are removed by freeze_graph().
+ *              Time complexity: O(1) amortized
+ * Error handling: Returns error codes for invalid arguments, graph full or
+ *                 allocation failure
+ */
+int queue_request_edge(ResourceGraph* graph, int pid, int rid)
+{
+    if (graph == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    int process_vertex = add_process_vertex(graph, pid);
+    if (process_vertex < 0) {
+        return ERROR_GRAPH_CREATION_FAILED;
+    }
+    
+    int resource_vertex = add_resource_vertex(graph, rid, 1);
+    if (resource_vertex < 0) {
+        return ERROR_GRAPH_CREATION_FAILED;
+    }
+    
+    int result = record_edge_key(graph, process_vertex, resource_vertex, 0);
+    if (result == SUCCESS) {
+        graph->num_edges++;
+    }
+    
+    return result;
+}
+
+/*
+ * queue_allocation_edge - Record an allocation edge for the next freeze
+ * @graph: ResourceGraph to modify
+ * @rid: Resource ID being allocated
+ * @pid: Process ID receiving the resource
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Creates vertices if needed and appends the R->P key.
+ *              Duplicates are removed by freeze_graph().
+ *              Time complexity: O(1) amortized
+ * Error handling: Returns error codes for invalid arguments, graph full or
+ *                 allocation failure
+ */
+int queue_allocation_edge(ResourceGraph* graph, int rid, int pid)
+{
+    if (graph == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    int resource_vertex = add_resource_vertex(graph, rid, 1);
+    if (resource_vertex < 0) {
+        return ERROR_GRAPH_CREATION_FAILED;
+    }
+    
+    int process_vertex = add_process_vertex(graph, pid);
+    if (process_vertex < 0) {
+        return ERROR_GRAPH_CREATION_FAILED;
+    }
+    
+    int result = record_edge_key(graph, resource_vertex, process_vertex, 1);
     if (result == SUCCESS) {
         graph->num_edges++;
     }
@@ -413,6 +655,130 @@ int add_allocation_edge(ResourceGraph* graph, int rid, int pid)
     return result;
 }
 
+/*
+ * freeze_graph - Build the CSR edge layout from all recorded edges
+ * @graph: ResourceGraph to freeze
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Radix-sorts the keys (source-major, then target, then type),
+ *              compacts duplicates in place so later freezes only re-sort
+ *              distinct edges plus new ones, then counts row sizes into
+ *              csr_offsets and writes targets and types in key order.
+ * Error handling: Returns ERROR_OUT_OF_MEMORY on allocation failure, leaving
+ *                 csr_valid cleared
+ */
+int freeze_graph(ResourceGraph* graph)
+{
+    if (graph == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+    
+    if (graph->csr_valid) {
+        return SUCCESS;
+    }
+    
+    int count = graph->num_edge_keys;
+    unsigned long long* keys = graph->edge_keys;
+    
+    if (count > 1) {
+        unsigned long long* scratch = (unsigned long long*)safe_malloc(
+            sizeof(unsigned long long) * count);
+        if (scratch == NULL) {
+            return ERROR_OUT_OF_MEMORY;
+        }
+        radix_sort_edge_keys(keys, scratch, count);
+        free(scratch);
+        
+        int unique = 1;
+        for (int i = 1; i < count; i++) {
+            if (keys[i] != keys[unique - 1]) {
+                keys[unique++] = keys[i];
+            }
+        }
+        count = unique;
+        graph->num_edge_keys = count;
+    }
+    
+    int* offsets = (int*)safe_realloc(graph->csr_offsets,
+                                      sizeof(int) * (graph->num_vertices + 1));
+    if (offsets == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    graph->csr_offsets = offsets;
+    
+    int alloc_count = count > 0 ? count : 1;
+    int* targets = (int*)safe_realloc(graph->csr_targets, sizeof(int) * alloc_count);
+    if (targets == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    graph->csr_targets = targets;
+    
+    unsigned char* types = (unsigned char*)safe_realloc(
+        graph->csr_edge_types, sizeof(unsigned char) * alloc_count);
+    if (types == NULL) {
+        return ERROR_OUT_OF_MEMORY;
+    }
+    graph->csr_edge_types = types;
+    
+    /* Keys are sorted by source, so rows are contiguous */
+    memset(offsets, 0, sizeof(int) * (graph->num_vertices + 1));
+    for (int i = 0; i < count; i++) {
+        offsets[(int)(keys[i] >> 32) + 1]++;
+        targets[i] = (int)((keys[i] >> 1) & 0x7fffffffULL);
+        types[i] = (unsigned char)(keys[i] & 1);
+    }
+    for (int v = 0; v < graph->num_vertices; v++) {
+        offsets[v + 1] += offsets[v];
+    }
+    
+    graph->num_edges = count;
+    graph->csr_valid = 1;
+    return SUCCESS;
+}
+
+/*
+ * graph_has_edge - Check whether an edge from one vertex to another exists
+ * @graph: ResourceGraph to query
+ * @from_vertex: Source vertex index
+ * @to_vertex: Target vertex index
+ * @return: 1 if an edge of any type exists, 0 otherwise
+ * Description: Binary search in the sorted CSR row when frozen; otherwise
+ *              scans the recorded keys, which include adjacency list edges.
+ * Error handling: Returns 0 for NULL graph or invalid vertices
+ */
+int graph_has_edge(const ResourceGraph* graph, int from_vertex, int to_vertex)
+{
+    if (graph == NULL ||
+        from_vertex < 0 || from_vertex >= graph->num_vertices ||
+        to_vertex < 0 || to_vertex >= graph->num_vertices) {
+        return 0;
+    }
+    
+    if (graph->csr_valid) {
+        int lo = graph->csr_offsets[from_vertex];
+        int hi = graph->csr_offsets[from_vertex + 1];
+        while (lo < hi) {
+            int mid = lo + (hi - lo) / 2;
+            if (graph->csr_targets[mid] < to_vertex) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return (lo < graph->csr_offsets[from_vertex + 1] &&
+                graph->csr_targets[lo] == to_vertex) ? 1 : 0;
+    }
+    
+    for (int i = 0; i < graph->num_edge_keys; i++) {
+        unsigned long long key = graph->edge_keys[i];
+        if ((int)(key >> 32) == from_vertex &&
+            (int)((key >> 1) & 0x7fffffffULL) == to_vertex) {
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
 /*
  * get_vertex_id - Get the PID or RID for a vertex index
  * @graph: ResourceGraph to query
@@ -468,6 +834,26 @@ void print_graph(const ResourceGraph* graph)
         
         printf(" -> ");
         
+        if (graph->csr_valid) {
+            int first = graph->csr_offsets[i];
+            int last = graph->csr_offsets[i + 1];
+            if (first == last) {
+                printf("(no edges)");
+            }
+            for (int e = first; e < last; e++) {
+                int target = graph->csr_targets[e];
+                if (e > first) {
+                    printf(", ");
+                }
+                printf("%c%d(%s)",
+                       graph->vertex_type[target] == VERTEX_TYPE_PROCESS ? 'P' : 'R',
+                       graph->vertex_id[target],
+                       graph->csr_edge_types[e] == 0 ? "req" : "alloc");
+            }
+            printf("\n");
+            continue;
+        }
+        
         GraphNode* current = graph->adjacency_list[i];
         if (current == NULL) {
             printf("(no edges)");
@@ -561,17 +947,23 @@ void reset_graph_colors(ResourceGraph* graph)
  * @wfg_out: Output parameter for new WFG graph
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Converts RAG to WFG by removing resource nodes and creating
- *              direct edges between processes. Only includes processes that
- *              are part of a cycle.
+ *              direct edges between processes. Runs on the RAG's CSR rows
+ *              and builds the WFG through the edge key buffer, so the result
+ *              is frozen and has no adjacency lists.
  *              Time complexity: O(V + E)
  * Error handling: Returns error codes on allocation failure
  */
-int convert_to_wfg(const ResourceGraph* rag, ResourceGraph** wfg_out)
+int convert_to_wfg(ResourceGraph* rag, ResourceGraph** wfg_out)
 {
     if (rag == NULL || wfg_out == NULL) {
         return ERROR_INVALID_ARGUMENT;
     }
     
+    int result = freeze_graph(rag);
+    if (result != SUCCESS) {
+        return result;
+    }
+    
     /* Count process vertices */
     int process_count = 0;
     for (int i = 0; i < rag->num_vertices; i++) {
@@ -591,47 +983,60 @@ int convert_to_wfg(const ResourceGraph* rag, ResourceGraph** wfg_out)
         return ERROR_OUT_OF_MEMORY;
     }
     
-    /* Add all process vertices to WFG */
+    /* Map RAG vertex -> WFG vertex for every process */
+    int* wfg_vertex = (int*)safe_malloc(sizeof(int) * rag->num_vertices);
+    if (wfg_vertex == NULL) {
+        free_graph(wfg);
+        return ERROR_OUT_OF_MEMORY;
+    }
+    
     for (int i = 0; i < rag->num_vertices; i++) {
+        wfg_vertex[i] = -1;
         if (rag->vertex_type[i] == VERTEX_TYPE_PROCESS) {
-            int pid = rag->vertex_id[i];
-            add_process_vertex(wfg, pid);
+            wfg_vertex[i] = add_process_vertex(wfg, rag->vertex_id[i]);
         }
     }
     
     /* Convert edges: P1->R->P2 becomes P1->P2 in WFG */
-    for (int i = 0; i < rag->num_vertices; i++) {
-        if (rag->vertex_type[i] == VERTEX_TYPE_PROCESS) {
-            GraphNode* current = rag->adjacency_list[i];
-            while (current != NULL) {
-                int resource_vertex = current->vertex_id;
-                
-                /* Follow resource's edges to find which process it's allocated to */
-                if (rag->vertex_type[resource_vertex] == VERTEX_TYPE_RESOURCE) {
-                    GraphNode* resource_edge = rag->adjacency_list[resource_vertex];
-                    while (resource_edge != NULL) {
-                        if (resource_edge->edge_type == 1) { /* Allocation edge */
-                            int target_process = resource_edge->vertex_id;
-                            
-                            /* Add direct edge P1->P2 in WFG */
-                            int p1_idx = find_vertex_by_pid(wfg, rag->vertex_id[i]);
-                            int p2_idx = find_vertex_by_pid(wfg, rag->vertex_id[target_process]);
-                            
-                            if (p1_idx >= 0 && p2_idx >= 0) {
-                                add_edge_to_list(&wfg->adjacency_list[p1_idx], 
-                                                p2_idx, 0);
-                                wfg->num_edges++;
-                            }
-                        }
-                        resource_edge = resource_edge->next;
+    for (int i = 0; i < rag->num_vertices && result == SUCCESS; i++) {
+        if (wfg_vertex[i] < 0) {
+            continue;
+        }
+        
+        for (int e = rag->csr_offsets[i]; e < rag->csr_offsets[i + 1]; e++) {
+            int resource_vertex = rag->csr_targets[e];
+            if (rag->vertex_type[resource_vertex] != VERTEX_TYPE_RESOURCE) {
+                continue;
+            }
+            
+            /* Follow resource's allocation edges to the holding processes */
+            for (int f = rag->csr_offsets[resource_vertex];
+                 f < rag->csr_offsets[resource_vertex + 1]; f++) {
+                int target_process = rag->csr_targets[f];
+                if (rag->csr_edge_types[f] == 1 && wfg_vertex[target_process] >= 0) {
+                    result = record_edge_key(wfg, wfg_vertex[i],
+                                             wfg_vertex[target_process], 0);
+                    if (result != SUCCESS) {
+                        break;
                     }
                 }
-                
-                current = current->next;
+            }
+            if (result != SUCCESS) {
+                break;
             }
         }
     }
     
+    free(wfg_vertex);
+    
+    if (result == SUCCESS) {
+        result = freeze_graph(wfg);
+    }
+    if (result != SUCCESS) {
+        free_graph(wfg);
+        return result;
+    }
+    
     *wfg_out = wfg;
     return SUCCESS;
 }
@@ -640,7 +1045,8 @@ int convert_to_wfg(const ResourceGraph* rag, ResourceGraph** wfg_out)
  * free_graph - Free all memory allocated for ResourceGraph
  * @graph: ResourceGraph to free
  * @return: None
- * Description: Frees adjacency lists, arrays, and graph structure itself.
+ * Description: Frees adjacency lists, edge keys, CSR arrays, other arrays,
+ *              and graph structure itself.
  *              Safe to call with NULL pointer.
  * Error handling: Handles NULL pointer and partially initialized graphs safely
  */
@@ -669,6 +1075,11 @@ void free_graph(ResourceGraph* graph)
     safe_free((void**)&graph->vertex_type);
     safe_free((void**)&graph->vertex_id);
     safe_free((void**)&graph->vertex_instances);
+    safe_free((void**)&graph->vertex_index);
+    safe_free((void**)&graph->edge_keys);
+    safe_free((void**)&graph->csr_offsets);
+    safe_free((void**)&graph->csr_targets);
+    safe_free((void**)&graph->csr_edge_types);
     
     /* Free graph structure */
     free(graph);
@@ -6,6 +6,11 @@
  * =============================================================================
  * This header defines structures and functions for building and managing
  * Resource Allocation Graphs (RAG) used in deadlock detection.
+ *
+ * Edges are recorded as packed 64-bit keys. freeze_graph() sorts and dedups
+ * the keys into a compressed sparse row (CSR) layout, which is what the
+ * analysis code traverses. The per-vertex adjacency lists are maintained
+ * only by the incremental add_request_edge()/add_allocation_edge() API.
  * =============================================================================
  */
 
@@ -29,7 +34,8 @@ typedef struct GraphNode {
 
 /*
  * ResourceGraph - Resource Allocation Graph structure
- * Uses adjacency list representation for efficient sparse graph storage
+ * Edges of vertex v are csr_targets[csr_offsets[v] .. csr_offsets[v + 1] - 1],
+ * sorted by target, valid while csr_valid is set
  */
 typedef struct {
     GraphNode** adjacency_list;     /* Array of adjacency lists, one per vertex */
@@ -42,6 +48,15 @@ typedef struct {
     int* vertex_instances;           /* Array: number of instances for resources, 0 for processes */
     int num_edges;                   /* Total number of edges in graph */
     int next_vertex_index;           /* Next available vertex index */
+    int* vertex_index;               /* Open-addressing (type, id) -> vertex table, -1 = empty */
+    int vertex_index_mask;           /* Size of vertex_index minus one (power of two) */
+    unsigned long long* edge_keys;   /* All edges as (from << 32 | to << 1 | type) */
+    int num_edge_keys;               /* Keys recorded (deduped up to last freeze) */
+    int edge_key_capacity;           /* Allocated key slots */
+    int* csr_offsets;                /* Row start per vertex, num_vertices + 1 entries */
+    int* csr_targets;                /* Edge targets grouped by source vertex */
+    unsigned char* csr_edge_types;   /* Edge type per csr_targets entry */
+    int csr_valid;                   /* 1 if CSR reflects every vertex and edge */
 } ResourceGraph;
 
 /* =============================================================================
@@ -54,7 +69,7 @@ typedef struct {
  * @max_vertices: Maximum number of vertices the graph can hold
  * @return: Pointer to allocated ResourceGraph, or NULL on failure
  * Description: Allocates and initializes a new RAG with specified capacity.
- *              Uses adjacency list representation for efficient sparse graphs.
+ *              Edge storage (key buffer and CSR arrays) is allocated lazily.
  *              Memory: O(V) where V is max_vertices.
  * Error handling: Returns NULL on allocation failure, logs error
  */
@@ -67,7 +82,7 @@ ResourceGraph* create_graph(int max_vertices);
  * @return: Vertex index on success, -1 on failure
  * Description: Adds a process vertex to the graph if not already present.
  *              Returns the vertex index for this process.
- *              Time complexity: O(V) worst case to check for duplicates
+ *              Time complexity: O(1) expected (hashed duplicate check)
  * Error handling: Returns -1 if graph is full or PID already exists
  */
 int add_process_vertex(ResourceGraph* graph, int pid);
@@ -79,7 +94,7 @@ int add_process_vertex(ResourceGraph* graph, int pid);
  * @instances: Number of instances for this resource (1 for single-instance)
  * @return: Vertex index on success, -1 on failure
  * Description: Adds a resource vertex with specified number of instances.
- *              Time complexity: O(V) worst case to check for duplicates
+ *              Time complexity: O(1) expected (hashed duplicate check)
  * Error handling: Returns -1 if graph is full or RID already exists
  */
 int add_resource_vertex(ResourceGraph* graph, int rid, int instances);
@@ -92,7 +107,7 @@ int add_resource_vertex(ResourceGraph* graph, int rid, int instances);
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Adds edge P->R indicating process is waiting for resource.
  *              Creates vertices if they don't exist.
- *              Time complexity: O(V + E) worst case
+ *              Time complexity: O(deg) for the duplicate edge check
  * Error handling: Returns error codes for invalid arguments or graph full
  */
 int add_request_edge(ResourceGraph* graph, int pid, int rid);
@@ -105,18 +120,75 @@ int add_request_edge(ResourceGraph* graph, int pid, int rid);
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Adds edge R->P indicating resource is allocated to process.
  *              Creates vertices if they don't exist.
- *              Time complexity: O(V + E) worst case
+ *              Time complexity: O(deg) for the duplicate edge check
  * Error handling: Returns error codes for invalid arguments or graph full
  */
 int add_allocation_edge(ResourceGraph* graph, int rid, int pid);
 
+/*
+ * queue_request_edge - Record a request edge for the next freeze
+ * @graph: ResourceGraph to modify
+ * @pid: Process ID requesting the resource
+ * @rid: Resource ID being requested
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Bulk-building variant of add_request_edge(): creates vertices
+ *              if needed and appends the edge key without a duplicate check
+ *              or per-edge allocation. The edge is not added to the
+ *              adjacency list; it becomes visible after freeze_graph().
+ *              Time complexity: O(1) amortized
+ * Error handling: Returns error codes for invalid arguments, graph full or
+ *                 allocation failure
+ */
+int queue_request_edge(ResourceGraph* graph, int pid, int rid);
+
+/*
+ * queue_allocation_edge - Record an allocation edge for the next freeze
+ * @graph: ResourceGraph to modify
+ * @rid: Resource ID being allocated
+ * @pid: Process ID receiving the resource
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: Bulk-building variant of add_allocation_edge(); see
+ *              queue_request_edge().
+ *              Time complexity: O(1) amortized
+ * Error handling: Returns error codes for invalid arguments, graph full or
+ *                 allocation failure
+ */
+int queue_allocation_edge(ResourceGraph* graph, int rid, int pid);
+
+/*
+ * freeze_graph - Build the CSR edge layout from all recorded edges
+ * @graph: ResourceGraph to freeze
+ * @return: SUCCESS (0) on success, negative error code on failure
+ * Description: LSD radix-sorts the edge keys, drops duplicates and fills
+ *              csr_offsets/csr_targets/csr_edge_types. num_edges becomes the
+ *              number of distinct edges. Returns immediately if the CSR is
+ *              already current; adding vertices or edges invalidates it.
+ *              Time complexity: O(V + E)
+ * Error handling: Returns ERROR_OUT_OF_MEMORY on allocation failure, leaving
+ *                 csr_valid cleared
+ */
+int freeze_graph(ResourceGraph* graph);
+
+/*
+ * graph_has_edge - Check whether an edge from one vertex to another exists
+ * @graph: ResourceGraph to query
+ * @from_vertex: Source vertex index
+ * @to_vertex: Target vertex index
+ * @return: 1 if an edge of any type exists, 0 otherwise
+ * Description: Binary search in the CSR row when the graph is frozen,
+ *              otherwise a linear scan of the recorded edge keys.
+ *              Time complexity: O(log deg) when frozen, O(deg + E) otherwise
+ * Error handling: Returns 0 for NULL graph or invalid vertices
+ */
+int graph_has_edge(const ResourceGraph* graph, int from_vertex, int to_vertex);
+
 /*
  * find_vertex_by_pid - Find vertex index for a given process ID
  * @graph: ResourceGraph to search
  * @pid: Process ID to find
  * @return: Vertex index if found, -1 if not found
- * Description: Searches for process vertex with given PID.
- *              Time complexity: O(V) linear search
+ * Description: Looks up process vertex with given PID in the vertex index.
+ *              Time complexity: O(1) expected
  * Error handling: Returns -1 if not found or graph is NULL
  */
 int find_vertex_by_pid(const ResourceGraph* graph, int pid);
@@ -126,8 +198,8 @@ int find_vertex_by_pid(const ResourceGraph* graph, int pid);
  * @graph: ResourceGraph to search
  * @rid: Resource ID to find
  * @return: Vertex index if found, -1 if not found
- * Description: Searches for resource vertex with given RID.
- *              Time complexity: O(V) linear search
+ * Description: Looks up resource vertex with given RID in the vertex index.
+ *              Time complexity: O(1) expected
  * Error handling: Returns -1 if not found or graph is NULL
  */
 int find_vertex_by_rid(const ResourceGraph* graph, int rid);
@@ -149,18 +221,19 @@ int get_vertex_id(const ResourceGraph* graph, int vertex_index);
  * @wfg_out: Output parameter for new WFG graph
  * @return: SUCCESS (0) on success, negative error code on failure
  * Description: Converts RAG to WFG by removing resource nodes and creating
- *              direct edges between processes. Only includes processes that
- *              are part of a cycle.
+ *              direct edges between processes. Freezes the RAG, walks its
+ *              CSR rows and returns a frozen WFG.
  *              Time complexity: O(V + E)
  * Error handling: Returns error codes on allocation failure
  */
-int convert_to_wfg(const ResourceGraph* rag, ResourceGraph** wfg_out);
+int convert_to_wfg(ResourceGraph* rag, ResourceGraph** wfg_out);
 
 /*
  * print_graph - Print graph structure for debugging
  * @graph: ResourceGraph to print
  * @return: None
- * Description: Prints adjacency list representation of graph to stdout.
+ * Description: Prints the edges of every vertex to stdout (CSR rows when
+ *              frozen, adjacency lists otherwise).
  *              Shows all vertices and edges in readable format.
  *              Time complexity: O(V + E)
  * Error handling: Handles NULL graph safely
@@ -195,7 +268,8 @@ void reset_graph_colors(ResourceGraph* graph);
  * free_graph - Free all memory allocated for ResourceGraph
  * @graph: ResourceGraph to free
  * @return: None
- * Description: Frees adjacency lists, arrays, and graph structure itself.
+ * Description: Frees adjacency lists, edge keys, CSR arrays, other arrays,
+ *              and graph structure itself.
  *              Safe to call with NULL pointer.
  * Error handling: Handles NULL pointer and partially initialized graphs safely
  */
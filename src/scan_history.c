@@ -0,0 +1,196 @@
+/* =============================================================================
+ * SCAN_HISTORY.C - Per-Process Scan History Implementation
+ * =============================================================================
+ * Double-buffered open-addressing hash of the records of the last scan.
+ * =============================================================================
+ */
+
+#include "scan_history.h"
+#include "utility.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * hash_pid - Hash a PID into a power-of-two table
+ * @pid: Process ID
+ * @mask: Table size minus one
+ * @return: Initial probe position
+ */
+static int hash_pid(pid_t pid, int mask)
+{
+    unsigned long long h = (unsigned long long)(unsigned int)pid * 0x9E3779B97F4A7C15ULL;
+    return (int)(h >> 32) & mask;
+}
+
+/*
+ * find_slot - Find the slot of pid, or the empty slot ending its probe
+ * @slots: Table to search
+ * @num_slots: Table size (power of two, never full)
+ * @pid: Process ID
+ * @return: Slot index
+ */
+static int find_slot(const ScanRecord* slots, int num_slots, pid_t pid)
+{
+    int mask = num_slots - 1;
+    int pos = hash_pid(pid, mask);
+
+    while (slots[pos].pid != 0 && slots[pos].pid != pid) {
+        pos = (pos + 1) & mask;
+    }
+
+    return pos;
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * scan_history_find - Look up the record of a PID
+ * @history: History to search
+ * @pid: Process ID
+ * @return: Record, or NULL if the PID was not recorded
+ */
+const ScanRecord* scan_history_find(const ScanHistory* history, pid_t pid)
+{
+    if (history == NULL || history->count == 0 || pid <= 0) {
+        return NULL;
+    }
+
+    const ScanRecord* record = &history->slots[find_slot(history->slots,
+                                                         history->num_slots, pid)];
+    return record->pid == pid ? record : NULL;
+}
+
+/*
+ * scan_record_unchanged - Decide whether a record can replace a re-read
+ * @record: Record from the previous scan (may be NULL)
+ * @fingerprint: Fingerprint read in this scan
+ * @return: 1 if the earlier collection can be reused, 0 otherwise
+ * Description: A running process may change its FDs without a context
+ *              switch being counted yet, so 'R' always forces a re-read.
+ *              Another thread may change the shared FD table while the
+ *              main thread's counters stand still, so multithreaded
+ *              processes are always re-read as well.
+ */
+int scan_record_unchanged(const ScanRecord* record, const ProcessFingerprint* fingerprint)
+{
+    if (record == NULL || fingerprint == NULL) {
+        return 0;
+    }
+
+    if (!record->reusable || record->participant || fingerprint->state == 'R' ||
+        fingerprint->num_threads != 1) {
+        return 0;
+    }
+
+    const ProcessFingerprint* old = &record->fingerprint;
+    return old->state == fingerprint->state &&
+           old->start_time == fingerprint->start_time &&
+           old->voluntary_ctxt == fingerprint->voluntary_ctxt &&
+           old->nonvoluntary_ctxt == fingerprint->nonvoluntary_ctxt;
+}
+
+/*
+ * scan_history_forget - Stop a PID's record from standing in for a re-read
+ * @history: History holding the record
+ * @pid: Process ID
+ * @return: None
+ */
+void scan_history_forget(ScanHistory* history, pid_t pid)
+{
+    if (history == NULL || history->count == 0 || pid <= 0) {
+        return;
+    }
+
+    ScanRecord* record = &history->slots[find_slot(history->slots, history->num_slots, pid)];
+    if (record->pid == pid) {
+        record->reusable = 0;
+    }
+}
+
+/*
+ * scan_history_commit - Replace the history with the records of a scan
+ * @history: History to rebuild
+ * @records: Records of the finished scan
+ * @num_records: Number of records
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ * Description: The table is kept at most half full.
+ * Error handling: Empties the history if the spare table cannot grow
+ */
+int scan_history_commit(ScanHistory* history, const ScanRecord* records, int num_records)
+{
+    if (history == NULL || (records == NULL && num_records > 0) || num_records < 0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    int num_slots = 16;
+    while (num_slots < num_records * 2) {
+        num_slots *= 2;
+    }
+
+    if (num_slots > history->spare_slots) {
+        ScanRecord* grown = (ScanRecord*)safe_realloc(history->spare,
+                                                      sizeof(ScanRecord) * num_slots);
+        if (grown == NULL) {
+            history->count = 0;
+            return ERROR_OUT_OF_MEMORY;
+        }
+        history->spare = grown;
+        history->spare_slots = num_slots;
+    }
+
+    ScanRecord* slots = history->spare;
+    memset(slots, 0, sizeof(ScanRecord) * num_slots);
+
+    int count = 0;
+    for (int i = 0; i < num_records; i++) {
+        if (records[i].pid <= 0) {
+            continue;
+        }
+        ScanRecord* slot = &slots[find_slot(slots, num_slots, records[i].pid)];
+        if (slot->pid == 0) {
+            count++;
+        }
+        *slot = records[i];
+    }
+
+    /* Swap tables; the old one becomes the next spare */
+    history->spare = history->slots;
+    history->spare_slots = history->num_slots;
+    history->slots = slots;
+    history->num_slots = num_slots;
+    history->count = count;
+    return SUCCESS;
+}
+
+/* =============================================================================
+ * CLEANUP FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * free_scan_history - Free all memory owned by a history
+ * @history: History to clean up
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void free_scan_history(ScanHistory* history)
+{
+    if (history == NULL) {
+        return;
+    }
+
+    safe_free((void**)&history->slots);
+    safe_free((void**)&history->spare);
+    history->num_slots = 0;
+    history->spare_slots = 0;
+    history->count = 0;
+}
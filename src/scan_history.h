@@ -0,0 +1,127 @@
+#ifndef SCAN_HISTORY_H
+#define SCAN_HISTORY_H
+
+/* =============================================================================
+ * SCAN_HISTORY.H - Per-Process Scan History Interface
+ * =============================================================================
+ * This header defines the records an incremental scan keeps about every
+ * process it collected: a cheap fingerprint of the process's scheduling
+ * state, where its FD table was left, and whether it took part in the
+ * resource graph. The next scan compares a fresh fingerprint against the
+ * record and reuses the earlier collection when nothing has changed.
+ * =============================================================================
+ */
+
+#include <sys/types.h>
+#include "config.h"
+#include "proc_handle.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * ProcessFingerprint - Values that change whenever a process runs
+ * A process whose fingerprint is unchanged has not been scheduled since the
+ * last scan, so its wait channel and FD table are unchanged as well. The
+ * counters are the main thread's only, while the FD table is shared by all
+ * threads, so this holds for single-threaded processes alone.
+ */
+typedef struct {
+    char state;                     /* Field 3 of /proc/[PID]/stat */
+    unsigned long long start_time;  /* Field 22 of /proc/[PID]/stat */
+    unsigned long voluntary_ctxt;   /* voluntary_ctxt_switches from status */
+    unsigned long nonvoluntary_ctxt; /* nonvoluntary_ctxt_switches from status */
+    int num_threads;                /* Threads from status */
+} ProcessFingerprint;
+
+/*
+ * ScanRecord - What one scan learned about one process
+ */
+typedef struct {
+    pid_t pid;                      /* Process ID (0 = empty / not recorded) */
+    ProcessFingerprint fingerprint; /* Fingerprint at collection time */
+    int slot;                       /* FD table slot in the recording scan (-1 = no table) */
+    int reusable;                   /* 1 if the collected data can stand in for a re-read */
+    int participant;                /* 1 if the process had graph edges in that scan */
+    WaitSyscall wait;               /* Decoded blocking syscall at collection time */
+    char wchan[SCAN_RECORD_WCHAN_LEN]; /* Wait channel at collection time */
+} ScanRecord;
+
+/*
+ * ScanHistory - PID-keyed records of the previous scan
+ * Open-addressing hash (power-of-two size, linear probing), rebuilt by every
+ * commit into the spare table so steady-state scans allocate nothing.
+ */
+typedef struct {
+    ScanRecord* slots;              /* Current table */
+    ScanRecord* spare;              /* Table the next commit rebuilds into */
+    int num_slots;                  /* Size of slots */
+    int spare_slots;                /* Size of spare */
+    int count;                      /* Number of records */
+} ScanHistory;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * scan_history_find - Look up the record of a PID
+ * @history: History to search (zero-initialized history is empty)
+ * @pid: Process ID
+ * @return: Record, or NULL if the PID was not recorded
+ * Description: Read-only; safe to call from several collectors at once.
+ *              Time complexity: O(1) expected
+ * Error handling: Returns NULL for NULL or empty history
+ */
+const ScanRecord* scan_history_find(const ScanHistory* history, pid_t pid);
+
+/*
+ * scan_record_unchanged - Decide whether a record can replace a re-read
+ * @record: Record from the previous scan (may be NULL)
+ * @fingerprint: Fingerprint read in this scan
+ * @return: 1 if the earlier collection can be reused, 0 otherwise
+ * Description: Requires a reusable record of a single-threaded process
+ *              that was not a graph participant, is not running, and whose
+ *              fingerprint matches exactly.
+ *              Time complexity: O(1)
+ */
+int scan_record_unchanged(const ScanRecord* record, const ProcessFingerprint* fingerprint);
+
+/*
+ * scan_history_forget - Stop a PID's record from standing in for a re-read
+ * @history: History holding the record
+ * @pid: Process ID
+ * @return: None
+ * Description: For processes known to have changed without it showing in
+ *              their fingerprint yet, e.g. reported by an exec event.
+ *              Time complexity: O(1) expected
+ * Error handling: Ignores NULL history and unrecorded PIDs
+ */
+void scan_history_forget(ScanHistory* history, pid_t pid);
+
+/*
+ * scan_history_commit - Replace the history with the records of a scan
+ * @history: History to rebuild
+ * @records: Records of the finished scan (entries with pid 0 are skipped)
+ * @num_records: Number of records
+ * @return: SUCCESS (0) on success, ERROR_OUT_OF_MEMORY on failure
+ * Description: Builds the new table in the spare array and swaps the two.
+ *              Time complexity: O(n) expected
+ * Error handling: On allocation failure the history is emptied, so the
+ *                 next scan simply collects everything
+ */
+int scan_history_commit(ScanHistory* history, const ScanRecord* records, int num_records);
+
+/*
+ * free_scan_history - Free all memory owned by a history
+ * @history: History to clean up
+ * @return: None
+ * Description: Frees both tables. Does not free the history itself.
+ * Error handling: Handles NULL pointer safely
+ */
+void free_scan_history(ScanHistory* history);
+
+#endif /* SCAN_HISTORY_H */
@@ -0,0 +1,121 @@
+/* =============================================================================
+ * SCAN_SCHEDULE.C - Continuous Monitoring Scheduler Implementation
+ * =============================================================================
+ * Back-off / tighten delay policy plus scan overhead and detection latency.
+ * =============================================================================
+ */
+
+#include "scan_schedule.h"
+#include "config.h"
+#include <string.h>
+#include <time.h>
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * scan_clock_ms - Read the monotonic clock
+ * @return: Milliseconds since an arbitrary fixed point
+ */
+double scan_clock_ms(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec * 1000.0 + (double)now.tv_nsec / 1000000.0;
+}
+
+/*
+ * scan_schedule_init - Set up a schedule
+ * @schedule: Schedule to initialize
+ * @floor_ms: Shortest delay between scans
+ * @ceiling_ms: Longest delay between scans
+ * @ramp: Back-off factor per quiet scan
+ * @initial_ms: Starting delay
+ * @return: SUCCESS (0) on success, ERROR_INVALID_ARGUMENT for bad bounds
+ */
+int scan_schedule_init(ScanSchedule* schedule, long floor_ms, long ceiling_ms,
+                       double ramp, long initial_ms)
+{
+    if (schedule == NULL || floor_ms <= 0 || ceiling_ms < floor_ms || ramp < 1.0) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    memset(schedule, 0, sizeof(*schedule));
+    schedule->floor_ms = floor_ms;
+    schedule->ceiling_ms = ceiling_ms;
+    schedule->ramp = ramp;
+    schedule->delay_ms = initial_ms < floor_ms ? floor_ms :
+                         initial_ms > ceiling_ms ? ceiling_ms : initial_ms;
+    schedule->started_ms = scan_clock_ms();
+    schedule->last_clear_ms = -1.0;
+    schedule->last_latency_ms = -1.0;
+    schedule->worst_latency_ms = -1.0;
+    return SUCCESS;
+}
+
+/*
+ * scan_schedule_update - Record a scan and choose the next delay
+ * @schedule: Schedule to update
+ * @outcome: What the scan saw
+ * @return: Delay before the next scan in milliseconds
+ */
+long scan_schedule_update(ScanSchedule* schedule, const ScanOutcome* outcome)
+{
+    if (schedule == NULL) {
+        return 0;
+    }
+    if (outcome == NULL) {
+        return schedule->delay_ms;
+    }
+
+    schedule->num_scans++;
+    schedule->last_scan_ms = outcome->end_ms - outcome->start_ms;
+    schedule->total_scan_ms += schedule->last_scan_ms;
+
+    /* Detection latency: the cycle formed after the last scan without edges */
+    int was_deadlocked = schedule->in_deadlock;
+    if (outcome->deadlock && !was_deadlocked && schedule->last_clear_ms >= 0.0) {
+        schedule->last_latency_ms = outcome->end_ms - schedule->last_clear_ms;
+        if (schedule->last_latency_ms > schedule->worst_latency_ms) {
+            schedule->worst_latency_ms = schedule->last_latency_ms;
+        }
+    }
+    schedule->in_deadlock = outcome->deadlock;
+    if (outcome->num_waiting == 0 && !outcome->deadlock) {
+        schedule->last_clear_ms = outcome->start_ms;
+    }
+
+    /* Only growth counts: a stable pipeline or an already reported deadlock
+     * would otherwise pin the schedule to the floor */
+    int pressure = (outcome->deadlock && !was_deadlocked) ||
+                   outcome->num_waiting > schedule->last_waiting ||
+                   outcome->num_blocked > schedule->last_blocked;
+    schedule->last_blocked = outcome->num_blocked;
+    schedule->last_waiting = outcome->num_waiting;
+
+    if (pressure) {
+        schedule->delay_ms = schedule->floor_ms;
+    } else {
+        double next = (double)schedule->delay_ms * schedule->ramp;
+        schedule->delay_ms = next >= (double)schedule->ceiling_ms ? schedule->ceiling_ms :
+                                                                    (long)next;
+    }
+
+    return schedule->delay_ms;
+}
+
+/*
+ * scan_schedule_overhead - Fraction of wall time spent scanning
+ * @schedule: Schedule with recorded scans
+ * @now_ms: Current monotonic time
+ * @return: Scan time divided by elapsed time
+ */
+double scan_schedule_overhead(const ScanSchedule* schedule, double now_ms)
+{
+    if (schedule == NULL || now_ms <= schedule->started_ms) {
+        return 0.0;
+    }
+    return schedule->total_scan_ms / (now_ms - schedule->started_ms);
+}
@@ -0,0 +1,105 @@
+#ifndef SCAN_SCHEDULE_H
+#define SCAN_SCHEDULE_H
+
+/* =============================================================================
+ * SCAN_SCHEDULE.H - Continuous Monitoring Scheduler Interface
+ * =============================================================================
+ * This header defines the scheduler that picks the delay before the next
+ * scan from what the last one found. While nothing is blocked the delay
+ * backs off geometrically towards a ceiling; new blocked candidates, new
+ * wait edges between processes (a cycle in the making) or a new deadlock
+ * bring it straight down to the floor. The scheduler also keeps the two
+ * numbers that trade off against each other: how much time goes into
+ * scanning, and how late a deadlock can be reported after it formed.
+ * =============================================================================
+ */
+
+#include "config.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * ScanOutcome - What one scan saw, as far as scheduling is concerned
+ */
+typedef struct {
+    double start_ms;                /* Monotonic time the scan started */
+    double end_ms;                  /* Monotonic time the scan finished */
+    int num_blocked;                /* Processes triaged as blocked on a pipe, lock or child */
+    int num_waiting;                /* Processes with a wait edge to another process */
+    int deadlock;                   /* 1 if the scan reported a deadlock */
+} ScanOutcome;
+
+/*
+ * ScanSchedule - Delay policy and overhead / latency statistics
+ * With floor_ms == ceiling_ms the delay is fixed (plain -i monitoring).
+ */
+typedef struct {
+    long floor_ms;                  /* Shortest delay between scans */
+    long ceiling_ms;                /* Longest delay between scans */
+    double ramp;                    /* Back-off factor per quiet scan (>= 1) */
+    long delay_ms;                  /* Delay chosen after the last scan */
+    int last_blocked;               /* num_blocked of the last scan */
+    int last_waiting;               /* num_waiting of the last scan */
+    double started_ms;              /* Monotonic time the schedule was set up */
+    unsigned long num_scans;        /* Scans recorded */
+    double total_scan_ms;           /* Time spent scanning */
+    double last_scan_ms;            /* Duration of the last scan */
+    double last_clear_ms;           /* Start of the last scan without wait edges (< 0 = none) */
+    int in_deadlock;                /* 1 while consecutive scans report a deadlock */
+    double last_latency_ms;         /* Detection latency bound of the last new deadlock (< 0 = none) */
+    double worst_latency_ms;        /* Largest detection latency bound seen (< 0 = none) */
+} ScanSchedule;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * scan_clock_ms - Read the monotonic clock
+ * @return: Milliseconds since an arbitrary fixed point
+ */
+double scan_clock_ms(void);
+
+/*
+ * scan_schedule_init - Set up a schedule
+ * @schedule: Schedule to initialize
+ * @floor_ms: Shortest delay between scans
+ * @ceiling_ms: Longest delay between scans (>= floor_ms)
+ * @ramp: Factor the delay grows by per quiet scan (>= 1)
+ * @initial_ms: Delay to start from, clamped into [floor_ms, ceiling_ms]
+ * @return: SUCCESS (0) on success, ERROR_INVALID_ARGUMENT for bad bounds
+ */
+int scan_schedule_init(ScanSchedule* schedule, long floor_ms, long ceiling_ms,
+                       double ramp, long initial_ms);
+
+/*
+ * scan_schedule_update - Record a scan and choose the next delay
+ * @schedule: Schedule to update
+ * @outcome: What the scan saw
+ * @return: Delay before the next scan in milliseconds
+ * Description: A new deadlock, or more blocked processes or wait edges than
+ *              in the previous scan, drop the delay to the floor; any other
+ *              scan multiplies it by the ramp, up to the ceiling, so stable
+ *              pipelines and deadlocks already reported do not keep the
+ *              scan rate up. The first scan reporting a deadlock also
+ *              records how long it can have gone unseen: from the start of
+ *              the last scan without wait edges (the cycle formed after
+ *              that) to the end of the reporting scan.
+ *              Time complexity: O(1)
+ * Error handling: Returns the current delay for NULL arguments
+ */
+long scan_schedule_update(ScanSchedule* schedule, const ScanOutcome* outcome);
+
+/*
+ * scan_schedule_overhead - Fraction of wall time spent scanning
+ * @schedule: Schedule with recorded scans
+ * @now_ms: Current monotonic time
+ * @return: Scan time divided by time since scan_schedule_init (0 if none)
+ */
+double scan_schedule_overhead(const ScanSchedule* schedule, double now_ms);
+
+#endif /* SCAN_SCHEDULE_H */
@@ -13,6 +13,7 @@
 #include <errno.h>
 #include <unistd.h>
 #include <ctype.h>
+#include <fcntl.h>
 
 /* =============================================================================
  * MEMORY MANAGEMENT FUNCTIONS
@@ -79,6 +80,182 @@ void safe_free(void** ptr)
     }
 }
 
+/* =============================================================================
+ * ARENA ALLOCATOR
+ * =============================================================================
+ */
+
+/* Chunk header size rounded up so chunk data starts aligned */
+#define ARENA_HEADER_SIZE \
+    ((sizeof(ArenaChunk) + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1))
+
+/*
+ * arena_new_chunk - Allocate a chunk with the given usable size
+ * @size: Usable bytes
+ * @return: Chunk, or NULL on allocation failure
+ */
+static ArenaChunk* arena_new_chunk(size_t size)
+{
+    if (size > (size_t)-1 - ARENA_HEADER_SIZE) {
+        return NULL;
+    }
+    
+    ArenaChunk* chunk = (ArenaChunk*)safe_malloc(ARENA_HEADER_SIZE + size);
+    if (chunk == NULL) {
+        return NULL;
+    }
+    
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    return chunk;
+}
+
+/*
+ * arena_create - Create an empty arena
+ * @chunk_size: Usable bytes per chunk (0 selects ARENA_CHUNK_SIZE)
+ * @return: Pointer to arena, or NULL on allocation failure
+ * Description: Chunks are allocated lazily by arena_alloc().
+ * Error handling: Returns NULL if allocation fails
+ */
+Arena* arena_create(size_t chunk_size)
+{
+    Arena* arena = (Arena*)safe_malloc(sizeof(Arena));
+    if (arena == NULL) {
+        return NULL;
+    }
+    
+    arena->first = NULL;
+    arena->current = NULL;
+    arena->chunk_size = chunk_size == 0 ? ARENA_CHUNK_SIZE : chunk_size;
+    arena->bytes_used = 0;
+    return arena;
+}
+
+/*
+ * arena_alloc - Allocate memory from an arena
+ * @arena: Arena to allocate from (NULL allocates with safe_malloc)
+ * @size: Number of bytes to allocate
+ * @return: Pointer aligned to ARENA_ALIGNMENT, or NULL on failure
+ * Description: Tries the current chunk, then the chunks kept from earlier
+ *              scans after it. Only when none has room is a new chunk
+ *              linked in right after the current one, so kept chunks stay
+ *              reachable. Space left at the end of a skipped chunk is
+ *              reclaimed on the next reset.
+ * Error handling: Returns NULL if size overflows or a chunk cannot be allocated
+ */
+void* arena_alloc(Arena* arena, size_t size)
+{
+    if (arena == NULL) {
+        return safe_malloc(size);
+    }
+    
+    size_t rounded = (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+    if (rounded < size) {
+        return NULL;
+    }
+    if (rounded == 0) {
+        rounded = ARENA_ALIGNMENT;
+    }
+    
+    ArenaChunk* chunk = arena->current;
+    while (chunk != NULL && chunk->size - chunk->used < rounded) {
+        chunk = chunk->next;
+    }
+    
+    if (chunk == NULL) {
+        chunk = arena_new_chunk(rounded > arena->chunk_size ? rounded : arena->chunk_size);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        
+        if (arena->current == NULL) {
+            chunk->next = arena->first;
+            arena->first = chunk;
+        } else {
+            chunk->next = arena->current->next;
+            arena->current->next = chunk;
+        }
+    }
+    
+    arena->current = chunk;
+    void* ptr = (char*)chunk + ARENA_HEADER_SIZE + chunk->used;
+    chunk->used += rounded;
+    arena->bytes_used += rounded;
+    return ptr;
+}
+
+/*
+ * arena_strdup - Duplicate a string into an arena
+ * @arena: Arena to allocate from (NULL duplicates with str_dup)
+ * @str: String to duplicate
+ * @return: Copy of the string, or NULL on failure
+ * Description: Time complexity: O(n)
+ * Error handling: Returns NULL if str is NULL or allocation fails
+ */
+char* arena_strdup(Arena* arena, const char* str)
+{
+    if (str == NULL) {
+        return NULL;
+    }
+    
+    if (arena == NULL) {
+        return str_dup(str);
+    }
+    
+    size_t len = strlen(str) + 1;
+    char* copy = (char*)arena_alloc(arena, len);
+    if (copy == NULL) {
+        return NULL;
+    }
+    
+    memcpy(copy, str, len);
+    return copy;
+}
+
+/*
+ * arena_reset - Release every allocation of an arena at once
+ * @arena: Arena to reset
+ * @return: None
+ * Description: Rewinds every chunk and restarts from the first one.
+ * Error handling: Handles NULL pointer safely
+ */
+void arena_reset(Arena* arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+    
+    for (ArenaChunk* chunk = arena->first; chunk != NULL; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+    
+    arena->current = arena->first;
+    arena->bytes_used = 0;
+}
+
+/*
+ * arena_destroy - Free an arena and all its chunks
+ * @arena: Arena to destroy
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void arena_destroy(Arena* arena)
+{
+    if (arena == NULL) {
+        return;
+    }
+    
+    ArenaChunk* chunk = arena->first;
+    while (chunk != NULL) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+    
+    free(arena);
+}
+
 /* =============================================================================
  * STRING UTILITY FUNCTIONS
  * =============================================================================
@@ -509,6 +686,149 @@ char* read_proc_file_safe(int pid, const char* filename)
     return buffer;
 }
 
+/* One reusable read buffer per thread */
+static __thread ReadBuffer s_thread_read_buffer;
+
+/*
+ * read_fd_into - Read an open file descriptor into a reusable buffer
+ * @fd: Open file descriptor positioned at the start (not closed)
+ * @buffer: Buffer to read into; grows only when a file does not fit
+ * @len: Output parameter for content length (may be NULL)
+ * @return: NUL-terminated content inside buffer, or NULL on error (errno set)
+ * Description: Reads straight into the buffer until read() returns 0. A
+ *              short read is not treated as end of file: seq_file-backed
+ *              /proc files stop at record boundaries (smaps, maps, locks),
+ *              so a small file costs one data read plus one empty read.
+ *              The buffer is doubled only when a read leaves it full.
+ * Error handling: Returns NULL on failure with errno from read, or ENOMEM
+ *                 if the buffer cannot grow
+ */
+char* read_fd_into(int fd, ReadBuffer* buffer, size_t* len)
+{
+    if (fd < 0 || buffer == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+    
+    if (buffer->data == NULL) {
+        buffer->data = (char*)safe_malloc(PROC_READ_BUFFER_SIZE);
+        if (buffer->data == NULL) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        buffer->capacity = PROC_READ_BUFFER_SIZE;
+    }
+    
+    size_t used = 0;
+    for (;;) {
+        size_t space = buffer->capacity - 1 - used;
+        ssize_t n = read(fd, buffer->data + used, space);
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            return NULL;
+        }
+        
+        if (n == 0) {
+            break; /* End of file */
+        }
+        
+        used += (size_t)n;
+        if ((size_t)n < space) {
+            continue;
+        }
+        
+        /* Buffer filled; grow and keep reading */
+        char* grown = (char*)safe_realloc(buffer->data, buffer->capacity * 2);
+        if (grown == NULL) {
+            errno = ENOMEM;
+            return NULL;
+        }
+        buffer->data = grown;
+        buffer->capacity *= 2;
+    }
+    
+    buffer->data[used] = '\0';
+    if (len != NULL) {
+        *len = used;
+    }
+    return buffer->data;
+}
+
+/*
+ * read_proc_file_into - Read a /proc file into a reusable buffer
+ * @pid: Process ID (0 for system-wide files)
+ * @filename: Name of file in /proc or /proc/[PID]/
+ * @buffer: Buffer to read into; grows only when a file does not fit
+ * @len: Output parameter for content length (may be NULL)
+ * @return: NUL-terminated content inside buffer, or NULL on error (errno set)
+ * Description: Formats the path, opens it and hands the descriptor to
+ *              read_fd_into(). Per-process collectors that read several
+ *              files of one process use a ProcHandle instead.
+ * Error handling: Returns NULL on failure with errno from open/read, or
+ *                 ENOMEM if the buffer cannot grow
+ */
+char* read_proc_file_into(int pid, const char* filename, ReadBuffer* buffer, size_t* len)
+{
+    if (filename == NULL || buffer == NULL) {
+        errno = EINVAL;
+        return NULL;
+    }
+    
+    char path[MAX_PATH_LEN];
+    int result;
+    
+    if (pid > 0) {
+        result = snprintf(path, sizeof(path), "%s/%d/%s",
+                          PROC_BASE_PATH, pid, filename);
+    } else {
+        result = snprintf(path, sizeof(path), "%s/%s",
+                          PROC_BASE_PATH, filename);
+    }
+    
+    if (result < 0 || (size_t)result >= sizeof(path)) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return NULL;
+    }
+    
+    char* content = read_fd_into(fd, buffer, len);
+    int saved_errno = errno;
+    close(fd);
+    errno = saved_errno;
+    return content;
+}
+
+/*
+ * thread_read_buffer - Get the calling thread's reusable read buffer
+ * @return: Pointer to a thread-local ReadBuffer (never NULL)
+ */
+ReadBuffer* thread_read_buffer(void)
+{
+    return &s_thread_read_buffer;
+}
+
+/*
+ * free_read_buffer - Free the storage of a read buffer
+ * @buffer: Buffer to release (left empty and reusable)
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void free_read_buffer(ReadBuffer* buffer)
+{
+    if (buffer == NULL) {
+        return;
+    }
+    
+    safe_free((void**)&buffer->data);
+    buffer->capacity = 0;
+}
+
 /* =============================================================================
  * ERROR HANDLING FUNCTIONS
  * =============================================================================
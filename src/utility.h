@@ -69,6 +69,87 @@ void* safe_realloc(void* ptr, size_t size);
  */
 void safe_free(void** ptr);
 
+/* =============================================================================
+ * ARENA ALLOCATOR
+ * =============================================================================
+ * A scan-scoped bump allocator. Per-scan data is carved out of large chained
+ * chunks and released all at once with arena_reset(), which keeps the chunks
+ * for the next scan. Functions that take an Arena* fall back to the heap when
+ * it is NULL, so the same code serves arena-backed and standalone callers.
+ */
+
+/*
+ * ArenaChunk - One block of arena memory; data follows the header
+ */
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;        /* Next chunk in the chain */
+    size_t size;                    /* Usable bytes after the header */
+    size_t used;                    /* Bytes handed out since last reset */
+} ArenaChunk;
+
+/*
+ * Arena - Chain of chunks with a bump pointer in the current chunk
+ * Not thread-safe; give each worker thread its own arena.
+ */
+typedef struct {
+    ArenaChunk* first;              /* Head of the chunk chain */
+    ArenaChunk* current;            /* Chunk allocations are taken from */
+    size_t chunk_size;              /* Usable size of regular chunks */
+    size_t bytes_used;              /* Bytes handed out since last reset */
+} Arena;
+
+/*
+ * arena_create - Create an empty arena
+ * @chunk_size: Usable bytes per chunk (0 selects ARENA_CHUNK_SIZE)
+ * @return: Pointer to arena, or NULL on allocation failure
+ * Description: No chunk is allocated until the first arena_alloc().
+ * Error handling: Returns NULL if allocation fails
+ */
+Arena* arena_create(size_t chunk_size);
+
+/*
+ * arena_alloc - Allocate memory from an arena
+ * @arena: Arena to allocate from (NULL allocates with safe_malloc)
+ * @size: Number of bytes to allocate
+ * @return: Pointer aligned to ARENA_ALIGNMENT, or NULL on failure
+ * Description: Bumps the pointer of the current chunk, moving on to the next
+ *              chunk in the chain (or appending a new one) when it is full.
+ *              Requests larger than a chunk get a dedicated chunk.
+ *              Memory is released by arena_reset(), never individually.
+ *              Time complexity: O(1) amortized
+ * Error handling: Returns NULL if a new chunk cannot be allocated
+ */
+void* arena_alloc(Arena* arena, size_t size);
+
+/*
+ * arena_strdup - Duplicate a string into an arena
+ * @arena: Arena to allocate from (NULL duplicates with str_dup)
+ * @str: String to duplicate
+ * @return: Copy of the string, or NULL on failure
+ * Description: Time complexity: O(n)
+ * Error handling: Returns NULL if str is NULL or allocation fails
+ */
+char* arena_strdup(Arena* arena, const char* str);
+
+/*
+ * arena_reset - Release every allocation of an arena at once
+ * @arena: Arena to reset
+ * @return: None
+ * Description: Rewinds all chunks but keeps them, so a scan of the same size
+ *              as the previous one allocates nothing from the heap.
+ *              Time complexity: O(chunks)
+ * Error handling: Handles NULL pointer safely
+ */
+void arena_reset(Arena* arena);
+
+/*
+ * arena_destroy - Free an arena and all its chunks
+ * @arena: Arena to destroy
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void arena_destroy(Arena* arena);
+
 /* =============================================================================
  * STRING UTILITY FUNCTIONS
  * =============================================================================
@@ -167,6 +248,62 @@ char* read_entire_file(const char* path);
  */
 char* read_proc_file_safe(int pid, const char* filename);
 
+/*
+ * ReadBuffer - Reusable buffer for single-read /proc file views
+ */
+typedef struct {
+    char* data;                     /* Buffer storage */
+    size_t capacity;                /* Allocated bytes */
+} ReadBuffer;
+
+/*
+ * read_fd_into - Read an open file descriptor into a reusable buffer
+ * @fd: Open file descriptor positioned at the start (not closed)
+ * @buffer: Buffer to read into; grows only when a file does not fit
+ * @len: Output parameter for content length (may be NULL)
+ * @return: NUL-terminated content inside buffer, or NULL on error (errno set)
+ * Description: The read loop shared by read_proc_file_into() and
+ *              proc_handle_read(). Same view semantics as
+ *              read_proc_file_into().
+ *              Time complexity: O(file_size)
+ * Error handling: Returns NULL on read failure or if the buffer cannot grow
+ */
+char* read_fd_into(int fd, ReadBuffer* buffer, size_t* len);
+
+/*
+ * read_proc_file_into - Read a /proc file into a reusable buffer
+ * @pid: Process ID (0 for system-wide files)
+ * @filename: Name of file in /proc or /proc/[PID]/
+ * @buffer: Buffer to read into; grows only when a file does not fit
+ * @len: Output parameter for content length (may be NULL)
+ * @return: NUL-terminated content inside buffer, or NULL on error (errno set)
+ * Description: open() and read() straight into the buffer, with no stdio
+ *              layer, no allocation and no copy. The view stays valid until
+ *              the next read into the same buffer; callers may modify it
+ *              but must not free it.
+ *              Time complexity: O(file_size)
+ * Error handling: Returns NULL on open/read failure or if the buffer cannot
+ *                 grow; ENOENT and EACCES are left in errno for the caller
+ */
+char* read_proc_file_into(int pid, const char* filename, ReadBuffer* buffer, size_t* len);
+
+/*
+ * thread_read_buffer - Get the calling thread's reusable read buffer
+ * @return: Pointer to a thread-local ReadBuffer (never NULL)
+ * Description: Each thread gets its own buffer, so collectors on different
+ *              workers never share one. Release it with free_read_buffer()
+ *              before the thread exits.
+ */
+ReadBuffer* thread_read_buffer(void);
+
+/*
+ * free_read_buffer - Free the storage of a read buffer
+ * @buffer: Buffer to release (left empty and reusable)
+ * @return: None
+ * Error handling: Handles NULL pointer safely
+ */
+void free_read_buffer(ReadBuffer* buffer);
+
 /* =============================================================================
  * ERROR HANDLING FUNCTIONS
  * =============================================================================
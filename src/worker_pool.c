@@ -0,0 +1,216 @@
+/* =============================================================================
+ * WORKER_POOL.C - Fixed Worker Thread Pool Implementation
+ * =============================================================================
+ * Pool threads wait on a condition variable for a new run generation, run the
+ * task once, and report back. The calling thread takes part as worker 0.
+ * =============================================================================
+ */
+
+#include "worker_pool.h"
+#include "utility.h"
+#include "proc_uring.h"
+#include "config.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+/* =============================================================================
+ * HELPER FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * WorkerStart - Start arguments of one pool thread
+ */
+typedef struct {
+    WorkerPool* pool;               /* Owning pool */
+    int worker_id;                  /* Worker ID passed to tasks */
+} WorkerStart;
+
+/*
+ * worker_main - Main loop of a pool thread
+ * @arg: Heap-allocated WorkerStart (freed by the thread)
+ * @return: NULL
+ */
+static void* worker_main(void* arg)
+{
+    WorkerStart start = *(WorkerStart*)arg;
+    free(arg);
+
+    WorkerPool* pool = start.pool;
+    unsigned long seen_generation = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen_generation) {
+            pthread_cond_wait(&pool->work_ready, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+
+        seen_generation = pool->generation;
+        WorkerTaskFn task = pool->task;
+        void* context = pool->context;
+        pthread_mutex_unlock(&pool->mutex);
+
+        task(context, start.worker_id);
+
+        pthread_mutex_lock(&pool->mutex);
+        if (--pool->pending == 0) {
+            pthread_cond_signal(&pool->work_done);
+        }
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    /* Tasks may have grown this thread's /proc read buffer or set up a ring */
+    free_read_buffer(thread_read_buffer());
+    release_thread_proc_uring();
+
+    return NULL;
+}
+
+/*
+ * stop_threads - Signal shutdown and join the first count threads
+ * @pool: Pool whose threads to stop
+ * @count: Number of started threads
+ * @return: None
+ */
+static void stop_threads(WorkerPool* pool, int count)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->shutdown = 1;
+    pthread_cond_broadcast(&pool->work_ready);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < count; i++) {
+        pthread_join(pool->threads[i], NULL);
+    }
+}
+
+/* =============================================================================
+ * MAIN FUNCTIONS
+ * =============================================================================
+ */
+
+/*
+ * worker_pool_create - Create a pool with a fixed number of participants
+ * @num_threads: Total participants per run including the calling thread
+ * @return: Pointer to pool, or NULL on failure
+ * Description: Allocates the pool and starts num_threads - 1 pool threads.
+ * Error handling: Returns NULL on failure after cleaning up
+ */
+WorkerPool* worker_pool_create(int num_threads)
+{
+    if (num_threads < 1) {
+        error_log("worker_pool_create: invalid thread count %d", num_threads);
+        return NULL;
+    }
+
+    WorkerPool* pool = (WorkerPool*)safe_malloc(sizeof(WorkerPool));
+    if (pool == NULL) {
+        return NULL;
+    }
+
+    memset(pool, 0, sizeof(WorkerPool));
+    pool->num_threads = num_threads;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->work_ready, NULL);
+    pthread_cond_init(&pool->work_done, NULL);
+
+    if (num_threads > 1) {
+        pool->threads = (pthread_t*)safe_malloc(sizeof(pthread_t) * (num_threads - 1));
+        if (pool->threads == NULL) {
+            worker_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    for (int i = 0; i < num_threads - 1; i++) {
+        WorkerStart* start = (WorkerStart*)safe_malloc(sizeof(WorkerStart));
+        int rc = start == NULL ? ENOMEM : 0;
+        if (start != NULL) {
+            start->pool = pool;
+            start->worker_id = i + 1;
+            rc = pthread_create(&pool->threads[i], NULL, worker_main, start);
+            if (rc != 0) {
+                free(start);
+            }
+        }
+
+        if (rc != 0) {
+            error_log("Failed to start worker thread: %s", strerror(rc));
+            stop_threads(pool, i);
+            pool->num_threads = 1; /* Threads already joined */
+            worker_pool_destroy(pool);
+            return NULL;
+        }
+    }
+
+    return pool;
+}
+
+/*
+ * worker_pool_run - Run a task on every participant and wait for completion
+ * @pool: Pool to use
+ * @task: Task to execute
+ * @context: Context passed to every invocation
+ * @return: SUCCESS (0) on success, ERROR_INVALID_ARGUMENT for bad parameters
+ * Description: Publishes the task under the mutex, broadcasts, runs worker 0
+ *              on the calling thread, then waits for pending to reach zero.
+ *              The mutex hand-off makes all writes done by the task visible
+ *              to the caller after return.
+ * Error handling: Returns error code for NULL parameters
+ */
+int worker_pool_run(WorkerPool* pool, WorkerTaskFn task, void* context)
+{
+    if (pool == NULL || task == NULL) {
+        return ERROR_INVALID_ARGUMENT;
+    }
+
+    if (pool->num_threads > 1) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->task = task;
+        pool->context = context;
+        pool->pending = pool->num_threads - 1;
+        pool->generation++;
+        pthread_cond_broadcast(&pool->work_ready);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    task(context, 0);
+
+    if (pool->num_threads > 1) {
+        pthread_mutex_lock(&pool->mutex);
+        while (pool->pending > 0) {
+            pthread_cond_wait(&pool->work_done, &pool->mutex);
+        }
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return SUCCESS;
+}
+
+/*
+ * worker_pool_destroy - Stop and free a pool
+ * @pool: Pool to destroy
+ * @return: None
+ * Description: Joins all pool threads and releases synchronization objects.
+ * Error handling: Handles NULL pointer safely
+ */
+void worker_pool_destroy(WorkerPool* pool)
+{
+    if (pool == NULL) {
+        return;
+    }
+
+    if (pool->threads != NULL && pool->num_threads > 1) {
+        stop_threads(pool, pool->num_threads - 1);
+    }
+
+    pthread_cond_destroy(&pool->work_done);
+    pthread_cond_destroy(&pool->work_ready);
+    pthread_mutex_destroy(&pool->mutex);
+    safe_free((void**)&pool->threads);
+    free(pool);
+}
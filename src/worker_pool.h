@@ -0,0 +1,86 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/* =============================================================================
+ * WORKER_POOL.H - Fixed Worker Thread Pool Interface
+ * =============================================================================
+ * This header defines a small fixed-size pool of worker threads. The pool is
+ * created once and reused for every scan; each run executes the same task on
+ * every worker (and on the calling thread) and returns when all are done.
+ * Tasks split their own work, typically by claiming ranges from a shared
+ * atomic cursor.
+ * =============================================================================
+ */
+
+#include <pthread.h>
+#include "config.h"
+
+/* =============================================================================
+ * DATA STRUCTURES
+ * =============================================================================
+ */
+
+/*
+ * WorkerTaskFn - Task executed by every participant of a pool run
+ * @context: Caller-supplied task context
+ * @worker_id: 0 for the calling thread, 1..num_threads-1 for pool threads
+ */
+typedef void (*WorkerTaskFn)(void* context, int worker_id);
+
+/*
+ * WorkerPool - Fixed-size pool of worker threads
+ */
+typedef struct {
+    pthread_t* threads;             /* Pool threads (num_threads - 1 of them) */
+    int num_threads;                /* Participants per run, including caller */
+    pthread_mutex_t mutex;          /* Guards all fields below */
+    pthread_cond_t work_ready;      /* Signalled when a new run starts */
+    pthread_cond_t work_done;       /* Signalled when the last worker finishes */
+    WorkerTaskFn task;              /* Task of the current run */
+    void* context;                  /* Context of the current run */
+    unsigned long generation;       /* Incremented for every run */
+    int pending;                    /* Pool threads still running current task */
+    int shutdown;                   /* Set to stop pool threads */
+} WorkerPool;
+
+/* =============================================================================
+ * FUNCTION PROTOTYPES
+ * =============================================================================
+ */
+
+/*
+ * worker_pool_create - Create a pool with a fixed number of participants
+ * @num_threads: Total participants per run including the calling thread
+ *               (1 means no extra threads; work runs serially)
+ * @return: Pointer to pool, or NULL on failure
+ * Description: Starts num_threads - 1 threads that sleep until a run starts.
+ *              Time complexity: O(num_threads)
+ * Error handling: Returns NULL on invalid count, allocation failure or
+ *                 thread creation failure (already started threads are
+ *                 joined)
+ */
+WorkerPool* worker_pool_create(int num_threads);
+
+/*
+ * worker_pool_run - Run a task on every participant and wait for completion
+ * @pool: Pool to use
+ * @task: Task to execute
+ * @context: Context passed to every invocation
+ * @return: SUCCESS (0) on success, ERROR_INVALID_ARGUMENT for bad parameters
+ * Description: Wakes every pool thread, runs the task on the calling thread
+ *              as worker 0, then blocks until all pool threads have returned.
+ *              Runs must not be nested or issued concurrently.
+ * Error handling: Returns error code for NULL parameters
+ */
+int worker_pool_run(WorkerPool* pool, WorkerTaskFn task, void* context);
+
+/*
+ * worker_pool_destroy - Stop and free a pool
+ * @pool: Pool to destroy
+ * @return: None
+ * Description: Signals shutdown, joins all threads and frees the pool.
+ * Error handling: Handles NULL pointer safely
+ */
+void worker_pool_destroy(WorkerPool* pool);
+
+#endif /* WORKER_POOL_H */
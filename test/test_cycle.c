@@ -316,6 +316,174 @@ static void test_single_vertex(void)
     }
 }
 
+/*
+ * test_scc_engine - Test SCC engine reports each deadlocked set once
+ */
+static void test_scc_engine(void)
+{
+    printf("\n[TEST] SCC Engine\n");
+    printf("----------------------------------------\n");
+    
+    ResourceGraph* graph = create_graph(100);
+    TEST_ASSERT(graph != NULL, "Graph creation");
+    
+    if (graph != NULL) {
+        /* Component A: two cycles sharing P1 and P2
+         * P1 -> R1 -> P2 -> R2 -> P1 and P2 -> R3 -> P3 -> R4 -> P1 */
+        add_request_edge(graph, 1001, 1);
+        add_allocation_edge(graph, 1, 1002);
+        add_request_edge(graph, 1002, 2);
+        add_allocation_edge(graph, 2, 1001);
+        add_request_edge(graph, 1002, 3);
+        add_allocation_edge(graph, 3, 1003);
+        add_request_edge(graph, 1003, 4);
+        add_allocation_edge(graph, 4, 1001);
+        
+        /* Component B: P10 -> R10 -> P11 -> R11 -> P10 */
+        add_request_edge(graph, 1010, 10);
+        add_allocation_edge(graph, 10, 1011);
+        add_request_edge(graph, 1011, 11);
+        add_allocation_edge(graph, 11, 1010);
+        
+        /* Waiter outside any cycle */
+        add_request_edge(graph, 1020, 1);
+        
+        CycleInfo* cycles = NULL;
+        int num_cycles = 0;
+        int result = find_cycle_components(graph, &cycles, &num_cycles);
+        
+        TEST_ASSERT(result == SUCCESS, "SCC detection should succeed");
+        TEST_ASSERT(num_cycles == 2, "Should find exactly 2 deadlocked components");
+        
+        int total_processes = 0;
+        for (int i = 0; i < num_cycles; i++) {
+            TEST_ASSERT(validate_cycle(&cycles[i], graph), "Witness cycle should be valid");
+            total_processes += cycles[i].num_processes;
+            for (int j = 0; j < cycles[i].num_processes; j++) {
+                TEST_ASSERT(cycles[i].process_ids[j] != 1020,
+                           "Waiter outside cycle should not be reported");
+            }
+        }
+        TEST_ASSERT(total_processes == 5, "Components should cover all 5 deadlocked processes");
+        free_cycle_list(cycles, num_cycles);
+        
+        /* has_cycle() dispatches to the selected engine */
+        TEST_ASSERT(set_cycle_engine(CYCLE_ENGINE_SCC) == SUCCESS, "Select SCC engine");
+        TEST_ASSERT(set_cycle_engine(42) == ERROR_INVALID_ARGUMENT, "Reject unknown engine");
+        TEST_ASSERT(get_cycle_engine() == CYCLE_ENGINE_SCC, "Engine unchanged after bad value");
+        
+        cycles = NULL;
+        num_cycles = 0;
+        result = has_cycle(graph, &cycles, &num_cycles);
+        TEST_ASSERT(result == 1 && num_cycles == 2, "has_cycle should use SCC engine");
+        free_cycle_list(cycles, num_cycles);
+        set_cycle_engine(CYCLE_ENGINE_DFS);
+        
+        free_graph(graph);
+    }
+    
+    /* Acyclic graph yields no components */
+    graph = create_graph(10);
+    if (graph != NULL) {
+        add_request_edge(graph, 1001, 1);
+        add_allocation_edge(graph, 1, 1002);
+        
+        CycleInfo* cycles = NULL;
+        int num_cycles = 0;
+        int result = find_cycle_components(graph, &cycles, &num_cycles);
+        TEST_ASSERT(result == SUCCESS && num_cycles == 0, "Acyclic graph has no components");
+        free_cycle_list(cycles, num_cycles);
+        free_graph(graph);
+    }
+}
+
+/*
+ * test_deep_chain - Test DFS on a cycle spanning thousands of vertices
+ */
+static void test_deep_chain(void)
+{
+    printf("\n[TEST] Deep Chain Cycle\n");
+    printf("----------------------------------------\n");
+    
+    ResourceGraph* graph = create_graph(MAX_VERTICES);
+    TEST_ASSERT(graph != NULL, "Graph creation");
+    
+    if (graph != NULL) {
+        /* P0 -> R0 -> P1 -> R1 -> ... -> P(n-1) -> R(n-1) -> P0 */
+        const int chain = 7000;
+        for (int i = 0; i < chain; i++) {
+            add_request_edge(graph, 100000 + i, i + 1);
+            add_allocation_edge(graph, i + 1, 100000 + (i + 1) % chain);
+        }
+        
+        CycleInfo* cycles = NULL;
+        int num_cycles = 0;
+        int result = find_all_cycles(graph, &cycles, &num_cycles);
+        
+        TEST_ASSERT(result == SUCCESS, "Cycle detection should succeed");
+        TEST_ASSERT(num_cycles == 1, "Should find the single chain cycle");
+        if (num_cycles == 1) {
+            TEST_ASSERT(cycles[0].cycle_length == 2 * chain + 1,
+                       "Cycle should span the whole chain");
+            TEST_ASSERT(validate_cycle(&cycles[0], graph), "Cycle should be valid");
+        }
+        free_cycle_list(cycles, num_cycles);
+        
+        reset_graph_colors(graph);
+        CycleInfo single;
+        int found = 0;
+        result = dfs_visit(graph, 0, graph->color, graph->parent, &single, &found);
+        TEST_ASSERT(result == SUCCESS && found, "dfs_visit should find the chain cycle");
+        TEST_ASSERT(single.cycle_length == 2 * chain + 1, "dfs_visit cycle spans the chain");
+        free_cycle_info(&single);
+        
+        free_graph(graph);
+    }
+}
+
+/*
+ * test_repeated_scans - Test detection across scans without color resets
+ */
+static void test_repeated_scans(void)
+{
+    printf("\n[TEST] Repeated Scans Without Reset\n");
+    printf("----------------------------------------\n");
+    
+    ResourceGraph* graph = create_graph(2000);
+    TEST_ASSERT(graph != NULL, "Graph creation");
+    
+    if (graph != NULL) {
+        /* Many isolated processes plus one cycle at the end */
+        for (int i = 0; i < 1500; i++) {
+            add_process_vertex(graph, 5000 + i);
+        }
+        add_request_edge(graph, 1001, 1);
+        add_allocation_edge(graph, 1, 1002);
+        add_request_edge(graph, 1002, 2);
+        add_allocation_edge(graph, 2, 1001);
+        
+        /* Stale graph colors must not affect detection */
+        for (int i = 0; i < graph->num_vertices; i++) {
+            graph->color[i] = COLOR_BLACK;
+        }
+        
+        for (int scan = 0; scan < 3; scan++) {
+            CycleInfo* cycles = NULL;
+            int num_cycles = 0;
+            int result = find_all_cycles(graph, &cycles, &num_cycles);
+            TEST_ASSERT(result == SUCCESS && num_cycles == 1,
+                       "Each scan should find the same single cycle");
+            if (num_cycles == 1) {
+                TEST_ASSERT(cycles[0].cycle_length == 5, "Cycle length should be 5");
+                TEST_ASSERT(validate_cycle(&cycles[0], graph), "Cycle should be valid");
+            }
+            free_cycle_list(cycles, num_cycles);
+        }
+        
+        free_graph(graph);
+    }
+}
+
 /* =============================================================================
  * MAIN TEST RUNNER
  * =============================================================================
@@ -336,6 +504,10 @@ int main(void)
     test_has_cycle_function();
     test_empty_graph();
     test_single_vertex();
+    test_scc_engine();
+    test_deep_chain();
+    test_repeated_scans();
+    free_cycle_workspace();
     
     /* Print summary */
     printf("\n========================================\n");
@@ -354,4 +526,3 @@ int main(void)
         return 1;
     }
 }
-
@@ -274,6 +274,44 @@ static void test_vertex_lookup(void)
     }
 }
 
+/*
+ * test_vertex_index - Test hashed vertex lookup at full capacity
+ */
+static void test_vertex_index(void)
+{
+    printf("\n[TEST] Vertex Index\n");
+    printf("----------------------------------------\n");
+    
+    ResourceGraph* graph = create_graph(MAX_VERTICES);
+    TEST_ASSERT(graph != NULL, "Graph creation with MAX_VERTICES capacity");
+    
+    if (graph != NULL) {
+        /* Resource IDs overlap PIDs on purpose: type is part of the key */
+        int ok = 1;
+        for (int i = 1; i <= MAX_PROCESSES && ok; i++) {
+            ok = add_process_vertex(graph, i) == i - 1;
+        }
+        for (int i = 1; i <= MAX_RESOURCES && ok; i++) {
+            ok = add_resource_vertex(graph, i, 1) == MAX_PROCESSES + i - 1;
+        }
+        TEST_ASSERT(ok, "Should add all processes and resources in order");
+        TEST_ASSERT(graph->num_vertices == MAX_VERTICES, "Graph should be full");
+        
+        int lookups_ok = 1;
+        for (int i = 1; i <= MAX_RESOURCES && lookups_ok; i++) {
+            lookups_ok = find_vertex_by_pid(graph, i) == i - 1 &&
+                         find_vertex_by_rid(graph, i) == MAX_PROCESSES + i - 1;
+        }
+        TEST_ASSERT(lookups_ok, "Process and resource with same ID resolve separately");
+        TEST_ASSERT(find_vertex_by_rid(graph, MAX_RESOURCES + 1) == -1,
+                    "Missing RID should return -1");
+        TEST_ASSERT(add_process_vertex(graph, 42) == 41,
+                    "Re-adding existing PID returns existing index when full");
+        
+        free_graph(graph);
+    }
+}
+
 /*
  * test_reset_colors - Test color reset functionality
  */
@@ -302,6 +340,77 @@ static void test_reset_colors(void)
     }
 }
 
+/*
+ * test_csr_freeze - Test queued edges are sorted, deduped and frozen as CSR
+ */
+static void test_csr_freeze(void)
+{
+    printf("\n[TEST] CSR Freeze\n");
+    printf("----------------------------------------\n");
+    
+    ResourceGraph* graph = create_graph(100);
+    TEST_ASSERT(graph != NULL, "Graph creation");
+    
+    if (graph != NULL) {
+        /* P1 waits on R3, R1, R2 (plus a duplicate); R1 held by P2 */
+        queue_request_edge(graph, 1001, 3);
+        queue_request_edge(graph, 1001, 1);
+        queue_request_edge(graph, 1001, 2);
+        queue_request_edge(graph, 1001, 1);
+        queue_allocation_edge(graph, 1, 1002);
+        /* Incremental API edges join the same CSR */
+        add_request_edge(graph, 1002, 3);
+        add_allocation_edge(graph, 3, 1001);
+        
+        TEST_ASSERT(!graph->csr_valid, "CSR should be stale before freeze");
+        TEST_ASSERT(freeze_graph(graph) == SUCCESS, "Freeze should succeed");
+        TEST_ASSERT(graph->csr_valid, "CSR should be valid after freeze");
+        TEST_ASSERT(graph->num_edges == 6, "Duplicate edge should be dropped");
+        
+        int p1 = find_vertex_by_pid(graph, 1001);
+        int p2 = find_vertex_by_pid(graph, 1002);
+        int r1 = find_vertex_by_rid(graph, 1);
+        int r3 = find_vertex_by_rid(graph, 3);
+        int first = graph->csr_offsets[p1];
+        int last = graph->csr_offsets[p1 + 1];
+        TEST_ASSERT(last - first == 3, "P1 should have 3 outgoing edges");
+        
+        int sorted = 1;
+        for (int e = first + 1; e < last; e++) {
+            if (graph->csr_targets[e - 1] >= graph->csr_targets[e]) {
+                sorted = 0;
+            }
+        }
+        TEST_ASSERT(sorted, "CSR row should be sorted by target");
+        TEST_ASSERT(graph->csr_offsets[graph->num_vertices] == graph->num_edges,
+                   "Offsets should cover all edges");
+        
+        TEST_ASSERT(graph_has_edge(graph, p1, r1), "P1->R1 should exist");
+        TEST_ASSERT(graph_has_edge(graph, r3, p1), "R3->P1 should exist");
+        TEST_ASSERT(!graph_has_edge(graph, r1, p1), "R1->P1 should not exist");
+        
+        /* WFG: P1 -> P2 (via R1), P2 -> P1 and P1 -> P1 (via R3) */
+        ResourceGraph* wfg = NULL;
+        TEST_ASSERT(convert_to_wfg(graph, &wfg) == SUCCESS && wfg != NULL,
+                   "WFG conversion should succeed");
+        if (wfg != NULL) {
+            int w1 = find_vertex_by_pid(wfg, 1001);
+            int w2 = find_vertex_by_pid(wfg, 1002);
+            TEST_ASSERT(wfg->num_edges == 3, "WFG should have 3 edges");
+            TEST_ASSERT(graph_has_edge(wfg, w1, w2) && graph_has_edge(wfg, w2, w1),
+                       "WFG should contain P1<->P2");
+            free_graph(wfg);
+        }
+        
+        /* New vertices invalidate the CSR */
+        add_process_vertex(graph, 1003);
+        TEST_ASSERT(!graph->csr_valid, "Adding a vertex should invalidate CSR");
+        TEST_ASSERT(graph_has_edge(graph, p2, r3), "Edge lookup should work while stale");
+        
+        free_graph(graph);
+    }
+}
+
 /* =============================================================================
  * MAIN TEST RUNNER
  * =============================================================================
@@ -319,6 +428,8 @@ int main(void)
     test_add_resource_vertex();
     test_add_edges();
     test_vertex_lookup();
+    test_vertex_index();
+    test_csr_freeze();
     test_reset_colors();
     test_large_graph();
     test_graph_cleanup();
@@ -5,10 +5,19 @@
  * =============================================================================
  */
 
+#define _GNU_SOURCE  /* splice() */
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <assert.h>
+#include <unistd.h>
+#include <errno.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <sys/file.h>
+#include <fcntl.h>
+#include <time.h>
+#include <pthread.h>
 #include "../src/config.h"
 #include "../src/utility.h"
 #include "../src/process_monitor.h"
@@ -16,6 +25,17 @@
 #include "../src/cycle_detection.h"
 #include "../src/deadlock_detection.h"
 #include "../src/output_handler.h"
+#include "../src/pipe_index.h"
+#include "../src/lock_index.h"
+#include "../src/proc_handle.h"
+#include "../src/proc_events.h"
+#include "../src/proc_uring.h"
+#include "../src/scan_schedule.h"
+#include "../src/event_loop.h"
+#include "../src/deadlock_confirm.h"
+#include <linux/netlink.h>
+#include <linux/connector.h>
+#include <linux/cn_proc.h>
 
 /* Test counters */
 static int g_tests_passed = 0;
@@ -218,6 +238,87 @@ static void test_deadlock_detection_with_deadlock(void)
     }
 }
 
+/*
+ * drop_cycle_of - Detection filter dropping the cycle that contains a PID
+ */
+static int drop_cycle_of(void* context, const int* pids, int num_pids)
+{
+    int pid = *(const int*)context;
+    if (pid < 0) {
+        return ERROR_SYSTEM_CALL_FAILED;
+    }
+    for (int i = 0; i < num_pids; i++) {
+        if (pids[i] == pid) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+/*
+ * test_deadlock_detection_filtered - Test dropping one of two cycles
+ */
+static void test_deadlock_detection_filtered(void)
+{
+    printf("\n[TEST] Deadlock Detection - Filtered Cycles\n");
+    printf("----------------------------------------\n");
+    
+    ProcessResourceInfo* procs = create_mock_process_data(4);
+    TEST_ASSERT(procs != NULL, "Create mock process data");
+    if (procs == NULL) {
+        return;
+    }
+    
+    /* Two separate cycles: P0 <-> P1 on R1/R2 and P2 <-> P3 on R3/R4 */
+    for (int i = 0; i < 4; i++) {
+        int pair = i / 2 * 2;
+        procs[i].held_resources = (int*)safe_malloc(sizeof(int));
+        procs[i].held_resources[0] = i + 1;
+        procs[i].num_held = 1;
+        procs[i].waiting_resources = (int*)safe_malloc(sizeof(int));
+        procs[i].waiting_resources[0] = pair + (i == pair ? 2 : 1);
+        procs[i].num_waiting = 1;
+    }
+    
+    DeadlockReport* report = create_deadlock_report();
+    int drop = procs[0].pid;
+    TEST_ASSERT(report != NULL && detect_deadlock_filtered(procs, 4, report, drop_cycle_of, &drop) == 1,
+                "A kept cycle should still be reported");
+    if (report != NULL) {
+        TEST_ASSERT(report->num_cycles == 1 && report->num_deadlocked == 2,
+                    "Only the kept cycle should remain");
+        TEST_ASSERT(report->num_deadlocked == 2 &&
+                    ((report->deadlocked_pids[0] == procs[2].pid && report->deadlocked_pids[1] == procs[3].pid) ||
+                     (report->deadlocked_pids[0] == procs[3].pid && report->deadlocked_pids[1] == procs[2].pid)),
+                    "Deadlocked PIDs should come from the kept cycle alone");
+        TEST_ASSERT(report->num_explanations > 0, "The kept cycle should be explained");
+        free_deadlock_report(report);
+        free(report);
+    }
+    
+    report = create_deadlock_report();
+    TEST_ASSERT(report != NULL && detect_deadlock_filtered(procs, 4, report, NULL, NULL) == 1 &&
+                report->num_cycles == 2 && report->num_deadlocked == 4,
+                "Without a filter both cycles should be reported");
+    if (report != NULL) {
+        free_deadlock_report(report);
+        free(report);
+    }
+    
+    /* A filter error stops detection */
+    report = create_deadlock_report();
+    drop = -1;
+    TEST_ASSERT(report != NULL &&
+                detect_deadlock_filtered(procs, 4, report, drop_cycle_of, &drop) == ERROR_SYSTEM_CALL_FAILED,
+                "A filter error should be returned");
+    if (report != NULL) {
+        free_deadlock_report(report);
+        free(report);
+    }
+    
+    free_mock_process_data(procs, 4);
+}
+
 /*
  * test_output_formatting_text - Test TEXT output format
  */
@@ -351,6 +452,1471 @@ static void test_report_creation_cleanup(void)
     }
 }
 
+/*
+ * test_parse_process_status - Test in-place parsing of status content
+ */
+static void test_parse_process_status(void)
+{
+    printf("\n[TEST] Parse Process Status\n");
+    printf("----------------------------------------\n");
+    
+    const char* status =
+        "Name:\tmy worker  \n"
+        "Umask:\t0022\n"
+        "State:\tD (disk sleep)\n"
+        "Tgid:\t4242\n"
+        "Ngid:\t0\n"
+        "Pid:\t4242\n"
+        "PPid:\t17\n"
+        "TracerPid:\t0\n"
+        "Uid:\t1000\t1001\t1002\t1003\n"
+        "Gid:\t2000\t2001\t2002\t2003\n"
+        "Groups:\t4 24 27\n"
+        "NSpid:\t4242\n"
+        "VmPeak:\t  99999 kB\n"
+        "VmRSS:\t   5120 kB\n"
+        "Threads:\t3\n"
+        "SigQ:\t0/63304\n";
+    
+    ProcessInfo info;
+    int result = parse_process_status(status, &info);
+    TEST_ASSERT(result == SUCCESS, "Parse full status content");
+    TEST_ASSERT(strcmp(info.name, "my worker") == 0, "Name should be trimmed, inner space kept");
+    TEST_ASSERT(info.state == 'D', "State should be parsed");
+    TEST_ASSERT(info.ppid == 17, "PPid should not match Pid or TracerPid");
+    TEST_ASSERT(info.uid == 1000 && info.gid == 2000, "Real UID and GID should be parsed");
+    TEST_ASSERT(info.vm_rss == 5120, "VmRSS should not match VmPeak");
+    TEST_ASSERT(info.num_threads == 3, "Threads should be parsed");
+    
+    /* Kernel threads have no VmRSS line and the content may lack a final newline */
+    result = parse_process_status("Name:\tkworker/0:1\nState:\tI (idle)\nPPid:\t2\nThreads:\t1", &info);
+    TEST_ASSERT(result == SUCCESS, "Parse partial status content");
+    TEST_ASSERT(strcmp(info.name, "kworker/0:1") == 0 && info.state == 'I' &&
+                info.ppid == 2 && info.num_threads == 1, "Present fields should be parsed");
+    TEST_ASSERT(info.vm_rss == 0 && info.uid == 0, "Missing fields should stay zero");
+    
+    TEST_ASSERT(parse_process_status(NULL, &info) == ERROR_INVALID_ARGUMENT,
+                "NULL content should be rejected");
+}
+
+/*
+ * test_read_proc_file_into - Test single-read /proc views in a reusable buffer
+ */
+static void test_read_proc_file_into(void)
+{
+    printf("\n[TEST] Read /proc File Into Buffer\n");
+    printf("----------------------------------------\n");
+    
+    ReadBuffer buffer;
+    memset(&buffer, 0, sizeof(buffer));
+    
+    size_t len = 0;
+    char* view = read_proc_file_into((int)getpid(), "status", &buffer, &len);
+    TEST_ASSERT(view != NULL && view == buffer.data, "View should point into the buffer");
+    TEST_ASSERT(view != NULL && len == strlen(view) && strncmp(view, "Name:", 5) == 0,
+                "Status content and length should match");
+    size_t capacity = buffer.capacity;
+    
+    /* smaps is larger than the initial buffer and returns short reads
+     * at record boundaries; it must still be read to the end */
+    view = read_proc_file_into((int)getpid(), "smaps", &buffer, &len);
+    TEST_ASSERT(view != NULL && len > PROC_READ_BUFFER_SIZE && len == strlen(view) &&
+                view[len - 1] == '\n', "Large file should be read completely");
+    TEST_ASSERT(buffer.capacity > capacity, "Buffer should grow only for the large file");
+    
+    capacity = buffer.capacity;
+    view = read_proc_file_into((int)getpid(), "status", &buffer, &len);
+    TEST_ASSERT(view != NULL && buffer.capacity == capacity, "Later reads should reuse the buffer");
+    
+    errno = 0;
+    view = read_proc_file_into(999999999, "status", &buffer, &len);
+    TEST_ASSERT(view == NULL && errno == ENOENT, "Missing process should report ENOENT");
+    
+    TEST_ASSERT(thread_read_buffer() != NULL, "Thread buffer should be available");
+    free_read_buffer(&buffer);
+    TEST_ASSERT(buffer.data == NULL && buffer.capacity == 0, "Buffer should be released");
+}
+
+/*
+ * CountFdsContext - Visitor state for test_proc_handle
+ */
+typedef struct {
+    int count;
+    int found_fd;
+    int wanted_fd;
+} CountFdsContext;
+
+static int count_fds_visit(void* context, int fd, const char* name)
+{
+    CountFdsContext* ctx = (CountFdsContext*)context;
+    (void)name;
+    ctx->count++;
+    if (fd == ctx->wanted_fd) {
+        ctx->found_fd = 1;
+    }
+    return SUCCESS;
+}
+
+/*
+ * test_proc_handle - Test dirfd-relative /proc access through a handle
+ */
+static void test_proc_handle(void)
+{
+    printf("\n[TEST] Process Directory Handle\n");
+    printf("----------------------------------------\n");
+    
+    int pipe_fds[2];
+    TEST_ASSERT(pipe(pipe_fds) == 0, "Test pipe should be created");
+    
+    ProcHandle handle;
+    int result = proc_handle_open(&handle, getpid());
+    TEST_ASSERT(result == SUCCESS && handle.dir_fd >= 0, "Handle should open for own PID");
+    
+    size_t len = 0;
+    char* view = proc_handle_read(&handle, "status", thread_read_buffer(), &len);
+    TEST_ASSERT(view != NULL && strncmp(view, "Name:", 5) == 0 && len == strlen(view),
+                "Status should be readable through the handle");
+    
+    CountFdsContext ctx = { 0, 0, pipe_fds[0] };
+    result = proc_handle_for_each_fd(&handle, count_fds_visit, &ctx);
+    TEST_ASSERT(result == SUCCESS && ctx.found_fd && ctx.count >= 2, "FD walk should see the pipe");
+    
+    /* The fd directory is rewound, so a second walk sees the same FDs */
+    int first_count = ctx.count;
+    ctx.count = 0;
+    result = proc_handle_for_each_fd(&handle, count_fds_visit, &ctx);
+    TEST_ASSERT(result == SUCCESS && ctx.count == first_count, "Repeated FD walk should match");
+    
+    char name[16];
+    char target[MAX_PATH_LEN];
+    snprintf(name, sizeof(name), "%d", pipe_fds[0]);
+    TEST_ASSERT(proc_handle_readlink_fd(&handle, name, target, sizeof(target)) > 0 &&
+                strncmp(target, "pipe:[", 6) == 0, "Pipe link should be readable");
+    
+    struct stat st;
+    TEST_ASSERT(proc_handle_stat_fd(&handle, name, &st) == SUCCESS && S_ISFIFO(st.st_mode),
+                "FD stat should follow the link to the pipe");
+    proc_handle_close(&handle);
+    TEST_ASSERT(handle.dir_fd == -1 && handle.fd_dir_fd == -1, "Close should reset descriptors");
+    
+    TEST_ASSERT(proc_handle_open(&handle, 999999999) == ERROR_FILE_NOT_FOUND,
+                "Missing process should report ERROR_FILE_NOT_FOUND");
+    
+    /* A handle stays bound to the process it was opened for */
+    pid_t child = fork();
+    if (child == 0) {
+        _exit(0);
+    }
+    TEST_ASSERT(child > 0, "Fork should succeed");
+    if (child > 0) {
+        result = proc_handle_open(&handle, child);
+        waitpid(child, NULL, 0);
+        TEST_ASSERT(result == SUCCESS, "Handle should open before the child is reaped");
+        view = proc_handle_read(&handle, "status", thread_read_buffer(), NULL);
+        TEST_ASSERT(view == NULL, "Reads through a reaped process's handle should fail");
+        proc_handle_close(&handle);
+    }
+    
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+/*
+ * count_own_fds - Number of open FDs of the test process
+ */
+static int count_own_fds(void)
+{
+    int* fds = NULL;
+    int count = 0;
+    if (get_open_files(getpid(), &fds, &count) != SUCCESS) {
+        return -1;
+    }
+    free(fds);
+    return count;
+}
+
+/*
+ * test_proc_handle_cache - Test handle reuse and eviction across scans
+ */
+static void test_proc_handle_cache(void)
+{
+    printf("\n[TEST] Process Handle Cache\n");
+    printf("----------------------------------------\n");
+    
+    int fds_before = count_own_fds();
+    
+    ProcHandleCache cache;
+    int result = proc_handle_cache_init(&cache);
+    TEST_ASSERT(result == SUCCESS && cache.max_entries > 0, "Cache should initialize");
+    
+    pid_t child = fork();
+    if (child == 0) {
+        pause();
+        _exit(0);
+    }
+    TEST_ASSERT(child > 0, "Fork should succeed");
+    if (child <= 0) {
+        proc_handle_cache_destroy(&cache);
+        return;
+    }
+    
+    pid_t pids[2] = { getpid(), child };
+    ProcHandle handles[2];
+    
+    /* Scan 1: nothing cached yet */
+    proc_handle_cache_checkout(&cache, pids, 2, handles);
+    TEST_ASSERT(handles[0].dir_fd == -1 && handles[1].dir_fd == -1, "First scan should miss");
+    TEST_ASSERT(proc_handle_acquire(&handles[0]) == SUCCESS &&
+                proc_handle_acquire(&handles[1]) == SUCCESS, "Fresh handles should open");
+    unsigned long long self_start = handles[0].start_time;
+    proc_handle_cache_checkin(&cache, handles, 2);
+    TEST_ASSERT(cache.count == 2 && handles[0].dir_fd == -1, "Check-in should keep both handles");
+    
+    /* Scan 2: both hit and validate without reopening */
+    proc_handle_cache_checkout(&cache, pids, 2, handles);
+    int cached_fd = handles[0].dir_fd;
+    TEST_ASSERT(cached_fd >= 0 && handles[0].start_time == self_start, "Second scan should hit");
+    TEST_ASSERT(proc_handle_acquire(&handles[0]) == SUCCESS && handles[0].dir_fd == cached_fd,
+                "Valid cached handle should be kept");
+    
+    /* A start-time mismatch means a different process now owns the PID */
+    unsigned long long child_start = handles[1].start_time;
+    handles[1].start_time += 1;
+    result = proc_handle_acquire(&handles[1]);
+    TEST_ASSERT(result == SUCCESS && handles[1].start_time == child_start,
+                "Start-time mismatch should reopen the handle");
+    proc_handle_cache_checkin(&cache, handles, 2);
+    
+    /* Scan 3: the child has exited */
+    kill(child, SIGKILL);
+    waitpid(child, NULL, 0);
+    proc_handle_cache_checkout(&cache, pids, 2, handles);
+    result = proc_handle_acquire(&handles[1]);
+    TEST_ASSERT(result == ERROR_FILE_NOT_FOUND && handles[1].dir_fd == -1,
+                "Exited process should be evicted");
+    proc_handle_cache_checkin(&cache, handles, 2);
+    TEST_ASSERT(cache.count == 1, "Only the live process should stay cached");
+    
+    /* Scan 4: a PID no longer enumerated is dropped */
+    proc_handle_cache_checkout(&cache, &pids[1], 1, handles);
+    proc_handle_cache_checkin(&cache, handles, 1);
+    TEST_ASSERT(cache.count == 0, "Unseen PIDs should be closed");
+    
+    proc_handle_cache_destroy(&cache);
+    TEST_ASSERT(count_own_fds() == fds_before, "Cache should not leak descriptors");
+}
+
+/*
+ * test_enumerate_processes - Test PID enumeration into a reusable vector
+ */
+static void test_enumerate_processes(void)
+{
+    printf("\n[TEST] Process Enumeration\n");
+    printf("----------------------------------------\n");
+    
+    PidVector vec;
+    memset(&vec, 0, sizeof(vec));
+    
+    int result = enumerate_processes(&vec);
+    TEST_ASSERT(result == SUCCESS, "Enumerate processes should succeed");
+    TEST_ASSERT(vec.count > 0, "Should find at least one process");
+    
+    int found_self = 0;
+    for (int i = 0; i < vec.count; i++) {
+        if (vec.pids[i] == getpid()) {
+            found_self = 1;
+            break;
+        }
+    }
+    TEST_ASSERT(found_self, "Own PID should be enumerated");
+    
+    /* Second scan must reuse storage rather than append */
+    pid_t* first_storage = vec.pids;
+    int first_count = vec.count;
+    result = enumerate_processes(&vec);
+    TEST_ASSERT(result == SUCCESS, "Repeated enumeration should succeed");
+    TEST_ASSERT(vec.count <= first_count + 64,
+                "Repeated enumeration should not accumulate PIDs");
+    TEST_ASSERT(vec.pids == first_storage || vec.capacity > first_count,
+                "Vector storage should be reused");
+    
+    free_pid_vector(&vec);
+    TEST_ASSERT(vec.pids == NULL && vec.count == 0, "Vector should be released");
+}
+
+/*
+ * test_fd_snapshot - Test FD table collection and classification
+ */
+static void test_fd_snapshot(void)
+{
+    printf("\n[TEST] FD Snapshot\n");
+    printf("----------------------------------------\n");
+    
+    int pipe_fds[2];
+    TEST_ASSERT(pipe(pipe_fds) == 0, "Create test pipe");
+    
+    FdSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    TEST_ASSERT(fd_snapshot_prepare(&snapshot, 1) == SUCCESS, "Prepare snapshot");
+    
+    ProcessResourceInfo proc;
+    int result = get_process_resources_with_table(getpid(), &snapshot.tables[0], NULL, &proc);
+    TEST_ASSERT(result == SUCCESS, "Collect own resources with FD table");
+    TEST_ASSERT(proc.fd_table == &snapshot.tables[0], "Resource info should reference FD table");
+    
+    int found_read = 0;
+    int found_write = 0;
+    unsigned long read_inode = 0;
+    unsigned long write_inode = 0;
+    for (int i = 0; i < snapshot.tables[0].num_entries; i++) {
+        const FdEntry* entry = &snapshot.tables[0].entries[i];
+        if (entry->fd == pipe_fds[0] && entry->kind == FD_KIND_PIPE) {
+            found_read = 1;
+            read_inode = entry->inode;
+        } else if (entry->fd == pipe_fds[1] && entry->kind == FD_KIND_PIPE) {
+            found_write = 1;
+            write_inode = entry->inode;
+        }
+    }
+    TEST_ASSERT(found_read && found_write, "Both pipe ends should be classified as pipes");
+    TEST_ASSERT(read_inode != 0 && read_inode == write_inode, "Pipe ends should share an inode");
+    for (int i = 0; i < snapshot.tables[0].num_entries; i++) {
+        const FdEntry* entry = &snapshot.tables[0].entries[i];
+        if (entry->fd == pipe_fds[0]) {
+            TEST_ASSERT(entry->pipe_end == PIPE_END_READ, "Read end should be classified from fdinfo");
+        } else if (entry->fd == pipe_fds[1]) {
+            TEST_ASSERT(entry->pipe_end == PIPE_END_WRITE, "Write end should be classified from fdinfo");
+        }
+    }
+    TEST_ASSERT(proc.num_pipe_inodes == snapshot.tables[0].num_pipes,
+                "Pipe inodes should come from the FD table");
+    
+    PipeInfo* pipes = NULL;
+    int pipe_count = 0;
+    result = detect_pipe_dependencies(&pipes, &pipe_count, &proc, 1);
+    TEST_ASSERT(result == SUCCESS && pipe_count == snapshot.tables[0].num_pipes,
+                "Pipe detection should use the snapshot");
+    free_pipe_info(pipes, pipe_count);
+    
+    free_process_resource_info(&proc);
+    free_fd_snapshot(&snapshot);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+}
+
+/*
+ * set_mock_pipes - Give a mock process a set of pipe inodes
+ */
+static void set_mock_pipes(ProcessResourceInfo* proc, const unsigned long* inodes, int count)
+{
+    proc->pipe_inodes = (unsigned long*)safe_malloc(sizeof(unsigned long) * count);
+    proc->pipe_fds = (int*)safe_malloc(sizeof(int) * count);
+    for (int i = 0; i < count; i++) {
+        proc->pipe_inodes[i] = inodes[i];
+        proc->pipe_fds[i] = 3 + i;
+    }
+    proc->num_pipe_inodes = count;
+}
+
+/*
+ * test_pipe_dependency_index - Test pipe peer matching through the inode index
+ */
+static void test_pipe_dependency_index(void)
+{
+    printf("\n[TEST] Pipe Dependency Index\n");
+    printf("----------------------------------------\n");
+    
+    ProcessResourceInfo* procs = create_mock_process_data(3);
+    TEST_ASSERT(procs != NULL, "Create mock process data");
+    if (procs == NULL) {
+        return;
+    }
+    
+    /* P0 (blocked) shares pipes 555 and 556 with P1; P2 has a private pipe.
+     * P0 also holds both ends of 555, which must not double-count. */
+    unsigned long p0_pipes[] = {555, 555, 556};
+    unsigned long p1_pipes[] = {555, 556};
+    unsigned long p2_pipes[] = {777, 777};
+    set_mock_pipes(&procs[0], p0_pipes, 3);
+    set_mock_pipes(&procs[1], p1_pipes, 2);
+    set_mock_pipes(&procs[2], p2_pipes, 2);
+    procs[0].is_blocked_on_pipe = 1;
+    
+    PipeIndex index;
+    memset(&index, 0, sizeof(index));
+    int result = pipe_index_build(&index, procs, 3);
+    TEST_ASSERT(result == SUCCESS, "Build pipe index");
+    TEST_ASSERT(index.num_inodes == 3, "Index should hold 3 distinct inodes");
+    TEST_ASSERT(index.num_endpoints == 7, "Index should hold 7 endpoints");
+    int pos = pipe_index_find(&index, 555);
+    TEST_ASSERT(pos >= 0 && index.slots[pos].count == 3 &&
+                index.slots[pos].num_procs == 2, "Inode 555 has 3 endpoints in 2 processes");
+    TEST_ASSERT(pipe_index_find(&index, 999) < 0, "Unknown inode should not be found");
+    free_pipe_index(&index);
+    
+    result = analyze_pipe_and_lock_dependencies(procs, 3);
+    TEST_ASSERT(result == SUCCESS, "Analyze dependencies");
+    TEST_ASSERT(procs[0].num_waiting_on_pids == 1 && procs[0].waiting_on_pids[0] == procs[1].pid,
+                "Blocked process should wait on its single peer once");
+    TEST_ASSERT(procs[0].num_waiting == 2, "Blocked process should wait on both shared pipes");
+    TEST_ASSERT(procs[1].num_held == 2, "Peer should hold both shared pipes");
+    TEST_ASSERT(procs[1].num_waiting == 0, "Unblocked peer should not wait");
+    TEST_ASSERT(procs[2].num_held == 0, "Private pipe should not create a resource");
+    
+    free_mock_process_data(procs, 3);
+}
+
+/*
+ * test_pipe_end_edges - Test that known pipe ends restrict wait edges
+ */
+static void test_pipe_end_edges(void)
+{
+    printf("\n[TEST] Pipe End Edges\n");
+    printf("----------------------------------------\n");
+    
+    TEST_ASSERT(fd_pipe_end_from_fdinfo("pos:\t0\nflags:\t02000000\nmnt_id:\t15\n") == PIPE_END_READ,
+                "O_RDONLY flags should be a read end");
+    TEST_ASSERT(fd_pipe_end_from_fdinfo("pos:\t0\nflags:\t02000001\n") == PIPE_END_WRITE,
+                "O_WRONLY flags should be a write end");
+    TEST_ASSERT(fd_pipe_end_from_fdinfo("flags:\t02\n") == PIPE_END_UNKNOWN &&
+                fd_pipe_end_from_fdinfo("pos:\t0\n") == PIPE_END_UNKNOWN &&
+                fd_pipe_end_from_fdinfo(NULL) == PIPE_END_UNKNOWN,
+                "O_RDWR or missing flags should leave the end unknown");
+    
+    ProcessResourceInfo* procs = create_mock_process_data(3);
+    TEST_ASSERT(procs != NULL, "Create mock process data");
+    if (procs == NULL) {
+        return;
+    }
+    
+    /* P0 (blocked) and P2 read pipe 900, P1 writes it */
+    unsigned long pipe_900[] = {900};
+    int ends[] = {PIPE_END_READ, PIPE_END_WRITE, PIPE_END_READ};
+    for (int i = 0; i < 3; i++) {
+        set_mock_pipes(&procs[i], pipe_900, 1);
+        procs[i].pipe_ends = (int*)safe_malloc(sizeof(int));
+        procs[i].pipe_ends[0] = ends[i];
+    }
+    procs[0].is_blocked_on_pipe = 1;
+    
+    int result = analyze_pipe_and_lock_dependencies(procs, 3);
+    TEST_ASSERT(result == SUCCESS, "Analyze dependencies");
+    TEST_ASSERT(procs[0].num_waiting_on_pids == 1 && procs[0].waiting_on_pids[0] == procs[1].pid,
+                "Blocked reader should wait on the writer only");
+    TEST_ASSERT(procs[0].num_waiting == 1 &&
+                procs[0].waiting_resources[0] == PIPE_WRITE_END_RESOURCE_BASE + 900,
+                "Blocked reader should wait on the write end");
+    TEST_ASSERT(procs[1].num_held == 1 &&
+                procs[1].held_resources[0] == PIPE_WRITE_END_RESOURCE_BASE + 900,
+                "Writer should hold the write end");
+    TEST_ASSERT(procs[2].num_held == 1 && procs[2].held_resources[0] == 900,
+                "Other reader should hold the read end only");
+    
+    free_mock_process_data(procs, 3);
+}
+
+/*
+ * count_task - Worker task counting participants
+ */
+static void count_task(void* context, int worker_id)
+{
+    (void)worker_id;
+    __atomic_fetch_add((int*)context, 1, __ATOMIC_RELAXED);
+}
+
+/*
+ * test_parallel_collection - Test worker pool and parallel resource collection
+ */
+static void test_parallel_collection(void)
+{
+    printf("\n[TEST] Parallel Resource Collection\n");
+    printf("----------------------------------------\n");
+    
+    WorkerPool* pool = worker_pool_create(4);
+    TEST_ASSERT(pool != NULL, "Create worker pool");
+    if (pool == NULL) {
+        return;
+    }
+    
+    int participants = 0;
+    worker_pool_run(pool, count_task, &participants);
+    worker_pool_run(pool, count_task, &participants);
+    TEST_ASSERT(participants == 8, "Every participant should run each task once");
+    
+    PidVector vec;
+    memset(&vec, 0, sizeof(vec));
+    FdSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    
+    int result = enumerate_processes(&vec);
+    if (result == SUCCESS) {
+        result = fd_snapshot_prepare(&snapshot, vec.count);
+    }
+    TEST_ASSERT(result == SUCCESS, "Prepare PIDs and snapshot");
+    
+    Arena* arenas[4];
+    for (int i = 0; i < 4; i++) {
+        arenas[i] = arena_create(0);
+    }
+    
+    ProcessResourceInfo* procs = (ProcessResourceInfo*)safe_malloc(
+        sizeof(ProcessResourceInfo) * vec.count);
+    int* results = (int*)safe_malloc(sizeof(int) * vec.count);
+    if (result == SUCCESS && procs != NULL && results != NULL &&
+        arenas[0] != NULL && arenas[1] != NULL && arenas[2] != NULL && arenas[3] != NULL) {
+        result = collect_process_resources(pool, vec.pids, vec.count, &snapshot,
+                                           arenas, NULL, NULL, procs, results);
+        TEST_ASSERT(result == SUCCESS, "Parallel collection should succeed");
+        
+        int self_ok = 0;
+        for (int i = 0; i < vec.count; i++) {
+            if (vec.pids[i] == getpid()) {
+                self_ok = results[i] == SUCCESS && procs[i].pid == (int)getpid() &&
+                          procs[i].fd_table == &snapshot.tables[i];
+            }
+            free_process_resource_info(&procs[i]);
+        }
+        TEST_ASSERT(self_ok, "Own slot should be filled by a worker");
+    }
+    
+    for (int i = 0; i < 4; i++) {
+        arena_destroy(arenas[i]);
+    }
+    free(procs);
+    free(results);
+    free_fd_snapshot(&snapshot);
+    free_pid_vector(&vec);
+    worker_pool_destroy(pool);
+}
+
+/*
+ * incremental_scan_once - Collect one PID incrementally and commit its record
+ * @cache: Handle cache
+ * @snapshots: Two snapshots used alternately
+ * @current: Index of the snapshot to fill (flipped on return)
+ * @history: Scan history
+ * @pid: PID to collect
+ * @proc: Output resource info (caller frees)
+ * @return: Number of reused slots
+ */
+static int incremental_scan_once(ProcHandleCache* cache, FdSnapshot* snapshots, int* current,
+                                 ScanHistory* history, pid_t pid, ProcessResourceInfo* proc)
+{
+    ProcHandle handle;
+    ScanRecord record;
+    int result_code = ERROR_SYSTEM_CALL_FAILED;
+    
+    fd_snapshot_prepare(&snapshots[*current], 1);
+    proc_handle_cache_checkout(cache, &pid, 1, &handle);
+    
+    IncrementalScan incremental;
+    incremental.history = history;
+    incremental.previous = &snapshots[1 - *current];
+    incremental.records = &record;
+    incremental.num_reused = 0;
+    
+    collect_process_resources(NULL, &pid, 1, &snapshots[*current], NULL, &handle,
+                              &incremental, proc, &result_code);
+    proc_handle_cache_checkin(cache, &handle, 1);
+    scan_history_commit(history, &record, 1);
+    *current = 1 - *current;
+    
+    return result_code == SUCCESS ? incremental.num_reused : -1;
+}
+
+/*
+ * idle_thread - Second thread of a test child; sleeps until the child exits
+ */
+static void* idle_thread(void* arg)
+{
+    (void)arg;
+    for (;;) {
+        pause();
+    }
+    return NULL;
+}
+
+/*
+ * test_incremental_collection - Test reuse of unchanged processes across scans
+ */
+static void test_incremental_collection(void)
+{
+    printf("\n[TEST] Incremental Collection\n");
+    printf("----------------------------------------\n");
+    
+    struct timespec settle = {0, 100000000};
+    int pipe_fds[2];
+    TEST_ASSERT(pipe(pipe_fds) == 0, "Test pipe should be created");
+    
+    /* Child sleeps in read() on the pipe until the parent writes */
+    pid_t child = fork();
+    if (child == 0) {
+        char c;
+        close(pipe_fds[1]);
+        while (read(pipe_fds[0], &c, 1) > 0) {
+        }
+        _exit(0);
+    }
+    TEST_ASSERT(child > 0, "Fork should succeed");
+    if (child <= 0) {
+        return;
+    }
+    nanosleep(&settle, NULL);
+    
+    ProcHandleCache cache;
+    proc_handle_cache_init(&cache);
+    FdSnapshot snapshots[2];
+    memset(snapshots, 0, sizeof(snapshots));
+    ScanHistory history;
+    memset(&history, 0, sizeof(history));
+    int current = 0;
+    ProcessResourceInfo first, second, third;
+    
+    int reused = incremental_scan_once(&cache, snapshots, &current, &history, child, &first);
+    TEST_ASSERT(reused == 0 && history.count == 1, "First scan should collect in full");
+    
+    reused = incremental_scan_once(&cache, snapshots, &current, &history, child, &second);
+    TEST_ASSERT(reused == 1, "Unchanged process should be reused");
+    TEST_ASSERT(second.fd_table != NULL && second.num_pipe_inodes == first.num_pipe_inodes &&
+                second.num_pipe_inodes > 0 && second.pipe_inodes[0] == first.pipe_inodes[0],
+                "Reused slot should carry the previous FD table");
+    TEST_ASSERT(second.wchan != NULL && first.wchan != NULL &&
+                strcmp(second.wchan, first.wchan) == 0, "Reused slot should keep the wait channel");
+    
+    /* Waking the child changes its context switch count */
+    TEST_ASSERT(write(pipe_fds[1], "x", 1) == 1, "Write should wake the child");
+    nanosleep(&settle, NULL);
+    reused = incremental_scan_once(&cache, snapshots, &current, &history, child, &third);
+    TEST_ASSERT(reused == 0 && third.num_pipe_inodes > 0, "Changed process should be re-read");
+    
+    free_process_resource_info(&first);
+    free_process_resource_info(&second);
+    free_process_resource_info(&third);
+    
+    close(pipe_fds[1]);
+    close(pipe_fds[0]);
+    waitpid(child, NULL, 0);
+    
+    /* Another thread can change the shared FD table while the main thread's
+     * counters stand still, so a multithreaded process is never reused */
+    TEST_ASSERT(pipe(pipe_fds) == 0, "Second test pipe should be created");
+    pid_t threaded = fork();
+    if (threaded == 0) {
+        char c;
+        pthread_t thread;
+        close(pipe_fds[1]);
+        if (pthread_create(&thread, NULL, idle_thread, NULL) != 0) {
+            _exit(1);
+        }
+        while (read(pipe_fds[0], &c, 1) > 0) {
+        }
+        _exit(0);
+    }
+    TEST_ASSERT(threaded > 0, "Fork should succeed");
+    if (threaded > 0) {
+        nanosleep(&settle, NULL);
+        reused = incremental_scan_once(&cache, snapshots, &current, &history, threaded, &first);
+        free_process_resource_info(&first);
+        TEST_ASSERT(reused == 0, "First scan of the threaded process should collect in full");
+        reused = incremental_scan_once(&cache, snapshots, &current, &history, threaded, &second);
+        TEST_ASSERT(reused == 0 && second.num_pipe_inodes > 0,
+                    "Multithreaded process should be re-read every scan");
+        free_process_resource_info(&second);
+        kill(threaded, SIGKILL);
+        waitpid(threaded, NULL, 0);
+    }
+    close(pipe_fds[1]);
+    close(pipe_fds[0]);
+    
+    proc_handle_cache_destroy(&cache);
+    free_fd_snapshot(&snapshots[0]);
+    free_fd_snapshot(&snapshots[1]);
+    free_scan_history(&history);
+}
+
+/*
+ * test_blocked_triage - Test wait-channel triage and the two-waiter rule
+ */
+static void test_blocked_triage(void)
+{
+    printf("\n[TEST] Blocked Process Triage\n");
+    printf("----------------------------------------\n");
+    
+    pid_t pids[2] = {getpid(), 999999999};
+    char blocked[2] = {1, 1};
+    int results[2] = {-1, -1};
+    
+    int result = triage_processes(NULL, pids, 2, NULL, blocked, results);
+    TEST_ASSERT(result == SUCCESS, "Serial triage should succeed");
+    TEST_ASSERT(results[0] == SUCCESS && blocked[0] == 0,
+                "The running test process should not be blocked");
+    TEST_ASSERT(results[1] == ERROR_FILE_NOT_FOUND, "Missing process should be reported");
+    TEST_ASSERT(triage_processes(NULL, pids, 2, NULL, NULL, results) == ERROR_INVALID_ARGUMENT,
+                "Triage without output flags should be rejected");
+    
+    /* Parallel triage through cached handles leaves them open for collection */
+    WorkerPool* pool = worker_pool_create(2);
+    ProcHandleCache cache;
+    proc_handle_cache_init(&cache);
+    ProcHandle handles[2];
+    proc_handle_cache_checkout(&cache, pids, 2, handles);
+    result = triage_processes(pool, pids, 2, handles, blocked, results);
+    TEST_ASSERT(result == SUCCESS && results[0] == SUCCESS && handles[0].dir_fd >= 0,
+                "Triage should acquire the slot's handle");
+    proc_handle_cache_checkin(&cache, handles, 2);
+    TEST_ASSERT(cache.count == 1, "Triaged handle should be cached at check-in");
+    proc_handle_cache_destroy(&cache);
+    worker_pool_destroy(pool);
+    
+    /* A single waiting process cannot form a cycle: no graph is built */
+    ProcessResourceInfo* procs = create_mock_process_data(2);
+    DeadlockReport* report = create_deadlock_report();
+    TEST_ASSERT(procs != NULL && report != NULL, "Create process data and report");
+    
+    if (procs != NULL && report != NULL) {
+        procs[0].held_resources = (int*)safe_malloc(sizeof(int));
+        procs[0].held_resources[0] = 1;
+        procs[0].num_held = 1;
+        procs[0].waiting_resources = (int*)safe_malloc(sizeof(int));
+        procs[0].waiting_resources[0] = 1;
+        procs[0].num_waiting = 1;
+        
+        report->total_processes_scanned = 10;
+        result = detect_deadlock_in_system(procs, 2, report);
+        TEST_ASSERT(result == 0 && report->deadlock_detected == 0,
+                    "One waiting process should never be a deadlock");
+        TEST_ASSERT(report->total_resources_found == 0, "Graph should not be built");
+        TEST_ASSERT(report->total_processes_scanned == 10,
+                    "Preset scanned count should be kept");
+        
+        result = detect_deadlock_in_system(NULL, 0, report);
+        TEST_ASSERT(result == 0, "Empty candidate set should report no deadlock");
+    }
+    
+    free_deadlock_report(report);
+    free(report);
+    free_mock_process_data(procs, 2);
+}
+
+/*
+ * test_wait_syscall_edges - Test exact wait edges from /proc/[PID]/syscall
+ */
+static void test_wait_syscall_edges(void)
+{
+    printf("\n[TEST] Wait Syscall Edges\n");
+    printf("----------------------------------------\n");
+    
+    /* Parent waits for its child, child reads a pipe only the parent can write */
+    int report_fds[2];
+    TEST_ASSERT(pipe(report_fds) == 0, "Report pipe should be created");
+    pid_t parent = fork();
+    if (parent == 0) {
+        int data_fds[2];
+        close(report_fds[0]);
+        if (pipe(data_fds) != 0) {
+            _exit(1);
+        }
+        pid_t child = fork();
+        if (child == 0) {
+            char c;
+            close(report_fds[1]);
+            close(data_fds[1]);
+            (void)read(data_fds[0], &c, 1);
+            _exit(0);
+        }
+        close(data_fds[0]);
+        (void)write(report_fds[1], &child, sizeof(child));
+        waitpid(child, NULL, 0);
+        _exit(0);
+    }
+    TEST_ASSERT(parent > 0, "Fork should succeed");
+    if (parent <= 0) {
+        return;
+    }
+    close(report_fds[1]);
+    
+    pid_t child = 0;
+    TEST_ASSERT(read(report_fds[0], &child, sizeof(child)) == (ssize_t)sizeof(child),
+                "Child PID should be reported");
+    close(report_fds[0]);
+    struct timespec settle = {0, 200000000};
+    nanosleep(&settle, NULL);
+    
+    ProcessResourceInfo procs[2];
+    FdSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    fd_snapshot_prepare(&snapshot, 2);
+    TEST_ASSERT(get_process_resources_with_table(parent, &snapshot.tables[0], NULL, &procs[0]) == SUCCESS &&
+                get_process_resources_with_table(child, &snapshot.tables[1], NULL, &procs[1]) == SUCCESS,
+                "Collect parent and child");
+    
+    TEST_ASSERT(procs[0].wait.kind == WAIT_SYSCALL_CHILD && procs[0].is_blocked_on_child &&
+                procs[0].num_child_pids == 1 && procs[0].child_pids[0] == (int)child,
+                "Parent should wait for exactly its child");
+    /* Inherited pipes (e.g. a piped stdout) are held too but not waited on */
+    int waited_fd_is_pipe = 0;
+    for (int k = 0; k < procs[1].num_pipe_inodes; k++) {
+        waited_fd_is_pipe |= procs[1].pipe_fds[k] == procs[1].wait.fd;
+    }
+    TEST_ASSERT(procs[1].wait.kind == WAIT_SYSCALL_READ && procs[1].is_blocked_on_pipe &&
+                waited_fd_is_pipe, "Child should wait on the read end it holds");
+    
+    analyze_pipe_and_lock_dependencies(procs, 2);
+    TEST_ASSERT(procs[0].num_waiting == 1 &&
+                procs[0].waiting_resources[0] == CHILD_EXIT_RESOURCE_BASE + (int)child,
+                "Parent should wait on the child's exit");
+    TEST_ASSERT(procs[1].num_waiting_on_pids == 1 && procs[1].waiting_on_pids[0] == (int)parent,
+                "Child should wait on the pipe writer only");
+    
+    DeadlockReport* report = create_deadlock_report();
+    TEST_ASSERT(report != NULL && detect_deadlock_in_system(procs, 2, report) == 1 &&
+                report->num_deadlocked == 2, "Wait/pipe cycle should be a deadlock");
+    free_deadlock_report(report);
+    free(report);
+    
+    free_process_resource_info(&procs[0]);
+    free_process_resource_info(&procs[1]);
+    free_fd_snapshot(&snapshot);
+    
+    kill(child, SIGKILL);
+    waitpid(parent, NULL, 0);
+    
+    /* splice() is not decoded; its pipe wchan must still mark a pipe wait */
+    int in_fds[2];
+    int out_fds[2];
+    TEST_ASSERT(pipe(in_fds) == 0 && pipe(out_fds) == 0, "Splice pipes should be created");
+    pid_t splicer = fork();
+    if (splicer == 0) {
+        close(in_fds[1]);
+        (void)splice(in_fds[0], NULL, out_fds[1], NULL, 4096, 0);
+        _exit(0);
+    }
+    TEST_ASSERT(splicer > 0, "Fork should succeed");
+    if (splicer <= 0) {
+        return;
+    }
+    nanosleep(&settle, NULL);
+    
+    FdTable table;
+    memset(&table, 0, sizeof(table));
+    ProcessResourceInfo spliced;
+    TEST_ASSERT(get_process_resources_with_table(splicer, &table, NULL, &spliced) == SUCCESS,
+                "Collect the splicing child");
+    TEST_ASSERT(spliced.wait.kind == WAIT_SYSCALL_UNKNOWN && spliced.is_blocked_on_pipe,
+                "A child blocked in splice() should still be a pipe waiter");
+    free_process_resource_info(&spliced);
+    free_fd_table(&table);
+    
+    kill(splicer, SIGKILL);
+    waitpid(splicer, NULL, 0);
+    for (int i = 0; i < 2; i++) {
+        close(in_fds[i]);
+        close(out_fds[i]);
+    }
+}
+
+/*
+ * test_lock_index - Test /proc/locks tokenizing and inode/PID lookups
+ */
+static void test_lock_index(void)
+{
+    printf("\n[TEST] Lock Index\n");
+    printf("----------------------------------------\n");
+    
+    const char* text =
+        "1: POSIX  ADVISORY  WRITE 4100 08:01:393231 0 EOF\n"
+        "1: -> POSIX  ADVISORY  WRITE 4200 08:01:393231 0 EOF\n"
+        "1:  -> POSIX  ADVISORY  READ  4300 08:01:393231 0 EOF\n"
+        "2: FLOCK  ADVISORY  READ  4200 fd:1a:55 0 EOF\n"
+        "3: OFDLCK ADVISORY  READ  -1 00:2e:393231 10 99\n"
+        "4: POSIX  ADVISORY  WRITE 4100 08:01:777 0 EOF\n"
+        "9: -> FLOCK  ADVISORY  WRITE 4400 08:01:888 0 EOF\n"
+        "garbage\n";
+    
+    LockIndex index;
+    memset(&index, 0, sizeof(index));
+    TEST_ASSERT(lock_index_parse(&index, text) == SUCCESS, "Parse lock table");
+    TEST_ASSERT(index.num_locks == 4, "Waiter and malformed lines should not be holders");
+    TEST_ASSERT(index.num_waiters == 2 &&
+                index.waiters[0].pid == 4200 && index.waiters[0].blocker == 0 &&
+                index.waiters[1].pid == 4300 && index.waiters[1].blocker == 0,
+                "Waiters, nested ones included, should point at the held lock");
+    
+    const FileLockInfo* lock = &index.locks[1];
+    TEST_ASSERT(lock->lock_id == 2 && lock->lock_type == 'F' && lock->pid == 4200 &&
+                lock->inode == 55 && !lock->is_blocking,
+                "FLOCK READ line should be tokenized");
+    TEST_ASSERT(index.locks[2].lock_type == 'P' && index.locks[2].start == 10 &&
+                index.locks[2].end == 99, "OFD lock range should be parsed");
+    
+    int j = lock_index_first_by_inode(&index, 393231);
+    TEST_ASSERT(j == 0 && index.next_by_inode[j] == 2 && index.next_by_inode[2] == -1,
+                "Inode chain should list both locks in file order");
+    TEST_ASSERT(lock_index_first_by_inode(&index, 12345) == -1, "Unlocked inode should not be found");
+    j = lock_index_first_by_pid(&index, 4100);
+    TEST_ASSERT(j == 0 && index.next_by_pid[j] == 3 && index.next_by_pid[3] == -1,
+                "PID chain should list the holder's locks");
+    TEST_ASSERT(lock_index_has_device(&index, 55, index.locks[1].device) &&
+                index.locks[1].device != index.locks[0].device &&
+                !lock_index_has_device(&index, 55, index.locks[0].device),
+                "Hex device numbers should tell locks apart");
+    
+    free_lock_index(&index);
+    TEST_ASSERT(index.num_locks == 0 && index.locks == NULL, "Free lock index");
+}
+
+/*
+ * append_proc_event - Append one connector process event to a datagram
+ * @buf: Datagram being built (4-byte aligned)
+ * @len: In/out: bytes used in buf
+ * @what: PROC_EVENT_* type
+ * @pid: Thread ID the event is about
+ * @tgid: Thread group ID the event is about
+ */
+static void append_proc_event(char* buf, size_t* len, unsigned int what, pid_t pid, pid_t tgid)
+{
+    struct nlmsghdr* nlh = (struct nlmsghdr*)(buf + *len);
+    memset(nlh, 0, NLMSG_SPACE(sizeof(struct cn_msg) + sizeof(struct proc_event)));
+    nlh->nlmsg_len = NLMSG_LENGTH(sizeof(struct cn_msg) + sizeof(struct proc_event));
+    nlh->nlmsg_type = NLMSG_DONE;
+    
+    struct cn_msg* cn = (struct cn_msg*)NLMSG_DATA(nlh);
+    cn->id.idx = CN_IDX_PROC;
+    cn->id.val = CN_VAL_PROC;
+    cn->len = sizeof(struct proc_event);
+    
+    struct proc_event event;
+    memset(&event, 0, sizeof(event));
+    event.what = what;
+    if (what == PROC_EVENT_FORK) {
+        event.event_data.fork.child_pid = pid;
+        event.event_data.fork.child_tgid = tgid;
+    } else if (what == PROC_EVENT_EXEC) {
+        event.event_data.exec.process_pid = pid;
+        event.event_data.exec.process_tgid = tgid;
+    } else if (what == PROC_EVENT_EXIT) {
+        event.event_data.exit.process_pid = pid;
+        event.event_data.exit.process_tgid = tgid;
+    }
+    memcpy(cn->data, &event, sizeof(event));
+    *len += NLMSG_ALIGN(nlh->nlmsg_len);
+}
+
+/*
+ * test_proc_events - Test the event-fed live PID set
+ */
+static void test_proc_events(void)
+{
+    printf("\n[TEST] Process Events\n");
+    printf("----------------------------------------\n");
+    
+    ProcEventFeed feed;
+    memset(&feed, 0, sizeof(feed));
+    feed.fd = -1;
+    
+    unsigned long storage[1024];
+    char* buf = (char*)storage;
+    size_t len = 0;
+    append_proc_event(buf, &len, PROC_EVENT_FORK, 300, 300);
+    append_proc_event(buf, &len, PROC_EVENT_FORK, 70000, 70000);
+    append_proc_event(buf, &len, PROC_EVENT_FORK, 42, 42);
+    append_proc_event(buf, &len, PROC_EVENT_FORK, 301, 300);
+    append_proc_event(buf, &len, PROC_EVENT_EXEC, 42, 42);
+    append_proc_event(buf, &len, PROC_EVENT_EXIT, 301, 300);
+    append_proc_event(buf, &len, PROC_EVENT_EXIT, 70000, 70000);
+    TEST_ASSERT(proc_events_dispatch(&feed, buf, len) == 5, "Thread fork and exit should be ignored");
+    TEST_ASSERT(feed.num_live == 2, "Thread exit should not remove its process");
+    TEST_ASSERT(feed.num_execs == 1 && feed.execs[0] == 42, "Exec should be reported");
+    
+    PidVector vec = {NULL, 0, 0};
+    TEST_ASSERT(proc_events_fill(&feed, &vec) == SUCCESS && vec.count == 2 &&
+                vec.pids[0] == 42 && vec.pids[1] == 300,
+                "Live set should list leaders in ascending order");
+    
+    len = 0;
+    append_proc_event(buf, &len, PROC_EVENT_FORK, 500, 500);
+    ((struct nlmsghdr*)buf)->nlmsg_len -= 8;
+    TEST_ASSERT(proc_events_dispatch(&feed, buf, len) == 0 && feed.num_live == 2,
+                "Truncated event should be ignored");
+    struct nlmsghdr* overrun = (struct nlmsghdr*)buf;
+    memset(overrun, 0, sizeof(*overrun));
+    overrun->nlmsg_len = NLMSG_LENGTH(0);
+    overrun->nlmsg_type = NLMSG_OVERRUN;
+    proc_events_dispatch(&feed, buf, overrun->nlmsg_len);
+    TEST_ASSERT(feed.need_reconcile, "Overrun should request reconciliation");
+    proc_events_close(&feed);
+    TEST_ASSERT(feed.live == NULL && feed.num_live == 0, "Close feed");
+    
+    /* Subscribing needs CAP_NET_ADMIN and the initial namespace */
+    int result = proc_events_open(&feed);
+    if (result == SUCCESS) {
+        TEST_ASSERT(feed.fd >= 0 && proc_events_poll(&feed, &vec) == SUCCESS, "Poll feed");
+        int found = 0;
+        for (int i = 0; i < vec.count; i++) {
+            found |= vec.pids[i] == getpid();
+        }
+        TEST_ASSERT(found, "Live set should contain this process");
+    } else {
+        TEST_ASSERT(feed.fd == -1 && feed.live == NULL,
+                    "Unavailable connector should leave the feed closed");
+    }
+    proc_events_close(&feed);
+    free_pid_vector(&vec);
+    
+    ScanRecord record;
+    memset(&record, 0, sizeof(record));
+    record.pid = 42;
+    record.reusable = 1;
+    ScanHistory history;
+    memset(&history, 0, sizeof(history));
+    scan_history_commit(&history, &record, 1);
+    scan_history_forget(&history, 42);
+    TEST_ASSERT(!scan_history_find(&history, 42)->reusable, "Exec'd process should be re-read");
+    free_scan_history(&history);
+}
+
+/*
+ * test_proc_uring - Test batched /proc reads and triage through io_uring
+ */
+static void test_proc_uring(void)
+{
+    printf("\n[TEST] io_uring Batched Reads\n");
+    printf("----------------------------------------\n");
+    
+    ProcUring ring;
+    int result = proc_uring_init(&ring);
+    if (result != SUCCESS) {
+        TEST_ASSERT(ring.fd == -1, "Unavailable io_uring should leave the ring closed");
+        proc_uring_set_enabled(1);
+        TEST_ASSERT(thread_proc_uring() == NULL, "Scans should fall back to synchronous reads");
+        proc_uring_set_enabled(0);
+        return;
+    }
+    
+    int dir_fd = open("/proc/self", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    ProcReadRequest requests[3] = {
+        {dir_fd, PROC_STAT_FILE, NULL, 0},
+        {dir_fd, PROC_WCHAN_FILE, NULL, 0},
+        {dir_fd, "no_such_file", NULL, 0}
+    };
+    TEST_ASSERT(proc_uring_read(&ring, requests, 3) == SUCCESS, "Batch should complete");
+    
+    char state = 0;
+    unsigned long long batched_start = 0;
+    unsigned long long start_time = 1;
+    ProcHandle self;
+    proc_handle_open(&self, getpid());
+    proc_handle_read_stat(&self, &state, &start_time);
+    proc_handle_close(&self);
+    TEST_ASSERT(requests[0].data != NULL &&
+                proc_stat_parse(requests[0].data, &state, &batched_start) == SUCCESS &&
+                batched_start == start_time, "Batched stat should match a synchronous read");
+    TEST_ASSERT(requests[1].data != NULL && requests[1].len == (ssize_t)strlen(requests[1].data),
+                "Batched wchan should be NUL-terminated");
+    TEST_ASSERT(requests[2].data == NULL && requests[2].len == -ENOENT,
+                "Missing file should report -ENOENT");
+    TEST_ASSERT(proc_uring_read(&ring, requests, PROC_URING_MAX_BATCH + 1) == ERROR_INVALID_ARGUMENT,
+                "Oversized batch should be rejected");
+    close(dir_fd);
+    proc_uring_destroy(&ring);
+    TEST_ASSERT(ring.fd == -1 && ring.buffers == NULL, "Destroy ring");
+    
+    /* Triage through the ring must agree with synchronous triage */
+    int fds[2];
+    TEST_ASSERT(pipe(fds) == 0, "Create pipe");
+    pid_t child = fork();
+    if (child == 0) {
+        char c;
+        close(fds[1]);
+        ssize_t n = read(fds[0], &c, 1);
+        _exit(n == 1 ? 0 : 1);
+    }
+    close(fds[0]);
+    for (int i = 0; i < 100; i++) {
+        char* wchan = NULL;
+        int blocked = get_process_wchan(child, &wchan) == SUCCESS &&
+                      wchan != NULL && strstr(wchan, "pipe") != NULL;
+        free(wchan);
+        if (blocked) {
+            break;
+        }
+        struct timespec delay = {0, 10000000};
+        nanosleep(&delay, NULL);
+    }
+    
+    pid_t pids[3] = {child, getpid(), 999999999};
+    char sync_blocked[3], batched_blocked[3];
+    int sync_results[3], batched_results[3];
+    triage_processes(NULL, pids, 3, NULL, sync_blocked, sync_results);
+    
+    proc_uring_set_enabled(1);
+    TEST_ASSERT(thread_proc_uring() != NULL, "Thread ring should be set up");
+    triage_processes(NULL, pids, 3, NULL, batched_blocked, batched_results);
+    TEST_ASSERT(memcmp(sync_blocked, batched_blocked, 3) == 0 &&
+                memcmp(sync_results, batched_results, sizeof(sync_results)) == 0,
+                "Batched triage should match synchronous triage");
+    TEST_ASSERT(batched_blocked[0] == 1 && batched_results[2] == ERROR_FILE_NOT_FOUND,
+                "Pipe reader should be flagged and the missing process reported");
+    
+    /* Second round revalidates the cached handles from the batched stat */
+    ProcHandleCache cache;
+    proc_handle_cache_init(&cache);
+    ProcHandle handles[3];
+    for (int round = 0; round < 2; round++) {
+        proc_handle_cache_checkout(&cache, pids, 3, handles);
+        memset(batched_blocked, 0, sizeof(batched_blocked));
+        triage_processes(NULL, pids, 3, handles, batched_blocked, batched_results);
+        TEST_ASSERT(memcmp(sync_blocked, batched_blocked, 3) == 0 &&
+                    memcmp(sync_results, batched_results, sizeof(sync_results)) == 0 &&
+                    handles[0].dir_fd >= 0 && handles[0].start_time != 0,
+                    round == 0 ? "Batched triage should open new handles" :
+                                 "Batched triage should revalidate cached handles");
+        proc_handle_cache_checkin(&cache, handles, 3);
+    }
+    proc_handle_cache_destroy(&cache);
+    release_thread_proc_uring();
+    proc_uring_set_enabled(0);
+    
+    close(fds[1]);
+    waitpid(child, NULL, 0);
+}
+
+/*
+ * test_scan_schedule - Test the adaptive scan delay and its statistics
+ */
+static void test_scan_schedule(void)
+{
+    printf("\n[TEST] Scan Schedule\n");
+    printf("----------------------------------------\n");
+    
+    ScanSchedule schedule;
+    TEST_ASSERT(scan_schedule_init(&schedule, 500, 100, 2.0, 100) == ERROR_INVALID_ARGUMENT,
+                "Floor above ceiling should be rejected");
+    TEST_ASSERT(scan_schedule_init(&schedule, 100, 1000, 0.5, 100) == ERROR_INVALID_ARGUMENT,
+                "Ramp below 1 should be rejected");
+    TEST_ASSERT(scan_schedule_init(&schedule, 100, 1000, 2.0, 5000) == SUCCESS &&
+                schedule.delay_ms == 1000, "Initial delay should be clamped to the ceiling");
+    
+    ScanOutcome outcome;
+    memset(&outcome, 0, sizeof(outcome));
+    outcome.start_ms = 0.0;
+    outcome.end_ms = 10.0;
+    outcome.num_blocked = 3;
+    TEST_ASSERT(scan_schedule_update(&schedule, &outcome) == 100,
+                "Newly blocked processes should tighten to the floor");
+    TEST_ASSERT(scan_schedule_update(&schedule, &outcome) == 200 &&
+                scan_schedule_update(&schedule, &outcome) == 400,
+                "A stable blocked set should back off by the ramp");
+    outcome.num_blocked = 0;
+    for (int i = 0; i < 5; i++) {
+        scan_schedule_update(&schedule, &outcome);
+    }
+    TEST_ASSERT(schedule.delay_ms == 1000, "Quiet scans should back off to the ceiling");
+    
+    /* Last clear scan starts at 1000; the cycle is reported by a scan ending at 1810 */
+    outcome.start_ms = 1000.0;
+    outcome.end_ms = 1010.0;
+    scan_schedule_update(&schedule, &outcome);
+    outcome.num_blocked = 2;
+    outcome.num_waiting = 2;
+    outcome.start_ms = 1800.0;
+    outcome.end_ms = 1810.0;
+    outcome.deadlock = 1;
+    TEST_ASSERT(scan_schedule_update(&schedule, &outcome) == 100,
+                "A deadlock should tighten to the floor");
+    TEST_ASSERT(schedule.last_latency_ms == 810.0 && schedule.worst_latency_ms == 810.0,
+                "Detection latency should run from the last clear scan");
+    outcome.start_ms = 1900.0;
+    outcome.end_ms = 1910.0;
+    scan_schedule_update(&schedule, &outcome);
+    TEST_ASSERT(schedule.last_latency_ms == 810.0 && schedule.delay_ms == 200,
+                "A deadlock that persists should back off and not be timed again");
+    TEST_ASSERT(schedule.num_scans == 11 && schedule.total_scan_ms == 110.0 &&
+                schedule.last_scan_ms == 10.0, "Scan time should be accumulated");
+    double overhead = scan_schedule_overhead(&schedule, schedule.started_ms + 1100.0);
+    TEST_ASSERT(overhead > 0.0999 && overhead < 0.1001,
+                "Overhead should be scan time over run time");
+    
+    TEST_ASSERT(scan_schedule_init(&schedule, 5000, 5000, 1.0, 5000) == SUCCESS &&
+                scan_schedule_update(&schedule, &outcome) == 5000, "Fixed interval should not adapt");
+}
+
+/*
+ * test_event_loop - Test drift-free ticks, overrun skipping and signal delivery
+ */
+static void test_event_loop(void)
+{
+    printf("\n[TEST] Event Loop\n");
+    printf("----------------------------------------\n");
+    
+    EventLoop loop;
+    TEST_ASSERT(event_loop_open(&loop) == SUCCESS, "Open timerfd and signalfd");
+    if (loop.timer_fd < 0) {
+        return;
+    }
+    
+    int sig = 0;
+    TEST_ASSERT(event_loop_rearm_now(&loop) == SUCCESS &&
+                event_loop_wait(&loop, &sig) == EVENT_LOOP_TIMER, "Rearmed tick should be due now");
+    
+    /* 5 ms of work per 20 ms period must not stretch the period */
+    double start = scan_clock_ms();
+    int ticks = 0;
+    for (int i = 0; i < 5; i++) {
+        struct timespec work = { 0, 5000000L };
+        nanosleep(&work, NULL);
+        if (event_loop_arm(&loop, 20) == SUCCESS &&
+            event_loop_wait(&loop, &sig) == EVENT_LOOP_TIMER) {
+            ticks++;
+        }
+    }
+    double elapsed = scan_clock_ms() - start;
+    TEST_ASSERT(ticks == 5 && elapsed >= 99.0 && elapsed < 120.0,
+                "Five 20 ms periods should take 100 ms, not 125 ms");
+    TEST_ASSERT(loop.overruns == 0, "No tick should be skipped");
+    
+    /* A 70 ms scan in a 20 ms period skips three ticks */
+    struct timespec overrun = { 0, 70000000L };
+    nanosleep(&overrun, NULL);
+    TEST_ASSERT(event_loop_arm(&loop, 20) == SUCCESS && loop.overruns == 3,
+                "Overrun ticks should be skipped and counted");
+    
+    raise(SIGHUP);
+    TEST_ASSERT(event_loop_wait(&loop, &sig) == EVENT_LOOP_SIGNAL && sig == SIGHUP,
+                "A pending signal should be read before the tick");
+    TEST_ASSERT(event_loop_wait(&loop, &sig) == EVENT_LOOP_TIMER, "The tick should follow");
+    TEST_ASSERT(event_loop_arm(&loop, 0) == ERROR_INVALID_ARGUMENT, "Zero delay should be rejected");
+    
+    event_loop_close(&loop);
+    sigset_t mask;
+    sigprocmask(SIG_BLOCK, NULL, &mask);
+    TEST_ASSERT(loop.timer_fd == -1 && !sigismember(&mask, SIGHUP),
+                "Close should restore the signal mask");
+    event_loop_close(&loop);
+}
+
+/*
+ * test_flock_deadlock - Test a real two-process flock() deadlock end to end
+ */
+static void test_flock_deadlock(void)
+{
+    printf("\n[TEST] Flock Deadlock\n");
+    printf("----------------------------------------\n");
+    
+    char paths[2][64];
+    int files[2];
+    for (int f = 0; f < 2; f++) {
+        snprintf(paths[f], sizeof(paths[f]), "/tmp/dd_test_lock_%d_%d", (int)getpid(), f);
+        files[f] = open(paths[f], O_RDWR | O_CREAT | O_TRUNC, 0600);
+    }
+    TEST_ASSERT(files[0] >= 0 && files[1] >= 0, "Create lock files");
+    
+    /* Child c locks file c, then file 1 - c */
+    int ready_fds[2];
+    int go_fds[2];
+    TEST_ASSERT(pipe(ready_fds) == 0 && pipe(go_fds) == 0, "Create handshake pipes");
+    pid_t children[2];
+    for (int c = 0; c < 2; c++) {
+        children[c] = fork();
+        if (children[c] == 0) {
+            char go;
+            int own = open(paths[c], O_RDWR);
+            int other = open(paths[1 - c], O_RDWR);
+            flock(own, LOCK_EX);
+            (void)write(ready_fds[1], "r", 1);
+            (void)read(go_fds[0], &go, 1);
+            flock(other, LOCK_EX);
+            _exit(0);
+        }
+    }
+    
+    char ready[2];
+    for (int got = 0; got < 2; ) {
+        ssize_t n = read(ready_fds[0], ready, (size_t)(2 - got));
+        if (n <= 0) {
+            break;
+        }
+        got += (int)n;
+    }
+    (void)write(go_fds[1], "gg", 2);
+    struct timespec settle = {0, 200000000};
+    nanosleep(&settle, NULL);
+    
+    ProcessResourceInfo procs[2];
+    FdSnapshot snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));
+    fd_snapshot_prepare(&snapshot, 2);
+    int collected = 1;
+    for (int c = 0; c < 2; c++) {
+        collected &= get_process_resources_with_table(children[c], &snapshot.tables[c],
+                                                      NULL, &procs[c]) == SUCCESS;
+    }
+    TEST_ASSERT(collected && procs[0].is_blocked_on_lock && procs[1].is_blocked_on_lock,
+                "Both children should be blocked on a lock");
+    
+    LockIndex locks;
+    memset(&locks, 0, sizeof(locks));
+    int listed = 0;
+    if (lock_index_load(&locks) == SUCCESS) {
+        for (int w = 0; w < locks.num_waiters; w++) {
+            for (int c = 0; c < 2; c++) {
+                listed += locks.waiters[w].pid == (int)children[c] &&
+                          locks.locks[locks.waiters[w].blocker].pid == (int)children[1 - c];
+            }
+        }
+    }
+    free_lock_index(&locks);
+    TEST_ASSERT(listed == 2, "/proc/locks should list each child waiting on the other");
+    
+    /* Waiter lines alone must produce the edges, without the wchan hint */
+    procs[0].is_blocked_on_lock = 0;
+    procs[1].is_blocked_on_lock = 0;
+    analyze_pipe_and_lock_dependencies(procs, 2);
+    TEST_ASSERT(procs[0].num_waiting_on_pids == 1 && procs[0].waiting_on_pids[0] == (int)children[1] &&
+                procs[1].num_waiting_on_pids == 1 && procs[1].waiting_on_pids[0] == (int)children[0],
+                "Each child should wait on the other's lock");
+    
+    DeadlockReport* report = create_deadlock_report();
+    TEST_ASSERT(report != NULL && detect_deadlock_in_system(procs, 2, report) == 1 &&
+                report->num_deadlocked == 2, "Crossed flock() calls should be a deadlock");
+    free_deadlock_report(report);
+    free(report);
+    
+    /* Re-reads of the two children alone must find the same cycle */
+    procs[0].is_blocked_on_lock = 1;
+    procs[1].is_blocked_on_lock = 1;
+    int members[2] = { (int)children[0], (int)children[1] };
+    ConfirmResult confirm;
+    TEST_ASSERT(confirm_deadlock(members, 2, procs, 2, 3, 10, &confirm) == 1 &&
+                confirm.rounds == 3 && confirm.reason == NULL && confirm.elapsed_ms >= 30.0,
+                "A real deadlock should survive every re-read");
+    TEST_ASSERT(confirm_deadlock(members, 2, procs, 1, 3, 10, &confirm) == ERROR_INVALID_ARGUMENT,
+                "A member missing from the scan should be rejected");
+    
+    /* A start time other than the scan's is a reused PID, not the member */
+    TEST_ASSERT(procs[0].start_time != 0 && procs[1].start_time != 0,
+                "Blocked processes should record their start time");
+    procs[0].start_time++;
+    TEST_ASSERT(confirm_deadlock(members, 2, procs, 2, 3, 10, &confirm) == 0 &&
+                confirm.rounds == 0 && confirm.changed_pid == (int)children[0] &&
+                confirm.reason != NULL && strcmp(confirm.reason, "process exited") == 0,
+                "A member with another start time should count as exited");
+    procs[0].start_time--;
+    
+    /* Killing one member releases its lock; the other takes it and exits */
+    kill(children[0], SIGKILL);
+    waitpid(children[0], NULL, 0);
+    TEST_ASSERT(confirm_deadlock(members, 2, procs, 2, 3, 10, &confirm) == 0 &&
+                confirm.rounds == 0 && confirm.changed_pid == (int)children[0] &&
+                confirm.reason != NULL, "A dissolved cycle should not be confirmed");
+    
+    for (int c = 0; c < 2; c++) {
+        free_process_resource_info(&procs[c]);
+        kill(children[c], SIGKILL);
+        waitpid(children[c], NULL, 0);
+        close(files[c]);
+        unlink(paths[c]);
+    }
+    free_fd_snapshot(&snapshot);
+    close(ready_fds[0]);
+    close(ready_fds[1]);
+    close(go_fds[0]);
+    close(go_fds[1]);
+}
+
+/*
+ * test_scan_arena - Test arena allocation, reset and arena-backed reports
+ */
+static void test_scan_arena(void)
+{
+    printf("\n[TEST] Scan Arena\n");
+    printf("----------------------------------------\n");
+    
+    Arena* arena = arena_create(256);
+    TEST_ASSERT(arena != NULL, "Create arena");
+    if (arena == NULL) {
+        return;
+    }
+    
+    char* a = (char*)arena_alloc(arena, 3);
+    char* b = (char*)arena_alloc(arena, 5);
+    TEST_ASSERT(a != NULL && b != NULL, "Small allocations should succeed");
+    TEST_ASSERT(((size_t)a % ARENA_ALIGNMENT) == 0 && ((size_t)b % ARENA_ALIGNMENT) == 0,
+                "Allocations should be aligned");
+    TEST_ASSERT(b == a + ARENA_ALIGNMENT, "Allocations should bump within a chunk");
+    
+    char* big = (char*)arena_alloc(arena, 1000);
+    TEST_ASSERT(big != NULL, "Oversized allocation should get its own chunk");
+    memset(big, 0xab, 1000);
+    for (int i = 0; i < 40; i++) {
+        arena_alloc(arena, 100);
+    }
+    
+    char* copy = arena_strdup(arena, "lock_42");
+    TEST_ASSERT(copy != NULL && strcmp(copy, "lock_42") == 0, "Duplicate string into arena");
+    
+    int chunks = 0;
+    for (ArenaChunk* chunk = arena->first; chunk != NULL; chunk = chunk->next) {
+        chunks++;
+    }
+    TEST_ASSERT(chunks > 2, "Arena should chain several chunks");
+    
+    arena_reset(arena);
+    TEST_ASSERT(arena->bytes_used == 0, "Reset should release all bytes");
+    TEST_ASSERT(arena_alloc(arena, 3) == a, "Reset should reuse the first chunk");
+    arena_alloc(arena, 1000);
+    for (int i = 0; i < 40; i++) {
+        arena_alloc(arena, 100);
+    }
+    int chunks_after = 0;
+    for (ArenaChunk* chunk = arena->first; chunk != NULL; chunk = chunk->next) {
+        chunks_after++;
+    }
+    TEST_ASSERT(chunks_after == chunks, "Same-sized scan should not add chunks");
+    
+    char* heap_copy = arena_strdup(NULL, "heap");
+    TEST_ASSERT(heap_copy != NULL && strcmp(heap_copy, "heap") == 0,
+                "NULL arena should fall back to the heap");
+    free(heap_copy);
+    
+    /* Arena-backed report: P1 <-> P2 deadlock as in the detection test */
+    arena_reset(arena);
+    ProcessResourceInfo* procs = create_mock_process_data(2);
+    DeadlockReport* report = create_deadlock_report();
+    TEST_ASSERT(procs != NULL && report != NULL, "Create process data and report");
+    
+    if (procs != NULL && report != NULL) {
+        for (int i = 0; i < 2; i++) {
+            procs[i].arena = arena;
+            procs[i].held_resources = (int*)arena_alloc(arena, sizeof(int));
+            procs[i].held_resources[0] = i + 1;
+            procs[i].num_held = 1;
+            procs[i].waiting_resources = (int*)arena_alloc(arena, sizeof(int));
+            procs[i].waiting_resources[0] = 2 - i;
+            procs[i].num_waiting = 1;
+        }
+        
+        report->arena = arena;
+        int result = detect_deadlock_in_system(procs, 2, report);
+        TEST_ASSERT(result > 0 && report->deadlock_detected == 1,
+                    "Arena-backed detection should find the deadlock");
+        TEST_ASSERT(report->num_deadlocked == 2, "Both processes should be reported");
+        TEST_ASSERT(report->num_explanations > 0 && report->explanations[0] != NULL,
+                    "Explanations should be generated in the arena");
+        TEST_ASSERT(arena->bytes_used > 0, "Report contents should come from the arena");
+        
+        free_deadlock_report(report);
+        TEST_ASSERT(report->cycles == NULL && report->explanations == NULL &&
+                    report->arena == NULL, "Freeing an arena-backed report drops its pointers");
+        free_mock_process_data(procs, 2);
+        procs = NULL;
+    }
+    
+    free(report);
+    free(procs);
+    arena_destroy(arena);
+}
+
 /* =============================================================================
  * MAIN TEST RUNNER
  * =============================================================================
@@ -366,11 +1932,31 @@ int main(void)
     test_build_rag_from_processes();
     test_deadlock_detection_no_deadlock();
     test_deadlock_detection_with_deadlock();
+    test_deadlock_detection_filtered();
     test_output_formatting_text();
     test_output_formatting_json();
     test_output_formatting_verbose();
     test_format_parsing();
     test_report_creation_cleanup();
+    test_parse_process_status();
+    test_read_proc_file_into();
+    test_proc_handle();
+    test_proc_handle_cache();
+    test_enumerate_processes();
+    test_fd_snapshot();
+    test_pipe_dependency_index();
+    test_pipe_end_edges();
+    test_parallel_collection();
+    test_scan_arena();
+    test_incremental_collection();
+    test_blocked_triage();
+    test_wait_syscall_edges();
+    test_lock_index();
+    test_flock_deadlock();
+    test_proc_events();
+    test_proc_uring();
+    test_scan_schedule();
+    test_event_loop();
     
     /* Print summary */
     printf("\n========================================\n");